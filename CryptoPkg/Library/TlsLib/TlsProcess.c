@@ -104,6 +104,16 @@ TlsDoHandshake (
     //
     PendingBufferSize = (UINTN) BIO_ctrl_pending (TlsConn->OutBio);
     if (PendingBufferSize == 0) {
+      if (SSL_is_init_finished (TlsConn->Ssl) || SSL_get_shutdown (TlsConn->Ssl) != 0) {
+        //
+        // A new connection is started on a TLS object used before. Reset the
+        // object and drop what is left of the previous connection. The session
+        // of the previous connection is kept, so the ClientHello offers to
+        // resume it and an abbreviated handshake is done if the server agrees.
+        //
+        SSL_clear (TlsConn->Ssl);
+        BIO_reset (TlsConn->InBio);
+      }
       SSL_set_connect_state (TlsConn->Ssl);
       Ret = SSL_do_handshake (TlsConn->Ssl);
       PendingBufferSize = (UINTN) BIO_ctrl_pending (TlsConn->OutBio);
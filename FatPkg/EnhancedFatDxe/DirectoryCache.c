@@ -37,6 +37,10 @@ FatFreeODir (
     FatFreeDirEnt (DirEnt);
   }
 
+  if (ODir->LongNameHashTable != NULL) {
+    FreePool (ODir->LongNameHashTable);
+  }
+
   FreePool (ODir);
 }
 
@@ -63,6 +67,11 @@ FatAllocateODir (
     ODir->Signature = FAT_ODIR_SIGNATURE;
     InitializeListHead (&ODir->ChildList);
     ODir->CurrentCursor = &ODir->ChildList;
+    ODir->DirCacheSize  = sizeof (FAT_ODIR);
+    if (EFI_ERROR (FatResizeHashTable (ODir, HASH_TABLE_MIN_SIZE))) {
+      FreePool (ODir);
+      ODir = NULL;
+    }
   }
 
   return ODir;
@@ -72,6 +81,8 @@ FatAllocateODir (
 
   Discard the directory structure when an OFile will be freed.
   Volume will cache this directory if the OFile does not represent a deleted file.
+  The least recently used directories are freed when the cached directories use
+  more memory than PcdFatDirCacheSize, the latest one is always kept.
 
   @param  OFile                 - The OFile whose directory structure is to be discarded.
 
@@ -93,26 +104,26 @@ FatDiscardODir (
     //
     ODir->DirCacheTag = OFile->FileCluster;
     InsertHeadList (&Volume->DirCacheList, &ODir->DirCacheLink);
-    if (Volume->DirCacheCount == FAT_MAX_DIR_CACHE_COUNT) {
+    Volume->DirCacheCount++;
+    Volume->DirCacheSize += ODir->DirCacheSize;
+    while (Volume->DirCacheCount > 1 &&
+           (Volume->DirCacheCount > FAT_MAX_DIR_CACHE_COUNT || Volume->DirCacheSize > PcdGet32 (PcdFatDirCacheSize))) {
       //
       // Replace the least recent used directory
       //
       ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
       RemoveEntryList (&ODir->DirCacheLink);
-    } else {
-      //
-      // No need to find a replace
-      //
-      Volume->DirCacheCount++;
-      ODir = NULL;
+      Volume->DirCacheCount--;
+      Volume->DirCacheSize -= ODir->DirCacheSize;
+      FatFreeODir (ODir);
     }
+
+    return;
   }
   //
   // Release ODir Structure
   //
-  if (ODir != NULL) {
-    FatFreeODir (ODir);
-  }
+  FatFreeODir (ODir);
 }
 
 /**
@@ -147,6 +158,7 @@ FatRequestODir (
     if (CurrentODir->DirCacheTag == DirCacheTag) {
       RemoveEntryList (&CurrentODir->DirCacheLink);
       Volume->DirCacheCount--;
+      Volume->DirCacheSize -= CurrentODir->DirCacheSize;
       ODir = CurrentODir;
       break;
     }
@@ -178,6 +190,7 @@ FatCleanupODirCache (
   while (Volume->DirCacheCount > 0) {
     ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
     RemoveEntryList (&ODir->DirCacheLink);
+    Volume->DirCacheSize -= ODir->DirCacheSize;
     FatFreeODir (ODir);
     Volume->DirCacheCount--;
   }
@@ -203,6 +203,100 @@ FatGetCachePage (
   return Status;
 }
 
+/**
+
+  Load the data cache page of PageNo together with the pages following it
+  with a single disk read, for sequential reads.
+
+  The read ahead stops at the end of the cache groups, at a dirty page, or
+  at a page which is already cached.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The first page to load.
+
+  @retval EFI_SUCCESS           - The pages are loaded, or the page is already cached.
+  @return Others                - An error occurred when reading the pages.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadDataCache (
+  IN FAT_VOLUME         *Volume,
+  IN UINTN              PageNo
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  UINTN       PageCount;
+  UINTN       Index;
+  UINTN       ReadSize;
+  UINTN       PageSize;
+  UINT64      EntryPos;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+  PageSize      = (UINTN)1 << PageAlignment;
+  GroupNo       = PageNo & DiskCache->GroupMask;
+  CacheTag      = &DiskCache->CacheTag[GroupNo];
+  EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  if ((CacheTag->RealSize > 0 && CacheTag->PageNo == PageNo) || EntryPos >= DiskCache->LimitAddress) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Write dirty cache page back to disk
+  //
+  if (CacheTag->RealSize > 0 && CacheTag->Dirty) {
+    Status = FatExchangeCachePage (Volume, CacheData, WriteDisk, CacheTag, NULL);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  for (PageCount = 1; PageCount < DiskCache->ReadAheadPages; PageCount++) {
+    if (GroupNo + PageCount > DiskCache->GroupMask) {
+      break;
+    }
+
+    if (CacheTag[PageCount].RealSize > 0 &&
+        (CacheTag[PageCount].Dirty || CacheTag[PageCount].PageNo == PageNo + PageCount)) {
+      break;
+    }
+  }
+
+  ReadSize = PageCount << PageAlignment;
+  if (DiskCache->LimitAddress - EntryPos < ReadSize) {
+    ReadSize  = (UINTN) (DiskCache->LimitAddress - EntryPos);
+    PageCount = (ReadSize + PageSize - 1) >> PageAlignment;
+  }
+
+  Status = FatDiskIo (
+             Volume,
+             ReadDisk,
+             EntryPos,
+             ReadSize,
+             DiskCache->CacheBase + (GroupNo << PageAlignment),
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    for (Index = 0; Index < PageCount; Index++) {
+      CacheTag[Index].RealSize = 0;
+    }
+    return Status;
+  }
+
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag[Index].PageNo   = PageNo + Index;
+    CacheTag[Index].Dirty    = FALSE;
+    CacheTag[Index].RealSize = MIN (PageSize, ReadSize - (Index << PageAlignment));
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Read Length bytes from the position of Offset into Buffer, or
@@ -273,7 +367,9 @@ FatAccessUnalignedCachePage (
   2. Access of Data cache (CACHE_DATA):
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
      The UnderRun data and OverRun data will be accessed by the Data cache,
-     but the Aligned data will be accessed with disk directly.
+     but the Aligned data will be accessed with disk directly. When reading, the
+     leading aligned pages which are cached, e.g. by read ahead, are copied from
+     the cache instead.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -308,9 +404,12 @@ FatAccessCache (
   UINTN       PageNo;
   UINTN       AlignedPageCount;
   UINTN       OverRunPageNo;
+  UINTN       GroupNo;
   DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
   UINT64      EntryPos;
   UINT8       PageAlignment;
+  BOOLEAN     Sequential;
 
   ASSERT (Volume->CacheBuffer != NULL);
 
@@ -322,12 +421,29 @@ FatAccessCache (
   PageNo        = (UINTN) RShiftU64 (EntryPos, PageAlignment);
   UnderRun      = ((UINTN) EntryPos) & (PageSize - 1);
 
+  //
+  // A data read which starts in or right after the last page of the previous
+  // read is sequential, its unaligned pages are loaded with read ahead.
+  //
+  Sequential = FALSE;
+  if (CacheDataType == CacheData && IoMode == ReadDisk && BufferSize > 0) {
+    Sequential = (BOOLEAN) (PageNo == DiskCache->LastPageNo || PageNo == DiskCache->LastPageNo + 1);
+    DiskCache->LastPageNo = (UINTN) RShiftU64 (EntryPos + BufferSize - 1, PageAlignment);
+  }
+
   if (UnderRun > 0) {
     Length = PageSize - UnderRun;
     if (Length > BufferSize) {
       Length = BufferSize;
     }
 
+    if (Sequential) {
+      Status = FatReadAheadDataCache (Volume, PageNo);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
     Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, PageNo, UnderRun, Length, Buffer);
     if (EFI_ERROR (Status)) {
       return Status;
@@ -341,6 +457,25 @@ FatAccessCache (
   AlignedPageCount  = BufferSize >> PageAlignment;
   OverRunPageNo     = PageNo + AlignedPageCount;
   //
+  // Read the leading aligned pages which are cached from the cache. They
+  // are typically the pages read ahead by the previous sequential read.
+  //
+  if (CacheDataType == CacheData && IoMode == ReadDisk) {
+    while (AlignedPageCount > 0) {
+      GroupNo  = PageNo & DiskCache->GroupMask;
+      CacheTag = &DiskCache->CacheTag[GroupNo];
+      if (CacheTag->RealSize != PageSize || CacheTag->PageNo != PageNo) {
+        break;
+      }
+
+      CopyMem (Buffer, DiskCache->CacheBase + (GroupNo << PageAlignment), PageSize);
+      Buffer     += PageSize;
+      BufferSize -= PageSize;
+      PageNo++;
+      AlignedPageCount--;
+    }
+  }
+  //
   // The access of the Aligned data
   //
   if (AlignedPageCount > 0) {
@@ -371,6 +506,13 @@ FatAccessCache (
     //
     // Last read is not a complete page
     //
+    if (Sequential) {
+      Status = FatReadAheadDataCache (Volume, OverRunPageNo);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
     Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, Buffer);
   }
 
@@ -431,10 +573,48 @@ FatVolumeFlushCache (
   return Status;
 }
 
+/**
+
+  Compute the number of cache groups needed to hold Size bytes in pages of
+  1 << PageAlignment bytes, as a power of two within [MinCount, MaxCount].
+
+  @param  Size                  - The number of bytes to cache.
+  @param  PageAlignment         - The page alignment of the cache.
+  @param  MinCount              - The minimum group count.
+  @param  MaxCount              - The maximum group count.
+
+  @return The group count.
+
+**/
+STATIC
+UINTN
+FatComputeCacheGroupCount (
+  IN UINT64             Size,
+  IN UINT8              PageAlignment,
+  IN UINTN              MinCount,
+  IN UINTN              MaxCount
+  )
+{
+  UINT64  Pages;
+  UINTN   GroupCount;
+
+  Pages      = RShiftU64 (Size + ((UINTN)1 << PageAlignment) - 1, PageAlignment);
+  GroupCount = MinCount;
+  while (GroupCount < Pages && GroupCount < MaxCount) {
+    GroupCount <<= 1;
+  }
+
+  return GroupCount;
+}
+
 /**
 
   Initialize the disk cache according to Volume's FatType.
 
+  The fat cache is sized to hold the whole fat if possible. The data cache is
+  sized by PcdFatDataCacheSize, without exceeding the size of the volume, and
+  shrunk when the memory can not be allocated.
+
   @param  Volume                - FAT file system volume.
 
   @retval EFI_SUCCESS           - The disk cache is successfully initialized.
@@ -448,8 +628,10 @@ FatInitializeDiskCache (
 {
   DISK_CACHE  *DiskCache;
   UINTN       FatCacheGroupCount;
+  UINTN       DataCacheGroupCount;
   UINTN       DataCacheSize;
   UINTN       FatCacheSize;
+  UINTN       TagSize;
   UINT8       *CacheBuffer;
 
   DiskCache = Volume->DiskCache;
@@ -457,33 +639,76 @@ FatInitializeDiskCache (
   // Configure the parameters of disk cache
   //
   if (Volume->FatType == Fat12) {
-    FatCacheGroupCount                  = FAT_FATCACHE_GROUP_MIN_COUNT;
     DiskCache[CacheFat].PageAlignment  = FAT_FATCACHE_PAGE_MIN_ALIGNMENT;
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MIN_ALIGNMENT;
   } else {
-    FatCacheGroupCount                  = FAT_FATCACHE_GROUP_MAX_COUNT;
     DiskCache[CacheFat].PageAlignment  = FAT_FATCACHE_PAGE_MAX_ALIGNMENT;
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
   }
 
-  DiskCache[CacheData].GroupMask     = FAT_DATACACHE_GROUP_COUNT - 1;
-  DiskCache[CacheData].BaseAddress   = Volume->RootPos;
-  DiskCache[CacheData].LimitAddress  = Volume->VolumeSize;
-  DiskCache[CacheFat].GroupMask      = FatCacheGroupCount - 1;
-  DiskCache[CacheFat].BaseAddress    = Volume->FatPos;
-  DiskCache[CacheFat].LimitAddress   = Volume->FatPos + Volume->FatSize;
-  FatCacheSize                        = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                       = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
   //
-  // Allocate the Fat Cache buffer
+  // The data cache may not exceed PcdFatDataCacheSize, rounded down to a
+  // power of two pages
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
-  if (CacheBuffer == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+  DataCacheGroupCount = PcdGet32 (PcdFatDataCacheSize) >> DiskCache[CacheData].PageAlignment;
+  if (DataCacheGroupCount != 0) {
+    DataCacheGroupCount = GetPowerOfTwo32 ((UINT32) DataCacheGroupCount);
   }
+  DataCacheGroupCount = MIN (MAX (DataCacheGroupCount, FAT_DATACACHE_GROUP_MIN_COUNT), FAT_DATACACHE_GROUP_MAX_COUNT);
+
+  FatCacheGroupCount  = FatComputeCacheGroupCount (
+                          Volume->FatSize,
+                          DiskCache[CacheFat].PageAlignment,
+                          FAT_FATCACHE_GROUP_MIN_COUNT,
+                          FAT_FATCACHE_GROUP_MAX_COUNT
+                          );
+  DataCacheGroupCount = FatComputeCacheGroupCount (
+                          Volume->VolumeSize - Volume->RootPos,
+                          DiskCache[CacheData].PageAlignment,
+                          FAT_DATACACHE_GROUP_MIN_COUNT,
+                          DataCacheGroupCount
+                          );
+
+  FatCacheSize = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
+  //
+  // Allocate the cache buffer and cache tags, use a smaller data cache if
+  // the memory is not available
+  //
+  for (;;) {
+    DataCacheSize = DataCacheGroupCount << DiskCache[CacheData].PageAlignment;
+    TagSize       = (FatCacheGroupCount + DataCacheGroupCount) * sizeof (CACHE_TAG);
+    CacheBuffer   = AllocateZeroPool (FatCacheSize + DataCacheSize + TagSize);
+    if (CacheBuffer != NULL) {
+      break;
+    }
+
+    if (DataCacheGroupCount <= FAT_DATACACHE_GROUP_MIN_COUNT) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    DataCacheGroupCount >>= 1;
+  }
+
+  DiskCache[CacheData].GroupMask      = DataCacheGroupCount - 1;
+  DiskCache[CacheData].BaseAddress    = Volume->RootPos;
+  DiskCache[CacheData].LimitAddress   = Volume->VolumeSize;
+  DiskCache[CacheData].ReadAheadPages = MIN (DataCacheGroupCount / 4, FAT_DATACACHE_READ_AHEAD_MAX_PAGES);
+  DiskCache[CacheData].LastPageNo     = MAX_UINTN - 1;
+  DiskCache[CacheFat].GroupMask       = FatCacheGroupCount - 1;
+  DiskCache[CacheFat].BaseAddress     = Volume->FatPos;
+  DiskCache[CacheFat].LimitAddress    = Volume->FatPos + Volume->FatSize;
 
   Volume->CacheBuffer             = CacheBuffer;
   DiskCache[CacheFat].CacheBase  = CacheBuffer;
   DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+  DiskCache[CacheFat].CacheTag   = (CACHE_TAG *) (CacheBuffer + FatCacheSize + DataCacheSize);
+  DiskCache[CacheData].CacheTag  = DiskCache[CacheFat].CacheTag + FatCacheGroupCount;
+
+  DEBUG ((
+    EFI_D_INIT,
+    "FatInitializeDiskCache: %d fat cache pages, %d data cache pages of 0x%x bytes\n",
+    FatCacheGroupCount,
+    DataCacheGroupCount,
+    (UINTN)1 << DiskCache[CacheData].PageAlignment
+    ));
   return EFI_SUCCESS;
 }
@@ -75,15 +75,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Minimum fat page size is 8K, maximum fat page alignment is 32K
 // Minimum data page size is 8K, maximum fat page alignment is 64K
+// The data cache group count is derived from PcdFatDataCacheSize and the
+// volume size, the fat cache group count from the fat size
 //
 #define FAT_FATCACHE_PAGE_MIN_ALIGNMENT   13
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
+#define FAT_DATACACHE_GROUP_MIN_COUNT     16
+#define FAT_DATACACHE_GROUP_MAX_COUNT     1024
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
+//
+// Maximum number of data cache pages read ahead for sequential reads
+//
+#define FAT_DATACACHE_READ_AHEAD_MAX_PAGES  16
+
 //
 // Used in 8.3 generation algorithm
 //
@@ -104,8 +112,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LC_ISO_639_2_ENTRY_SIZE 3
 #define MAX_LANG_CODE_SIZE      100
 
-#define FAT_MAX_DIR_CACHE_COUNT 8
+#define FAT_MAX_DIR_CACHE_COUNT 64
 #define FAT_MAX_DIRENTRY_COUNT  0xFFFF
+
+//
+// Initial and maximum number of extents in the extent map of an OFile
+//
+#define FAT_EXTENT_MAP_INIT_COUNT 16
+#define FAT_MAX_EXTENT_COUNT      0x10000
+
+//
+// The free cluster bitmap is loaded from the FAT in chunks of 4096 clusters,
+// and is not used on volumes that would need a bitmap larger than 4MB
+//
+#define FAT_FREE_MAP_CHUNK_ALIGNMENT  12
+#define FAT_MAX_FREE_MAP_SIZE         0x400000
 typedef CHAR8                   LC_ISO_639_2;
 
 //
@@ -156,14 +177,17 @@ typedef struct {
   BOOLEAN   Dirty;
   UINT8     PageAlignment;
   UINTN     GroupMask;
-  CACHE_TAG CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  CACHE_TAG *CacheTag;
+  UINTN     ReadAheadPages;   // Pages to read at once for sequential reads
+  UINTN     LastPageNo;       // Last page accessed by the previous read
 } DISK_CACHE;
 
 //
-// Hash table size
+// Hash table size, the hash tables of a directory double when the directory
+// has more entries than buckets
 //
-#define HASH_TABLE_SIZE  0x400
-#define HASH_TABLE_MASK  (HASH_TABLE_SIZE - 1)
+#define HASH_TABLE_MIN_SIZE  0x40
+#define HASH_TABLE_MAX_SIZE  0x10000
 
 //
 // The directory entry for opened directory
@@ -196,8 +220,11 @@ struct _FAT_ODIR {
   BOOLEAN             EndOfDir;               // Indicate whether we have reached the end of the directory
   LIST_ENTRY          DirCacheLink;           // Linked in Volume->DirCacheList when discarded
   UINTN               DirCacheTag;            // The identification of the directory when in directory cache
-  FAT_DIRENT          *LongNameHashTable[HASH_TABLE_SIZE];
-  FAT_DIRENT          *ShortNameHashTable[HASH_TABLE_SIZE];
+  UINTN               DirCacheSize;           // The memory used by the directory entries and hash tables
+  UINTN               DirEntCount;            // The count of directory entries in the hash tables
+  UINTN               HashTableSize;          // The bucket count of the hash tables, a power of 2
+  FAT_DIRENT          **LongNameHashTable;
+  FAT_DIRENT          **ShortNameHashTable;
 };
 
 typedef struct {
@@ -229,6 +256,15 @@ typedef struct {
   LIST_ENTRY          Link;
 } FAT_SUBTASK;
 
+//
+// FAT_EXTENT - A run of physically contiguous clusters in a file
+//
+typedef struct {
+  UINTN               FileCluster;            // Index of the first cluster within the file
+  UINTN               Cluster;                // The first cluster on the disk
+  UINTN               Count;                  // Number of clusters in the run
+} FAT_EXTENT;
+
 //
 // FAT_OFILE - Each opened file
 //
@@ -272,6 +308,14 @@ struct _FAT_OFILE {
   UINT64              PosDisk;  // on the disk
   UINTN               PosRem;   // remaining in this disk run
   //
+  // The extent map of the leading part of the cluster chain,
+  // built lazily as the chain is walked
+  //
+  FAT_EXTENT          *Extents;
+  UINTN               ExtentCount;
+  UINTN               ExtentMax;
+  UINTN               MappedClusters;
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE           *Parent;
@@ -335,6 +379,8 @@ struct _FAT_VOLUME {
   FAT_INFO_SECTOR                 FatInfoSector;  // Free cluster info
   UINTN                           FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                         FreeInfoValid;  // If free cluster info is valid
+  UINT8                           *FreeMap;       // Bitmap of free clusters, NULL if not used
+  BOOLEAN                         *FreeMapLoaded; // If the chunk of the bitmap is loaded from the fat
   //
   // Unpacked Fat BPB info
   //
@@ -369,6 +415,7 @@ struct _FAT_VOLUME {
   //
   LIST_ENTRY                      DirCacheList;
   UINTN                           DirCacheCount;
+  UINTN                           DirCacheSize;
 
   //
   // Disk Cache for this volume
@@ -946,6 +993,31 @@ FatOFilePosition (
   IN UINTN                PosLimit
   );
 
+/**
+
+  Allocate the free cluster bitmap of the volume. The bitmap is filled from
+  the FAT lazily, so this does not access the disk.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeFreeMap (
+  IN FAT_VOLUME           *Volume
+  );
+
+/**
+
+  Free the extent map of the open file.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatFreeExtentMap (
+  IN FAT_OFILE            *OFile
+  );
+
 /**
 
   Update the free cluster info of FatInfoSector of the volume.
@@ -1759,6 +1831,23 @@ FatSetVolumeEntry (
 //
 // Hash.c
 //
+/**
+
+  Resize the hash tables of the directory and rehash its directory entries.
+
+  @param  ODir                  - The directory whose hash tables are resized.
+  @param  HashTableSize         - The new bucket count, a power of 2.
+
+  @retval EFI_SUCCESS           - The hash tables are resized.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory, the hash tables are unchanged.
+
+**/
+EFI_STATUS
+FatResizeHashTable (
+  IN FAT_ODIR           *ODir,
+  IN UINTN              HashTableSize
+  );
+
 /**
 
   Search the long name hash table for the directory entry.
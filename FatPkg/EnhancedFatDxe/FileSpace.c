@@ -121,6 +121,114 @@ FatGetFatEntry (
   return Accum;
 }
 
+/**
+
+  Fill one chunk of the free cluster bitmap of the volume from the FAT.
+
+  @param  Volume                - FAT file system volume.
+  @param  Chunk                 - The index of the chunk.
+
+**/
+STATIC
+VOID
+FatLoadFreeMapChunk (
+  IN FAT_VOLUME       *Volume,
+  IN UINTN            Chunk
+  )
+{
+  UINTN   Index;
+  UINTN   LastIndex;
+
+  Index     = Chunk << FAT_FREE_MAP_CHUNK_ALIGNMENT;
+  LastIndex = Index + (1 << FAT_FREE_MAP_CHUNK_ALIGNMENT) - 1;
+  if (Index < FAT_MIN_CLUSTER) {
+    Index = FAT_MIN_CLUSTER;
+  }
+  if (LastIndex > Volume->MaxCluster + 1) {
+    LastIndex = Volume->MaxCluster + 1;
+  }
+
+  for (; Index <= LastIndex; Index++) {
+    if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+      Volume->FreeMap[Index / 8] |= (UINT8) (1 << (Index % 8));
+    } else {
+      Volume->FreeMap[Index / 8] &= (UINT8) ~(1 << (Index % 8));
+    }
+  }
+
+  if (!Volume->DiskError) {
+    Volume->FreeMapLoaded[Chunk] = TRUE;
+  }
+}
+
+/**
+
+  Check whether a cluster of the volume is free, using the free cluster
+  bitmap when it is available.
+
+  @param  Volume                - FAT file system volume.
+  @param  Cluster               - The cluster to check.
+
+  @retval TRUE                  - The cluster is free.
+  @retval FALSE                 - The cluster is in use.
+
+**/
+STATIC
+BOOLEAN
+FatIsClusterFree (
+  IN FAT_VOLUME       *Volume,
+  IN UINTN            Cluster
+  )
+{
+  UINTN   Chunk;
+
+  if (Volume->FreeMap == NULL) {
+    return (BOOLEAN) (FatGetFatEntry (Volume, Cluster) == FAT_CLUSTER_FREE);
+  }
+
+  if (Cluster < FAT_MIN_CLUSTER || Cluster > Volume->MaxCluster + 1) {
+    return FALSE;
+  }
+
+  Chunk = Cluster >> FAT_FREE_MAP_CHUNK_ALIGNMENT;
+  if (!Volume->FreeMapLoaded[Chunk]) {
+    FatLoadFreeMapChunk (Volume, Chunk);
+  }
+
+  return (BOOLEAN) ((Volume->FreeMap[Cluster / 8] & (1 << (Cluster % 8))) != 0);
+}
+
+/**
+
+  Check whether a cluster of the volume is free without reading the FAT.
+  A cluster whose chunk of the free cluster bitmap is not loaded yet is
+  reported as in use.
+
+  @param  Volume                - FAT file system volume.
+  @param  Cluster               - The cluster to check.
+
+  @retval TRUE                  - The cluster is free.
+  @retval FALSE                 - The cluster is in use, or its chunk is not loaded.
+
+**/
+STATIC
+BOOLEAN
+FatIsLoadedClusterFree (
+  IN FAT_VOLUME       *Volume,
+  IN UINTN            Cluster
+  )
+{
+  if (Cluster < FAT_MIN_CLUSTER || Cluster > Volume->MaxCluster + 1) {
+    return FALSE;
+  }
+
+  if (!Volume->FreeMapLoaded[Cluster >> FAT_FREE_MAP_CHUNK_ALIGNMENT]) {
+    return FALSE;
+  }
+
+  return (BOOLEAN) ((Volume->FreeMap[Cluster / 8] & (1 << (Cluster % 8))) != 0);
+}
+
 /**
 
   Set the FAT entry value of the volume, which is identified with the Index.
@@ -166,6 +274,19 @@ FatSetFatEntry (
     }
   }
   //
+  // Keep the free cluster bitmap in sync. A corrupted cluster chain may
+  // reference clusters beyond the end of the bitmap.
+  //
+  if (Volume->FreeMap != NULL &&
+      Index <= Volume->MaxCluster + 1 &&
+      Volume->FreeMapLoaded[Index >> FAT_FREE_MAP_CHUNK_ALIGNMENT]) {
+    if (Value == FAT_CLUSTER_FREE) {
+      Volume->FreeMap[Index / 8] |= (UINT8) (1 << (Index % 8));
+    } else {
+      Volume->FreeMap[Index / 8] &= (UINT8) ~(1 << (Index % 8));
+    }
+  }
+  //
   // Make sure the entry is in memory
   //
   Pos = FatLoadFatEntry (Volume, Index);
@@ -295,8 +416,7 @@ FatAllocateCluster (
       }
     }
 
-    Cluster = FatGetFatEntry (Volume, Volume->FatInfoSector.FreeInfo.NextCluster);
-    if (Cluster == FAT_CLUSTER_FREE) {
+    if (FatIsClusterFree (Volume, Volume->FatInfoSector.FreeInfo.NextCluster)) {
       break;
     }
     //
@@ -310,6 +430,149 @@ FatAllocateCluster (
   return Cluster;
 }
 
+/**
+
+  Count the free clusters following Cluster, including Cluster itself.
+
+  @param  Volume                - FAT file system volume.
+  @param  Cluster               - The first cluster of the free run.
+  @param  Limit                 - The maximum number of clusters to count.
+  @param  LoadedOnly            - Stop at the first chunk of the free cluster
+                                  bitmap which is not loaded, instead of loading it.
+
+  @return The number of consecutive free clusters, at most Limit.
+
+**/
+STATIC
+UINTN
+FatFreeRunLength (
+  IN FAT_VOLUME   *Volume,
+  IN UINTN        Cluster,
+  IN UINTN        Limit,
+  IN BOOLEAN      LoadedOnly
+  )
+{
+  UINTN Length;
+
+  Length = 0;
+  if (LoadedOnly) {
+    while (Length < Limit && FatIsLoadedClusterFree (Volume, Cluster + Length)) {
+      Length++;
+    }
+  } else {
+    while (Length < Limit && FatIsClusterFree (Volume, Cluster + Length)) {
+      Length++;
+    }
+  }
+
+  return Length;
+}
+
+/**
+
+  Allocate a run of free clusters to grow a file.
+
+  The clusters directly following the last cluster of the file are used if
+  they are free, so that the file stays contiguous. Otherwise the smallest
+  free run which can hold all the wanted clusters is used. Only the chunks
+  of the free cluster bitmap which are already loaded are searched for it,
+  so that an allocation doesn't read the whole FAT. If there is no such
+  run, the first free run at or after the next free cluster hint is used,
+  as for single cluster allocations.
+
+  @param  Volume                - FAT file system volume.
+  @param  LastCluster           - The last cluster of the file, or FAT_CLUSTER_FREE
+                                  if the file has no cluster yet.
+  @param  Wanted                - The number of clusters wanted.
+  @param  Count                 - The number of clusters in the allocated run.
+
+  @return The first cluster of the run, FAT_CLUSTER_LAST if there is no free cluster.
+
+**/
+STATIC
+UINTN
+FatAllocateClusterRun (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINTN       LastCluster,
+  IN  UINTN       Wanted,
+  OUT UINTN       *Count
+  )
+{
+  UINTN   Index;
+  UINTN   Length;
+  UINTN   BestCluster;
+  UINTN   BestLength;
+
+  *Count = 1;
+  if (Volume->FreeMap == NULL || Volume->DiskError) {
+    return FatAllocateCluster (Volume);
+  }
+
+  //
+  // Grow the file in place if possible
+  //
+  if (LastCluster >= FAT_MIN_CLUSTER && FatIsClusterFree (Volume, LastCluster + 1)) {
+    BestCluster = LastCluster + 1;
+    BestLength  = FatFreeRunLength (Volume, BestCluster, Wanted, FALSE);
+  } else {
+    //
+    // Best fit search over the free runs in the loaded chunks of the bitmap
+    //
+    BestCluster = 0;
+    BestLength  = 0;
+    Index       = FAT_MIN_CLUSTER;
+    while (Index <= Volume->MaxCluster + 1 && BestLength != Wanted) {
+      if (!Volume->FreeMapLoaded[Index >> FAT_FREE_MAP_CHUNK_ALIGNMENT]) {
+        Index = ((Index >> FAT_FREE_MAP_CHUNK_ALIGNMENT) + 1) << FAT_FREE_MAP_CHUNK_ALIGNMENT;
+        continue;
+      }
+
+      if ((Index % 8) == 0 && Volume->FreeMap[Index / 8] == 0) {
+        Index += 8;
+        continue;
+      }
+
+      if (!FatIsLoadedClusterFree (Volume, Index)) {
+        Index++;
+        continue;
+      }
+
+      Length = FatFreeRunLength (Volume, Index, MAX_UINTN, TRUE);
+      if (Length >= Wanted && (BestLength == 0 || Length < BestLength)) {
+        BestCluster = Index;
+        BestLength  = Length;
+      }
+
+      Index += Length;
+    }
+
+    if (BestLength == 0) {
+      //
+      // First free run from the next free cluster hint. FatAllocateCluster
+      // loads the chunks of the bitmap it walks through.
+      //
+      BestCluster = FatAllocateCluster (Volume);
+      if (FAT_END_OF_FAT_CHAIN (BestCluster)) {
+        return (UINTN) FAT_CLUSTER_LAST;
+      }
+
+      BestLength = FatFreeRunLength (Volume, BestCluster, Wanted, FALSE);
+      Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) (BestCluster + BestLength);
+    }
+
+    if (BestLength > Wanted) {
+      BestLength = Wanted;
+    }
+  }
+
+  if (BestCluster == Volume->FatInfoSector.FreeInfo.NextCluster) {
+    Volume->FatInfoSector.FreeInfo.NextCluster += (UINT32) BestLength;
+  }
+
+  *Count = BestLength;
+  return BestCluster;
+}
+
 /**
 
   Count the number of clusters given a size.
@@ -337,6 +600,194 @@ FatSizeToClusters (
   return Clusters;
 }
 
+/**
+
+  Drop the extents beyond the first Clusters clusters of the file from the
+  extent map of the open file.
+
+  @param  OFile                 - The open file.
+  @param  Clusters              - The number of clusters of the file to keep mapped.
+
+**/
+STATIC
+VOID
+FatTruncateExtentMap (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                Clusters
+  )
+{
+  FAT_EXTENT  *Extent;
+
+  while (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->FileCluster < Clusters) {
+      if (Extent->FileCluster + Extent->Count > Clusters) {
+        Extent->Count = Clusters - Extent->FileCluster;
+      }
+      break;
+    }
+
+    OFile->ExtentCount--;
+  }
+
+  if (OFile->MappedClusters > Clusters) {
+    OFile->MappedClusters = Clusters;
+  }
+}
+
+/**
+
+  Append the next cluster of the file's cluster chain to the extent map of
+  the open file.
+
+  @param  OFile                 - The open file.
+  @param  Cluster               - The cluster following the last mapped cluster.
+
+  @retval EFI_SUCCESS           - The cluster is added to the extent map.
+  @retval EFI_OUT_OF_RESOURCES  - The extent map can not hold more extents.
+
+**/
+STATIC
+EFI_STATUS
+FatAppendExtent (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                Cluster
+  )
+{
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *NewExtents;
+  UINTN       NewMax;
+
+  if (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->Cluster + Extent->Count == Cluster) {
+      Extent->Count++;
+      OFile->MappedClusters++;
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (OFile->ExtentCount == OFile->ExtentMax) {
+    if (OFile->ExtentMax >= FAT_MAX_EXTENT_COUNT) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    NewMax     = (OFile->ExtentMax == 0) ? FAT_EXTENT_MAP_INIT_COUNT : OFile->ExtentMax * 2;
+    NewExtents = ReallocatePool (
+                   OFile->ExtentMax * sizeof (FAT_EXTENT),
+                   NewMax * sizeof (FAT_EXTENT),
+                   OFile->Extents
+                   );
+    if (NewExtents == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    OFile->Extents   = NewExtents;
+    OFile->ExtentMax = NewMax;
+  }
+
+  Extent              = &OFile->Extents[OFile->ExtentCount];
+  Extent->FileCluster = OFile->MappedClusters;
+  Extent->Cluster     = Cluster;
+  Extent->Count       = 1;
+  OFile->ExtentCount++;
+  OFile->MappedClusters++;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Walk the cluster chain of the open file past the last mapped cluster until
+  the extent map covers the first Clusters clusters of the file.
+
+  @param  OFile                 - The open file.
+  @param  Clusters              - The number of clusters of the file to map.
+
+  @retval EFI_SUCCESS           - The extent map covers the requested clusters, or
+                                  the cluster chain ends before them.
+  @retval EFI_OUT_OF_RESOURCES  - The extent map can not hold more extents.
+
+**/
+STATIC
+EFI_STATUS
+FatExtendExtentMap (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                Clusters
+  )
+{
+  FAT_VOLUME  *Volume;
+  FAT_EXTENT  *Extent;
+  UINTN       Cluster;
+  EFI_STATUS  Status;
+
+  Volume = OFile->Volume;
+
+  //
+  // The map is stale if the file has been truncated to zero and grown again
+  //
+  if (OFile->ExtentCount != 0 && OFile->Extents[0].Cluster != OFile->FileCluster) {
+    FatTruncateExtentMap (OFile, 0);
+  }
+
+  while (OFile->MappedClusters < Clusters) {
+    if (OFile->ExtentCount == 0) {
+      Cluster = OFile->FileCluster;
+    } else {
+      Extent  = &OFile->Extents[OFile->ExtentCount - 1];
+      Cluster = FatGetFatEntry (Volume, Extent->Cluster + Extent->Count - 1);
+    }
+
+    if (Cluster < FAT_MIN_CLUSTER || Cluster > Volume->MaxCluster + 1) {
+      break;
+    }
+
+    Status = FatAppendExtent (OFile, Cluster);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Find the extent which contains the cluster of the file with the given index.
+
+  @param  OFile                 - The open file.
+  @param  ClusterIndex          - The index of the cluster within the file, which
+                                  must be covered by the extent map.
+
+  @return The extent containing the cluster.
+
+**/
+STATIC
+FAT_EXTENT *
+FatLookupExtent (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                ClusterIndex
+  )
+{
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Mid;
+
+  ASSERT (ClusterIndex < OFile->MappedClusters);
+
+  Low  = 0;
+  High = OFile->ExtentCount - 1;
+  while (Low < High) {
+    Mid = (Low + High + 1) / 2;
+    if (OFile->Extents[Mid].FileCluster <= ClusterIndex) {
+      Low = Mid;
+    } else {
+      High = Mid - 1;
+    }
+  }
+
+  return &OFile->Extents[Low];
+}
+
 /**
 
   Shrink the end of the open file base on the file size.
@@ -362,6 +813,7 @@ FatShrinkEof (
   ASSERT_VOLUME_LOCKED (Volume);
 
   NewSize = FatSizeToClusters (Volume, OFile->FileSize);
+  FatTruncateExtentMap (OFile, NewSize);
 
   //
   // Find the address of the last cluster
@@ -436,6 +888,7 @@ FatGrowEof (
   UINTN       LastCluster;
   UINTN       NewCluster;
   UINTN       ClusterCount;
+  UINTN       RunLength;
 
   //
   // For FAT file system, the max file is 4GB.
@@ -492,7 +945,7 @@ FatGrowEof (
     LastCluster = OFile->FileLastCluster;
 
     while (CurSize < NewSize) {
-      NewCluster = FatAllocateCluster (Volume);
+      NewCluster = FatAllocateClusterRun (Volume, LastCluster, NewSize - CurSize, &RunLength);
       if (FAT_END_OF_FAT_CHAIN (NewCluster)) {
         if (LastCluster != FAT_CLUSTER_FREE) {
           FatSetFatEntry (Volume, LastCluster, (UINTN) FAT_CLUSTER_LAST);
@@ -503,28 +956,33 @@ FatGrowEof (
         goto Done;
       }
 
-      if (NewCluster < FAT_MIN_CLUSTER || NewCluster > Volume->MaxCluster + 1) {
+      if (NewCluster < FAT_MIN_CLUSTER || NewCluster + RunLength - 1 > Volume->MaxCluster + 1) {
         Status = EFI_VOLUME_CORRUPTED;
         goto Done;
       }
 
-      if (LastCluster != 0) {
-        FatSetFatEntry (Volume, LastCluster, NewCluster);
-      } else {
-        OFile->FileCluster        = NewCluster;
-        OFile->FileCurrentCluster = NewCluster;
-      }
+      //
+      // Link the run of clusters to the end of the file
+      //
+      for (; RunLength > 0; RunLength--, NewCluster++) {
+        if (LastCluster != 0) {
+          FatSetFatEntry (Volume, LastCluster, NewCluster);
+        } else {
+          OFile->FileCluster        = NewCluster;
+          OFile->FileCurrentCluster = NewCluster;
+        }
 
-      LastCluster = NewCluster;
-      CurSize += 1;
+        LastCluster = NewCluster;
+        CurSize += 1;
+      }
 
       //
       // Terminate the cluster list
       //
-      // Note that we must do this EVERY time we allocate a cluster, because
-      // FatAllocateCluster scans the FAT looking for a free cluster and
-      // "LastCluster" is no longer free!  Usually, FatAllocateCluster will
-      // start looking with the cluster after "LastCluster"; however, when
+      // Note that we must do this EVERY time we allocate a run of clusters,
+      // because FatAllocateClusterRun scans the FAT looking for free clusters
+      // and "LastCluster" is no longer free!  Usually, FatAllocateClusterRun
+      // will start looking with the cluster after "LastCluster"; however, when
       // there is only one free cluster left, it will find "LastCluster"
       // a second time.  There are other, less predictable scenarios
       // where this could happen, as well.
@@ -568,6 +1026,11 @@ FatOFilePosition (
   UINTN       Cluster;
   UINTN       StartPos;
   UINTN       Run;
+  UINTN       ClusterIndex;
+  UINTN       Clusters;
+  UINTN       RunCluster;
+  FAT_EXTENT  *Extent;
+  EFI_STATUS  Status;
 
   Volume      = OFile->Volume;
   ClusterSize = Volume->ClusterSize;
@@ -583,35 +1046,72 @@ FatOFilePosition (
     Run             = OFile->FileSize - Position;
   } else {
     //
-    // Run the file's cluster chain to find the current position
-    // If possible, run from the current cluster rather than
-    // start from beginning
-    // Assumption: OFile->Position is always consistent with
-    // OFile->FileCurrentCluster.
-    // OFile->Position is not modified outside this function;
-    // OFile->FileCurrentCluster is modified outside this function
-    // to be the same as OFile->FileCluster
-    // when OFile->FileCluster is updated, so make a check of this
-    // and invalidate the original OFile->Position in this case
+    // Make sure the extent map covers the clusters from the beginning of
+    // the file up to the end of the requested range, then look up the
+    // position in it. Only the part of the chain that has never been
+    // walked before is read from the FAT.
     //
-    Cluster     = OFile->FileCurrentCluster;
-    StartPos    = OFile->Position;
-    if (Position < StartPos || OFile->FileCluster == Cluster) {
-      StartPos  = 0;
-      Cluster   = OFile->FileCluster;
-    }
+    ClusterIndex = Position >> Volume->ClusterAlignment;
+    Clusters     = FatSizeToClusters (Volume, (Position & (ClusterSize - 1)) + MIN (PosLimit, MAX_UINTN - ClusterSize));
+    Status       = FatExtendExtentMap (OFile, ClusterIndex + MAX (Clusters, 1));
 
-    while (StartPos + ClusterSize <= Position) {
-      StartPos += ClusterSize;
-      if (Cluster == FAT_CLUSTER_FREE || (Cluster >= FAT_CLUSTER_SPECIAL)) {
-        DEBUG ((EFI_D_INIT | EFI_D_ERROR, "FatOFilePosition:"" cluster chain corrupt\n"));
-        return EFI_VOLUME_CORRUPTED;
+    if (ClusterIndex < OFile->MappedClusters) {
+      Extent    = FatLookupExtent (OFile, ClusterIndex);
+      Cluster   = Extent->Cluster + ClusterIndex - Extent->FileCluster;
+      StartPos  = ClusterIndex << Volume->ClusterAlignment;
+
+      //
+      // All the clusters up to the end of the extent are consecutive
+      //
+      Run = ((Extent->FileCluster + Extent->Count - ClusterIndex) << Volume->ClusterAlignment) -
+            (Position - StartPos);
+    } else if (Status == EFI_OUT_OF_RESOURCES) {
+      //
+      // The extent map is full, run the file's cluster chain from the last
+      // mapped cluster, or from the current cluster if it is further.
+      // Assumption: OFile->Position is always consistent with
+      // OFile->FileCurrentCluster, unless OFile->FileCurrentCluster has
+      // been reset to OFile->FileCluster outside this function.
+      //
+      Cluster  = OFile->FileCluster;
+      StartPos = 0;
+      if (OFile->ExtentCount != 0) {
+        Extent   = &OFile->Extents[OFile->ExtentCount - 1];
+        Cluster  = Extent->Cluster + Extent->Count - 1;
+        StartPos = (OFile->MappedClusters - 1) << Volume->ClusterAlignment;
       }
 
-      Cluster = FatGetFatEntry (Volume, Cluster);
-    }
+      if (OFile->FileCurrentCluster != OFile->FileCluster &&
+          OFile->Position > StartPos && OFile->Position <= Position) {
+        Cluster  = OFile->FileCurrentCluster;
+        StartPos = OFile->Position;
+      }
 
-    if (Cluster < FAT_MIN_CLUSTER || Cluster > Volume->MaxCluster + 1) {
+      while (StartPos + ClusterSize <= Position) {
+        StartPos += ClusterSize;
+        if (Cluster == FAT_CLUSTER_FREE || (Cluster >= FAT_CLUSTER_SPECIAL)) {
+          DEBUG ((EFI_D_INIT | EFI_D_ERROR, "FatOFilePosition:"" cluster chain corrupt\n"));
+          return EFI_VOLUME_CORRUPTED;
+        }
+
+        Cluster = FatGetFatEntry (Volume, Cluster);
+      }
+
+      if (Cluster < FAT_MIN_CLUSTER || Cluster > Volume->MaxCluster + 1) {
+        return EFI_VOLUME_CORRUPTED;
+      }
+
+      //
+      // Compute the number of consecutive clusters in the file
+      //
+      Run        = StartPos + ClusterSize - Position;
+      RunCluster = Cluster;
+      while ((FatGetFatEntry (Volume, RunCluster) == RunCluster + 1) && Run < PosLimit) {
+        Run        += ClusterSize;
+        RunCluster += 1;
+      }
+    } else {
+      DEBUG ((EFI_D_INIT | EFI_D_ERROR, "FatOFilePosition:"" cluster chain corrupt\n"));
       return EFI_VOLUME_CORRUPTED;
     }
 
@@ -620,23 +1120,70 @@ FatOFilePosition (
                                 Position - StartPos;
     OFile->FileCurrentCluster = Cluster;
     OFile->Position           = StartPos;
-
-    //
-    // Compute the number of consecutive clusters in the file
-    //
-    Run = StartPos + ClusterSize - Position;
-    if (!FAT_END_OF_FAT_CHAIN (Cluster)) {
-      while ((FatGetFatEntry (Volume, Cluster) == Cluster + 1) && Run < PosLimit) {
-        Run     += ClusterSize;
-        Cluster += 1;
-      }
-    }
   }
 
   OFile->PosRem = Run;
   return EFI_SUCCESS;
 }
 
+/**
+
+  Allocate the free cluster bitmap of the volume. The bitmap is filled from
+  the FAT lazily, so this does not access the disk.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeFreeMap (
+  IN FAT_VOLUME           *Volume
+  )
+{
+  UINTN   MapSize;
+  UINTN   ChunkCount;
+
+  MapSize    = (Volume->MaxCluster + 2) / 8 + 1;
+  ChunkCount = ((Volume->MaxCluster + 1) >> FAT_FREE_MAP_CHUNK_ALIGNMENT) + 1;
+  if (MapSize > FAT_MAX_FREE_MAP_SIZE) {
+    return;
+  }
+
+  Volume->FreeMap       = AllocateZeroPool (MapSize);
+  Volume->FreeMapLoaded = AllocateZeroPool (ChunkCount * sizeof (BOOLEAN));
+  if (Volume->FreeMap == NULL || Volume->FreeMapLoaded == NULL) {
+    if (Volume->FreeMap != NULL) {
+      FreePool (Volume->FreeMap);
+    }
+    if (Volume->FreeMapLoaded != NULL) {
+      FreePool (Volume->FreeMapLoaded);
+    }
+    Volume->FreeMap       = NULL;
+    Volume->FreeMapLoaded = NULL;
+  }
+}
+
+/**
+
+  Free the extent map of the open file.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatFreeExtentMap (
+  IN FAT_OFILE            *OFile
+  )
+{
+  if (OFile->Extents != NULL) {
+    FreePool (OFile->Extents);
+  }
+
+  OFile->Extents        = NULL;
+  OFile->ExtentCount    = 0;
+  OFile->ExtentMax      = 0;
+  OFile->MappedClusters = 0;
+}
+
 /**
 
   Get the size of directory of the open file.
@@ -731,7 +1278,7 @@ FatComputeFreeInfo (
         break;
       }
 
-      if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+      if (FatIsClusterFree (Volume, Index)) {
         Volume->FatInfoSector.FreeInfo.ClusterCount += 1;
         Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) Index;
       }
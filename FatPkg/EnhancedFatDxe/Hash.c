@@ -33,7 +33,7 @@ FatHashLongName (
     );
   FatStrUpr (UpCasedLongFileName);
   gBS->CalculateCrc32 (UpCasedLongFileName, StrSize (UpCasedLongFileName), &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
 }
 
 /**
@@ -53,7 +53,70 @@ FatHashShortName (
 {
   UINT32  HashValue;
   gBS->CalculateCrc32 (ShortNameString, FAT_NAME_LEN, &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
+}
+
+/**
+
+  Resize the hash tables of the directory and rehash its directory entries.
+
+  @param  ODir                  - The directory whose hash tables are resized.
+  @param  HashTableSize         - The new bucket count, a power of 2.
+
+  @retval EFI_SUCCESS           - The hash tables are resized.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory, the hash tables are unchanged.
+
+**/
+EFI_STATUS
+FatResizeHashTable (
+  IN FAT_ODIR       *ODir,
+  IN UINTN          HashTableSize
+  )
+{
+  FAT_DIRENT  **LongNameHashTable;
+  FAT_DIRENT  **ShortNameHashTable;
+  FAT_DIRENT  *DirEnt;
+  UINTN       Index;
+  UINT32      HashTableIndex;
+
+  ASSERT ((HashTableSize & (HashTableSize - 1)) == 0);
+
+  //
+  // The long name table and the short name table share one allocation
+  //
+  LongNameHashTable = AllocateZeroPool (2 * HashTableSize * sizeof (FAT_DIRENT *));
+  if (LongNameHashTable == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ShortNameHashTable = LongNameHashTable + HashTableSize;
+  for (Index = 0; Index < ODir->HashTableSize; Index++) {
+    while (ODir->LongNameHashTable[Index] != NULL) {
+      DirEnt                              = ODir->LongNameHashTable[Index];
+      ODir->LongNameHashTable[Index]      = DirEnt->LongNameForwardLink;
+      HashTableIndex                      = FatHashLongName (DirEnt->FileString) & (HashTableSize - 1);
+      DirEnt->LongNameForwardLink         = LongNameHashTable[HashTableIndex];
+      LongNameHashTable[HashTableIndex]   = DirEnt;
+    }
+
+    while (ODir->ShortNameHashTable[Index] != NULL) {
+      DirEnt                              = ODir->ShortNameHashTable[Index];
+      ODir->ShortNameHashTable[Index]     = DirEnt->ShortNameForwardLink;
+      HashTableIndex                      = FatHashShortName (DirEnt->Entry.FileName) & (HashTableSize - 1);
+      DirEnt->ShortNameForwardLink        = ShortNameHashTable[HashTableIndex];
+      ShortNameHashTable[HashTableIndex]  = DirEnt;
+    }
+  }
+
+  if (ODir->LongNameHashTable != NULL) {
+    FreePool (ODir->LongNameHashTable);
+  }
+
+  ODir->DirCacheSize       = ODir->DirCacheSize + 2 * (HashTableSize - ODir->HashTableSize) * sizeof (FAT_DIRENT *);
+  ODir->HashTableSize      = HashTableSize;
+  ODir->LongNameHashTable  = LongNameHashTable;
+  ODir->ShortNameHashTable = ShortNameHashTable;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -73,7 +136,7 @@ FatLongNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
-  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString)];
+  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString) & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
       ) {
@@ -102,7 +165,7 @@ FatShortNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
-  for (PreviousHashNode   = &ODir->ShortNameHashTable[FatHashShortName (ShortNameString)];
+  for (PreviousHashNode   = &ODir->ShortNameHashTable[FatHashShortName (ShortNameString) & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->ShortNameForwardLink
       ) {
@@ -131,17 +194,27 @@ FatInsertToHashTable (
   FAT_DIRENT  **HashTable;
   UINT32      HashTableIndex;
 
+  //
+  // Grow the hash tables to keep the chains short, the directory can still be
+  // searched with the old tables if there is not enough memory
+  //
+  if (ODir->DirEntCount >= ODir->HashTableSize && ODir->HashTableSize < HASH_TABLE_MAX_SIZE) {
+    FatResizeHashTable (ODir, ODir->HashTableSize * 2);
+  }
+
+  ODir->DirEntCount++;
+  ODir->DirCacheSize += sizeof (FAT_DIRENT) + StrSize (DirEnt->FileString);
   //
   // Insert hash table index for short name
   //
-  HashTableIndex                = FatHashShortName (DirEnt->Entry.FileName);
+  HashTableIndex                = FatHashShortName (DirEnt->Entry.FileName) & (ODir->HashTableSize - 1);
   HashTable                     = ODir->ShortNameHashTable;
   DirEnt->ShortNameForwardLink  = HashTable[HashTableIndex];
   HashTable[HashTableIndex]     = DirEnt;
   //
   // Insert hash table index for long name
   //
-  HashTableIndex                = FatHashLongName (DirEnt->FileString);
+  HashTableIndex                = FatHashLongName (DirEnt->FileString) & (ODir->HashTableSize - 1);
   HashTable                     = ODir->LongNameHashTable;
   DirEnt->LongNameForwardLink   = HashTable[HashTableIndex];
   HashTable[HashTableIndex]     = DirEnt;
@@ -163,4 +236,6 @@ FatDeleteFromHashTable (
 {
   *FatShortNameHashSearch (ODir, DirEnt->Entry.FileName) = DirEnt->ShortNameForwardLink;
   *FatLongNameHashSearch (ODir, DirEnt->FileString)      = DirEnt->LongNameForwardLink;
+  ODir->DirEntCount--;
+  ODir->DirCacheSize -= sizeof (FAT_DIRENT) + StrSize (DirEnt->FileString);
 }
@@ -75,6 +75,7 @@ FatAllocateVolume (
   if (EFI_ERROR (Status)) {
     goto Done;
   }
+  FatInitializeFreeMap (Volume);
   //
   // Install our protocol interfaces on the device's handle
   //
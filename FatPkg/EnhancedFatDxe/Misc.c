@@ -465,6 +465,13 @@ FatFreeVolume (
     FreePool (Volume->CacheBuffer);
   }
   //
+  // Free free cluster bitmap
+  //
+  if (Volume->FreeMap != NULL) {
+    FreePool (Volume->FreeMap);
+    FreePool (Volume->FreeMapLoaded);
+  }
+  //
   // Free directory cache
   //
   FatCleanupODirCache (Volume);
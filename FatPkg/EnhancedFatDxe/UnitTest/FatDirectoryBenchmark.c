@@ -0,0 +1,245 @@
+/** @file
+  Host based benchmark of file opens in large FAT directories.
+
+  The benchmark mounts the synthetic FAT16 volume of FatTestVolume.c and
+  measures the opens per second in one large directory and across many
+  directories. The unit tests in FatDirectoryUnitTest.c check the results
+  of the same lookups.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "FatTestVolume.h"
+
+#define UNIT_TEST_NAME     "EnhancedFatDxe Directory Benchmark"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define FAT_BENCHMARK_OPEN_COUNT       0x40000
+
+/**
+  Return the elapsed time since Start in microseconds.
+**/
+STATIC
+UINT64
+BenchmarkElapsed (
+  IN clock_t  Start
+  )
+{
+  return DivU64x32 (MultU64x32 ((UINT64) (clock () - Start), 1000000), CLOCKS_PER_SEC);
+}
+
+/**
+  Print the rate of Count operations which took Elapsed microseconds.
+**/
+STATIC
+VOID
+BenchmarkReport (
+  IN CONST CHAR8  *Name,
+  IN UINTN        Count,
+  IN UINT64       Elapsed
+  )
+{
+  printf (
+    "%s: %u opens in %llu us, %llu opens/sec\n",
+    Name,
+    (UINT32) Count,
+    (unsigned long long) Elapsed,
+    (unsigned long long) DivU64x64Remainder (MultU64x32 ((UINT64) Count, 1000000), MAX (Elapsed, 1), NULL)
+    );
+}
+
+/**
+  Open the files of the large directory in a pseudo random order.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+OpenFilesInLargeDirectory (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Directory;
+  EFI_FILE_PROTOCOL  *File;
+  CHAR16             FileName[EFI_FILE_STRING_LENGTH + 1];
+  UINTN              Index;
+  UINT32             Random;
+  clock_t            Start;
+
+  Status = mFatTest.Root->Open (mFatTest.Root, &Directory, FAT_TEST_LARGE_DIR_NAME, EFI_FILE_MODE_READ, 0);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  //
+  // The first pass loads the directory entries from the disk
+  //
+  Start = clock ();
+  for (Index = 0; Index < FAT_TEST_LARGE_DIR_FILES; Index++) {
+    FatTestFileName (Index, FileName, sizeof (FileName));
+    Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    File->Close (File);
+  }
+  BenchmarkReport ("Large directory, first pass", FAT_TEST_LARGE_DIR_FILES, BenchmarkElapsed (Start));
+
+  Random = 1;
+  Start  = clock ();
+  for (Index = 0; Index < FAT_BENCHMARK_OPEN_COUNT; Index++) {
+    Random = Random * 1103515245 + 12345;
+    FatTestFileName ((Random >> 8) % FAT_TEST_LARGE_DIR_FILES, FileName, sizeof (FileName));
+    Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    File->Close (File);
+  }
+  BenchmarkReport ("Large directory, random opens", FAT_BENCHMARK_OPEN_COUNT, BenchmarkElapsed (Start));
+
+  Status = Directory->Open (Directory, &File, L"vmlinuz-missing.efi", EFI_FILE_MODE_READ, 0);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  Directory->Close (Directory);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reopen the large directory and a file in it, which is served by the
+  directory cache when the directory fits in its memory budget.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ReopenLargeDirectory (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Directory;
+  EFI_FILE_PROTOCOL  *File;
+  CHAR16             FileName[EFI_FILE_STRING_LENGTH + 1];
+  UINTN              Index;
+  UINTN              Count;
+  clock_t            Start;
+
+  Count = FAT_BENCHMARK_OPEN_COUNT / 64;
+  Start = clock ();
+  for (Index = 0; Index < Count; Index++) {
+    Status = mFatTest.Root->Open (mFatTest.Root, &Directory, FAT_TEST_LARGE_DIR_NAME, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    FatTestFileName (FAT_TEST_LARGE_DIR_FILES - 1 - Index % 64, FileName, sizeof (FileName));
+    Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    File->Close (File);
+    Directory->Close (Directory);
+  }
+  BenchmarkReport ("Large directory, reopened", Count, BenchmarkElapsed (Start));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Open files round robin across more directories than the directory cache
+  used to hold.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+OpenFilesAcrossDirectories (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Directory;
+  EFI_FILE_PROTOCOL  *File;
+  CHAR16             DirectoryName[EFI_FILE_STRING_LENGTH + 1];
+  CHAR16             FileName[EFI_FILE_STRING_LENGTH + 1];
+  UINTN              Index;
+  UINTN              DirectoryIndex;
+  UINTN              Count;
+  clock_t            Start;
+
+  Count = FAT_BENCHMARK_OPEN_COUNT / 4;
+  Start = clock ();
+  for (Index = 0; Index < Count; Index++) {
+    DirectoryIndex = Index % FAT_TEST_SMALL_DIR_COUNT;
+    UnicodeSPrint (DirectoryName, sizeof (DirectoryName), L"Small%02d", DirectoryIndex);
+    Status = mFatTest.Root->Open (mFatTest.Root, &Directory, DirectoryName, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    FatTestFileName (
+      DirectoryIndex * FAT_TEST_SMALL_DIR_FILES + (Index / FAT_TEST_SMALL_DIR_COUNT) % FAT_TEST_SMALL_DIR_FILES,
+      FileName,
+      sizeof (FileName)
+      );
+    Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    File->Close (File);
+    Directory->Close (Directory);
+  }
+  BenchmarkReport ("Small directories, round robin", Count, BenchmarkElapsed (Start));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  directory benchmark and run them.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DirectoryTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (
+             &DirectoryTests,
+             Framework,
+             "Directory Benchmark",
+             "FatPkg.EnhancedFatDxe.Directory",
+             FatTestSetup,
+             FatTestTeardown
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DirectoryTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (DirectoryTests, "Open files in a large directory", "LargeDirectory", OpenFilesInLargeDirectory, NULL, NULL, NULL);
+  AddTestCase (DirectoryTests, "Reopen a large directory", "ReopenDirectory", ReopenLargeDirectory, NULL, NULL, NULL);
+  AddTestCase (DirectoryTests, "Open files across many directories", "ManyDirectories", OpenFilesAcrossDirectories, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,331 @@
+/** @file
+  Host based unit tests of file lookups in FAT directories.
+
+  The tests build a synthetic FAT16 image in memory, mount it with the
+  EnhancedFatDxe sources over a mocked Disk I/O protocol, and check that
+  file opens find the right file in one large directory, across many
+  directories served by the directory cache, and in a directory whose name
+  hash tables grow as files are created.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "FatTestVolume.h"
+
+#define UNIT_TEST_NAME     "EnhancedFatDxe Directory Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define FAT_TEST_NEW_FILES             1024
+#define FAT_TEST_INFO_SIZE             (SIZE_OF_EFI_FILE_INFO + (EFI_FILE_STRING_LENGTH + 1) * sizeof (CHAR16))
+
+/**
+  Check that an open file has the expected long name.
+
+  @param  File                  - The open file.
+  @param  FileName              - The expected name of the file.
+
+  @retval TRUE                  - The file has the expected name.
+  @retval FALSE                 - The file has another name, or its information
+                                  can't be read.
+**/
+STATIC
+BOOLEAN
+FatTestFileNameIs (
+  IN EFI_FILE_PROTOCOL  *File,
+  IN CHAR16             *FileName
+  )
+{
+  EFI_STATUS     Status;
+  UINT64         Buffer[FAT_TEST_INFO_SIZE / sizeof (UINT64) + 1];
+  UINTN          BufferSize;
+  EFI_FILE_INFO  *Info;
+
+  BufferSize = sizeof (Buffer);
+  Status     = File->GetInfo (File, &gEfiFileInfoGuid, &BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  Info = (EFI_FILE_INFO *) Buffer;
+  return (BOOLEAN) (StrCmp (Info->FileName, FileName) == 0);
+}
+
+/**
+  Open a file of a directory and check that the file found has the
+  expected long name.
+
+  @param  Directory             - The open directory.
+  @param  OpenName              - The name used to open the file.
+  @param  FileName              - The expected long name of the file.
+
+  @retval TRUE                  - The file is found and has the expected name.
+  @retval FALSE                 - The file is not found or has another name.
+**/
+STATIC
+BOOLEAN
+FatTestLookup (
+  IN EFI_FILE_PROTOCOL  *Directory,
+  IN CHAR16             *OpenName,
+  IN CHAR16             *FileName
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *File;
+  BOOLEAN            Found;
+
+  Status = Directory->Open (Directory, &File, OpenName, EFI_FILE_MODE_READ, 0);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  Found = FatTestFileNameIs (File, FileName);
+  File->Close (File);
+  return Found;
+}
+
+/**
+  Look up every file of the large directory by its long name, and some of
+  them by their short name or a name in another case.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LookupInLargeDirectory (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Directory;
+  EFI_FILE_PROTOCOL  *File;
+  CHAR16             FileName[EFI_FILE_STRING_LENGTH + 1];
+  CHAR16             OpenName[EFI_FILE_STRING_LENGTH + 1];
+  UINTN              Index;
+
+  Status = mFatTest.Root->Open (mFatTest.Root, &Directory, FAT_TEST_LARGE_DIR_NAME, EFI_FILE_MODE_READ, 0);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  for (Index = 0; Index < FAT_TEST_LARGE_DIR_FILES; Index++) {
+    FatTestFileName (Index, FileName, sizeof (FileName));
+    UT_ASSERT_TRUE (FatTestLookup (Directory, FileName, FileName));
+  }
+
+  for (Index = 0; Index < FAT_TEST_LARGE_DIR_FILES; Index += 997) {
+    FatTestFileName (Index, FileName, sizeof (FileName));
+    UnicodeSPrint (OpenName, sizeof (OpenName), L"VM%06d.EFI", Index);
+    UT_ASSERT_TRUE (FatTestLookup (Directory, OpenName, FileName));
+    UnicodeSPrint (OpenName, sizeof (OpenName), L"VMLINUZ-%05d.EFI", Index);
+    UT_ASSERT_TRUE (FatTestLookup (Directory, OpenName, FileName));
+  }
+
+  Status = Directory->Open (Directory, &File, L"vmlinuz-missing.efi", EFI_FILE_MODE_READ, 0);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  FatTestFileName (FAT_TEST_LARGE_DIR_FILES, FileName, sizeof (FileName));
+  Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ, 0);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Directory->Close (Directory);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reopen the large directory, which is then served by the directory cache,
+  and look up files in it.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LookupInReopenedDirectory (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Directory;
+  CHAR16             FileName[EFI_FILE_STRING_LENGTH + 1];
+  UINTN              Index;
+
+  for (Index = 0; Index < 64; Index++) {
+    Status = mFatTest.Root->Open (mFatTest.Root, &Directory, FAT_TEST_LARGE_DIR_NAME, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    FatTestFileName (FAT_TEST_LARGE_DIR_FILES - 1 - Index * 251, FileName, sizeof (FileName));
+    UT_ASSERT_TRUE (FatTestLookup (Directory, FileName, FileName));
+    Directory->Close (Directory);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Look up files round robin across more directories than the directory cache
+  used to hold, and check that a directory doesn't find the files of
+  another one.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LookupAcrossDirectories (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Directory;
+  EFI_FILE_PROTOCOL  *File;
+  CHAR16             DirectoryName[EFI_FILE_STRING_LENGTH + 1];
+  CHAR16             FileName[EFI_FILE_STRING_LENGTH + 1];
+  UINTN              Index;
+  UINTN              DirectoryIndex;
+  UINTN              FileIndex;
+
+  for (Index = 0; Index < FAT_TEST_SMALL_DIR_COUNT * 8; Index++) {
+    DirectoryIndex = Index % FAT_TEST_SMALL_DIR_COUNT;
+    FileIndex      = DirectoryIndex * FAT_TEST_SMALL_DIR_FILES + (Index * 37) % FAT_TEST_SMALL_DIR_FILES;
+    UnicodeSPrint (DirectoryName, sizeof (DirectoryName), L"Small%02d", DirectoryIndex);
+    Status = mFatTest.Root->Open (mFatTest.Root, &Directory, DirectoryName, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+
+    FatTestFileName (FileIndex, FileName, sizeof (FileName));
+    UT_ASSERT_TRUE (FatTestLookup (Directory, FileName, FileName));
+
+    FileIndex = (FileIndex + FAT_TEST_SMALL_DIR_FILES) % (FAT_TEST_SMALL_DIR_COUNT * FAT_TEST_SMALL_DIR_FILES);
+    FatTestFileName (FileIndex, FileName, sizeof (FileName));
+    Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ, 0);
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+    Directory->Close (Directory);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Create files in a small directory so that its name hash tables grow, then
+  check that both the old and the new files are found, and that deleted
+  files are not.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LookupAfterCreateAndDelete (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Directory;
+  EFI_FILE_PROTOCOL  *File;
+  CHAR16             FileName[EFI_FILE_STRING_LENGTH + 1];
+  UINTN              Index;
+
+  Status = mFatTest.Root->Open (mFatTest.Root, &Directory, L"Small00", EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE, 0);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  for (Index = 0; Index < FAT_TEST_NEW_FILES; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), L"initrd-%05d.img", Index);
+    Status = Directory->Open (
+                          Directory,
+                          &File,
+                          FileName,
+                          EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE,
+                          0
+                          );
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    File->Close (File);
+  }
+
+  for (Index = 0; Index < FAT_TEST_SMALL_DIR_FILES; Index++) {
+    FatTestFileName (Index, FileName, sizeof (FileName));
+    UT_ASSERT_TRUE (FatTestLookup (Directory, FileName, FileName));
+  }
+
+  for (Index = 0; Index < FAT_TEST_NEW_FILES; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), L"initrd-%05d.img", Index);
+    UT_ASSERT_TRUE (FatTestLookup (Directory, FileName, FileName));
+  }
+
+  for (Index = 0; Index < FAT_TEST_NEW_FILES; Index += 2) {
+    UnicodeSPrint (FileName, sizeof (FileName), L"initrd-%05d.img", Index);
+    Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    Status = File->Delete (File);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  for (Index = 0; Index < FAT_TEST_NEW_FILES; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), L"initrd-%05d.img", Index);
+    if ((Index % 2) == 0) {
+      Status = Directory->Open (Directory, &File, FileName, EFI_FILE_MODE_READ, 0);
+      UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+    } else {
+      UT_ASSERT_TRUE (FatTestLookup (Directory, FileName, FileName));
+    }
+  }
+
+  Directory->Close (Directory);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  directory lookups and run them.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DirectoryTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (
+             &DirectoryTests,
+             Framework,
+             "Directory Lookup Tests",
+             "FatPkg.EnhancedFatDxe.Directory",
+             FatTestSetup,
+             FatTestTeardown
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DirectoryTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (DirectoryTests, "Look up files in a large directory", "LargeDirectory", LookupInLargeDirectory, NULL, NULL, NULL);
+  AddTestCase (DirectoryTests, "Look up files in a reopened directory", "ReopenDirectory", LookupInReopenedDirectory, NULL, NULL, NULL);
+  AddTestCase (DirectoryTests, "Look up files across many directories", "ManyDirectories", LookupAcrossDirectories, NULL, NULL, NULL);
+  AddTestCase (DirectoryTests, "Look up files after create and delete", "CreateDelete", LookupAfterCreateAndDelete, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,599 @@
+/** @file
+  Synthetic FAT16 volume shared by the EnhancedFatDxe host based tests.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "FatTestVolume.h"
+
+//
+// Defined in UnicodeCollation.c, normally located by the driver binding
+//
+extern EFI_UNICODE_COLLATION_PROTOCOL  *mUnicodeCollationInterface;
+
+FAT_TEST_CONTEXT            mFatTest;
+STATIC EFI_BOOT_SERVICES    mBootServices;
+STATIC EFI_RUNTIME_SERVICES mRuntimeServices;
+
+EFI_BOOT_SERVICES           *gBS = &mBootServices;
+EFI_RUNTIME_SERVICES        *gRT = &mRuntimeServices;
+STATIC EFI_TPL              mCurrentTpl = TPL_APPLICATION;
+
+/**
+  Mock of the Disk I/O ReadDisk service over the in-memory image.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockReadDisk (
+  IN EFI_DISK_IO_PROTOCOL         *This,
+  IN UINT32                       MediaId,
+  IN UINT64                       Offset,
+  IN UINTN                        BufferSize,
+  OUT VOID                        *Buffer
+  )
+{
+  if (Offset + BufferSize > (UINT64) FAT_TEST_SECTORS * FAT_TEST_SECTOR_SIZE) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem (Buffer, mFatTest.Image + Offset, BufferSize);
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of the Disk I/O WriteDisk service over the in-memory image.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockWriteDisk (
+  IN EFI_DISK_IO_PROTOCOL         *This,
+  IN UINT32                       MediaId,
+  IN UINT64                       Offset,
+  IN UINTN                        BufferSize,
+  IN VOID                         *Buffer
+  )
+{
+  if (Offset + BufferSize > (UINT64) FAT_TEST_SECTORS * FAT_TEST_SECTOR_SIZE) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem (mFatTest.Image + Offset, Buffer, BufferSize);
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of the Block I/O FlushBlocks service, the image has no write cache.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockFlushBlocks (
+  IN EFI_BLOCK_IO_PROTOCOL        *This
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of the CalculateCrc32 boot service.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockCalculateCrc32 (
+  IN  VOID                        *Data,
+  IN  UINTN                       DataSize,
+  OUT UINT32                      *Crc32
+  )
+{
+  *Crc32 = CalculateCrc32 (Data, DataSize);
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of the InstallMultipleProtocolInterfaces boot service, which records
+  the FAT volume installed by FatAllocateVolume().
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockInstallMultipleProtocolInterfaces (
+  IN OUT EFI_HANDLE           *Handle,
+  ...
+  )
+{
+  VA_LIST                          Args;
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *VolumeInterface;
+
+  VA_START (Args, Handle);
+  VA_ARG (Args, EFI_GUID *);
+  VolumeInterface = VA_ARG (Args, EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *);
+  VA_END (Args);
+
+  mFatTest.Volume = VOLUME_FROM_VOL_INTERFACE (VolumeInterface);
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of the UninstallMultipleProtocolInterfaces boot service.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockUninstallMultipleProtocolInterfaces (
+  IN EFI_HANDLE           Handle,
+  ...
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of the GetTime runtime service, the volume has no real time clock.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetTime (
+  OUT  EFI_TIME                    *Time,
+  OUT  EFI_TIME_CAPABILITIES       *Capabilities OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Mock of the Unicode Collation StriColl service for ASCII names.
+**/
+STATIC
+INTN
+EFIAPI
+MockStriColl (
+  IN EFI_UNICODE_COLLATION_PROTOCOL   *This,
+  IN CHAR16                           *Str1,
+  IN CHAR16                           *Str2
+  )
+{
+  CHAR16  Char1;
+  CHAR16  Char2;
+
+  do {
+    Char1 = CharToUpper (*Str1++);
+    Char2 = CharToUpper (*Str2++);
+  } while (Char1 != L'\0' && Char1 == Char2);
+
+  return Char1 - Char2;
+}
+
+/**
+  Mock of the Unicode Collation StrLwr service for ASCII names.
+**/
+STATIC
+VOID
+EFIAPI
+MockStrLwr (
+  IN EFI_UNICODE_COLLATION_PROTOCOL   *This,
+  IN OUT CHAR16                       *Str
+  )
+{
+  for (; *Str != L'\0'; Str++) {
+    if (*Str >= L'A' && *Str <= L'Z') {
+      *Str = (CHAR16) (*Str - L'A' + L'a');
+    }
+  }
+}
+
+/**
+  Mock of the Unicode Collation StrUpr service for ASCII names.
+**/
+STATIC
+VOID
+EFIAPI
+MockStrUpr (
+  IN EFI_UNICODE_COLLATION_PROTOCOL   *This,
+  IN OUT CHAR16                       *Str
+  )
+{
+  for (; *Str != L'\0'; Str++) {
+    *Str = CharToUpper (*Str);
+  }
+}
+
+/**
+  Mock of the Unicode Collation FatToStr service for ASCII names.
+**/
+STATIC
+VOID
+EFIAPI
+MockFatToStr (
+  IN EFI_UNICODE_COLLATION_PROTOCOL   *This,
+  IN UINTN                            FatSize,
+  IN CHAR8                            *Fat,
+  OUT CHAR16                          *String
+  )
+{
+  for (; FatSize != 0 && *Fat != '\0'; FatSize--) {
+    *String++ = (CHAR16) *Fat++;
+  }
+
+  *String = L'\0';
+}
+
+/**
+  Mock of the Unicode Collation StrToFat service for ASCII names.
+**/
+STATIC
+BOOLEAN
+EFIAPI
+MockStrToFat (
+  IN EFI_UNICODE_COLLATION_PROTOCOL   *This,
+  IN CHAR16                           *String,
+  IN UINTN                            FatSize,
+  OUT CHAR8                           *Fat
+  )
+{
+  BOOLEAN  Lossy;
+
+  Lossy = FALSE;
+  for (; FatSize != 0 && *String != L'\0'; String++) {
+    if (*String == L'.' || *String == L' ') {
+      continue;
+    }
+
+    if ((*String >= L'0' && *String <= L'9') || (*String >= L'A' && *String <= L'Z') ||
+        (*String >= L'a' && *String <= L'z') || *String == L'-' || *String == L'_') {
+      *Fat = (CHAR8) CharToUpper (*String);
+    } else {
+      *Fat  = '_';
+      Lossy = TRUE;
+    }
+
+    Fat++;
+    FatSize--;
+  }
+
+  return Lossy;
+}
+
+STATIC EFI_UNICODE_COLLATION_PROTOCOL  mUnicodeCollation = {
+  MockStriColl,
+  NULL,
+  MockStrLwr,
+  MockStrUpr,
+  MockFatToStr,
+  MockStrToFat,
+  "en"
+};
+
+/**
+  Host implementation of EfiAcquireLock(), the tests are single threaded.
+**/
+VOID
+EFIAPI
+EfiAcquireLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockReleased);
+  Lock->OwnerTpl = mCurrentTpl;
+  mCurrentTpl    = Lock->Tpl;
+  Lock->Lock     = EfiLockAcquired;
+}
+
+/**
+  Host implementation of EfiAcquireLockOrFail().
+**/
+EFI_STATUS
+EFIAPI
+EfiAcquireLockOrFail (
+  IN EFI_LOCK  *Lock
+  )
+{
+  if (Lock->Lock != EfiLockReleased) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  EfiAcquireLock (Lock);
+  return EFI_SUCCESS;
+}
+
+/**
+  Host implementation of EfiReleaseLock().
+**/
+VOID
+EFIAPI
+EfiReleaseLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockAcquired);
+  mCurrentTpl = Lock->OwnerTpl;
+  Lock->Lock  = EfiLockReleased;
+}
+
+/**
+  Host implementation of EfiGetCurrentTpl().
+**/
+EFI_TPL
+EFIAPI
+EfiGetCurrentTpl (
+  VOID
+  )
+{
+  return mCurrentTpl;
+}
+
+/**
+  Host implementation of GetBestLanguage(), the Unicode Collation protocol is
+  provided by the tests so no language is negotiated.
+**/
+CHAR8 *
+EFIAPI
+GetBestLanguage (
+  IN CONST CHAR8  *SupportedLanguages,
+  IN UINTN        Iso639Language,
+  ...
+  )
+{
+  return NULL;
+}
+
+/**
+  Host implementation of GetEfiGlobalVariable2(), no variable exists.
+**/
+EFI_STATUS
+EFIAPI
+GetEfiGlobalVariable2 (
+  IN CONST CHAR16    *Name,
+  OUT VOID           **Value,
+  OUT UINTN          *Size   OPTIONAL
+  )
+{
+  *Value = NULL;
+  if (Size != NULL) {
+    *Size = 0;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Return the long name of a file in the synthetic volume.
+**/
+VOID
+FatTestFileName (
+  IN  UINTN   Index,
+  OUT CHAR16  *Buffer,
+  IN  UINTN   BufferSize
+  )
+{
+  UnicodeSPrint (Buffer, BufferSize, L"vmlinuz-%05d.efi", Index);
+}
+
+/**
+  Return the address of a cluster in the image.
+**/
+STATIC
+UINT8 *
+FatTestCluster (
+  IN UINTN  Cluster
+  )
+{
+  return mFatTest.Image + (FAT_TEST_FIRST_CLUSTER_LBA + (Cluster - FAT_MIN_CLUSTER) * FAT_TEST_SECTORS_PER_CLUSTER) * FAT_TEST_SECTOR_SIZE;
+}
+
+/**
+  Set a FAT16 entry in all the FATs of the image.
+**/
+STATIC
+VOID
+FatTestSetFatEntry (
+  IN UINTN   Cluster,
+  IN UINT16  Value
+  )
+{
+  UINTN  Index;
+  UINT8  *Fat;
+
+  for (Index = 0; Index < FAT_TEST_NUM_FATS; Index++) {
+    Fat = mFatTest.Image + (FAT_TEST_RESERVED_SECTORS + Index * FAT_TEST_SECTORS_PER_FAT) * FAT_TEST_SECTOR_SIZE;
+    WriteUnaligned16 ((UINT16 *) (Fat + FAT_POS_FAT16 (Cluster)), Value);
+  }
+}
+
+/**
+  Allocate a contiguous cluster chain for a directory of EntryCount entries.
+
+  @return The first cluster of the directory.
+**/
+STATIC
+UINTN
+FatTestAllocateDirectory (
+  IN UINTN  EntryCount
+  )
+{
+  UINTN  FirstCluster;
+  UINTN  ClusterCount;
+  UINTN  Index;
+
+  FirstCluster = mFatTest.NextCluster;
+  ClusterCount = MAX (1, (EntryCount * sizeof (FAT_DIRECTORY_ENTRY) + FAT_TEST_CLUSTER_SIZE - 1) / FAT_TEST_CLUSTER_SIZE);
+  for (Index = 0; Index < ClusterCount - 1; Index++) {
+    FatTestSetFatEntry (FirstCluster + Index, (UINT16) (FirstCluster + Index + 1));
+  }
+
+  FatTestSetFatEntry (FirstCluster + Index, (UINT16) FAT_CLUSTER_LAST);
+  mFatTest.NextCluster += ClusterCount;
+  return FirstCluster;
+}
+
+/**
+  Add a directory entry and its long name entries.
+
+  @return The next free directory entry.
+**/
+STATIC
+FAT_DIRECTORY_ENTRY *
+FatTestAddEntry (
+  IN FAT_DIRECTORY_ENTRY  *Entry,
+  IN CONST CHAR8          *ShortName,
+  IN CHAR16               *LongName OPTIONAL,
+  IN UINT8                Attributes,
+  IN UINTN                Cluster
+  )
+{
+  FAT_DIRECTORY_LFN  *LfnEntry;
+  CHAR16             NameBuffer[MAX_LFN_ENTRIES * LFN_CHAR_TOTAL];
+  UINTN              LfnCount;
+  UINTN              Ordinal;
+  UINTN              Index;
+  UINT8              Checksum;
+
+  if (LongName != NULL) {
+    Checksum = 0;
+    for (Index = 0; Index < FAT_NAME_LEN; Index++) {
+      Checksum = (UINT8) (((Checksum & 1) << 7) + (Checksum >> 1) + ShortName[Index]);
+    }
+
+    SetMem16 (NameBuffer, sizeof (NameBuffer), 0xFFFF);
+    StrCpyS (NameBuffer, ARRAY_SIZE (NameBuffer), LongName);
+    LfnCount = LFN_ENTRY_NUMBER (StrLen (LongName));
+    for (Ordinal = LfnCount; Ordinal > 0; Ordinal--) {
+      LfnEntry = (FAT_DIRECTORY_LFN *) Entry;
+      ZeroMem (LfnEntry, sizeof (*LfnEntry));
+      LfnEntry->Ordinal    = (UINT8) (Ordinal | (Ordinal == LfnCount ? FAT_LFN_LAST : 0));
+      LfnEntry->Attributes = FAT_ATTRIBUTE_LFN;
+      LfnEntry->Checksum   = Checksum;
+      Index                = (Ordinal - 1) * LFN_CHAR_TOTAL;
+      CopyMem (LfnEntry->Name1, &NameBuffer[Index], LFN_CHAR1_LEN * sizeof (CHAR16));
+      CopyMem (LfnEntry->Name2, &NameBuffer[Index + LFN_CHAR1_LEN], LFN_CHAR2_LEN * sizeof (CHAR16));
+      CopyMem (LfnEntry->Name3, &NameBuffer[Index + LFN_CHAR1_LEN + LFN_CHAR2_LEN], LFN_CHAR3_LEN * sizeof (CHAR16));
+      Entry++;
+    }
+  }
+
+  CopyMem (Entry->FileName, ShortName, FAT_NAME_LEN);
+  Entry->Attributes  = Attributes;
+  Entry->FileCluster = (UINT16) Cluster;
+  return Entry + 1;
+}
+
+/**
+  Create a directory with FileCount files, each with a long name and a
+  numbered short name.
+
+  @return The first cluster of the directory.
+**/
+STATIC
+UINTN
+FatTestCreateDirectory (
+  IN UINTN  FileCount,
+  IN UINTN  FirstFile
+  )
+{
+  FAT_DIRECTORY_ENTRY  *Entry;
+  UINTN                Cluster;
+  UINTN                Index;
+  CHAR8                ShortName[FAT_NAME_LEN + 1];
+  CHAR16               LongName[EFI_FILE_STRING_LENGTH + 1];
+
+  Cluster = FatTestAllocateDirectory (2 + FileCount * (LFN_ENTRY_NUMBER (16) + 1));
+  Entry   = (FAT_DIRECTORY_ENTRY *) FatTestCluster (Cluster);
+  Entry   = FatTestAddEntry (Entry, ".          ", NULL, FAT_ATTRIBUTE_DIRECTORY, Cluster);
+  Entry   = FatTestAddEntry (Entry, "..         ", NULL, FAT_ATTRIBUTE_DIRECTORY, 0);
+  for (Index = FirstFile; Index < FirstFile + FileCount; Index++) {
+    AsciiSPrint (ShortName, sizeof (ShortName), "VM%06dEFI", Index);
+    FatTestFileName (Index, LongName, sizeof (LongName));
+    Entry = FatTestAddEntry (Entry, ShortName, LongName, FAT_ATTRIBUTE_ARCHIVE, 0);
+  }
+
+  return Cluster;
+}
+
+/**
+  Build the synthetic volume and mount it with the FAT driver.
+**/
+VOID
+EFIAPI
+FatTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FAT_BOOT_SECTOR      *BootSector;
+  FAT_DIRECTORY_ENTRY  *Entry;
+  UINTN                Index;
+  UINTN                Cluster;
+  CHAR8                ShortName[FAT_NAME_LEN + 1];
+  EFI_STATUS           Status;
+
+  mBootServices.CalculateCrc32                      = MockCalculateCrc32;
+  mBootServices.InstallMultipleProtocolInterfaces   = MockInstallMultipleProtocolInterfaces;
+  mBootServices.UninstallMultipleProtocolInterfaces = MockUninstallMultipleProtocolInterfaces;
+  mRuntimeServices.GetTime                          = MockGetTime;
+  mUnicodeCollationInterface                        = &mUnicodeCollation;
+
+  mFatTest.Image = AllocateZeroPool (FAT_TEST_SECTORS * FAT_TEST_SECTOR_SIZE);
+  ASSERT (mFatTest.Image != NULL);
+
+  BootSector = (FAT_BOOT_SECTOR *) mFatTest.Image;
+  BootSector->FatBsb.Ia32Jump[0]       = 0xEB;
+  BootSector->FatBsb.SectorSize        = FAT_TEST_SECTOR_SIZE;
+  BootSector->FatBsb.SectorsPerCluster = FAT_TEST_SECTORS_PER_CLUSTER;
+  BootSector->FatBsb.ReservedSectors   = FAT_TEST_RESERVED_SECTORS;
+  BootSector->FatBsb.NumFats           = FAT_TEST_NUM_FATS;
+  BootSector->FatBsb.RootEntries       = FAT_TEST_ROOT_ENTRIES;
+  BootSector->FatBsb.Media             = 0xF8;
+  BootSector->FatBsb.SectorsPerFat     = FAT_TEST_SECTORS_PER_FAT;
+  BootSector->FatBsb.LargeSectors      = FAT_TEST_SECTORS;
+  CopyMem (BootSector->FatBse.FatBse.SystemId, "FAT16   ", 8);
+  mFatTest.Image[510] = 0x55;
+  mFatTest.Image[511] = 0xAA;
+  FatTestSetFatEntry (0, 0xFFF8);
+  FatTestSetFatEntry (1, 0xFFFF);
+
+  //
+  // The root directory holds one large directory and many small ones
+  //
+  mFatTest.NextCluster = FAT_MIN_CLUSTER;
+  Entry   = (FAT_DIRECTORY_ENTRY *) (mFatTest.Image + FAT_TEST_ROOT_LBA * FAT_TEST_SECTOR_SIZE);
+  Cluster = FatTestCreateDirectory (FAT_TEST_LARGE_DIR_FILES, 0);
+  Entry   = FatTestAddEntry (Entry, "LARGE      ", NULL, FAT_ATTRIBUTE_DIRECTORY, Cluster);
+  for (Index = 0; Index < FAT_TEST_SMALL_DIR_COUNT; Index++) {
+    Cluster = FatTestCreateDirectory (FAT_TEST_SMALL_DIR_FILES, Index * FAT_TEST_SMALL_DIR_FILES);
+    AsciiSPrint (ShortName, sizeof (ShortName), "SMALL%02d    ", Index);
+    Entry   = FatTestAddEntry (Entry, ShortName, NULL, FAT_ATTRIBUTE_DIRECTORY, Cluster);
+  }
+
+  mFatTest.Media.BlockSize      = FAT_TEST_SECTOR_SIZE;
+  mFatTest.Media.LastBlock      = FAT_TEST_SECTORS - 1;
+  mFatTest.Media.MediaPresent   = TRUE;
+  mFatTest.BlockIo.Media        = &mFatTest.Media;
+  mFatTest.BlockIo.FlushBlocks  = MockFlushBlocks;
+  mFatTest.DiskIo.Revision      = EFI_DISK_IO_PROTOCOL_REVISION;
+  mFatTest.DiskIo.ReadDisk      = MockReadDisk;
+  mFatTest.DiskIo.WriteDisk     = MockWriteDisk;
+
+  Status = FatAllocateVolume (&mFatTest, &mFatTest.DiskIo, NULL, &mFatTest.BlockIo);
+  ASSERT_EFI_ERROR (Status);
+  Status = FatOpenVolume (&mFatTest.Volume->VolumeInterface, &mFatTest.Root);
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Unmount the synthetic volume.
+**/
+VOID
+EFIAPI
+FatTestTeardown (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mFatTest.Root->Close (mFatTest.Root);
+  FatAbandonVolume (mFatTest.Volume);
+  FreePool (mFatTest.Image);
+  ZeroMem (&mFatTest, sizeof (mFatTest));
+}
@@ -0,0 +1,92 @@
+/** @file
+  Synthetic FAT16 volume shared by the EnhancedFatDxe host based tests.
+
+  The volume is built in memory and mounted with the EnhancedFatDxe sources
+  over a mocked Disk I/O protocol. Its root directory holds one large
+  directory and many small ones, whose files have numbered long names.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _FAT_TEST_VOLUME_H_
+#define _FAT_TEST_VOLUME_H_
+
+#include "../Fat.h"
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+//
+// Geometry of the synthetic FAT16 volume, 64MB with 4KB clusters
+//
+#define FAT_TEST_SECTOR_SIZE           512
+#define FAT_TEST_SECTORS_PER_CLUSTER   8
+#define FAT_TEST_CLUSTER_SIZE          (FAT_TEST_SECTOR_SIZE * FAT_TEST_SECTORS_PER_CLUSTER)
+#define FAT_TEST_RESERVED_SECTORS      1
+#define FAT_TEST_NUM_FATS              2
+#define FAT_TEST_SECTORS_PER_FAT       64
+#define FAT_TEST_ROOT_ENTRIES          512
+#define FAT_TEST_SECTORS               0x20000
+#define FAT_TEST_ROOT_LBA              (FAT_TEST_RESERVED_SECTORS + FAT_TEST_NUM_FATS * FAT_TEST_SECTORS_PER_FAT)
+#define FAT_TEST_FIRST_CLUSTER_LBA     (FAT_TEST_ROOT_LBA + FAT_TEST_ROOT_ENTRIES * sizeof (FAT_DIRECTORY_ENTRY) / FAT_TEST_SECTOR_SIZE)
+
+//
+// Contents of the synthetic volume
+//
+#define FAT_TEST_LARGE_DIR_FILES       16384
+#define FAT_TEST_SMALL_DIR_COUNT       32
+#define FAT_TEST_SMALL_DIR_FILES       256
+#define FAT_TEST_LARGE_DIR_NAME        L"Large"
+typedef struct {
+  UINT8                     *Image;
+  UINTN                     NextCluster;
+  EFI_BLOCK_IO_MEDIA        Media;
+  EFI_BLOCK_IO_PROTOCOL     BlockIo;
+  EFI_DISK_IO_PROTOCOL      DiskIo;
+  FAT_VOLUME                *Volume;
+  EFI_FILE_PROTOCOL         *Root;
+} FAT_TEST_CONTEXT;
+
+extern FAT_TEST_CONTEXT  mFatTest;
+
+/**
+  Return the long name of a file in the synthetic volume.
+
+  @param  Index                 - The number of the file.
+  @param  Buffer                - Return the long name of the file.
+  @param  BufferSize            - The size of Buffer in bytes.
+
+**/
+VOID
+FatTestFileName (
+  IN  UINTN   Index,
+  OUT CHAR16  *Buffer,
+  IN  UINTN   BufferSize
+  );
+
+/**
+  Build the synthetic volume and mount it with the FAT driver.
+
+  @param  Context               - The unit test context, not used.
+
+**/
+VOID
+EFIAPI
+FatTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+/**
+  Unmount the synthetic volume.
+
+  @param  Context               - The unit test context, not used.
+
+**/
+VOID
+EFIAPI
+FatTestTeardown (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+#endif
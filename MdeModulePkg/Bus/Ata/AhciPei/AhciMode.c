@@ -61,6 +61,13 @@ UINT32 mMaxTransferBlockNumber[2] = {
   MAX_48BIT_TRANSFER_BLOCK_NUM
 };
 
+//
+// Block reads from 48-bit devices first try transfers as large as the PRDT
+// entries can describe (16M bytes for 512-byte block size), and fall back
+// towards MAX_48BIT_TRANSFER_BLOCK_NUM when the DMA buffer cannot be mapped.
+//
+#define MAX_48BIT_LARGE_TRANSFER_BLOCK_NUM     0x8000
+
 //
 // The maximum total sectors count in 28 bit addressing mode
 //
@@ -1545,6 +1552,15 @@ IdentifyAtaDevice (
     __FUNCTION__, Media->BlockSize, Media->LastBlock
     ));
 
+  DeviceData->MaxTransferBlocks = MaxSectorCount;
+  if (DeviceData->Lba48Bit) {
+    DeviceData->MaxTransferBlocks = MIN (
+                                      MAX_48BIT_LARGE_TRANSFER_BLOCK_NUM,
+                                      AHCI_MAX_PRDT_NUMBER * AHCI_MAX_DATA_PER_PRDT / Media->BlockSize
+                                      );
+    DeviceData->MaxTransferBlocks = MAX (DeviceData->MaxTransferBlocks, MaxSectorCount);
+  }
+
   if ((IdentifyData->trusted_computing_support & BIT0) != 0) {
     DEBUG ((DEBUG_INFO, "%a: Found Trust Computing feature support.\n", __FUNCTION__));
     DeviceData->TrustComputing = TRUE;
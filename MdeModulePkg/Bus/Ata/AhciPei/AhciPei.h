@@ -29,6 +29,8 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/IoLib.h>
 #include <Library/TimerLib.h>
+#include <Library/ElapsedTimeLib.h>
+#include <Library/PerformanceLib.h>
 
 //
 // Structure forward declarations
@@ -60,6 +62,12 @@ typedef struct _PEI_AHCI_CONTROLLER_PRIVATE_DATA  PEI_AHCI_CONTROLLER_PRIVATE_DA
 // Maximal number of Physical Region Descriptor Table entries supported.
 //
 #define AHCI_MAX_PRDT_NUMBER                   8
+//
+// Reads of at least this many bytes are logged as performance measurements.
+// Smaller reads are only counted in the read statistics, so that the file
+// system reads don't fill the PEI performance log.
+//
+#define AHCI_PERF_READ_SIZE                    SIZE_1MB
 
 #define AHCI_CAPABILITY_OFFSET                 0x0000
 #define   AHCI_CAP_SAM                         BIT18
@@ -288,6 +296,12 @@ typedef struct {
   UINTN                               TrustComputingDeviceIndex;
   EFI_PEI_BLOCK_IO2_MEDIA             Media;
 
+  //
+  // Maximum block number of a single read, reduced when the DMA buffer cannot
+  // be mapped
+  //
+  UINT32                              MaxTransferBlocks;
+
   PEI_AHCI_CONTROLLER_PRIVATE_DATA    *Private;
 } PEI_AHCI_ATA_DEVICE_DATA;
 
@@ -332,6 +346,12 @@ struct _PEI_AHCI_CONTROLLER_PRIVATE_DATA {
 
   UINT16                                PreviousPort;
   UINT16                                PreviousPortMultiplier;
+
+  //
+  // Read throughput statistics, reported at the end of PEI
+  //
+  UINT64                                ReadBytes;
+  UINT64                                ReadTime;
 };
 
 #define GET_AHCI_PEIM_HC_PRIVATE_DATA_FROM_THIS_PASS_THRU(a)           \
@@ -90,12 +90,10 @@ AccessAtaDevice (
   BlockSize              = DeviceData->Media.BlockSize;
 
   do {
-    if (NumberOfBlocks > MaxTransferBlockNumber) {
-      TransferBlockNumber = MaxTransferBlockNumber;
-      NumberOfBlocks     -= MaxTransferBlockNumber;
+    if (NumberOfBlocks > DeviceData->MaxTransferBlocks) {
+      TransferBlockNumber = DeviceData->MaxTransferBlocks;
     } else  {
       TransferBlockNumber = NumberOfBlocks;
-      NumberOfBlocks      = 0;
     }
     DEBUG ((
       DEBUG_BLKIO, "%a: Blocking AccessAtaDevice, TransferBlockNumber = %x; StartLba = %x\n",
@@ -109,11 +107,24 @@ AccessAtaDevice (
                (UINT32) TransferBlockNumber,
                FALSE  // Read
                );
+    if ((Status == EFI_OUT_OF_RESOURCES) && (TransferBlockNumber > MaxTransferBlockNumber)) {
+      //
+      // The DMA buffer cannot be mapped at this size, use smaller transfers
+      // for this and all subsequent reads of the device.
+      //
+      DeviceData->MaxTransferBlocks = MAX ((UINT32) TransferBlockNumber >> 1, (UINT32) MaxTransferBlockNumber);
+      DEBUG ((
+        DEBUG_BLKIO, "%a: Retry with smaller transfer block number - 0x%x\n",
+        __FUNCTION__, DeviceData->MaxTransferBlocks
+        ));
+      continue;
+    }
     if (EFI_ERROR (Status)) {
       return Status;
     }
 
-    StartLba += TransferBlockNumber;
+    NumberOfBlocks -= TransferBlockNumber;
+    StartLba       += TransferBlockNumber;
     Buffer   += TransferBlockNumber * BlockSize;
   } while (NumberOfBlocks > 0);
 
@@ -143,6 +154,8 @@ AhciRead (
   EFI_STATUS    Status;
   UINTN         BlockSize;
   UINTN         NumberOfBlocks;
+  UINT64        StartCounter;
+  BOOLEAN       PerfRead;
 
   //
   // Check parameters.
@@ -171,7 +184,19 @@ AhciRead (
   //
   // Invoke low level AtaDevice Access Routine.
   //
+  PerfRead = (BOOLEAN) (BufferSize >= AHCI_PERF_READ_SIZE);
+  if (PerfRead) {
+    PERF_INMODULE_BEGIN ("AhciPeiRead");
+  }
+  StartCounter = GetPerformanceCounter ();
   Status = AccessAtaDevice (DeviceData, Buffer, StartLba, NumberOfBlocks);
+  if (!EFI_ERROR (Status)) {
+    DeviceData->Private->ReadBytes += BufferSize;
+    DeviceData->Private->ReadTime  += GetElapsedTimeInNanoSecond (StartCounter, GetPerformanceCounter ());
+  }
+  if (PerfRead) {
+    PERF_INMODULE_END ("AhciPeiRead");
+  }
 
   return Status;
 }
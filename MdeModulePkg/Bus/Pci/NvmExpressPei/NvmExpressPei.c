@@ -190,6 +190,16 @@ NvmePeimEndOfPei (
   PEI_NVME_CONTROLLER_PRIVATE_DATA    *Private;
 
   Private = GET_NVME_PEIM_HC_PRIVATE_DATA_FROM_THIS_NOTIFY (NotifyDescriptor);
+  if (Private->ReadTime != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "%a: Read 0x%lx bytes in %ld us (%ld KB/s).\n",
+      __FUNCTION__,
+      Private->ReadBytes,
+      DivU64x32 (Private->ReadTime, 1000),
+      DivU64x64Remainder (MultU64x32 (Private->ReadBytes, 1000000), Private->ReadTime, NULL)
+      ));
+  }
   NvmeFreeDmaResource (Private);
 
   return EFI_SUCCESS;
@@ -29,6 +29,8 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/IoLib.h>
 #include <Library/TimerLib.h>
+#include <Library/ElapsedTimeLib.h>
+#include <Library/PerformanceLib.h>
 
 //
 // Structure forward declarations
@@ -64,6 +66,13 @@ typedef struct _PEI_NVME_CONTROLLER_PRIVATE_DATA  PEI_NVME_CONTROLLER_PRIVATE_DA
 #define NVME_GENERIC_TIMEOUT                          5000000   // Generic PassThru command timeout value, in us unit
 #define NVME_POLL_INTERVAL                            100       // Poll interval for PassThru command, in us unit
 
+//
+// Reads of at least this many bytes are logged as performance measurements.
+// Smaller reads are only counted in the read statistics, so that the file
+// system reads don't fill the PEI performance log.
+//
+#define NVME_PERF_READ_SIZE                           SIZE_1MB
+
 //
 // Nvme namespace data structure.
 //
@@ -143,6 +152,12 @@ struct _PEI_NVME_CONTROLLER_PRIVATE_DATA {
   //
   UINT32                                    ActiveNamespaceNum;
   PEI_NVME_NAMESPACE_INFO                   *NamespaceInfo;
+
+  //
+  // Read throughput statistics, reported at the end of PEI
+  //
+  UINT64                                    ReadBytes;
+  UINT64                                    ReadTime;
 };
 
 #define GET_NVME_PEIM_HC_PRIVATE_DATA_FROM_THIS_BLKIO(a)               \
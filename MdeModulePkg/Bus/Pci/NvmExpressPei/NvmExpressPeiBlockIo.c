@@ -74,6 +74,185 @@ ReadSectors (
   return Status;
 }
 
+/**
+  Read some blocks from the device by keeping several read commands outstanding
+  on the I/O queue.
+
+  The whole buffer is mapped once, split into commands which each fit in a
+  single PRP list page, and submitted in batches of up to NVME_QUEUED_READ_DEPTH
+  commands with one submission queue doorbell write per batch.
+
+  @param[in]  NamespaceInfo        The pointer to the PEI_NVME_NAMESPACE_INFO data structure.
+  @param[out] Buffer               The Buffer used to store the Data read from the device.
+  @param[in]  Lba                  The start block number.
+  @param[in]  Blocks               Total block number to be read.
+  @param[in]  MaxTransferBlocks    The maximum block number of a single read command.
+
+  @retval EFI_SUCCESS             Data are read from the device.
+  @retval EFI_OUT_OF_RESOURCES    The buffer cannot be mapped for DMA.
+  @retval EFI_TIMEOUT             A read command did not complete in time.
+  @retval Others                  Fail to read all the data.
+
+**/
+EFI_STATUS
+NvmeReadQueued (
+  IN  PEI_NVME_NAMESPACE_INFO    *NamespaceInfo,
+  OUT UINTN                      Buffer,
+  IN  UINT64                     Lba,
+  IN  UINTN                      Blocks,
+  IN  UINT32                     MaxTransferBlocks
+  )
+{
+  EFI_STATUS                          Status;
+  PEI_NVME_CONTROLLER_PRIVATE_DATA    *Private;
+  UINT32                              BlockSize;
+  UINTN                               MapLength;
+  EFI_PHYSICAL_ADDRESS                PhyAddr;
+  VOID                                *MapData;
+  NVME_SQ                             *Sq;
+  NVME_CQ                             *Cq;
+  UINT64                              *PrpList;
+  UINT64                              Prp;
+  UINT32                              CommandBlocks;
+  UINTN                               Offset;
+  UINTN                               Bytes;
+  UINTN                               Pages;
+  UINTN                               Index;
+  UINTN                               Slot;
+  UINTN                               Submitted;
+  UINTN                               Completed;
+  UINT32                              Data32;
+  UINT64                              Timer;
+
+  Private   = NamespaceInfo->Controller;
+  BlockSize = NamespaceInfo->Media.BlockSize;
+
+  //
+  // Limit every command to what a single PRP list page can describe.
+  //
+  if (MaxTransferBlocks > NVME_QUEUED_READ_MAX_BYTES / BlockSize) {
+    MaxTransferBlocks = NVME_QUEUED_READ_MAX_BYTES / BlockSize;
+  }
+  if (MaxTransferBlocks == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  MapLength = Blocks * BlockSize;
+  Status    = IoMmuMap (
+                EdkiiIoMmuOperationBusMasterWrite,
+                (VOID *) Buffer,
+                &MapLength,
+                &PhyAddr,
+                &MapData
+                );
+  if (EFI_ERROR (Status) || (MapLength != Blocks * BlockSize)) {
+    if (!EFI_ERROR (Status)) {
+      IoMmuUnmap (MapData);
+    }
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = EFI_SUCCESS;
+  while ((Blocks > 0) && !EFI_ERROR (Status)) {
+    //
+    // Build up to NVME_QUEUED_READ_DEPTH commands, each using its own PRP list page.
+    //
+    Submitted = 0;
+    for (Slot = 0; (Slot < NVME_QUEUED_READ_DEPTH) && (Blocks > 0); Slot++) {
+      CommandBlocks = (Blocks > MaxTransferBlocks) ? MaxTransferBlocks : (UINT32) Blocks;
+      Bytes         = (UINTN) CommandBlocks * BlockSize;
+
+      Sq = Private->SqBuffer[NVME_IO_QUEUE] + Private->SqTdbl[NVME_IO_QUEUE].Sqt;
+      ZeroMem (Sq, sizeof (NVME_SQ));
+      Sq->Opc    = NVME_IO_READ_OPC;
+      Sq->Cid    = Private->Cid[NVME_IO_QUEUE]++;
+      Sq->Nsid   = NamespaceInfo->NamespaceId;
+      Sq->Prp[0] = PhyAddr;
+      Sq->Prp[1] = 0;
+      Sq->Payload.Raw.Cdw10 = (UINT32) Lba;
+      Sq->Payload.Raw.Cdw11 = (UINT32) RShiftU64 (Lba, 32);
+      Sq->Payload.Raw.Cdw12 = (CommandBlocks - 1) & 0xFFFF;
+
+      Offset = (UINTN) PhyAddr & (EFI_PAGE_SIZE - 1);
+      if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
+        PrpList = (UINT64 *) (UINTN) (NVME_PRP_BASE (Private) + Slot * EFI_PAGE_SIZE);
+        Pages   = EFI_SIZE_TO_PAGES (Offset + Bytes) - 1;
+        ASSERT (Pages <= EFI_PAGE_SIZE / sizeof (UINT64));
+        Prp     = (PhyAddr + EFI_PAGE_SIZE) & ~((UINT64) EFI_PAGE_SIZE - 1);
+        for (Index = 0; Index < Pages; Index++) {
+          PrpList[Index] = Prp;
+          Prp           += EFI_PAGE_SIZE;
+        }
+        Sq->Prp[1] = (UINT64) (UINTN) PrpList;
+      } else if ((Offset + Bytes) > EFI_PAGE_SIZE) {
+        Sq->Prp[1] = (PhyAddr + EFI_PAGE_SIZE) & ~((UINT64) EFI_PAGE_SIZE - 1);
+      }
+
+      Private->SqTdbl[NVME_IO_QUEUE].Sqt++;
+      if (Private->SqTdbl[NVME_IO_QUEUE].Sqt == NVME_CSQ_SIZE + 1) {
+        Private->SqTdbl[NVME_IO_QUEUE].Sqt = 0;
+      }
+
+      Blocks  -= CommandBlocks;
+      Lba     += CommandBlocks;
+      PhyAddr += Bytes;
+      Submitted++;
+    }
+
+    //
+    // Ring the submission queue doorbell once for the whole batch.
+    //
+    Data32 = ReadUnaligned32 ((UINT32 *)&Private->SqTdbl[NVME_IO_QUEUE]);
+    Status = NVME_SET_SQTDBL (Private, NVME_IO_QUEUE, &Data32);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    //
+    // Reap the completions of the batch, in whatever order they are posted.
+    //
+    Completed = 0;
+    Timer     = 0;
+    while (Completed < Submitted) {
+      Cq = Private->CqBuffer[NVME_IO_QUEUE] + Private->CqHdbl[NVME_IO_QUEUE].Cqh;
+      if (Cq->Pt == Private->Pt[NVME_IO_QUEUE]) {
+        if (Timer >= NVME_GENERIC_TIMEOUT) {
+          break;
+        }
+        MicroSecondDelay (NVME_POLL_INTERVAL);
+        Timer += NVME_POLL_INTERVAL;
+        continue;
+      }
+
+      if (EFI_ERROR (NvmeCheckCqStatus (Cq))) {
+        Status = EFI_DEVICE_ERROR;
+      }
+
+      Private->CqHdbl[NVME_IO_QUEUE].Cqh++;
+      if (Private->CqHdbl[NVME_IO_QUEUE].Cqh == NVME_CCQ_SIZE + 1) {
+        Private->CqHdbl[NVME_IO_QUEUE].Cqh = 0;
+        Private->Pt[NVME_IO_QUEUE] ^= 1;
+      }
+      Completed++;
+    }
+
+    if (Completed < Submitted) {
+      //
+      // Timeout occurs, reset the controller to abort the outstanding commands
+      //
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for the queued read commands.\n", __FUNCTION__));
+      NvmeControllerInit (Private);
+      Status = EFI_TIMEOUT;
+      break;
+    }
+
+    NVME_SET_CQHDBL (Private, NVME_IO_QUEUE, &Private->CqHdbl[NVME_IO_QUEUE]);
+  }
+
+  IoMmuUnmap (MapData);
+  return Status;
+}
+
 /**
   Read some blocks from the device.
 
@@ -100,12 +279,19 @@ NvmeRead (
   PEI_NVME_CONTROLLER_PRIVATE_DATA    *Private;
   UINT32                              MaxTransferBlocks;
   UINTN                               OrginalBlocks;
+  UINT64                              StartCounter;
+  BOOLEAN                             PerfRead;
 
   Status        = EFI_SUCCESS;
   Retries       = 0;
   Private       = NamespaceInfo->Controller;
   BlockSize     = NamespaceInfo->Media.BlockSize;
   OrginalBlocks = Blocks;
+  PerfRead      = (BOOLEAN) (MultU64x32 (Blocks, BlockSize) >= NVME_PERF_READ_SIZE);
+  if (PerfRead) {
+    PERF_INMODULE_BEGIN ("NvmePeiRead");
+  }
+  StartCounter  = GetPerformanceCounter ();
 
   if (Private->ControllerData->Mdts != 0) {
     MaxTransferBlocks = (1 << (Private->ControllerData->Mdts)) * (1 << (Private->Cap.Mpsmin + 12)) / BlockSize;
@@ -113,6 +299,20 @@ NvmeRead (
     MaxTransferBlocks = 1024;
   }
 
+  //
+  // Keep several read commands outstanding for large reads, fall back to one
+  // command at a time if that fails.
+  //
+  if (Blocks > MaxTransferBlocks) {
+    Status = NvmeReadQueued (NamespaceInfo, Buffer, Lba, Blocks, MaxTransferBlocks);
+    if (!EFI_ERROR (Status)) {
+      Blocks = 0;
+    } else {
+      DEBUG ((DEBUG_BLKIO, "%a: NvmeReadQueued fail, Status - %r\n", __FUNCTION__, Status));
+      Status = EFI_SUCCESS;
+    }
+  }
+
   while (Blocks > 0) {
     Status = ReadSectors (
                NamespaceInfo,
@@ -149,6 +349,14 @@ NvmeRead (
   DEBUG ((DEBUG_BLKIO, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
     "Remaining = 0x%08Lx, BlockSize = 0x%x, Status = %r\n", __FUNCTION__, Lba,
     (UINT64)OrginalBlocks, (UINT64)Blocks, BlockSize, Status));
+
+  if (!EFI_ERROR (Status)) {
+    Private->ReadBytes += MultU64x32 (OrginalBlocks, BlockSize);
+    Private->ReadTime  += GetElapsedTimeInNanoSecond (StartCounter, GetPerformanceCounter ());
+  }
+  if (PerfRead) {
+    PERF_INMODULE_END ("NvmePeiRead");
+  }
   return Status;
 }
 
@@ -18,6 +18,14 @@
 
 #define NVME_READ_MAX_RETRY                 3
 
+//
+// Large reads are split into commands that each fit in a single PRP list page
+// and up to NVME_PRP_SIZE of them are kept outstanding on the I/O queue, one
+// PRP list page per command.
+//
+#define NVME_QUEUED_READ_DEPTH              NVME_PRP_SIZE
+#define NVME_QUEUED_READ_MAX_BYTES          SIZE_2MB
+
 /**
   Gets the count of block I/O devices that one specific block driver detects.
 
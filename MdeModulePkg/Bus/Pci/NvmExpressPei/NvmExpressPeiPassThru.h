@@ -13,6 +13,17 @@
 
 
 
+/**
+  Check the execution status from a given completion queue entry.
+
+  @param[in] Cq    A pointer to the NVME_CQ item.
+
+**/
+EFI_STATUS
+NvmeCheckCqStatus (
+  IN NVME_CQ             *Cq
+  );
+
 /**
   Sends an NVM Express Command Packet to an NVM Express controller or namespace. This function only
   supports blocking execution of the command.
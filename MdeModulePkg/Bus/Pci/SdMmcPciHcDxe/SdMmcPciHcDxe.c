@@ -142,6 +142,17 @@ InitializeSdMmcPciHcDxe (
 /**
   Call back function when the timer event is signaled.
 
+  The TRBs in the async I/O queue are chained: as soon as the TRB at the
+  head of the queue completes, the next one is started in the same timer
+  tick instead of the following one. This keeps the controller busy when
+  the upper layer queues several requests at once, e.g. the CMD23 and
+  CMD18/CMD25 pairs submitted by EmmcDxe for each BlockIo2 request.
+
+  Only one TRB is handed to the controller at a time. ADMA3 integrated
+  descriptors and eMMC command queuing (CQE), which let the controller run
+  several commands without software in between, are not supported, so a
+  command still waits up to one timer tick after its predecessor.
+
   @param[in]  Event     The Event this notify function registered to.
   @param[in]  Context   Pointer to the context data registered to the
                         Event.
@@ -167,54 +178,57 @@ ProcessAsyncTaskList (
   //
   // Check if the first entry in the async I/O queue is done or not.
   //
-  Status = EFI_SUCCESS;
-  Trb    = NULL;
-  Link   = GetFirstNode (&Private->Queue);
-  if (!IsNull (&Private->Queue, Link)) {
+  for (Link = GetFirstNode (&Private->Queue);
+       !IsNull (&Private->Queue, Link);
+       Link = GetFirstNode (&Private->Queue)) {
     Trb = SD_MMC_HC_TRB_FROM_THIS (Link);
     if (!Private->Slot[Trb->Slot].MediaPresent) {
       Status = EFI_NO_MEDIA;
-      goto Done;
-    }
-    if (!Trb->Started) {
-      //
-      // Check whether the cmd/data line is ready for transfer.
-      //
-      Status = SdMmcCheckTrbEnv (Private, Trb);
-      if (!EFI_ERROR (Status)) {
-        Trb->Started = TRUE;
-        Status = SdMmcExecTrb (Private, Trb);
-        if (EFI_ERROR (Status)) {
-          goto Done;
+    } else {
+      Status = EFI_SUCCESS;
+      if (!Trb->Started) {
+        //
+        // Check whether the cmd/data line is ready for transfer.
+        //
+        Status = SdMmcCheckTrbEnv (Private, Trb);
+        if (!EFI_ERROR (Status)) {
+          Trb->Started = TRUE;
+          Status = SdMmcExecTrb (Private, Trb);
         }
-      } else {
-        goto Done;
+      }
+      if (!EFI_ERROR (Status)) {
+        Status = SdMmcCheckTrbResult (Private, Trb);
       }
     }
-    Status = SdMmcCheckTrbResult (Private, Trb);
-  }
 
-Done:
-  if ((Trb != NULL) && (Status == EFI_NOT_READY)) {
-    Packet = Trb->Packet;
-    if (Packet->Timeout == 0) {
-      InfiniteWait = TRUE;
-    } else {
-      InfiniteWait = FALSE;
+    if (Status == EFI_NOT_READY) {
+      Packet = Trb->Packet;
+      if (Packet->Timeout == 0) {
+        InfiniteWait = TRUE;
+      } else {
+        InfiniteWait = FALSE;
+      }
+      if ((!InfiniteWait) && (Trb->Timeout-- == 0)) {
+        RemoveEntryList (Link);
+        Trb->Packet->TransactionStatus = EFI_TIMEOUT;
+        TrbEvent = Trb->Event;
+        SdMmcFreeTrb (Trb);
+        DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n", TrbEvent));
+        gBS->SignalEvent (TrbEvent);
+      }
+      //
+      // The head TRB is still in progress, or the lines are still busy
+      // after a timeout. Check again in the next tick.
+      //
+      return;
     }
-    if ((!InfiniteWait) && (Trb->Timeout-- == 0)) {
-      RemoveEntryList (Link);
-      Trb->Packet->TransactionStatus = EFI_TIMEOUT;
-      TrbEvent = Trb->Event;
-      SdMmcFreeTrb (Trb);
-      DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n", TrbEvent));
-      gBS->SignalEvent (TrbEvent);
+
+    if ((Status == EFI_CRC_ERROR) && (Trb->Retries > 0)) {
+      Trb->Retries--;
+      Trb->Started = FALSE;
       return;
     }
-  } else if ((Trb != NULL) && (Status == EFI_CRC_ERROR) && (Trb->Retries > 0)) {
-    Trb->Retries--;
-    Trb->Started = FALSE;
-  } else if ((Trb != NULL)) {
+
     RemoveEntryList (Link);
     Trb->Packet->TransactionStatus = Status;
     TrbEvent = Trb->Event;
@@ -222,7 +236,6 @@ Done:
     DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p with %r\n", TrbEvent, Status));
     gBS->SignalEvent (TrbEvent);
   }
-  return;
 }
 
 /**
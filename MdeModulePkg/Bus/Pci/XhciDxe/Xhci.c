@@ -1412,6 +1412,7 @@ XhcAsyncInterruptTransfer (
           EndPointAddress,
           DeviceSpeed,
           MaximumPacketLength,
+          PollingInterval,
           DataLength,
           CallBackFunction,
           Context
@@ -1421,6 +1422,8 @@ XhcAsyncInterruptTransfer (
     goto ON_EXIT;
   }
 
+  XhcUpdateAsyncTimer (Xhc);
+
   //
   // Ring the doorbell
   //
@@ -1862,10 +1865,12 @@ XhcExitBootService (
   // and uninstall the XHCI protocl.
   //
   gBS->SetTimer (Xhc->PollTimer, TimerCancel, 0);
+  XhcDumpPollStatistics (Xhc);
   XhcHaltHC (Xhc, XHC_GENERIC_TIMEOUT);
 
   if (Xhc->PollTimer != NULL) {
     gBS->CloseEvent (Xhc->PollTimer);
+    Xhc->PollTimer = NULL;
   }
 
   XhcClearBiosOwnership (Xhc);
@@ -2028,14 +2033,9 @@ XhcDriverBindingStart (
   XhcRunHC(Xhc, XHC_GENERIC_TIMEOUT);
 
   //
-  // Start the asynchronous interrupt monitor
+  // The asynchronous interrupt monitor is started by XhcUpdateAsyncTimer()
+  // once the first async interrupt transfer is submitted.
   //
-  Status = gBS->SetTimer (Xhc->PollTimer, TimerPeriodic, XHC_ASYNC_TIMER_INTERVAL);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((EFI_D_ERROR, "XhcDriverBindingStart: failed to start async interrupt monitor\n"));
-    XhcHaltHC (Xhc, XHC_GENERIC_TIMEOUT);
-    goto FREE_POOL;
-  }
 
   //
   // Create event to stop the HC when exit boot service.
@@ -2178,6 +2178,7 @@ XhcDriverBindingStop (
   // and uninstall the XHCI protocl.
   //
   gBS->SetTimer (Xhc->PollTimer, TimerCancel, 0);
+  XhcDumpPollStatistics (Xhc);
 
   //
   // Disable the device slots occupied by these devices on its downstream ports.
@@ -2197,6 +2198,7 @@ XhcDriverBindingStop (
 
   if (Xhc->PollTimer != NULL) {
     gBS->CloseEvent (Xhc->PollTimer);
+    Xhc->PollTimer = NULL;
   }
 
   if (Xhc->ExitBootServiceEvent != NULL) {
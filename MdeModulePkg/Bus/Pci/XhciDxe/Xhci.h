@@ -25,6 +25,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTimeLib.h>
 
 #include <IndustryStandard/Pci.h>
 
@@ -64,6 +66,13 @@ typedef struct _USB_DEV_CONTEXT      USB_DEV_CONTEXT;
 // The unit is 100us, takes 1ms as interval.
 //
 #define XHC_ASYNC_TIMER_INTERVAL     EFI_TIMER_PERIOD_MILLISECONDS(1)
+//
+// Upper bound of the async transfer timer interval. The timer is re-armed
+// with the shortest polling interval of the active async interrupt transfers,
+// clamped to this value so that slow endpoints (hubs) don't add latency.
+// The unit is 100us, takes 16ms as interval.
+//
+#define XHC_ASYNC_TIMER_MAX_INTERVAL EFI_TIMER_PERIOD_MILLISECONDS(16)
 
 //
 // XHC raises TPL to TPL_NOTIFY to serialize all its operations
@@ -217,6 +226,17 @@ struct _USB_XHCI_INSTANCE {
   EFI_EVENT                 ExitBootServiceEvent;
   EFI_EVENT                 PollTimer;
   LIST_ENTRY                AsyncIntTransfers;
+  //
+  // Period the PollTimer is currently armed with, 0 if it is cancelled.
+  //
+  UINT64                    PollTimerInterval;
+  //
+  // Async monitor and sync transfer polling statistics for profiling.
+  //
+  UINT64                    AsyncPollCount;
+  UINT64                    AsyncPollIdleCount;
+  UINT64                    AsyncPollTime;    ///< In nanoseconds
+  UINT64                    SyncPollCount;
 
   UINT8                     CapLength;    ///< Capability Register Length
   XHC_HCSPARAMS1            HcSParams1;   ///< Structural Parameters 1
@@ -1063,6 +1063,27 @@ IsAsyncIntTrb (
 }
 
 
+/**
+  Check whether the hardware has posted a new event to the event ring
+  since the last check, without touching any XHCI register.
+
+  @param  Xhc             The XHCI Instance.
+
+  @retval TRUE            A new event TRB is pending at the dequeue pointer.
+  @retval FALSE           The event ring has no new event.
+
+**/
+BOOLEAN
+XhcHasPendingEvent (
+  IN  USB_XHCI_INSTANCE   *Xhc
+  )
+{
+  EVENT_RING              *EvtRing;
+
+  EvtRing = &Xhc->EventRing;
+  return (BOOLEAN) (EvtRing->EventRingDequeue->CycleBit == EvtRing->EventRingCCS);
+}
+
 /**
   Check the URB's execution result and update the URB's
   result accordingly.
@@ -1299,9 +1320,19 @@ XhcExecTransfer (
   XhcRingDoorBell (Xhc, SlotId, Dci);
 
   for (Index = 0; Index < Loop; Index++) {
-    Finished = XhcCheckUrbResult (Xhc, Urb);
-    if (Finished) {
-      break;
+    //
+    // Only walk the event ring when the hardware has posted a new
+    // event or the URB was completed by a previous check. A halted
+    // or failed controller posts no event, so check it on every poll
+    // to report EFI_USB_ERR_SYSTEM instead of timing out.
+    //
+    if (Urb->Finished || XhcHasPendingEvent (Xhc) ||
+        XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+      Xhc->SyncPollCount++;
+      Finished = XhcCheckUrbResult (Xhc, Urb);
+      if (Finished) {
+        break;
+      }
     }
     gBS->Stall (XHC_1_MICROSECOND);
   }
@@ -1363,6 +1394,7 @@ XhciDelAsyncIntTransfer (
       RemoveEntryList (&Urb->UrbList);
       FreePool (Urb->Data);
       XhcFreeUrb (Xhc, Urb);
+      XhcUpdateAsyncTimer (Xhc);
       return EFI_SUCCESS;
     }
   }
@@ -1402,6 +1434,8 @@ XhciDelAllAsyncIntTransfers (
     FreePool (Urb->Data);
     XhcFreeUrb (Xhc, Urb);
   }
+
+  XhcUpdateAsyncTimer (Xhc);
 }
 
 /**
@@ -1413,6 +1447,7 @@ XhciDelAllAsyncIntTransfers (
   @param EpAddr         Endpoint addrress
   @param DevSpeed       The device speed
   @param MaxPacket      The max packet length of the endpoint
+  @param PollingInterval The polling interval of the endpoint
   @param DataLen        The length of data buffer
   @param Callback       The function to call when data is transferred
   @param Context        The context to the callback
@@ -1427,6 +1462,7 @@ XhciInsertAsyncIntTransfer (
   IN UINT8                              EpAddr,
   IN UINT8                              DevSpeed,
   IN UINTN                              MaxPacket,
+  IN UINTN                              PollingInterval,
   IN UINTN                              DataLen,
   IN EFI_ASYNC_USB_TRANSFER_CALLBACK    Callback,
   IN VOID                               *Context
@@ -1460,6 +1496,18 @@ XhciInsertAsyncIntTransfer (
     return NULL;
   }
 
+  //
+  // High speed and super speed endpoints express the interval as
+  // 2^(bInterval-1) microframes, full and low speed ones in frames.
+  //
+  if ((DevSpeed == EFI_USB_SPEED_HIGH) || (DevSpeed == EFI_USB_SPEED_SUPER)) {
+    Urb->PollingInterval = EFI_TIMER_PERIOD_MICROSECONDS (
+                             LShiftU64 (125, MIN (PollingInterval, 16) - 1)
+                             );
+  } else {
+    Urb->PollingInterval = EFI_TIMER_PERIOD_MILLISECONDS (PollingInterval);
+  }
+
   //
   // New asynchronous transfer must inserted to the head.
   // Check the comments in XhcMoniteAsyncRequests
@@ -1551,6 +1599,89 @@ ON_ERROR:
   return EFI_DEVICE_ERROR;
 }
 
+/**
+  Re-arm the async transfer monitor timer according to the active
+  asynchronous interrupt transfers.
+
+  Every async interrupt transfer has a single TD outstanding until it is
+  re-submitted by the monitor, so polling with the shortest endpoint
+  interval doesn't lose any completion. Transfers of a device whose slot
+  is disabled are skipped by the monitor, so they don't count. The timer
+  is cancelled when there is no active async interrupt transfer at all.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhcUpdateAsyncTimer (
+  IN USB_XHCI_INSTANCE    *Xhc
+  )
+{
+  LIST_ENTRY              *Entry;
+  URB                     *Urb;
+  UINT64                  Interval;
+  EFI_STATUS              Status;
+
+  if (Xhc->PollTimer == NULL) {
+    return;
+  }
+
+  Interval = 0;
+  for (Entry = GetFirstNode (&Xhc->AsyncIntTransfers);
+       !IsNull (&Xhc->AsyncIntTransfers, Entry);
+       Entry = GetNextNode (&Xhc->AsyncIntTransfers, Entry)) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr) == 0) {
+      continue;
+    }
+    if (Interval == 0) {
+      Interval = XHC_ASYNC_TIMER_MAX_INTERVAL;
+    }
+    Interval = MIN (Interval, Urb->PollingInterval);
+  }
+  if (Interval != 0) {
+    Interval = MAX (Interval, XHC_ASYNC_TIMER_INTERVAL);
+  }
+
+  if (Interval == Xhc->PollTimerInterval) {
+    return;
+  }
+
+  if (Interval == 0) {
+    Status = gBS->SetTimer (Xhc->PollTimer, TimerCancel, 0);
+  } else {
+    Status = gBS->SetTimer (Xhc->PollTimer, TimerPeriodic, Interval);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcUpdateAsyncTimer: failed to set async monitor timer - %r\n", Status));
+    return;
+  }
+
+  Xhc->PollTimerInterval = Interval;
+}
+
+/**
+  Dump the polling statistics of the XHCI instance.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhcDumpPollStatistics (
+  IN USB_XHCI_INSTANCE    *Xhc
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "XhcDumpPollStatistics: async polls %Ld (idle %Ld), async time %Ld us, sync polls %Ld\n",
+    Xhc->AsyncPollCount,
+    Xhc->AsyncPollIdleCount,
+    DivU64x32 (Xhc->AsyncPollTime, 1000),
+    Xhc->SyncPollCount
+    ));
+}
+
 /**
   Interrupt transfer periodic check handler.
 
@@ -1573,10 +1704,18 @@ XhcMonitorAsyncRequests (
   UINT8                   SlotId;
   EFI_STATUS              Status;
   EFI_TPL                 OldTpl;
+  UINT64                  StartTick;
+  BOOLEAN                 Idle;
+  BOOLEAN                 Halted;
 
   OldTpl = gBS->RaiseTPL (XHC_TPL);
 
-  Xhc    = (USB_XHCI_INSTANCE*) Context;
+  Xhc       = (USB_XHCI_INSTANCE*) Context;
+  StartTick = GetPerformanceCounter ();
+  Idle      = TRUE;
+  Halted    = (BOOLEAN) (XhcIsHalt (Xhc) || XhcIsSysError (Xhc));
+
+  Xhc->AsyncPollCount++;
 
   EFI_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncIntTransfers) {
     Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
@@ -1591,14 +1730,21 @@ XhcMonitorAsyncRequests (
 
     //
     // Check the result of URB execution. If it is still
-    // active, check the next one.
+    // active, check the next one. The event ring is drained by the
+    // first check, which also completes the other async URBs, so
+    // only go to the hardware when there is a new event, or when the
+    // controller is halted and the URB has to be failed.
     //
-    XhcCheckUrbResult (Xhc, Urb);
+    if (!Urb->Finished && (Halted || XhcHasPendingEvent (Xhc))) {
+      XhcCheckUrbResult (Xhc, Urb);
+    }
 
     if (!Urb->Finished) {
       continue;
     }
 
+    Idle = FALSE;
+
     //
     // Flush any PCI posted write transactions from a PCI host
     // bridge to system memory.
@@ -1656,6 +1802,12 @@ XhcMonitorAsyncRequests (
 
     XhcUpdateAsyncRequest (Xhc, Urb);
   }
+
+  if (Idle) {
+    Xhc->AsyncPollIdleCount++;
+  }
+  Xhc->AsyncPollTime += GetElapsedTimeInNanoSecond (StartTick, GetPerformanceCounter ());
+
   gBS->RestoreTPL (OldTpl);
 }
 
@@ -2564,6 +2716,12 @@ XhcDisableSlotCmd (
   Xhc->UsbDevContext[SlotId].Enabled = FALSE;
   Xhc->UsbDevContext[SlotId].SlotId  = 0;
 
+  //
+  // The async interrupt transfers of the device stay queued until UsbBus
+  // removes them, but they are no longer polled.
+  //
+  XhcUpdateAsyncTimer (Xhc);
+
   return Status;
 }
 
@@ -2671,6 +2829,12 @@ XhcDisableSlotCmd64 (
   Xhc->UsbDevContext[SlotId].Enabled = FALSE;
   Xhc->UsbDevContext[SlotId].SlotId  = 0;
 
+  //
+  // The async interrupt transfers of the device stay queued until UsbBus
+  // removes them, but they are no longer polled.
+  //
+  XhcUpdateAsyncTimer (Xhc);
+
   return Status;
 }
 
@@ -192,6 +192,10 @@ typedef struct _URB {
   BOOLEAN                         Finished;
 
   TRB_TEMPLATE                    *EvtTrb;
+  //
+  // Polling interval of async interrupt transfer, in 100ns unit
+  //
+  UINT64                          PollingInterval;
 } URB;
 
 //
@@ -855,6 +859,7 @@ XhciDelAllAsyncIntTransfers (
   @param EpAddr         Endpoint addrress
   @param DevSpeed       The device speed
   @param MaxPacket      The max packet length of the endpoint
+  @param PollingInterval The polling interval of the endpoint
   @param DataLen        The length of data buffer
   @param Callback       The function to call when data is transferred
   @param Context        The context to the callback
@@ -869,6 +874,7 @@ XhciInsertAsyncIntTransfer (
   IN UINT8                              EpAddr,
   IN UINT8                              DevSpeed,
   IN UINTN                              MaxPacket,
+  IN UINTN                              PollingInterval,
   IN UINTN                              DataLen,
   IN EFI_ASYNC_USB_TRANSFER_CALLBACK    Callback,
   IN VOID                               *Context
@@ -945,6 +951,29 @@ XhcRingDoorBell (
   IN UINT8                Dci
   );
 
+/**
+  Re-arm the async transfer monitor timer according to the active
+  asynchronous interrupt transfers.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhcUpdateAsyncTimer (
+  IN USB_XHCI_INSTANCE    *Xhc
+  );
+
+/**
+  Dump the polling statistics of the XHCI instance.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhcDumpPollStatistics (
+  IN USB_XHCI_INSTANCE    *Xhc
+  );
+
 /**
   Interrupt transfer periodic check handler.
 
@@ -650,6 +650,9 @@ UsbFindChild (
 /**
   Enumerate and configure the new device on the port of this HUB interface.
 
+  The caller is responsible for waiting for the connection to be stable
+  (USB_WAIT_PORT_STABLE_STALL) before calling this function.
+
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
   @param  ResetIsNeeded         The boolean to control whether skip the reset of the port.
@@ -674,13 +677,19 @@ UsbEnumerateNewDev (
   UINTN                   Address;
   UINT8                   Config;
   EFI_STATUS              Status;
+  CHAR8                   PerfString[USB_PERF_STRING_LENGTH];
 
   Parent  = HubIf->Device;
   Bus     = Parent->Bus;
   HubApi  = HubIf->HubApi;
   Address = Bus->MaxDevices;
 
-  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  //
+  // Record the enumeration time of each device, identified by its
+  // parent hub address and port, in the FPDT.
+  //
+  AsciiSPrint (PerfString, sizeof (PerfString), "UsbEnum %d.%d", Parent->Address, Port);
+  PERF_INMODULE_BEGIN (PerfString);
 
   //
   // Hub resets the device for at least 10 milliseconds.
@@ -693,6 +702,7 @@ UsbEnumerateNewDev (
     if (EFI_ERROR (Status)) {
       DEBUG ((EFI_D_ERROR, "UsbEnumerateNewDev: failed to reset port %d - %r\n", Port, Status));
 
+      PERF_INMODULE_END (PerfString);
       return Status;
     }
     DEBUG (( EFI_D_INFO, "UsbEnumerateNewDev: hub port %d is reset\n", Port));
@@ -703,6 +713,7 @@ UsbEnumerateNewDev (
   Child = UsbCreateDevice (HubIf, Port);
 
   if (Child == NULL) {
+    PERF_INMODULE_END (PerfString);
     return EFI_OUT_OF_RESOURCES;
   }
 
@@ -850,6 +861,7 @@ UsbEnumerateNewDev (
     (EFI_IO_BUS_USB | EFI_IOB_PC_HOTPLUG),
     Bus->DevicePath
     );
+  PERF_INMODULE_END (PerfString);
   return EFI_SUCCESS;
 
 ON_ERROR:
@@ -867,6 +879,7 @@ ON_ERROR:
   //
   // EDKII UHCI/EHCI doesn't get impacted as it's make sense to reserve s/w resource till it gets unplugged.
   //
+  PERF_INMODULE_END (PerfString);
   return Status;
 }
 
@@ -874,18 +887,27 @@ ON_ERROR:
 /**
   Process the events on the port.
 
+  If a new device is connected to the port, it isn't enumerated here but
+  reported through NewDevice, so that the caller can wait for the connection
+  of all the changed ports to be stable once and then enumerate the devices
+  through UsbEnumeratePortDevice(). The port change is left pending until
+  then.
+
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
+  @param  NewDevice             Returns USB_PORT_NEW_DEVICE if a new device is
+                                connected, or'ed with USB_PORT_SKIP_RESET if
+                                the port is already reset. 0 otherwise.
 
-  @retval EFI_SUCCESS           The device is enumerated (added or removed).
-  @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
-  @retval Others                Failed to enumerate the device.
+  @retval EFI_SUCCESS           The port events are processed.
+  @retval Others                Failed to process the port events.
 
 **/
 EFI_STATUS
 UsbEnumeratePort (
-  IN USB_INTERFACE        *HubIf,
-  IN UINT8                Port
+  IN  USB_INTERFACE        *HubIf,
+  IN  UINT8                Port,
+  OUT UINT8                *NewDevice
   )
 {
   USB_HUB_API             *HubApi;
@@ -893,8 +915,9 @@ UsbEnumeratePort (
   EFI_USB_PORT_STATUS     PortState;
   EFI_STATUS              Status;
 
-  Child   = NULL;
-  HubApi  = HubIf->HubApi;
+  Child      = NULL;
+  HubApi     = HubIf->HubApi;
+  *NewDevice = 0;
 
   //
   // Host learns of the new device by polling the hub for port changes.
@@ -975,24 +998,121 @@ UsbEnumeratePort (
 
   if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_CONNECTION)) {
     //
-    // Now, new device connected, enumerate and configure the device
+    // Now, new device connected, let the caller enumerate and configure
+    // the device once the connection is stable.
     //
     DEBUG (( EFI_D_INFO, "UsbEnumeratePort: new device connected at port %d\n", Port));
+    *NewDevice = USB_PORT_NEW_DEVICE;
     if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
-      Status = UsbEnumerateNewDev (HubIf, Port, FALSE);
-    } else {
-      Status = UsbEnumerateNewDev (HubIf, Port, TRUE);
+      *NewDevice |= USB_PORT_SKIP_RESET;
     }
-
-  } else {
-    DEBUG (( EFI_D_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
+    return EFI_SUCCESS;
   }
 
+  DEBUG (( EFI_D_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
+
   HubApi->ClearPortChange (HubIf, Port);
   return Status;
 }
 
 
+/**
+  Enumerate the new device reported by UsbEnumeratePort() and clear
+  the port change.
+
+  @param  HubIf                 The HUB that has the device connected.
+  @param  Port                  The port index of the hub (started with zero).
+  @param  NewDevice             The value returned by UsbEnumeratePort().
+
+  @retval EFI_SUCCESS           The device is enumerated.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
+  @retval Others                Failed to enumerate the device.
+
+**/
+EFI_STATUS
+UsbEnumeratePortDevice (
+  IN USB_INTERFACE        *HubIf,
+  IN UINT8                Port,
+  IN UINT8                NewDevice
+  )
+{
+  EFI_STATUS              Status;
+
+  Status = UsbEnumerateNewDev (
+             HubIf,
+             Port,
+             (BOOLEAN) !USB_BIT_IS_SET (NewDevice, USB_PORT_SKIP_RESET)
+             );
+
+  HubIf->HubApi->ClearPortChange (HubIf, Port);
+  return Status;
+}
+
+
+/**
+  Process the events on the ports of the hub, then enumerate the newly
+  connected devices.
+
+  Instead of waiting USB_WAIT_PORT_STABLE_STALL for each new device in
+  turn, the connection debounce interval is waited once for all the ports
+  with a new device, so that several devices connected at the same time
+  (multi-port KVM dongles, devices behind a newly attached hub) don't
+  serialize their debounce time. The devices themselves are still reset
+  and addressed one at a time, as only one device may respond to the
+  default address.
+
+  @param  HubIf                 The HUB to enumerate.
+  @param  ChangeMap             The port change bitmap of the hub, port
+                                index starting with bit 1. NULL to check
+                                all the ports.
+
+**/
+VOID
+UsbEnumerateHubPorts (
+  IN USB_INTERFACE        *HubIf,
+  IN UINT8                *ChangeMap OPTIONAL
+  )
+{
+  UINT8                   NewDevice[USB_MAX_HUB_PORT];
+  BOOLEAN                 Pending;
+  UINT8                   Byte;
+  UINT8                   Bit;
+  UINT8                   Index;
+
+  Pending = FALSE;
+
+  //
+  // HUB starts its port index with 1.
+  //
+  Byte  = 0;
+  Bit   = 1;
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    NewDevice[Index] = 0;
+    if ((ChangeMap == NULL) || USB_BIT_IS_SET (ChangeMap[Byte], USB_BIT (Bit))) {
+      UsbEnumeratePort (HubIf, Index, &NewDevice[Index]);
+      if (NewDevice[Index] != 0) {
+        Pending = TRUE;
+      }
+    }
+
+    USB_NEXT_BIT (Byte, Bit);
+  }
+
+  if (!Pending) {
+    return;
+  }
+
+  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    if (NewDevice[Index] != 0) {
+      UsbEnumeratePortDevice (HubIf, Index, NewDevice[Index]);
+    }
+  }
+}
+
+
 /**
   Enumerate all the changed hub ports.
 
@@ -1008,8 +1128,6 @@ UsbHubEnumeration (
   )
 {
   USB_INTERFACE           *HubIf;
-  UINT8                   Byte;
-  UINT8                   Bit;
   UINT8                   Index;
   USB_DEVICE              *Child;
 
@@ -1029,19 +1147,7 @@ UsbHubEnumeration (
     return ;
   }
 
-  //
-  // HUB starts its port index with 1.
-  //
-  Byte  = 0;
-  Bit   = 1;
-
-  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
-    if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
-      UsbEnumeratePort (HubIf, Index);
-    }
-
-    USB_NEXT_BIT (Byte, Bit);
-  }
+  UsbEnumerateHubPorts (HubIf, HubIf->ChangeMap);
 
   UsbHubAckHubStatus (HubIf->Device);
 
@@ -1077,7 +1183,7 @@ UsbRootHubEnumeration (
       DEBUG (( EFI_D_INFO, "UsbEnumeratePort: The device disconnect fails at port %d from root hub %p, try again\n", Index, RootHub));
       UsbRemoveDevice (Child);
     }
-
-    UsbEnumeratePort (RootHub, Index);
   }
+
+  UsbEnumerateHubPorts (RootHub, NULL);
 }
@@ -22,6 +22,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
             }                 \
           } while (0)
 
+//
+// Hub port enumeration result reported by UsbEnumeratePort().
+//
+#define USB_PORT_NEW_DEVICE       BIT0
+#define USB_PORT_SKIP_RESET       BIT1
+
+//
+// Max number of downstream ports of a hub.
+//
+#define USB_MAX_HUB_PORT          255
+
+//
+// Max length of the FPDT measurement string of a device enumeration.
+//
+#define USB_PERF_STRING_LENGTH    32
+
 
 //
 // Common interface used by usb bus enumeration process.
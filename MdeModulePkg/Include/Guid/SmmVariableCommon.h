@@ -77,6 +77,12 @@ typedef struct {
 // The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO
 //
 #define SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO                14
+//
+// The payload for these functions is SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH.
+//
+#define SMM_VARIABLE_FUNCTION_GET_VARIABLE_BATCH                    15
+
+#define SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH                    16
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -99,6 +105,33 @@ typedef struct {
   CHAR16      Name[1];
 } SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE;
 
+///
+/// This structure is used to communicate with SMI handler by the batched
+/// GetVariable and SetVariable. It is followed by EntryCount entries of
+/// SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY, each of them
+/// SMM_VARIABLE_BATCH_ENTRY_SIZE () bytes long for the NameSize and DataSize
+/// it is sent with.
+///
+typedef struct {
+  UINTN       EntryCount;
+} SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH;
+
+typedef struct {
+  EFI_STATUS                                Status;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE  Variable;
+} SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY;
+
+///
+/// Size of a batch entry, without including the variable name and data.
+///
+#define SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE  (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY, Variable.Name))
+
+///
+/// Size of a batch entry, which keeps the next entry naturally aligned.
+///
+#define SMM_VARIABLE_BATCH_ENTRY_SIZE(NameSize, DataSize) \
+  ALIGN_VALUE (SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE + (NameSize) + (DataSize), sizeof (UINTN))
+
 ///
 /// This structure is used to communicate with SMI handler by GetNextVariableName.
 ///
@@ -132,12 +165,13 @@ typedef struct {
 } SMM_VARIABLE_COMMUNICATE_GET_PAYLOAD_SIZE;
 
 typedef struct {
-  BOOLEAN                 *ReadLock;
+  UINT32                  *SequenceCount;
   BOOLEAN                 *PendingUpdate;
   BOOLEAN                 *HobFlushComplete;
   VARIABLE_STORE_HEADER   *RuntimeHobCache;
   VARIABLE_STORE_HEADER   *RuntimeNvCache;
   VARIABLE_STORE_HEADER   *RuntimeVolatileCache;
+  UINT32                  *RebuildCount;
 } SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT;
 
 typedef struct {
@@ -0,0 +1,31 @@
+/** @file
+  Provides the time elapsed between two values of the performance counter.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ELAPSED_TIME_LIB_H__
+#define __ELAPSED_TIME_LIB_H__
+
+/**
+  Get the time elapsed between two values returned by GetPerformanceCounter().
+
+  The performance counter may count up or down, and may roll over once
+  between the two values.
+
+  @param[in] StartCounter    The counter value at the start of the interval.
+  @param[in] EndCounter      The counter value at the end of the interval.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+EFIAPI
+GetElapsedTimeInNanoSecond (
+  IN UINT64    StartCounter,
+  IN UINT64    EndCounter
+  );
+
+#endif
@@ -0,0 +1,64 @@
+/** @file
+  EDKII Mapped Media Protocol.
+
+  This protocol is installed next to EFI_BLOCK_IO_PROTOCOL on handles whose
+  media contents live in system memory, such as RAM disks and the partitions
+  found on them. It lets consumers read the media contents in place instead
+  of having them copied through the Block I/O protocol first.
+
+  The memory range returned by GetRange() stays valid as long as the protocol
+  remains installed and the media ID does not change. Consumers must only read
+  from it; writes still go through EFI_BLOCK_IO_PROTOCOL.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_MAPPED_MEDIA_PROTOCOL_H__
+#define __EDKII_MAPPED_MEDIA_PROTOCOL_H__
+
+#define EDKII_MAPPED_MEDIA_PROTOCOL_GUID \
+  { \
+    0x6b3e2d4f, 0x7a18, 0x4c59, { 0x9e, 0x21, 0x3d, 0x8c, 0x5f, 0x47, 0xb1, 0x0a } \
+  }
+
+typedef struct _EDKII_MAPPED_MEDIA_PROTOCOL EDKII_MAPPED_MEDIA_PROTOCOL;
+
+#define EDKII_MAPPED_MEDIA_PROTOCOL_REVISION  0x00010000
+
+/**
+  Return the memory range that backs the media.
+
+  @param[in]  This             Pointer to the EDKII_MAPPED_MEDIA_PROTOCOL
+                               instance.
+  @param[in]  MediaId          The media ID the caller expects.
+  @param[out] StartingAddress  The address of the first byte of the media.
+  @param[out] Length           The length of the media in bytes.
+
+  @retval EFI_SUCCESS            The memory range was returned.
+  @retval EFI_MEDIA_CHANGED      MediaId does not match the current media.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_INVALID_PARAMETER  StartingAddress or Length is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MAPPED_MEDIA_GET_RANGE) (
+  IN  EDKII_MAPPED_MEDIA_PROTOCOL  *This,
+  IN  UINT32                       MediaId,
+  OUT EFI_PHYSICAL_ADDRESS         *StartingAddress,
+  OUT UINT64                       *Length
+  );
+
+///
+/// EDKII_MAPPED_MEDIA_PROTOCOL exposes the memory that backs a block device.
+///
+struct _EDKII_MAPPED_MEDIA_PROTOCOL {
+  UINT64                        Revision;
+  EDKII_MAPPED_MEDIA_GET_RANGE  GetRange;
+};
+
+extern EFI_GUID gEdkiiMappedMediaProtocolGuid;
+
+#endif
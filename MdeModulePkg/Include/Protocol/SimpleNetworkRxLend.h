@@ -0,0 +1,96 @@
+/** @file
+  EDKII Simple Network Receive Lend Protocol.
+
+  This protocol is installed next to EFI_SIMPLE_NETWORK_PROTOCOL by network
+  drivers that can lend their receive buffers to the consumer of the network
+  interface, instead of copying each received packet into a buffer provided
+  by the consumer as EFI_SIMPLE_NETWORK_PROTOCOL.Receive() does.
+
+  A lent buffer is owned by the consumer until it is given back by Release().
+  The driver may stop lending buffers at any time, e.g. when too many of them
+  are outstanding; the consumer then receives the next packets through
+  EFI_SIMPLE_NETWORK_PROTOCOL.Receive(). Both receive paths return the packets
+  in the order they were received.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL_H__
+#define __EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL_H__
+
+#define EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL_GUID \
+  { \
+    0x7970d651, 0xae03, 0x4d02, { 0x9b, 0x6b, 0x3a, 0xd9, 0xf4, 0x1f, 0xb2, 0xfd } \
+  }
+
+typedef struct _EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL;
+
+#define EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL_REVISION  0x00010000
+
+/**
+  Receive a packet in a buffer lent by the network interface.
+
+  This function must be called at or below TPL_CALLBACK.
+
+  @param[in]  This             Pointer to the EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL
+                               instance.
+  @param[out] Frame            The received packet, starting with the media header.
+  @param[out] FrameLength      The length of the received packet in bytes.
+  @param[out] Context          The value to pass to Release() to give the buffer
+                               back to the network interface.
+
+  @retval EFI_SUCCESS            A packet is returned in Frame.
+  @retval EFI_NOT_STARTED        The network interface has not been started.
+  @retval EFI_NOT_READY          No packet has been received.
+  @retval EFI_OUT_OF_RESOURCES   No buffer can be lent at the moment. The packet,
+                                 if any, must be received through
+                                 EFI_SIMPLE_NETWORK_PROTOCOL.Receive().
+  @retval EFI_UNSUPPORTED        The network interface does not lend buffers in
+                                 its current configuration.
+  @retval EFI_DEVICE_ERROR       The command could not be sent to the network
+                                 interface.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_RX_LEND_RECEIVE) (
+  IN  EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL  *This,
+  OUT VOID                                   **Frame,
+  OUT UINTN                                  *FrameLength,
+  OUT VOID                                   **Context
+  );
+
+/**
+  Give a buffer returned by Receive() back to the network interface.
+
+  The buffer may be given back after the network interface is shut down, but
+  not after the protocol is uninstalled. This function may be called at or
+  below TPL_NOTIFY.
+
+  @param[in]  This             Pointer to the EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL
+                               instance.
+  @param[in]  Context          The Context returned by Receive() with the buffer.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_SIMPLE_NETWORK_RX_LEND_RELEASE) (
+  IN  EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL  *This,
+  IN  VOID                                   *Context
+  );
+
+///
+/// EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL lends the receive buffers of a
+/// network interface to its consumer.
+///
+struct _EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL {
+  UINT64                                Revision;
+  EDKII_SIMPLE_NETWORK_RX_LEND_RECEIVE  Receive;
+  EDKII_SIMPLE_NETWORK_RX_LEND_RELEASE  Release;
+};
+
+extern EFI_GUID gEdkiiSimpleNetworkRxLendProtocolGuid;
+
+#endif
@@ -0,0 +1,112 @@
+/** @file
+  EDKII Variable Batch Protocol.
+
+  The variable driver that forwards variable services to SMM produces this
+  protocol, so that a caller that reads or writes many variables in a row,
+  such as the boot manager enumerating Boot#### options, pays the cost of
+  one SMM communication per batch instead of one per variable.
+
+  Every entry of a batch is handled like a separate GetVariable() or
+  SetVariable() call, in order, and gets its own status.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_VARIABLE_BATCH_PROTOCOL_H__
+#define __EDKII_VARIABLE_BATCH_PROTOCOL_H__
+
+#define EDKII_VARIABLE_BATCH_PROTOCOL_GUID \
+  { \
+    0x4f2a9c1e, 0x83b7, 0x4d26, { 0xa5, 0x0c, 0x6e, 0x19, 0xd8, 0x73, 0xb4, 0x2f } \
+  }
+
+typedef struct _EDKII_VARIABLE_BATCH_PROTOCOL  EDKII_VARIABLE_BATCH_PROTOCOL;
+
+///
+/// One variable of a batch.
+///
+typedef struct {
+  ///
+  /// The name and vendor GUID of the variable.
+  ///
+  CHAR16                *VariableName;
+  EFI_GUID              *VendorGuid;
+  ///
+  /// GetVariables() returns the attributes of the variable. SetVariables()
+  /// sets the variable with them.
+  ///
+  UINT32                Attributes;
+  ///
+  /// GetVariables() takes the size of the Data buffer, and returns the size
+  /// of the variable data, or the size needed with EFI_BUFFER_TOO_SMALL.
+  /// SetVariables() writes DataSize bytes of Data.
+  ///
+  UINTN                 DataSize;
+  VOID                  *Data;
+  ///
+  /// The status GetVariable() or SetVariable() would have returned for the
+  /// entry.
+  ///
+  EFI_STATUS            Status;
+} EDKII_VARIABLE_BATCH_ENTRY;
+
+/**
+  Read several variables.
+
+  Each entry is read as GetVariable() would read it, and its Status is set.
+  Data may be NULL in the entries whose DataSize is 0, to learn the size of
+  the variables.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries.
+  @param[in, out] Entries       The variables to read.
+
+  @retval EFI_SUCCESS           The batch was processed, the Status of each
+                                entry tells whether the entry was read.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_VARIABLE_BATCH_GET_VARIABLES) (
+  IN     EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN     UINTN                          EntryCount,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  );
+
+/**
+  Write several variables.
+
+  Each entry is written as SetVariable() would write it, in order, and its
+  Status is set. A failed entry does not stop the following ones.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries.
+  @param[in, out] Entries       The variables to write.
+
+  @retval EFI_SUCCESS           The batch was processed, the Status of each
+                                entry tells whether the entry was written.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_VARIABLE_BATCH_SET_VARIABLES) (
+  IN     EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN     UINTN                          EntryCount,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  );
+
+///
+/// EDKII_VARIABLE_BATCH_PROTOCOL reads or writes many variables at once.
+///
+struct _EDKII_VARIABLE_BATCH_PROTOCOL {
+  EDKII_VARIABLE_BATCH_GET_VARIABLES  GetVariables;
+  EDKII_VARIABLE_BATCH_SET_VARIABLES  SetVariables;
+};
+
+extern EFI_GUID gEdkiiVariableBatchProtocolGuid;
+
+#endif
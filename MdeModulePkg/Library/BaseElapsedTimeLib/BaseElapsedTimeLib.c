@@ -0,0 +1,50 @@
+/** @file
+  Provides the time elapsed between two values of the performance counter.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTimeLib.h>
+
+/**
+  Get the time elapsed between two values returned by GetPerformanceCounter().
+
+  The performance counter may count up or down, and may roll over once
+  between the two values.
+
+  @param[in] StartCounter    The counter value at the start of the interval.
+  @param[in] EndCounter      The counter value at the end of the interval.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+EFIAPI
+GetElapsedTimeInNanoSecond (
+  IN UINT64    StartCounter,
+  IN UINT64    EndCounter
+  )
+{
+  UINT64    StartValue;
+  UINT64    EndValue;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (StartValue > EndValue) {
+    //
+    // The performance counter counts down.
+    //
+    if (StartCounter >= EndCounter) {
+      return GetTimeInNanoSecond (StartCounter - EndCounter);
+    }
+    return GetTimeInNanoSecond (StartCounter - EndValue + StartValue - EndCounter);
+  }
+
+  if (EndCounter >= StartCounter) {
+    return GetTimeInNanoSecond (EndCounter - StartCounter);
+  }
+  return GetTimeInNanoSecond (EndValue - StartCounter + EndCounter - StartValue);
+}
@@ -844,30 +844,31 @@ EfiBootManagerIsValidLoadOptionVariableName (
 }
 
 /**
-  Build the Boot#### or Driver#### option from the VariableName.
+  Build the Boot#### or Driver#### option from the data of the variable.
 
   @param  VariableName          Variable name of the load option
   @param  VendorGuid            Variable GUID of the load option
+  @param  Variable              The data of the variable.
+  @param  VariableSize          The size of the data of the variable.
   @param  Option                Return the load option.
 
-  @retval EFI_SUCCESS     Get the option just been created
-  @retval EFI_NOT_FOUND   Failed to get the new option
+  @retval EFI_SUCCESS            Get the option just been created
+  @retval EFI_INVALID_PARAMETER  The variable is not a valid load option.
 
 **/
 EFI_STATUS
-EFIAPI
-EfiBootManagerVariableToLoadOptionEx (
+BmVariableDataToLoadOption (
   IN CHAR16                           *VariableName,
   IN EFI_GUID                         *VendorGuid,
+  IN UINT8                            *Variable,
+  IN UINTN                            VariableSize,
   IN OUT EFI_BOOT_MANAGER_LOAD_OPTION *Option
   )
 {
   EFI_STATUS                         Status;
   UINT32                             Attribute;
   UINT16                             FilePathSize;
-  UINT8                              *Variable;
   UINT8                              *VariablePtr;
-  UINTN                              VariableSize;
   EFI_DEVICE_PATH_PROTOCOL           *FilePath;
   UINT8                              *OptionalData;
   UINT32                             OptionalDataSize;
@@ -875,27 +876,14 @@ EfiBootManagerVariableToLoadOptionEx (
   EFI_BOOT_MANAGER_LOAD_OPTION_TYPE  OptionType;
   UINT16                             OptionNumber;
 
-  if ((VariableName == NULL) || (Option == NULL)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
   if (!EfiBootManagerIsValidLoadOptionVariableName (VariableName, &OptionType, &OptionNumber)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Read the variable
-  //
-  GetVariable2 (VariableName, VendorGuid, (VOID **) &Variable, &VariableSize);
-  if (Variable == NULL) {
-    return EFI_NOT_FOUND;
-  }
-
   //
   // Validate *#### variable data.
   //
   if (!BmValidateOption(Variable, VariableSize)) {
-    FreePool (Variable);
     return EFI_INVALID_PARAMETER;
   }
 
@@ -949,6 +937,52 @@ EfiBootManagerVariableToLoadOptionEx (
 
   CopyGuid (&Option->VendorGuid, VendorGuid);
 
+  return Status;
+}
+
+/**
+  Build the Boot#### or Driver#### option from the VariableName.
+
+  @param  VariableName          Variable name of the load option
+  @param  VendorGuid            Variable GUID of the load option
+  @param  Option                Return the load option.
+
+  @retval EFI_SUCCESS     Get the option just been created
+  @retval EFI_NOT_FOUND   Failed to get the new option
+
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerVariableToLoadOptionEx (
+  IN CHAR16                           *VariableName,
+  IN EFI_GUID                         *VendorGuid,
+  IN OUT EFI_BOOT_MANAGER_LOAD_OPTION *Option
+  )
+{
+  EFI_STATUS                         Status;
+  UINT8                              *Variable;
+  UINTN                              VariableSize;
+  EFI_BOOT_MANAGER_LOAD_OPTION_TYPE  OptionType;
+  UINT16                             OptionNumber;
+
+  if ((VariableName == NULL) || (Option == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!EfiBootManagerIsValidLoadOptionVariableName (VariableName, &OptionType, &OptionNumber)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Read the variable
+  //
+  GetVariable2 (VariableName, VendorGuid, (VOID **) &Variable, &VariableSize);
+  if (Variable == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = BmVariableDataToLoadOption (VariableName, VendorGuid, Variable, VariableSize, Option);
+
   FreePool (Variable);
   return Status;
 }
@@ -1053,7 +1087,11 @@ EfiBootManagerGetLoadOptions (
   UINTN                         Index;
   UINTN                         OptionIndex;
   EFI_BOOT_MANAGER_LOAD_OPTION  *Options;
-  CHAR16                        OptionName[BM_OPTION_NAME_LEN];
+  CHAR16                        (*OptionNames)[BM_OPTION_NAME_LEN];
+  CHAR16                        **OptionNamePtrs;
+  VOID                          **Variables;
+  UINTN                         *VariableSizes;
+  EFI_STATUS                    *VariableStatuses;
   UINT16                        OptionNumber;
   BM_COLLECT_LOAD_OPTIONS_PARAM Param;
 
@@ -1074,14 +1112,48 @@ EfiBootManagerGetLoadOptions (
     Options = AllocatePool (*OptionCount * sizeof (EFI_BOOT_MANAGER_LOAD_OPTION));
     ASSERT (Options != NULL);
 
+    //
+    // Read all the Boot####, or Driver#### variables at once.
+    //
+    OptionNames    = AllocatePool (*OptionCount * sizeof (*OptionNames));
+    OptionNamePtrs = AllocatePool (*OptionCount * sizeof (CHAR16 *));
+    Variables      = AllocatePool (*OptionCount * sizeof (VOID *));
+    VariableSizes    = AllocatePool (*OptionCount * sizeof (UINTN));
+    VariableStatuses = AllocatePool (*OptionCount * sizeof (EFI_STATUS));
+    ASSERT (OptionNames != NULL && OptionNamePtrs != NULL && Variables != NULL && VariableSizes != NULL && VariableStatuses != NULL);
+
+    for (Index = 0; Index < *OptionCount; Index++) {
+      UnicodeSPrint (OptionNames[Index], sizeof (OptionNames[Index]), L"%s%04x", mBmLoadOptionName[LoadOptionType], OptionOrder[Index]);
+      OptionNamePtrs[Index] = OptionNames[Index];
+    }
+    BmGetVariables (*OptionCount, OptionNamePtrs, &gEfiGlobalVariableGuid, Variables, VariableSizes, VariableStatuses);
+
     OptionIndex = 0;
     for (Index = 0; Index < *OptionCount; Index++) {
       OptionNumber = OptionOrder[Index];
-      UnicodeSPrint (OptionName, sizeof (OptionName), L"%s%04x", mBmLoadOptionName[LoadOptionType], OptionNumber);
 
-      Status = EfiBootManagerVariableToLoadOption (OptionName, &Options[OptionIndex]);
+      if ((Variables[Index] == NULL) && (VariableStatuses[Index] != EFI_NOT_FOUND) && EFI_ERROR (VariableStatuses[Index])) {
+        //
+        // The option may exist but could not be read, keep its reference.
+        //
+        DEBUG ((EFI_D_ERROR, "[Bds] Failed to read %s - %r\n", OptionNames[Index], VariableStatuses[Index]));
+        continue;
+      }
+
+      if (Variables[Index] == NULL) {
+        Status = EFI_NOT_FOUND;
+      } else {
+        Status = BmVariableDataToLoadOption (
+                   OptionNames[Index],
+                   &gEfiGlobalVariableGuid,
+                   Variables[Index],
+                   VariableSizes[Index],
+                   &Options[OptionIndex]
+                   );
+        FreePool (Variables[Index]);
+      }
       if (EFI_ERROR (Status)) {
-        DEBUG ((EFI_D_INFO, "[Bds] %s doesn't exist - Update ****Order variable to remove the reference!!", OptionName));
+        DEBUG ((EFI_D_INFO, "[Bds] %s doesn't exist - Update ****Order variable to remove the reference!!", OptionNames[Index]));
         EfiBootManagerDeleteLoadOptionVariable (OptionNumber, LoadOptionType);
       } else {
         ASSERT (Options[OptionIndex].OptionNumber == OptionNumber);
@@ -1089,6 +1161,12 @@ EfiBootManagerGetLoadOptions (
       }
     }
 
+    FreePool (OptionNames);
+    FreePool (OptionNamePtrs);
+    FreePool (Variables);
+    FreePool (VariableSizes);
+    FreePool (VariableStatuses);
+
     if (OptionOrder != NULL) {
       FreePool (OptionOrder);
     }
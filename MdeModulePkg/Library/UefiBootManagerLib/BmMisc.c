@@ -371,6 +371,119 @@ BmSetVariableAndReportStatusCodeOnError (
   return Status;
 }
 
+/**
+  Read several variables of one vendor GUID, and allocate a buffer for each of
+  them like GetVariable2 () does.
+
+  The variables are read through EDKII_VARIABLE_BATCH_PROTOCOL when the
+  variable driver produces it, which costs two batched reads for all the
+  variables instead of two GetVariable () calls for each of them. A variable
+  the batch fails to read for any other reason than EFI_NOT_FOUND is read
+  again on its own with GetVariable2 ().
+
+  @param  Count                  The number of variables.
+  @param  VariableNames          The names of the variables.
+  @param  VendorGuid             The vendor GUID of the variables.
+  @param  Values                 Return the data of each variable in a buffer
+                                 the caller frees, or NULL if it was not read.
+  @param  ValueSizes             Return the data size of each variable.
+  @param  Statuses               Return the status GetVariable2 () would have
+                                 returned for each variable.
+**/
+VOID
+BmGetVariables (
+  IN  UINTN                         Count,
+  IN  CHAR16                        **VariableNames,
+  IN  EFI_GUID                      *VendorGuid,
+  OUT VOID                          **Values,
+  OUT UINTN                         *ValueSizes,
+  OUT EFI_STATUS                    *Statuses
+  )
+{
+  EFI_STATUS                        Status;
+  EDKII_VARIABLE_BATCH_PROTOCOL     *VariableBatch;
+  EDKII_VARIABLE_BATCH_ENTRY        *Entries;
+  UINTN                             *EntryIndex;
+  UINTN                             ReadCount;
+  UINTN                             Index;
+
+  ZeroMem (Values, Count * sizeof (VOID *));
+  ZeroMem (ValueSizes, Count * sizeof (UINTN));
+
+  Entries    = NULL;
+  EntryIndex = NULL;
+  Status = gBS->LocateProtocol (&gEdkiiVariableBatchProtocolGuid, NULL, (VOID **) &VariableBatch);
+  if (!EFI_ERROR (Status)) {
+    Entries    = AllocateZeroPool (Count * sizeof (EDKII_VARIABLE_BATCH_ENTRY));
+    EntryIndex = AllocatePool (Count * sizeof (UINTN));
+  }
+
+  if ((Entries == NULL) || (EntryIndex == NULL)) {
+    for (Index = 0; Index < Count; Index++) {
+      Statuses[Index] = GetVariable2 (VariableNames[Index], VendorGuid, &Values[Index], &ValueSizes[Index]);
+    }
+  } else {
+    //
+    // Get the sizes of all the variables first.
+    //
+    for (Index = 0; Index < Count; Index++) {
+      Entries[Index].VariableName = VariableNames[Index];
+      Entries[Index].VendorGuid   = VendorGuid;
+    }
+    VariableBatch->GetVariables (VariableBatch, Count, Entries);
+
+    //
+    // Then read the existing variables into buffers of their size. A batch
+    // that failed as a whole, e.g. on an SMM communication error, sets the
+    // same error on all its entries, so only EFI_NOT_FOUND tells that a
+    // variable doesn't exist; read the others again one at a time.
+    //
+    ReadCount = 0;
+    for (Index = 0; Index < Count; Index++) {
+      Statuses[Index] = Entries[Index].Status;
+      if (Statuses[Index] == EFI_NOT_FOUND) {
+        continue;
+      }
+      if (Statuses[Index] == EFI_BUFFER_TOO_SMALL) {
+        Entries[Index].Data = AllocatePool (Entries[Index].DataSize);
+        if (Entries[Index].Data != NULL) {
+          CopyMem (&Entries[ReadCount], &Entries[Index], sizeof (EDKII_VARIABLE_BATCH_ENTRY));
+          EntryIndex[ReadCount++] = Index;
+          continue;
+        }
+      }
+      Statuses[Index] = GetVariable2 (VariableNames[Index], VendorGuid, &Values[Index], &ValueSizes[Index]);
+    }
+    VariableBatch->GetVariables (VariableBatch, ReadCount, Entries);
+
+    for (Index = 0; Index < ReadCount; Index++) {
+      if (Entries[Index].Status == EFI_SUCCESS) {
+        Values[EntryIndex[Index]]     = Entries[Index].Data;
+        ValueSizes[EntryIndex[Index]] = Entries[Index].DataSize;
+        Statuses[EntryIndex[Index]]   = EFI_SUCCESS;
+      } else {
+        //
+        // The variable changed between the two reads, or the second batch
+        // failed.
+        //
+        FreePool (Entries[Index].Data);
+        Statuses[EntryIndex[Index]] = GetVariable2 (
+                                        VariableNames[EntryIndex[Index]],
+                                        VendorGuid,
+                                        &Values[EntryIndex[Index]],
+                                        &ValueSizes[EntryIndex[Index]]
+                                        );
+      }
+    }
+  }
+
+  if (Entries != NULL) {
+    FreePool (Entries);
+  }
+  if (EntryIndex != NULL) {
+    FreePool (EntryIndex);
+  }
+}
 
 /**
   Print the device path info.
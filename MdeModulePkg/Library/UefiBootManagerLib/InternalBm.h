@@ -43,6 +43,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/RamDisk.h>
 #include <Protocol/DeferredImageLoad.h>
 #include <Protocol/PlatformBootManager.h>
+#include <Protocol/VariableBatch.h>
 
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FileInfo.h>
@@ -139,6 +140,29 @@ BmForEachVariable (
   VOID                        *Context
   );
 
+/**
+  Read several variables of one vendor GUID, and allocate a buffer for each of
+  them like GetVariable2 () does.
+
+  @param  Count                  The number of variables.
+  @param  VariableNames          The names of the variables.
+  @param  VendorGuid             The vendor GUID of the variables.
+  @param  Values                 Return the data of each variable in a buffer
+                                 the caller frees, or NULL if it was not read.
+  @param  ValueSizes             Return the data size of each variable.
+  @param  Statuses               Return the status GetVariable2 () would have
+                                 returned for each variable.
+**/
+VOID
+BmGetVariables (
+  IN  UINTN                         Count,
+  IN  CHAR16                        **VariableNames,
+  IN  EFI_GUID                      *VendorGuid,
+  OUT VOID                          **Values,
+  OUT UINTN                         *ValueSizes,
+  OUT EFI_STATUS                    *Statuses
+  );
+
 #define BM_BOOT_DESCRIPTION_ENTRY_SIGNATURE SIGNATURE_32 ('b', 'm', 'd', 'h')
 typedef struct {
   UINT32                                    Signature;
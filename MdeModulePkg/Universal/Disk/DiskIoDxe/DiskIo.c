@@ -157,6 +157,21 @@ DiskIoDriverBindingStart (
     gDiskIoPrivateDataTemplate.BlockIo2 = NULL;
   }
 
+  //
+  // Media that lives in memory can be read in place.
+  //
+  Status = gBS->OpenProtocol (
+                  ControllerHandle,
+                  &gEdkiiMappedMediaProtocolGuid,
+                  (VOID **) &gDiskIoPrivateDataTemplate.MappedMedia,
+                  This->DriverBindingHandle,
+                  ControllerHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    gDiskIoPrivateDataTemplate.MappedMedia = NULL;
+  }
+
   //
   // Initialize the Disk IO device instance.
   //
@@ -782,6 +797,64 @@ DiskIo2RemoveCompletedTask (
   return QueueEmpty;
 }
 
+/**
+  Read the disk by copying straight out of the memory that backs it.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium to read.
+  @param Offset      The starting byte offset on the logical block I/O device to read.
+  @param Token       A pointer to the token associated with the transaction.
+                     If this field is NULL, synchronous/blocking IO is performed.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS        The data was read and the token, if any, was signaled.
+  @retval EFI_MEDIA_CHANGED  The MediaId is not for the current media.
+  @retval EFI_UNSUPPORTED    The request cannot be served from memory; the caller
+                             should go through the Block I/O protocols instead.
+**/
+EFI_STATUS
+DiskIoReadMappedMedia (
+  IN DISK_IO_PRIVATE_DATA     *Instance,
+  IN UINT32                   MediaId,
+  IN UINT64                   Offset,
+  IN EFI_DISK_IO2_TOKEN       *Token,
+  IN UINTN                    BufferSize,
+  OUT UINT8                   *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  EFI_PHYSICAL_ADDRESS   Address;
+  UINT64                 Length;
+
+  if (Instance->MappedMedia == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Reads must not overtake writes that are still queued.
+  //
+  if (!DiskIo2RemoveCompletedTask (Instance)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = Instance->MappedMedia->GetRange (Instance->MappedMedia, MediaId, &Address, &Length);
+  if (Status == EFI_MEDIA_CHANGED) {
+    return Status;
+  }
+  if (EFI_ERROR (Status) || (Offset > Length) || (BufferSize > Length - Offset)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  CopyMem (Buffer, (VOID *) (UINTN) (Address + Offset), BufferSize);
+
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+  }
+  return EFI_SUCCESS;
+}
+
 /**
   Common routine to access the disk.
 
@@ -827,6 +900,14 @@ DiskIo2ReadWriteDisk (
   Status    = EFI_SUCCESS;
   Blocking  = (BOOLEAN) ((Token == NULL) || (Token->Event == NULL));
 
+  if (!Write) {
+    Status = DiskIoReadMappedMedia (Instance, MediaId, Offset, Token, BufferSize, Buffer);
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+    Status = EFI_SUCCESS;
+  }
+
   if (Blocking) {
     //
     // Wait till pending async task is completed.
@@ -16,6 +16,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/DiskIo.h>
+#include <Protocol/MappedMedia.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiLib.h>
@@ -32,6 +33,7 @@ typedef struct {
   EFI_DISK_IO2_PROTOCOL           DiskIo2;
   EFI_BLOCK_IO_PROTOCOL           *BlockIo;
   EFI_BLOCK_IO2_PROTOCOL          *BlockIo2;
+  EDKII_MAPPED_MEDIA_PROTOCOL     *MappedMedia;
 
   UINT8                           *SharedWorkingBuffer;
 
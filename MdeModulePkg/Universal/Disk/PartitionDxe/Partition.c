@@ -496,6 +496,31 @@ PartitionDriverBindingStop (
       TypeGuid = &Private->TypeGuid;
     }
 
+    //
+    // Remove the memory mapping first so that no new in-place reader can
+    // find the child while its Block I/O protocols are going away.
+    //
+    if (Private->ParentMappedMedia != NULL) {
+      Status = gBS->UninstallProtocolInterface (
+                      ChildHandleBuffer[Index],
+                      &gEdkiiMappedMediaProtocolGuid,
+                      &Private->MappedMedia
+                      );
+      if (EFI_ERROR (Status)) {
+        Private->InStop = FALSE;
+        gBS->OpenProtocol (
+               ControllerHandle,
+               &gEfiDiskIoProtocolGuid,
+               (VOID **) &DiskIo,
+               This->DriverBindingHandle,
+               ChildHandleBuffer[Index],
+               EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+               );
+        AllChildrenStopped = FALSE;
+        continue;
+      }
+    }
+
     //
     // All Software protocols have be freed from the handle so remove it.
     // Remove the BlockIo Protocol if has.
@@ -541,6 +566,14 @@ PartitionDriverBindingStop (
 
     if (EFI_ERROR (Status)) {
       Private->InStop = FALSE;
+      if (Private->ParentMappedMedia != NULL) {
+        gBS->InstallProtocolInterface (
+               &ChildHandleBuffer[Index],
+               &gEdkiiMappedMediaProtocolGuid,
+               EFI_NATIVE_INTERFACE,
+               &Private->MappedMedia
+               );
+      }
       gBS->OpenProtocol (
              ControllerHandle,
              &gEfiDiskIoProtocolGuid,
@@ -1090,6 +1123,68 @@ PartitionFlushBlocksEx (
   return Status;
 }
 
+/**
+  Return the memory range that backs the partition.
+
+  The range is the slice of the parent media's memory range that starts at
+  the partition's first byte and ends at its last byte.
+
+  @param[in]  This             Pointer to the EDKII_MAPPED_MEDIA_PROTOCOL
+                               instance.
+  @param[in]  MediaId          The media ID the caller expects.
+  @param[out] StartingAddress  The address of the first byte of the partition.
+  @param[out] Length           The length of the partition in bytes.
+
+  @retval EFI_SUCCESS            The memory range was returned.
+  @retval EFI_MEDIA_CHANGED      MediaId does not match the current media, or
+                                 the parent media no longer covers the
+                                 partition.
+  @retval EFI_NO_MEDIA           There is no media in the device.
+  @retval EFI_INVALID_PARAMETER  StartingAddress or Length is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+PartitionMappedMediaGetRange (
+  IN  EDKII_MAPPED_MEDIA_PROTOCOL  *This,
+  IN  UINT32                       MediaId,
+  OUT EFI_PHYSICAL_ADDRESS         *StartingAddress,
+  OUT UINT64                       *Length
+  )
+{
+  EFI_STATUS              Status;
+  PARTITION_PRIVATE_DATA  *Private;
+  EFI_PHYSICAL_ADDRESS    ParentAddress;
+  UINT64                  ParentLength;
+
+  if ((StartingAddress == NULL) || (Length == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = PARTITION_DEVICE_FROM_MAPPED_MEDIA_THIS (This);
+
+  //
+  // Like the Block I/O services, let the parent validate MediaId.
+  //
+  Status = Private->ParentMappedMedia->GetRange (
+                                         Private->ParentMappedMedia,
+                                         MediaId,
+                                         &ParentAddress,
+                                         &ParentLength
+                                         );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Private->End > ParentLength) {
+    return EFI_MEDIA_CHANGED;
+  }
+
+  *StartingAddress = ParentAddress + Private->Start;
+  *Length          = Private->End - Private->Start;
+  return EFI_SUCCESS;
+}
+
 
 /**
   Create a child handle for a logical block device that represents the
@@ -1163,6 +1258,24 @@ PartitionInstallChildHandle (
   Private->BlockIo.WriteBlocks  = PartitionWriteBlocks;
   Private->BlockIo.FlushBlocks  = PartitionFlushBlocks;
 
+  //
+  // Pass the parent's memory mapping through to the child when the parent
+  // media lives in memory.
+  //
+  Status = gBS->OpenProtocol (
+                  ParentHandle,
+                  &gEdkiiMappedMediaProtocolGuid,
+                  (VOID **) &Private->ParentMappedMedia,
+                  This->DriverBindingHandle,
+                  ParentHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    Private->ParentMappedMedia = NULL;
+  }
+  Private->MappedMedia.Revision = EDKII_MAPPED_MEDIA_PROTOCOL_REVISION;
+  Private->MappedMedia.GetRange = PartitionMappedMediaGetRange;
+
   //
   // Set the BlockIO2 into Private Data.
   //
@@ -1262,6 +1375,22 @@ PartitionInstallChildHandle (
   }
 
   if (!EFI_ERROR (Status)) {
+    //
+    // The memory mapping is optional, so failing to install it only costs
+    // the child the in-place read path.
+    //
+    if (Private->ParentMappedMedia != NULL) {
+      Status = gBS->InstallProtocolInterface (
+                      &Private->Handle,
+                      &gEdkiiMappedMediaProtocolGuid,
+                      EFI_NATIVE_INTERFACE,
+                      &Private->MappedMedia
+                      );
+      if (EFI_ERROR (Status)) {
+        Private->ParentMappedMedia = NULL;
+      }
+    }
+
     //
     // Open the Parent Handle for the child
     //
@@ -23,6 +23,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/DiskIo.h>
 #include <Protocol/DiskIo2.h>
 #include <Protocol/PartitionInfo.h>
+#include <Protocol/MappedMedia.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/BaseLib.h>
@@ -50,11 +51,13 @@ typedef struct {
   EFI_BLOCK_IO_MEDIA           Media;
   EFI_BLOCK_IO_MEDIA           Media2;//For BlockIO2
   EFI_PARTITION_INFO_PROTOCOL  PartitionInfo;
+  EDKII_MAPPED_MEDIA_PROTOCOL  MappedMedia;
 
   EFI_DISK_IO_PROTOCOL         *DiskIo;
   EFI_DISK_IO2_PROTOCOL        *DiskIo2;
   EFI_BLOCK_IO_PROTOCOL        *ParentBlockIo;
   EFI_BLOCK_IO2_PROTOCOL       *ParentBlockIo2;
+  EDKII_MAPPED_MEDIA_PROTOCOL  *ParentMappedMedia;
   UINT64                       Start;
   UINT64                       End;
   UINT32                       BlockSize;
@@ -71,6 +74,7 @@ typedef struct {
 
 #define PARTITION_DEVICE_FROM_BLOCK_IO_THIS(a)  CR (a, PARTITION_PRIVATE_DATA, BlockIo, PARTITION_PRIVATE_DATA_SIGNATURE)
 #define PARTITION_DEVICE_FROM_BLOCK_IO2_THIS(a) CR (a, PARTITION_PRIVATE_DATA, BlockIo2, PARTITION_PRIVATE_DATA_SIGNATURE)
+#define PARTITION_DEVICE_FROM_MAPPED_MEDIA_THIS(a) CR (a, PARTITION_PRIVATE_DATA, MappedMedia, PARTITION_PRIVATE_DATA_SIGNATURE)
 
 //
 // Global Variables
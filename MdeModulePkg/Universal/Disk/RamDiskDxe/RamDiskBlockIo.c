@@ -34,6 +34,16 @@ EFI_BLOCK_IO2_PROTOCOL  mRamDiskBlockIo2Template = {
 };
 
 
+//
+// The EDKII_MAPPED_MEDIA_PROTOCOL instances that is installed onto the handle
+// for newly registered RAM disks
+//
+EDKII_MAPPED_MEDIA_PROTOCOL  mRamDiskMappedMediaTemplate = {
+  EDKII_MAPPED_MEDIA_PROTOCOL_REVISION,
+  RamDiskMappedMediaGetRange
+};
+
+
 /**
   Initialize the BlockIO & BlockIO2 protocol of a RAM disk device.
 
@@ -56,6 +66,11 @@ RamDiskInitBlockIo (
 
   CopyMem (BlockIo, &mRamDiskBlockIoTemplate, sizeof (EFI_BLOCK_IO_PROTOCOL));
   CopyMem (BlockIo2, &mRamDiskBlockIo2Template, sizeof (EFI_BLOCK_IO2_PROTOCOL));
+  CopyMem (
+    &PrivateData->MappedMedia,
+    &mRamDiskMappedMediaTemplate,
+    sizeof (EDKII_MAPPED_MEDIA_PROTOCOL)
+    );
 
   BlockIo->Media          = Media;
   BlockIo2->Media         = Media;
@@ -485,3 +500,49 @@ RamDiskBlkIo2FlushBlocksEx (
 
   return EFI_SUCCESS;
 }
+
+
+/**
+  Return the memory range that backs the RAM disk.
+
+  Consumers such as the Disk I/O driver use it to read the RAM disk contents
+  in place, instead of having them copied into an intermediate block buffer
+  first.
+
+  @param[in]  This             Indicates a pointer to the calling context.
+  @param[in]  MediaId          The media ID the caller expects.
+  @param[out] StartingAddress  The address of the first byte of the RAM disk.
+  @param[out] Length           The size of the RAM disk in bytes.
+
+  @retval EFI_SUCCESS             The memory range was returned.
+  @retval EFI_MEDIA_CHANGED       The MediaId does not matched the current
+                                  device.
+  @retval EFI_INVALID_PARAMETER   StartingAddress or Length is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskMappedMediaGetRange (
+  IN  EDKII_MAPPED_MEDIA_PROTOCOL *This,
+  IN  UINT32                      MediaId,
+  OUT EFI_PHYSICAL_ADDRESS        *StartingAddress,
+  OUT UINT64                      *Length
+  )
+{
+  RAM_DISK_PRIVATE_DATA           *PrivateData;
+
+  PrivateData = RAM_DISK_PRIVATE_FROM_MAPPED_MEDIA (This);
+
+  if (MediaId != PrivateData->Media.MediaId) {
+    return EFI_MEDIA_CHANGED;
+  }
+
+  if ((StartingAddress == NULL) || (Length == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *StartingAddress = PrivateData->StartingAddr;
+  *Length          = PrivateData->Size;
+
+  return EFI_SUCCESS;
+}
@@ -27,6 +27,7 @@
 #include <Protocol/RamDisk.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/BlockIo2.h>
+#include <Protocol/MappedMedia.h>
 #include <Protocol/HiiConfigAccess.h>
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/AcpiTable.h>
@@ -92,6 +93,7 @@ typedef struct {
 
   EFI_BLOCK_IO_PROTOCOL           BlockIo;
   EFI_BLOCK_IO2_PROTOCOL          BlockIo2;
+  EDKII_MAPPED_MEDIA_PROTOCOL     MappedMedia;
   EFI_BLOCK_IO_MEDIA              Media;
   EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
 
@@ -110,6 +112,7 @@ typedef struct {
 #define RAM_DISK_PRIVATE_DATA_SIGNATURE     SIGNATURE_32 ('R', 'D', 'S', 'K')
 #define RAM_DISK_PRIVATE_FROM_BLKIO(a)      CR (a, RAM_DISK_PRIVATE_DATA, BlockIo, RAM_DISK_PRIVATE_DATA_SIGNATURE)
 #define RAM_DISK_PRIVATE_FROM_BLKIO2(a)     CR (a, RAM_DISK_PRIVATE_DATA, BlockIo2, RAM_DISK_PRIVATE_DATA_SIGNATURE)
+#define RAM_DISK_PRIVATE_FROM_MAPPED_MEDIA(a) CR (a, RAM_DISK_PRIVATE_DATA, MappedMedia, RAM_DISK_PRIVATE_DATA_SIGNATURE)
 #define RAM_DISK_PRIVATE_FROM_THIS(a)       CR (a, RAM_DISK_PRIVATE_DATA, ThisInstance, RAM_DISK_PRIVATE_DATA_SIGNATURE)
 
 ///
@@ -451,6 +454,29 @@ RamDiskBlkIo2FlushBlocksEx (
   IN OUT EFI_BLOCK_IO2_TOKEN      *Token
   );
 
+/**
+  Return the memory range that backs the RAM disk.
+
+  @param[in]  This             Indicates a pointer to the calling context.
+  @param[in]  MediaId          The media ID the caller expects.
+  @param[out] StartingAddress  The address of the first byte of the RAM disk.
+  @param[out] Length           The size of the RAM disk in bytes.
+
+  @retval EFI_SUCCESS             The memory range was returned.
+  @retval EFI_MEDIA_CHANGED       The MediaId does not matched the current
+                                  device.
+  @retval EFI_INVALID_PARAMETER   StartingAddress or Length is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskMappedMediaGetRange (
+  IN  EDKII_MAPPED_MEDIA_PROTOCOL *This,
+  IN  UINT32                      MediaId,
+  OUT EFI_PHYSICAL_ADDRESS        *StartingAddress,
+  OUT UINT64                      *Length
+  );
+
 /**
   This function publish the RAM disk configuration Form.
 
@@ -686,8 +686,8 @@ RamDiskRegister (
   RamDiskInitBlockIo (PrivateData);
 
   //
-  // Install EFI_DEVICE_PATH_PROTOCOL & EFI_BLOCK_IO(2)_PROTOCOL on a new
-  // handle
+  // Install EFI_DEVICE_PATH_PROTOCOL, EFI_BLOCK_IO(2)_PROTOCOL &
+  // EDKII_MAPPED_MEDIA_PROTOCOL on a new handle
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &PrivateData->Handle,
@@ -695,6 +695,8 @@ RamDiskRegister (
                   &PrivateData->BlockIo,
                   &gEfiBlockIo2ProtocolGuid,
                   &PrivateData->BlockIo2,
+                  &gEdkiiMappedMediaProtocolGuid,
+                  &PrivateData->MappedMedia,
                   &gEfiDevicePathProtocolGuid,
                   PrivateData->DevicePath,
                   NULL
@@ -815,7 +817,8 @@ RamDiskUnregister (
         }
 
         //
-        // Uninstall the EFI_DEVICE_PATH_PROTOCOL & EFI_BLOCK_IO(2)_PROTOCOL
+        // Uninstall the EFI_DEVICE_PATH_PROTOCOL, EFI_BLOCK_IO(2)_PROTOCOL &
+        // EDKII_MAPPED_MEDIA_PROTOCOL
         //
         gBS->UninstallMultipleProtocolInterfaces (
                PrivateData->Handle,
@@ -823,6 +826,8 @@ RamDiskUnregister (
                &PrivateData->BlockIo,
                &gEfiBlockIo2ProtocolGuid,
                &PrivateData->BlockIo2,
+               &gEdkiiMappedMediaProtocolGuid,
+               &PrivateData->MappedMedia,
                &gEfiDevicePathProtocolGuid,
                (EFI_DEVICE_PATH_PROTOCOL *) PrivateData->DevicePath,
                NULL
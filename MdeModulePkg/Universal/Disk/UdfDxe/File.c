@@ -74,6 +74,8 @@ UdfOpenVolume (
     // There is no more open files. Read volume information again since it was
     // cleaned up on the last UdfClose() call.
     //
+    CleanupDirectoryIndexCache (&PrivFsData->Volume);
+
     Status = ReadUdfVolumeInformation (
       PrivFsData->BlockIo,
       PrivFsData->DiskIo,
@@ -264,6 +266,7 @@ UdfOpen (
   NewPrivFileData->FilePosition = 0;
   ZeroMem ((VOID *)&NewPrivFileData->ReadDirInfo,
            sizeof (UDF_READ_DIRECTORY_INFO));
+  ZeroMem ((VOID *)&NewPrivFileData->ExtentMap, sizeof (UDF_EXTENT_MAP));
 
   *NewHandle = &NewPrivFileData->FileIo;
 
@@ -375,7 +378,8 @@ UdfRead (
       PrivFileData->FileSize,
       &PrivFileData->FilePosition,
       Buffer,
-      &BufferSizeUint64
+      &BufferSizeUint64,
+      &PrivFileData->ExtentMap
       );
     ASSERT (BufferSizeUint64 <= MAX_UINTN);
     *BufferSize = (UINTN)BufferSizeUint64;
@@ -558,6 +562,10 @@ UdfClose (
     if (PrivFileData->ReadDirInfo.DirectoryData != NULL) {
       FreePool (PrivFileData->ReadDirInfo.DirectoryData);
     }
+
+    if (PrivFileData->ExtentMap.Extents != NULL) {
+      FreePool (PrivFileData->ExtentMap.Extents);
+    }
   }
 
   FreePool ((VOID *)PrivFileData);
@@ -1039,6 +1039,76 @@ GrowUpBufferToNextAd (
   return EFI_SUCCESS;
 }
 
+/**
+  Append an extent to the extent list being built in ReadFileInfo.
+
+  The extent is merged into the previous one when both are contiguous on disk.
+
+  @param[in, out] ReadFileInfo      Read file information pointer.
+  @param[in]      Lsn               Logical sector number of the extent.
+  @param[in]      ExtentLength      Length of the extent.
+  @param[in]      LogicalBlockSize  Logical block size of the volume.
+
+  @retval EFI_SUCCESS             The extent was appended.
+  @retval EFI_OUT_OF_RESOURCES    The extent was not appended due to lack of
+                                  resources.
+
+**/
+EFI_STATUS
+AppendFileExtent (
+  IN OUT  UDF_READ_FILE_INFO  *ReadFileInfo,
+  IN      UINT64              Lsn,
+  IN      UINT32              ExtentLength,
+  IN      UINT32              LogicalBlockSize
+  )
+{
+  UDF_FILE_EXTENT  *Extents;
+  UDF_FILE_EXTENT  *LastExtent;
+  UINTN            Count;
+
+  if (ExtentLength == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Extents = ReadFileInfo->FileData;
+  Count   = ReadFileInfo->ExtentCount;
+
+  if (Count > 0) {
+    LastExtent = &Extents[Count - 1];
+    if (MultU64x32 (LastExtent->Lsn, LogicalBlockSize) + LastExtent->Length ==
+        MultU64x32 (Lsn, LogicalBlockSize)) {
+      LastExtent->Length += ExtentLength;
+      return EFI_SUCCESS;
+    }
+  }
+
+  //
+  // The list holds 8 extents at first and doubles every time it gets full.
+  //
+  if (Count == 0) {
+    Extents = AllocatePool (8 * sizeof (UDF_FILE_EXTENT));
+  } else if (Count >= 8 && (Count & (Count - 1)) == 0) {
+    Extents = ReallocatePool (
+                Count * sizeof (UDF_FILE_EXTENT),
+                2 * Count * sizeof (UDF_FILE_EXTENT),
+                Extents
+                );
+  }
+
+  if (Extents == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Extents[Count].FileOffset = ReadFileInfo->ReadLength;
+  Extents[Count].Lsn        = Lsn;
+  Extents[Count].Length     = ExtentLength;
+
+  ReadFileInfo->FileData    = Extents;
+  ReadFileInfo->ExtentCount = Count + 1;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read data or size of either a File Entry or an Extended File Entry.
 
@@ -1102,12 +1172,14 @@ ReadFile (
   switch (ReadFileInfo->Flags) {
   case ReadFileGetFileSize:
   case ReadFileAllocateAndRead:
+  case ReadFileGetExtents:
     //
-    // Initialise ReadFileInfo structure for either getting file size, or
-    // reading file's recorded data.
+    // Initialise ReadFileInfo structure for either getting file size, reading
+    // file's recorded data, or getting the list of its extents.
     //
     ReadFileInfo->ReadLength = 0;
     ReadFileInfo->FileData = NULL;
+    ReadFileInfo->ExtentCount = 0;
     break;
   case ReadFileSeekAndRead:
     //
@@ -1284,6 +1356,19 @@ ReadFile (
           goto Error_Read_Disk_Blk;
         }
 
+        ReadFileInfo->ReadLength += ExtentLength;
+        break;
+      case ReadFileGetExtents:
+        Status = AppendFileExtent (
+          ReadFileInfo,
+          Lsn,
+          ExtentLength,
+          LogicalBlockSize
+          );
+        if (EFI_ERROR (Status)) {
+          goto Error_Alloc_Buffer_To_Next_Ad;
+        }
+
         ReadFileInfo->ReadLength += ExtentLength;
         break;
       case ReadFileSeekAndRead:
@@ -1386,7 +1471,8 @@ Done:
 
 Error_Read_Disk_Blk:
 Error_Alloc_Buffer_To_Next_Ad:
-  if (ReadFileInfo->Flags != ReadFileSeekAndRead) {
+  if (ReadFileInfo->Flags != ReadFileSeekAndRead &&
+      ReadFileInfo->FileData != NULL) {
     FreePool (ReadFileInfo->FileData);
   }
 
@@ -1398,6 +1484,393 @@ Error_Get_Aed:
   return Status;
 }
 
+/**
+  Calculate the hash of a file name for the directory name index.
+
+  @param[in]  FileName            File name string.
+
+  @return The hash of FileName.
+
+**/
+UINT32
+GetFileNameHash (
+  IN CHAR16  *FileName
+  )
+{
+  UINT32  Hash;
+
+  //
+  // FNV-1a over the UCS-2 characters of the name.
+  //
+  Hash = 0x811C9DC5;
+  while (*FileName != L'\0') {
+    Hash = (Hash ^ *FileName++) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Build the name index of a directory.
+
+  The directory's recorded data is read into memory and every FID that is
+  neither deleted nor the parent FID is hashed by its decoded name.
+
+  @param[in]  BlockIo             BlockIo interface.
+  @param[in]  DiskIo              DiskIo interface.
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  ParentIcb           ICB of the directory.
+  @param[in]  FileEntryData       FE/EFE of the directory.
+  @param[in]  Lsn                 Logical sector number of the directory's
+                                  FE/EFE.
+  @param[out] DirectoryIndex      The new directory name index.
+
+  @retval EFI_SUCCESS             The directory name index was built.
+  @retval EFI_VOLUME_CORRUPTED    The file system structures are corrupted.
+  @retval EFI_OUT_OF_RESOURCES    The directory name index was not built due to
+                                  lack of resources.
+  @retval other                   The directory name index was not built.
+
+**/
+EFI_STATUS
+BuildDirectoryIndex (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  IN   UINT64                          Lsn,
+  OUT  UDF_DIRECTORY_INDEX             **DirectoryIndex
+  )
+{
+  EFI_STATUS                      Status;
+  UDF_READ_FILE_INFO              ReadFileInfo;
+  UDF_DIRECTORY_INDEX             *Index;
+  UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
+  UINT64                          FidOffset;
+  UINT64                          FidLength;
+  UINT64                          ParentFidOffset;
+  UINTN                           EntryCount;
+  UINTN                           BucketCount;
+  UINTN                           Entry;
+  UINTN                           Bucket;
+  CHAR16                          FileName[UDF_FILENAME_LENGTH];
+
+  ReadFileInfo.Flags = ReadFileAllocateAndRead;
+
+  Status = ReadFile (
+    BlockIo,
+    DiskIo,
+    Volume,
+    ParentIcb,
+    FileEntryData,
+    &ReadFileInfo
+    );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Walk the FIDs once to validate them and count the entries to index.
+  //
+  EntryCount      = 0;
+  ParentFidOffset = MAX_UINT64;
+  for (FidOffset = 0;
+       FidOffset < ReadFileInfo.ReadLength;
+       FidOffset += FidLength) {
+    if (ReadFileInfo.ReadLength - FidOffset <
+        sizeof (UDF_FILE_IDENTIFIER_DESCRIPTOR)) {
+      Status = EFI_VOLUME_CORRUPTED;
+      goto Error_Free_Data;
+    }
+
+    FileIdentifierDesc = GET_FID_FROM_ADS (ReadFileInfo.FileData, FidOffset);
+    FidLength          = GetFidDescriptorLength (FileIdentifierDesc);
+    if (FidLength > ReadFileInfo.ReadLength - FidOffset) {
+      Status = EFI_VOLUME_CORRUPTED;
+      goto Error_Free_Data;
+    }
+
+    if (IS_FID_DELETED_FILE (FileIdentifierDesc)) {
+      continue;
+    }
+
+    if (IS_FID_PARENT_FILE (FileIdentifierDesc)) {
+      if (ParentFidOffset == MAX_UINT64) {
+        ParentFidOffset = FidOffset;
+      }
+    } else {
+      EntryCount++;
+    }
+  }
+
+  BucketCount = UDF_DIRECTORY_INDEX_MIN_BUCKETS;
+  while (BucketCount < EntryCount) {
+    BucketCount <<= 1;
+  }
+
+  Index = AllocatePool (
+            sizeof (UDF_DIRECTORY_INDEX) +
+            EntryCount * sizeof (UDF_DIRECTORY_INDEX_ENTRY) +
+            BucketCount * sizeof (UINT32)
+            );
+  if (Index == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Error_Free_Data;
+  }
+
+  Index->Signature       = UDF_DIRECTORY_INDEX_SIGNATURE;
+  Index->Lsn             = Lsn;
+  Index->DirectoryData   = ReadFileInfo.FileData;
+  Index->DirectoryLength = ReadFileInfo.ReadLength;
+  Index->ParentFidOffset = ParentFidOffset;
+  Index->EntryCount      = EntryCount;
+  Index->BucketCount     = BucketCount;
+  Index->Entries         = (UDF_DIRECTORY_INDEX_ENTRY *)(Index + 1);
+  Index->Buckets         = (UINT32 *)(Index->Entries + EntryCount);
+
+  //
+  // Hash the decoded name of every entry.
+  //
+  Entry = 0;
+  for (FidOffset = 0;
+       FidOffset < ReadFileInfo.ReadLength;
+       FidOffset += GetFidDescriptorLength (FileIdentifierDesc)) {
+    FileIdentifierDesc = GET_FID_FROM_ADS (ReadFileInfo.FileData, FidOffset);
+    if (IS_FID_DELETED_FILE (FileIdentifierDesc) ||
+        IS_FID_PARENT_FILE (FileIdentifierDesc)) {
+      continue;
+    }
+
+    Status = GetFileNameFromFid (
+               FileIdentifierDesc,
+               ARRAY_SIZE (FileName),
+               FileName
+               );
+    if (EFI_ERROR (Status)) {
+      goto Error_Free_Index;
+    }
+
+    Index->Entries[Entry].NameHash  = GetFileNameHash (FileName);
+    Index->Entries[Entry].FidOffset = FidOffset;
+    Entry++;
+  }
+
+  //
+  // Chain the entries into their buckets, keeping every chain in directory
+  // order so that the first FID with a given name is found first.
+  //
+  SetMem32 (
+    Index->Buckets,
+    BucketCount * sizeof (UINT32),
+    UDF_DIRECTORY_INDEX_END
+    );
+  for (Entry = EntryCount; Entry > 0; Entry--) {
+    Bucket = Index->Entries[Entry - 1].NameHash & (BucketCount - 1);
+    Index->Entries[Entry - 1].Next = Index->Buckets[Bucket];
+    Index->Buckets[Bucket]         = (UINT32)(Entry - 1);
+  }
+
+  *DirectoryIndex = Index;
+
+  return EFI_SUCCESS;
+
+Error_Free_Index:
+  FreePool (Index);
+
+Error_Free_Data:
+  if (ReadFileInfo.FileData != NULL) {
+    FreePool (ReadFileInfo.FileData);
+  }
+
+  return Status;
+}
+
+/**
+  Free a directory name index.
+
+  @param[in]  DirectoryIndex      Directory name index pointer.
+
+**/
+VOID
+FreeDirectoryIndex (
+  IN UDF_DIRECTORY_INDEX  *DirectoryIndex
+  )
+{
+  if (DirectoryIndex->DirectoryData != NULL) {
+    FreePool (DirectoryIndex->DirectoryData);
+  }
+
+  FreePool (DirectoryIndex);
+}
+
+/**
+  Get the name index of a directory, building it on the first call for that
+  directory.
+
+  The indexes are kept in most recently used order on the volume, and at most
+  UDF_MAX_DIRECTORY_INDEX_COUNT of them are kept.
+
+  @param[in]  BlockIo             BlockIo interface.
+  @param[in]  DiskIo              DiskIo interface.
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  ParentIcb           ICB of the directory.
+  @param[in]  FileEntryData       FE/EFE of the directory.
+  @param[out] DirectoryIndex      Directory name index pointer.
+
+  @retval EFI_SUCCESS             The directory name index was returned.
+  @retval other                   The directory name index is not available.
+
+**/
+EFI_STATUS
+GetDirectoryIndex (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  OUT  UDF_DIRECTORY_INDEX             **DirectoryIndex
+  )
+{
+  EFI_STATUS           Status;
+  UINT64               Lsn;
+  LIST_ENTRY           *Link;
+  UDF_DIRECTORY_INDEX  *Index;
+
+  Status = GetLongAdLsn (Volume, ParentIcb, &Lsn);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Link = GetFirstNode (&Volume->DirectoryIndexList);
+       !IsNull (&Volume->DirectoryIndexList, Link);
+       Link = GetNextNode (&Volume->DirectoryIndexList, Link)) {
+    Index = UDF_DIRECTORY_INDEX_FROM_LINK (Link);
+    if (Index->Lsn == Lsn) {
+      RemoveEntryList (&Index->Link);
+      InsertHeadList (&Volume->DirectoryIndexList, &Index->Link);
+      *DirectoryIndex = Index;
+      return EFI_SUCCESS;
+    }
+  }
+
+  Status = BuildDirectoryIndex (
+    BlockIo,
+    DiskIo,
+    Volume,
+    ParentIcb,
+    FileEntryData,
+    Lsn,
+    &Index
+    );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  InsertHeadList (&Volume->DirectoryIndexList, &Index->Link);
+  Volume->DirectoryIndexCount++;
+
+  if (Volume->DirectoryIndexCount > UDF_MAX_DIRECTORY_INDEX_COUNT) {
+    Link = GetPreviousNode (
+             &Volume->DirectoryIndexList,
+             &Volume->DirectoryIndexList
+             );
+    RemoveEntryList (Link);
+    FreeDirectoryIndex (UDF_DIRECTORY_INDEX_FROM_LINK (Link));
+    Volume->DirectoryIndexCount--;
+  }
+
+  *DirectoryIndex = Index;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Look a file up by its filename in a directory name index.
+
+  @param[in]  DirectoryIndex      Directory name index pointer.
+  @param[in]  FileName            File name string.
+  @param[out] FoundFid            Duplicated File Identifier Descriptor of the
+                                  found file.
+
+  @retval EFI_SUCCESS             The file was found.
+  @retval EFI_NOT_FOUND           The file was not found.
+  @retval EFI_OUT_OF_RESOURCES    The found FID was not duplicated due to lack
+                                  of resources.
+  @retval other                   The name of a candidate FID was not decoded.
+
+**/
+EFI_STATUS
+LookupDirectoryIndex (
+  IN   UDF_DIRECTORY_INDEX             *DirectoryIndex,
+  IN   CHAR16                          *FileName,
+  OUT  UDF_FILE_IDENTIFIER_DESCRIPTOR  **FoundFid
+  )
+{
+  EFI_STATUS                      Status;
+  UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
+  UDF_DIRECTORY_INDEX_ENTRY       *IndexEntry;
+  UINT32                          NameHash;
+  UINT32                          Entry;
+  CHAR16                          FoundFileName[UDF_FILENAME_LENGTH];
+
+  FileIdentifierDesc = NULL;
+
+  if (StrCmp (FileName, L"..") == 0 || StrCmp (FileName, L"\\") == 0) {
+    //
+    // The parent FID contains the location (FE/EFE) of the parent directory.
+    //
+    if (DirectoryIndex->ParentFidOffset != MAX_UINT64) {
+      FileIdentifierDesc = GET_FID_FROM_ADS (
+                             DirectoryIndex->DirectoryData,
+                             DirectoryIndex->ParentFidOffset
+                             );
+    }
+  } else {
+    NameHash = GetFileNameHash (FileName);
+    Entry    = DirectoryIndex->Buckets[
+                 NameHash & (DirectoryIndex->BucketCount - 1)];
+
+    while (Entry != UDF_DIRECTORY_INDEX_END) {
+      IndexEntry = &DirectoryIndex->Entries[Entry];
+      if (IndexEntry->NameHash == NameHash) {
+        Status = GetFileNameFromFid (
+                   GET_FID_FROM_ADS (
+                     DirectoryIndex->DirectoryData,
+                     IndexEntry->FidOffset
+                     ),
+                   ARRAY_SIZE (FoundFileName),
+                   FoundFileName
+                   );
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+
+        if (StrCmp (FileName, FoundFileName) == 0) {
+          FileIdentifierDesc = GET_FID_FROM_ADS (
+                                 DirectoryIndex->DirectoryData,
+                                 IndexEntry->FidOffset
+                                 );
+          break;
+        }
+      }
+
+      Entry = IndexEntry->Next;
+    }
+  }
+
+  if (FileIdentifierDesc == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  DuplicateFid (FileIdentifierDesc, FoundFid);
+  if (*FoundFid == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Find a file by its filename from a given Parent file.
 
@@ -1429,8 +1902,11 @@ InternalFindFile (
   UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
   UDF_READ_DIRECTORY_INFO         ReadDirInfo;
   BOOLEAN                         Found;
+  BOOLEAN                         Indexed;
   CHAR16                          FoundFileName[UDF_FILENAME_LENGTH];
   VOID                            *CompareFileEntry;
+  UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb;
+  UDF_DIRECTORY_INDEX             *DirectoryIndex;
 
   //
   // Check if both Parent->FileIdentifierDesc and Icb are NULL.
@@ -1469,74 +1945,98 @@ InternalFindFile (
     return EFI_SUCCESS;
   }
 
+  ParentIcb = (Parent->FileIdentifierDesc != NULL) ?
+              &Parent->FileIdentifierDesc->Icb :
+              Icb;
+
   //
-  // Start directory listing.
+  // Look FileName up in the directory's name index. The index is built on the
+  // first lookup in this directory and reused afterwards.
   //
-  ZeroMem ((VOID *)&ReadDirInfo, sizeof (UDF_READ_DIRECTORY_INFO));
-  Found = FALSE;
+  Found   = FALSE;
+  Indexed = FALSE;
 
-  for (;;) {
-    Status = ReadDirectoryEntry (
-      BlockIo,
-      DiskIo,
-      Volume,
-      (Parent->FileIdentifierDesc != NULL) ?
-      &Parent->FileIdentifierDesc->Icb :
-      Icb,
-      Parent->FileEntry,
-      &ReadDirInfo,
-      &FileIdentifierDesc
-      );
-    if (EFI_ERROR (Status)) {
-      if (Status == EFI_DEVICE_ERROR) {
-        Status = EFI_NOT_FOUND;
-      }
+  Status = GetDirectoryIndex (
+    BlockIo,
+    DiskIo,
+    Volume,
+    ParentIcb,
+    Parent->FileEntry,
+    &DirectoryIndex
+    );
+  if (!EFI_ERROR (Status)) {
+    Status  = LookupDirectoryIndex (DirectoryIndex, FileName, &FileIdentifierDesc);
+    Found   = (BOOLEAN)!EFI_ERROR (Status);
+    Indexed = (BOOLEAN)(Found || Status == EFI_NOT_FOUND);
+  }
 
-      break;
-    }
+  if (!Indexed) {
     //
-    // After calling function ReadDirectoryEntry(), if 'FileIdentifierDesc' is
-    // NULL, then the 'Status' must be EFI_OUT_OF_RESOURCES. Hence, if the code
-    // reaches here, 'FileIdentifierDesc' must be not NULL.
+    // The directory could not be indexed. Start directory listing.
     //
-    // The ASSERT here is for addressing a false positive NULL pointer
-    // dereference issue raised from static analysis.
-    //
-    ASSERT (FileIdentifierDesc != NULL);
+    ZeroMem ((VOID *)&ReadDirInfo, sizeof (UDF_READ_DIRECTORY_INFO));
 
-    if (FileIdentifierDesc->FileCharacteristics & PARENT_FILE) {
-      //
-      // This FID contains the location (FE/EFE) of the parent directory of this
-      // directory (Parent), and if FileName is either ".." or "\\", then it's
-      // the expected FID.
-      //
-      if (StrCmp (FileName, L"..") == 0 || StrCmp (FileName, L"\\") == 0) {
-        Found = TRUE;
-        break;
-      }
-    } else {
-      Status = GetFileNameFromFid (FileIdentifierDesc, ARRAY_SIZE (FoundFileName), FoundFileName);
+    for (;;) {
+      Status = ReadDirectoryEntry (
+        BlockIo,
+        DiskIo,
+        Volume,
+        ParentIcb,
+        Parent->FileEntry,
+        &ReadDirInfo,
+        &FileIdentifierDesc
+        );
       if (EFI_ERROR (Status)) {
+        if (Status == EFI_DEVICE_ERROR) {
+          Status = EFI_NOT_FOUND;
+        }
+
         break;
       }
+      //
+      // After calling function ReadDirectoryEntry(), if 'FileIdentifierDesc'
+      // is NULL, then the 'Status' must be EFI_OUT_OF_RESOURCES. Hence, if the
+      // code reaches here, 'FileIdentifierDesc' must be not NULL.
+      //
+      // The ASSERT here is for addressing a false positive NULL pointer
+      // dereference issue raised from static analysis.
+      //
+      ASSERT (FileIdentifierDesc != NULL);
 
-      if (StrCmp (FileName, FoundFileName) == 0) {
+      if (FileIdentifierDesc->FileCharacteristics & PARENT_FILE) {
         //
-        // FID has been found. Prepare to find its respective FE/EFE.
+        // This FID contains the location (FE/EFE) of the parent directory of
+        // this directory (Parent), and if FileName is either ".." or "\\",
+        // then it's the expected FID.
         //
-        Found = TRUE;
-        break;
+        if (StrCmp (FileName, L"..") == 0 || StrCmp (FileName, L"\\") == 0) {
+          Found = TRUE;
+          break;
+        }
+      } else {
+        Status = GetFileNameFromFid (FileIdentifierDesc, ARRAY_SIZE (FoundFileName), FoundFileName);
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+
+        if (StrCmp (FileName, FoundFileName) == 0) {
+          //
+          // FID has been found. Prepare to find its respective FE/EFE.
+          //
+          Found = TRUE;
+          break;
+        }
       }
-    }
 
-    FreePool ((VOID *)FileIdentifierDesc);
-  }
+      FreePool ((VOID *)FileIdentifierDesc);
+    }
 
-  if (ReadDirInfo.DirectoryData != NULL) {
-    //
-    // Free all allocated resources for the directory listing.
-    //
-    FreePool (ReadDirInfo.DirectoryData);
+    if (ReadDirInfo.DirectoryData != NULL) {
+      //
+      // Free all allocated resources for the directory listing.
+      //
+      FreePool (ReadDirInfo.DirectoryData);
+    }
   }
 
   if (Found) {
@@ -2333,6 +2833,28 @@ Error_Find_File:
   return Status;
 }
 
+/**
+  Free all directory name indexes cached for an UDF volume.
+
+  @param[in] Volume UDF volume information structure.
+
+**/
+VOID
+CleanupDirectoryIndexCache (
+  IN UDF_VOLUME_INFO  *Volume
+  )
+{
+  LIST_ENTRY  *Link;
+
+  while (!IsListEmpty (&Volume->DirectoryIndexList)) {
+    Link = GetFirstNode (&Volume->DirectoryIndexList);
+    RemoveEntryList (Link);
+    FreeDirectoryIndex (UDF_DIRECTORY_INDEX_FROM_LINK (Link));
+  }
+
+  Volume->DirectoryIndexCount = 0;
+}
+
 /**
   Clean up in-memory UDF file information.
 
@@ -2788,6 +3310,146 @@ Out_Free:
   return Status;
 }
 
+/**
+  Find the extent of an extent map that contains a given file position.
+
+  @param[in]  ExtentMap           Extent map pointer.
+  @param[in]  Position            File position.
+
+  @return The index of the last extent starting at or before Position.
+
+**/
+UINTN
+FindFileExtent (
+  IN  UDF_EXTENT_MAP  *ExtentMap,
+  IN  UINT64          Position
+  )
+{
+  UDF_FILE_EXTENT  *Extents;
+  UINTN            Index;
+  UINTN            Low;
+  UINTN            High;
+  UINTN            Middle;
+
+  Extents = ExtentMap->Extents;
+
+  //
+  // Sequential reads stay within the extent used last, or move on to the one
+  // that follows it.
+  //
+  Index = ExtentMap->LastExtent;
+  if (Index < ExtentMap->ExtentCount && Extents[Index].FileOffset <= Position) {
+    if (Position - Extents[Index].FileOffset < Extents[Index].Length) {
+      return Index;
+    }
+
+    if (Index + 1 < ExtentMap->ExtentCount &&
+        Position - Extents[Index + 1].FileOffset < Extents[Index + 1].Length) {
+      return Index + 1;
+    }
+  }
+
+  Low  = 0;
+  High = ExtentMap->ExtentCount;
+  while (High - Low > 1) {
+    Middle = (Low + High) / 2;
+    if (Extents[Middle].FileOffset <= Position) {
+      Low = Middle;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return Low;
+}
+
+/**
+  Seek a file and read its data into memory, using its extent map.
+
+  @param[in]      BlockIo       BlockIo interface.
+  @param[in]      DiskIo        DiskIo interface.
+  @param[in]      Volume        UDF volume information structure.
+  @param[in, out] ExtentMap     Extent map of the file.
+  @param[in]      FileSize      Size of the file.
+  @param[in, out] FilePosition  File position.
+  @param[in, out] Buffer        File data.
+  @param[in, out] BufferSize    Read size.
+
+  @retval EFI_SUCCESS          File seeked and read.
+  @retval EFI_NO_MEDIA         The device has no media.
+  @retval EFI_DEVICE_ERROR     The device reported an error.
+
+**/
+EFI_STATUS
+ReadFileDataFromExtentMap (
+  IN      EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN      EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN      UDF_VOLUME_INFO        *Volume,
+  IN OUT  UDF_EXTENT_MAP         *ExtentMap,
+  IN      UINT64                 FileSize,
+  IN OUT  UINT64                 *FilePosition,
+  IN OUT  VOID                   *Buffer,
+  IN OUT  UINT64                 *BufferSize
+  )
+{
+  EFI_STATUS       Status;
+  UDF_FILE_EXTENT  *Extent;
+  UINTN            Index;
+  UINT64           Position;
+  UINT64           BytesLeft;
+  UINT64           DataOffset;
+  UINT64           Offset;
+  UINT64           DataLength;
+
+  Position  = *FilePosition;
+  BytesLeft = *BufferSize;
+  if (Position >= FileSize) {
+    BytesLeft = 0;
+  } else if (BytesLeft > FileSize - Position) {
+    //
+    // About to read beyond the EOF -- truncate it.
+    //
+    BytesLeft = FileSize - Position;
+  }
+
+  DataOffset = 0;
+  Index      = FindFileExtent (ExtentMap, Position);
+
+  while (BytesLeft > 0 && Index < ExtentMap->ExtentCount) {
+    Extent = &ExtentMap->Extents[Index];
+    Offset = Position - Extent->FileOffset;
+    if (Offset >= Extent->Length) {
+      Index++;
+      continue;
+    }
+
+    DataLength = MIN (Extent->Length - Offset, BytesLeft);
+
+    Status = DiskIo->ReadDisk (
+      DiskIo,
+      BlockIo->Media->MediaId,
+      MultU64x32 (Extent->Lsn, Volume->LogicalVolDesc.LogicalBlockSize) +
+      Offset,
+      (UINTN)DataLength,
+      (VOID *)((UINT8 *)Buffer + DataOffset)
+      );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    ExtentMap->LastExtent = Index;
+
+    DataOffset += DataLength;
+    Position   += DataLength;
+    BytesLeft  -= DataLength;
+  }
+
+  *BufferSize   = DataOffset;
+  *FilePosition = Position;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Seek a file and read its data into memory on an UDF volume.
 
@@ -2799,6 +3461,8 @@ Out_Free:
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
+  @param[in, out] ExtentMap     Extent map of the file, built on first use.
+                                Optional.
 
   @retval EFI_SUCCESS          File seeked and read.
   @retval EFI_UNSUPPORTED      Extended Allocation Descriptors not supported.
@@ -2818,11 +3482,53 @@ ReadFileData (
   IN      UINT64                 FileSize,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
-  IN OUT  UINT64                 *BufferSize
+  IN OUT  UINT64                 *BufferSize,
+  IN OUT  UDF_EXTENT_MAP         *ExtentMap  OPTIONAL
   )
 {
-  EFI_STATUS          Status;
-  UDF_READ_FILE_INFO  ReadFileInfo;
+  EFI_STATUS              Status;
+  UDF_READ_FILE_INFO      ReadFileInfo;
+  UDF_FE_RECORDING_FLAGS  RecordingFlags;
+
+  RecordingFlags = GET_FE_RECORDING_FLAGS (File->FileEntry);
+  if (ExtentMap != NULL &&
+      (RecordingFlags == LongAdsSequence ||
+       RecordingFlags == ShortAdsSequence)) {
+    if (ExtentMap->Extents == NULL) {
+      //
+      // Walk the file's Allocation Descriptors once, and keep its extents for
+      // the next reads.
+      //
+      ReadFileInfo.Flags = ReadFileGetExtents;
+
+      Status = ReadFile (
+                 BlockIo,
+                 DiskIo,
+                 Volume,
+                 &File->FileIdentifierDesc->Icb,
+                 File->FileEntry,
+                 &ReadFileInfo
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      ExtentMap->Extents     = ReadFileInfo.FileData;
+      ExtentMap->ExtentCount = ReadFileInfo.ExtentCount;
+      ExtentMap->LastExtent  = 0;
+    }
+
+    return ReadFileDataFromExtentMap (
+             BlockIo,
+             DiskIo,
+             Volume,
+             ExtentMap,
+             FileSize,
+             FilePosition,
+             Buffer,
+             BufferSize
+             );
+  }
 
   ReadFileInfo.Flags         = ReadFileSeekAndRead;
   ReadFileInfo.FilePosition  = *FilePosition;
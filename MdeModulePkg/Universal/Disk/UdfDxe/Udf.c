@@ -176,6 +176,8 @@ UdfDriverBindingStart (
   PrivFsData->DiskIo    = DiskIo;
   PrivFsData->Handle    = ControllerHandle;
 
+  InitializeListHead (&PrivFsData->Volume.DirectoryIndexList);
+
   //
   // Set up SimpleFs protocol
   //
@@ -270,6 +272,7 @@ UdfDriverBindingStop (
       NULL
       );
 
+    CleanupDirectoryIndexCache (&PrivFsData->Volume);
     FreePool ((VOID *)PrivFsData);
   }
 
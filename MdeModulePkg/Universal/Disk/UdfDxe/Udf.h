@@ -134,6 +134,7 @@ typedef enum {
   ReadFileGetFileSize,
   ReadFileAllocateAndRead,
   ReadFileSeekAndRead,
+  ReadFileGetExtents,
 } UDF_READ_FILE_FLAGS;
 
 typedef struct {
@@ -143,8 +144,29 @@ typedef struct {
   UINT64               FilePosition;
   UINT64               FileSize;
   UINT64               ReadLength;
+  UINTN                ExtentCount;
 } UDF_READ_FILE_INFO;
 
+//
+// A run of file data that is contiguous both in the file and on disk.
+// Physically adjacent Allocation Descriptors are merged into one extent.
+//
+typedef struct {
+  UINT64  FileOffset;
+  UINT64  Lsn;
+  UINT64  Length;
+} UDF_FILE_EXTENT;
+
+//
+// Extents of an open file, built on its first read so that later reads and
+// seeks don't need to walk (and re-read) its Allocation Descriptors.
+//
+typedef struct {
+  UDF_FILE_EXTENT  *Extents;
+  UINTN            ExtentCount;
+  UINTN            LastExtent;
+} UDF_EXTENT_MAP;
+
 #pragma pack(1)
 
 typedef struct {
@@ -318,6 +340,8 @@ typedef struct {
   UDF_PARTITION_DESCRIPTOR       PartitionDesc;
   UDF_FILE_SET_DESCRIPTOR        FileSetDesc;
   UINTN                          FileEntrySize;
+  LIST_ENTRY                     DirectoryIndexList;
+  UINTN                          DirectoryIndexCount;
 } UDF_VOLUME_INFO;
 
 typedef struct {
@@ -331,6 +355,49 @@ typedef struct {
   UINT64                    FidOffset;
 } UDF_READ_DIRECTORY_INFO;
 
+//
+// Maximum number of directory name indexes kept per volume. The least
+// recently used index is dropped when a new directory gets indexed.
+//
+#define UDF_MAX_DIRECTORY_INDEX_COUNT  32
+
+#define UDF_DIRECTORY_INDEX_MIN_BUCKETS  16
+#define UDF_DIRECTORY_INDEX_END          MAX_UINT32
+
+typedef struct {
+  UINT32                    NameHash;
+  UINT32                    Next;
+  UINT64                    FidOffset;
+} UDF_DIRECTORY_INDEX_ENTRY;
+
+#define UDF_DIRECTORY_INDEX_SIGNATURE SIGNATURE_32 ('U', 'd', 'f', 'i')
+
+#define UDF_DIRECTORY_INDEX_FROM_LINK(a) \
+  CR ( \
+      a, \
+      UDF_DIRECTORY_INDEX, \
+      Link, \
+      UDF_DIRECTORY_INDEX_SIGNATURE \
+      )
+
+//
+// Name index of a directory, built when the directory is first searched. It
+// holds the directory's recorded data and hashes every FID's decoded name to
+// the FID's offset within it.
+//
+typedef struct {
+  UINTN                      Signature;
+  LIST_ENTRY                 Link;
+  UINT64                     Lsn;
+  VOID                       *DirectoryData;
+  UINT64                     DirectoryLength;
+  UINT64                     ParentFidOffset;
+  UINTN                      EntryCount;
+  UINTN                      BucketCount;
+  UINT32                     *Buckets;
+  UDF_DIRECTORY_INDEX_ENTRY  *Entries;
+} UDF_DIRECTORY_INDEX;
+
 #define PRIVATE_UDF_FILE_DATA_SIGNATURE SIGNATURE_32 ('U', 'd', 'f', 'f')
 
 #define PRIVATE_UDF_FILE_DATA_FROM_THIS(a) \
@@ -353,6 +420,7 @@ typedef struct {
   CHAR16                           FileName[UDF_FILENAME_LENGTH];
   UINT64                           FileSize;
   UINT64                           FilePosition;
+  UDF_EXTENT_MAP                   ExtentMap;
 } PRIVATE_UDF_FILE_DATA;
 
 #define PRIVATE_UDF_SIMPLE_FS_DATA_SIGNATURE SIGNATURE_32 ('U', 'd', 'f', 's')
@@ -830,6 +898,17 @@ ResolveSymlink (
   OUT  UDF_FILE_INFO          *File
   );
 
+/**
+  Free all directory name indexes cached for an UDF volume.
+
+  @param[in] Volume UDF volume information structure.
+
+**/
+VOID
+CleanupDirectoryIndexCache (
+  IN UDF_VOLUME_INFO  *Volume
+  );
+
 /**
   Clean up in-memory UDF file information.
 
@@ -965,6 +1044,8 @@ GetVolumeSize (
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
+  @param[in, out] ExtentMap     Extent map of the file, built on first use.
+                                Optional.
 
   @retval EFI_SUCCESS          File seeked and read.
   @retval EFI_UNSUPPORTED      Extended Allocation Descriptors not supported.
@@ -984,7 +1065,8 @@ ReadFileData (
   IN      UINT64                 FileSize,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
-  IN OUT  UINT64                 *BufferSize
+  IN OUT  UINT64                 *BufferSize,
+  IN OUT  UDF_EXTENT_MAP         *ExtentMap  OPTIONAL
   );
 
 /**
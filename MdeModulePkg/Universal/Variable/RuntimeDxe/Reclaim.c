@@ -85,6 +85,80 @@ GetLbaAndOffsetByAddress (
   return EFI_ABORTED;
 }
 
+/**
+  Gets the range of blocks of the variable store that the new variable
+  store contents change.
+
+  The range is returned as offsets from the start of the variable store. The
+  range starts at the first block that holds a changed byte and ends with the
+  last one, so leading blocks that a reclaim leaves as they are and trailing
+  blocks that stay erased are left out.
+
+  @param  VariableBase   Base address of the variable store.
+  @param  VariableBuffer Point to the new variable store contents.
+  @param  VarOffset      Offset of the variable store in its first block.
+  @param  BlockSize      Size of the blocks of the firmware volume.
+  @param  RangeStart     Pointer to the offset of the range for output.
+  @param  RangeEnd       Pointer to the offset of the end of the range for output,
+                         equal to RangeStart if nothing changed.
+
+**/
+VOID
+GetChangedVariableSpace (
+  IN  EFI_PHYSICAL_ADDRESS   VariableBase,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN  UINTN                  VarOffset,
+  IN  UINTN                  BlockSize,
+  OUT UINTN                  *RangeStart,
+  OUT UINTN                  *RangeEnd
+  )
+{
+  UINT8                              *Old;
+  UINT8                              *New;
+  UINTN                              StoreSize;
+  UINTN                              Start;
+  UINTN                              End;
+
+  Old       = (UINT8 *) (UINTN) VariableBase;
+  New       = (UINT8 *) VariableBuffer;
+  StoreSize = VariableBuffer->Size;
+
+  //
+  // Walk the store block by block from the front, then from the back. The
+  // first block may start before the store, and the last may end after it.
+  //
+  Start = 0;
+  End   = BlockSize - VarOffset;
+  while (Start < StoreSize) {
+    End = MIN (End, StoreSize);
+    if (CompareMem (Old + Start, New + Start, End - Start) != 0) {
+      break;
+    }
+    Start = End;
+    End  += BlockSize;
+  }
+  *RangeStart = Start;
+  if (Start == StoreSize) {
+    *RangeEnd = Start;
+    return;
+  }
+
+  End = StoreSize;
+  while (End > *RangeStart) {
+    //
+    // Start of the block that holds the byte before End, in store offsets.
+    //
+    Start = ((VarOffset + End - 1) / BlockSize) * BlockSize;
+    Start = (Start < VarOffset) ? 0 : Start - VarOffset;
+    Start = MAX (Start, *RangeStart);
+    if (CompareMem (Old + Start, New + Start, End - Start) != 0) {
+      break;
+    }
+    End = Start;
+  }
+  *RangeEnd = End;
+}
+
 /**
   Writes a buffer to variable storage space, in the working block.
 
@@ -92,6 +166,9 @@ GetLbaAndOffsetByAddress (
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
+  Only the blocks whose contents change are written, so a reclaim that leaves
+  the front of the store in place does not erase and rewrite the whole store.
+
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
 
@@ -108,8 +185,13 @@ FtwVariableSpace (
 {
   EFI_STATUS                         Status;
   EFI_HANDLE                         FvbHandle;
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL *Fvb;
   EFI_LBA                            VarLba;
   UINTN                              VarOffset;
+  UINTN                              BlockSize;
+  UINTN                              NumberOfBlocks;
+  UINTN                              RangeStart;
+  UINTN                              RangeEnd;
   UINTN                              FtwBufferSize;
   EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
 
@@ -123,7 +205,7 @@ FtwVariableSpace (
   //
   // Locate Fvb handle by address.
   //
-  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, NULL);
+  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, &Fvb);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -138,17 +220,47 @@ FtwVariableSpace (
   FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
   ASSERT (FtwBufferSize == VariableBuffer->Size);
 
+  //
+  // Skip the blocks that keep their contents. The store is assumed to sit in
+  // blocks of one size, as in GetLbaAndOffsetByAddress ().
+  //
+  RangeStart = 0;
+  RangeEnd   = FtwBufferSize;
+  Status     = Fvb->GetBlockSize (Fvb, VarLba, &BlockSize, &NumberOfBlocks);
+  if (!EFI_ERROR (Status) && BlockSize != 0) {
+    GetChangedVariableSpace (VariableBase, VariableBuffer, VarOffset, BlockSize, &RangeStart, &RangeEnd);
+    if (RangeStart != 0) {
+      VarLba    += (VarOffset + RangeStart) / BlockSize;
+      VarOffset  = 0;
+    }
+  }
+
+  mVariableModuleGlobal->ReclaimCount++;
+  mVariableModuleGlobal->ReclaimWriteSize += RangeEnd - RangeStart;
+  DEBUG ((
+    DEBUG_INFO,
+    "Variable: Reclaim rewrites 0x%x of 0x%x bytes of the variable store, 0x%lx bytes in %d reclaims\n",
+    RangeEnd - RangeStart,
+    FtwBufferSize,
+    mVariableModuleGlobal->ReclaimWriteSize,
+    mVariableModuleGlobal->ReclaimCount
+    ));
+
+  if (RangeEnd == RangeStart) {
+    return EFI_SUCCESS;
+  }
+
   //
   // FTW write record.
   //
   Status = FtwProtocol->Write (
                           FtwProtocol,
-                          VarLba,         // LBA
-                          VarOffset,      // Offset
-                          FtwBufferSize,  // NumBytes
-                          NULL,           // PrivateData NULL
-                          FvbHandle,      // Fvb Handle
-                          (VOID *) VariableBuffer // write buffer
+                          VarLba,                   // LBA
+                          VarOffset,                // Offset
+                          RangeEnd - RangeStart,    // NumBytes
+                          NULL,                     // PrivateData NULL
+                          FvbHandle,                // Fvb Handle
+                          (UINT8 *) VariableBuffer + RangeStart // write buffer
                           );
 
   return Status;
@@ -0,0 +1,182 @@
+/** @file
+  Host based benchmark of variable lookups in a large variable store.
+
+  The benchmark builds the synthetic variable store of
+  VariableLookupTestStore.c and measures the lookups per second of
+  FindVariableEx () against the plain walk of the store that it replaces.
+  The unit tests in VariableLookupUnitTest.c check the lookup results.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "VariableLookupTestStore.h"
+
+#define UNIT_TEST_NAME     "Variable Lookup Benchmark"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define LOOKUP_BENCHMARK_COUNT          0x20000
+
+/**
+  Return the elapsed time since Start in microseconds.
+**/
+STATIC
+UINT64
+BenchmarkElapsed (
+  IN clock_t  Start
+  )
+{
+  return DivU64x32 (MultU64x32 ((UINT64) (clock () - Start), 1000000), CLOCKS_PER_SEC);
+}
+
+/**
+  Print the rate of Count lookups which took Elapsed microseconds.
+**/
+STATIC
+VOID
+BenchmarkReport (
+  IN CONST CHAR8  *Name,
+  IN UINTN        Count,
+  IN UINT64       Elapsed
+  )
+{
+  printf (
+    "%s: %u lookups in %llu us, %llu lookups/sec\n",
+    Name,
+    (UINT32) Count,
+    (unsigned long long) Elapsed,
+    (unsigned long long) DivU64x64Remainder (MultU64x32 ((UINT64) Count, 1000000), MAX (Elapsed, 1), NULL)
+    );
+}
+
+/**
+  Measure random lookups of existing variables and lookups of missing ones,
+  with the store walk and with FindVariableEx ().
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MeasureLookups (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  LOOKUP_TEST_VARIABLE    *Entry;
+  EFI_STATUS              Status;
+  UINTN                   Index;
+  UINT32                  Random;
+  UINTN                   Pass;
+  clock_t                 Start;
+  CHAR16                  MissingName[32];
+
+  ZeroMem (&PtrTrack, sizeof (PtrTrack));
+  PtrTrack.StartPtr = GetStartPointer (mLookupTestStore);
+  PtrTrack.EndPtr   = GetEndPointer (mLookupTestStore);
+
+  for (Pass = 0; Pass < 2; Pass++) {
+    Random = 1;
+    Start  = clock ();
+    for (Index = 0; Index < LOOKUP_BENCHMARK_COUNT; Index++) {
+      Random = Random * 1103515245 + 12345;
+      Entry  = &mLookupTestVariables[(Random >> 8) % mLookupTestVariableCount];
+      if (Pass == 0) {
+        Status = LookupTestWalkStore (Entry->Name, Entry->Guid, &PtrTrack);
+      } else {
+        Status = FindVariableEx (Entry->Name, Entry->Guid, FALSE, &PtrTrack, TRUE);
+      }
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+    BenchmarkReport (
+      (Pass == 0) ? "Existing variables, store walk" : "Existing variables, FindVariableEx",
+      LOOKUP_BENCHMARK_COUNT,
+      BenchmarkElapsed (Start)
+      );
+  }
+
+  for (Pass = 0; Pass < 2; Pass++) {
+    Start = clock ();
+    for (Index = 0; Index < LOOKUP_BENCHMARK_COUNT / 4; Index++) {
+      UnicodeSPrint (MissingName, sizeof (MissingName), L"Boot%04x", 0x8000 + Index % 0x100);
+      if (Pass == 0) {
+        Status = LookupTestWalkStore (MissingName, &gEfiGlobalVariableGuid, &PtrTrack);
+      } else {
+        Status = FindVariableEx (MissingName, &gEfiGlobalVariableGuid, FALSE, &PtrTrack, TRUE);
+      }
+      UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+    }
+    BenchmarkReport (
+      (Pass == 0) ? "Missing variables, store walk" : "Missing variables, FindVariableEx",
+      LOOKUP_BENCHMARK_COUNT / 4,
+      BenchmarkElapsed (Start)
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  variable lookup benchmark and run them.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      BenchmarkTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (
+             &BenchmarkTests,
+             Framework,
+             "Variable Lookup Benchmark",
+             "MdeModulePkg.Variable.Lookup",
+             NULL,
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BenchmarkTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (BenchmarkTests, "Measure variable lookups", "Lookups", MeasureLookups, LookupTestSetup, LookupTestTeardown, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
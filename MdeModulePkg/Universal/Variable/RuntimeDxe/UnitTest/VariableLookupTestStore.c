@@ -0,0 +1,190 @@
+/** @file
+  Synthetic variable store shared by the variable lookup host based tests.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableLookupTestStore.h"
+
+EFI_GUID  mLookupTestPlatformGuid = {
+  0x1b3c2a6e, 0x59d4, 0x4c1f, { 0x8a, 0x3e, 0x64, 0x0d, 0x9b, 0x27, 0x5f, 0xc1 }
+};
+
+VARIABLE_STORE_HEADER  *mLookupTestStore;
+UINTN                  mLookupTestLastOffset;
+LOOKUP_TEST_VARIABLE   *mLookupTestVariables;
+UINTN                  mLookupTestVariableCount;
+
+/**
+  The tests run at boot time.
+**/
+BOOLEAN
+AtRuntime (
+  VOID
+  )
+{
+  return FALSE;
+}
+
+/**
+  Find the variable by walking the whole store, the way FindVariableEx () did
+  before the store index.
+**/
+EFI_STATUS
+LookupTestWalkStore (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack
+  )
+{
+  VARIABLE_HEADER  *InDeletedVariable;
+
+  PtrTrack->InDeletedTransitionPtr = NULL;
+  InDeletedVariable = NULL;
+
+  for ( PtrTrack->CurrPtr = PtrTrack->StartPtr
+      ; IsValidVariableHeader (PtrTrack->CurrPtr, PtrTrack->EndPtr)
+      ; PtrTrack->CurrPtr = GetNextVariablePtr (PtrTrack->CurrPtr, TRUE)
+      ) {
+    if ((PtrTrack->CurrPtr->State == VAR_ADDED ||
+         PtrTrack->CurrPtr->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) &&
+        CompareGuid (VendorGuid, GetVendorGuidPtr (PtrTrack->CurrPtr, TRUE)) &&
+        CompareMem (VariableName, GetVariableNamePtr (PtrTrack->CurrPtr, TRUE), NameSizeOfVariable (PtrTrack->CurrPtr, TRUE)) == 0) {
+      if (PtrTrack->CurrPtr->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+        InDeletedVariable = PtrTrack->CurrPtr;
+      } else {
+        PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  PtrTrack->CurrPtr = InDeletedVariable;
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
+/**
+  Append a variable to the synthetic store.
+**/
+VOID
+LookupTestAppendVariable (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid,
+  IN UINT8     State
+  )
+{
+  AUTHENTICATED_VARIABLE_HEADER  *Variable;
+
+  Variable = (AUTHENTICATED_VARIABLE_HEADER *) ((UINT8 *) mLookupTestStore + mLookupTestLastOffset);
+  ZeroMem (Variable, sizeof (*Variable));
+  Variable->StartId    = VARIABLE_DATA;
+  Variable->State      = State;
+  Variable->Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS;
+  CopyGuid (&Variable->VendorGuid, VendorGuid);
+  SetNameSizeOfVariable ((VARIABLE_HEADER *) Variable, StrSize (VariableName), TRUE);
+  SetDataSizeOfVariable ((VARIABLE_HEADER *) Variable, LOOKUP_TEST_DATA_SIZE, TRUE);
+  CopyMem (GetVariableNamePtr ((VARIABLE_HEADER *) Variable, TRUE), VariableName, StrSize (VariableName));
+  SetMem (GetVariableDataPtr ((VARIABLE_HEADER *) Variable, TRUE), LOOKUP_TEST_DATA_SIZE, 0x5A);
+
+  mLookupTestLastOffset = (UINTN) GetNextVariablePtr ((VARIABLE_HEADER *) Variable, TRUE) - (UINTN) mLookupTestStore;
+  ASSERT (mLookupTestLastOffset < mLookupTestStore->Size);
+}
+
+/**
+  Add a variable to the list of variables the store is built from.
+**/
+STATIC
+VOID
+LookupTestAddVariable (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid
+  )
+{
+  LOOKUP_TEST_VARIABLE  *Entry;
+
+  Entry = &mLookupTestVariables[mLookupTestVariableCount++];
+  StrCpyS (Entry->Name, ARRAY_SIZE (Entry->Name), VariableName);
+  Entry->Guid = VendorGuid;
+}
+
+/**
+  Build the synthetic variable store. Each test gets a fresh one.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LookupTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR16  Name[32];
+  UINTN   Index;
+  UINTN   Update;
+
+  mLookupTestStore = AllocatePool (LOOKUP_TEST_STORE_SIZE);
+  UT_ASSERT_NOT_NULL (mLookupTestStore);
+  SetMem (mLookupTestStore, LOOKUP_TEST_STORE_SIZE, 0xFF);
+  CopyGuid (&mLookupTestStore->Signature, &gEfiAuthenticatedVariableGuid);
+  mLookupTestStore->Size   = LOOKUP_TEST_STORE_SIZE;
+  mLookupTestStore->Format = VARIABLE_STORE_FORMATTED;
+  mLookupTestStore->State  = VARIABLE_STORE_HEALTHY;
+  mLookupTestLastOffset    = (UINTN) GetStartPointer (mLookupTestStore) - (UINTN) mLookupTestStore;
+
+  mLookupTestVariables = AllocateZeroPool (
+                          (LOOKUP_TEST_BOOT_OPTIONS + LOOKUP_TEST_DRIVER_OPTIONS + LOOKUP_TEST_PLATFORM_VARIABLES + 8) *
+                          sizeof (LOOKUP_TEST_VARIABLE)
+                          );
+  UT_ASSERT_NOT_NULL (mLookupTestVariables);
+  mLookupTestVariableCount = 0;
+
+  LookupTestAddVariable (L"PK", &gEfiGlobalVariableGuid);
+  LookupTestAddVariable (L"KEK", &gEfiGlobalVariableGuid);
+  LookupTestAddVariable (L"db", &gEfiImageSecurityDatabaseGuid);
+  LookupTestAddVariable (L"dbx", &gEfiImageSecurityDatabaseGuid);
+  LookupTestAddVariable (L"BootOrder", &gEfiGlobalVariableGuid);
+  LookupTestAddVariable (L"DriverOrder", &gEfiGlobalVariableGuid);
+  for (Index = 0; Index < LOOKUP_TEST_BOOT_OPTIONS; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"Boot%04x", Index);
+    LookupTestAddVariable (Name, &gEfiGlobalVariableGuid);
+  }
+  for (Index = 0; Index < LOOKUP_TEST_DRIVER_OPTIONS; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"Driver%04x", Index);
+    LookupTestAddVariable (Name, &gEfiGlobalVariableGuid);
+  }
+  for (Index = 0; Index < LOOKUP_TEST_PLATFORM_VARIABLES; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"PlatformSetup%03d", Index);
+    LookupTestAddVariable (Name, &mLookupTestPlatformGuid);
+  }
+
+  //
+  // Every variable was updated a few times, so its older instances are still
+  // in the store, ahead of the live one.
+  //
+  for (Update = 0; Update < LOOKUP_TEST_UPDATES; Update++) {
+    for (Index = 0; Index < mLookupTestVariableCount; Index++) {
+      LookupTestAppendVariable (mLookupTestVariables[Index].Name, mLookupTestVariables[Index].Guid, VAR_ADDED & VAR_DELETED);
+    }
+  }
+  for (Index = 0; Index < mLookupTestVariableCount; Index++) {
+    LookupTestAppendVariable (mLookupTestVariables[Index].Name, mLookupTestVariables[Index].Guid, VAR_ADDED);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the synthetic variable store.
+**/
+VOID
+EFIAPI
+LookupTestTeardown (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  InvalidateVariableStoreIndex (mLookupTestStore);
+  FreePool (mLookupTestStore);
+  FreePool (mLookupTestVariables);
+  mLookupTestStore     = NULL;
+  mLookupTestVariables = NULL;
+}
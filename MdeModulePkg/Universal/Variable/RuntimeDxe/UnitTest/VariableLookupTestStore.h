@@ -0,0 +1,102 @@
+/** @file
+  Synthetic variable store shared by the variable lookup host based tests.
+
+  The store is an authenticated variable store built in memory, with Secure
+  Boot databases, many Boot and Driver options and their deleted older
+  instances.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _VARIABLE_LOOKUP_TEST_STORE_H_
+#define _VARIABLE_LOOKUP_TEST_STORE_H_
+
+#include "../VariableParsing.h"
+#include "../VariableIndex.h"
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+//
+// Contents of the synthetic variable store
+//
+#define LOOKUP_TEST_STORE_SIZE          SIZE_512KB
+#define LOOKUP_TEST_BOOT_OPTIONS        256
+#define LOOKUP_TEST_DRIVER_OPTIONS      64
+#define LOOKUP_TEST_PLATFORM_VARIABLES  384
+#define LOOKUP_TEST_UPDATES             2
+#define LOOKUP_TEST_DATA_SIZE           48
+
+typedef struct {
+  CHAR16      Name[32];
+  EFI_GUID    *Guid;
+} LOOKUP_TEST_VARIABLE;
+
+extern EFI_GUID               mLookupTestPlatformGuid;
+extern VARIABLE_STORE_HEADER  *mLookupTestStore;
+extern UINTN                  mLookupTestLastOffset;
+extern LOOKUP_TEST_VARIABLE   *mLookupTestVariables;
+extern UINTN                  mLookupTestVariableCount;
+
+/**
+  Find the variable by walking the whole store, the way FindVariableEx () did
+  before the store index.
+
+  @param[in]       VariableName  Name of the variable to be found.
+  @param[in]       VendorGuid    Vendor GUID to be found.
+  @param[in, out]  PtrTrack      The store to walk, returns the variable found.
+
+  @retval EFI_SUCCESS            The variable is found.
+  @retval EFI_NOT_FOUND          The variable is not found.
+
+**/
+EFI_STATUS
+LookupTestWalkStore (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack
+  );
+
+/**
+  Append a variable to the synthetic store.
+
+  @param[in]  VariableName       Name of the variable.
+  @param[in]  VendorGuid         Vendor GUID of the variable.
+  @param[in]  State              State of the variable header.
+
+**/
+VOID
+LookupTestAppendVariable (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid,
+  IN UINT8     State
+  );
+
+/**
+  Build the synthetic variable store. Each test gets a fresh one.
+
+  @param[in]  Context            The unit test context, not used.
+
+  @retval UNIT_TEST_PASSED       The store is built.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LookupTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+/**
+  Free the synthetic variable store.
+
+  @param[in]  Context            The unit test context, not used.
+
+**/
+VOID
+EFIAPI
+LookupTestTeardown (
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+#endif
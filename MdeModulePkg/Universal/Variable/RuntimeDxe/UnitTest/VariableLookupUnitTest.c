@@ -0,0 +1,348 @@
+/** @file
+  Host based unit tests of variable lookups in a large variable store.
+
+  The tests build a synthetic authenticated variable store in memory, with
+  Secure Boot databases, many Boot and Driver options and their deleted older
+  instances, and check that FindVariableEx () finds the live instance of each
+  variable, the same one as a plain walk of the store, including after
+  variables are updated, deleted or appended and after the store is compacted.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableLookupTestStore.h"
+
+#define UNIT_TEST_NAME     "Variable Lookup Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define LOOKUP_TEST_LOOKUP_COUNT        0x1000
+
+/**
+  Look a variable up with FindVariableEx () and check the result against the
+  store walk.
+**/
+STATIC
+UNIT_TEST_STATUS
+LookupTestCheckLookup (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid
+  )
+{
+  VARIABLE_POINTER_TRACK  Expected;
+  VARIABLE_POINTER_TRACK  Actual;
+  EFI_STATUS              ExpectedStatus;
+  EFI_STATUS              ActualStatus;
+
+  ZeroMem (&Expected, sizeof (Expected));
+  Expected.StartPtr = GetStartPointer (mLookupTestStore);
+  Expected.EndPtr   = GetEndPointer (mLookupTestStore);
+  CopyMem (&Actual, &Expected, sizeof (Actual));
+
+  ExpectedStatus = LookupTestWalkStore (VariableName, VendorGuid, &Expected);
+  ActualStatus   = FindVariableEx (VariableName, VendorGuid, FALSE, &Actual, TRUE);
+  UT_ASSERT_STATUS_EQUAL (ActualStatus, ExpectedStatus);
+  if (!EFI_ERROR (ExpectedStatus)) {
+    UT_ASSERT_EQUAL ((UINTN) Actual.CurrPtr, (UINTN) Expected.CurrPtr);
+    UT_ASSERT_EQUAL ((UINTN) Actual.InDeletedTransitionPtr, (UINTN) Expected.InDeletedTransitionPtr);
+  }
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that indexed lookups find the same variable headers as the store walk,
+  including after variables are appended and after the store is compacted.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+IndexedLookupsMatchStoreWalk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+  UINTN             Index;
+  UINT8             *Compacted;
+  VARIABLE_HEADER   *Variable;
+  UINTN             Offset;
+  UINTN             Size;
+
+  for (Index = 0; Index < mLookupTestVariableCount; Index++) {
+    Status = LookupTestCheckLookup (mLookupTestVariables[Index].Name, mLookupTestVariables[Index].Guid);
+    if (Status != UNIT_TEST_PASSED) {
+      return Status;
+    }
+  }
+  Status = LookupTestCheckLookup (L"Boot", &gEfiGlobalVariableGuid);
+  UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  Status = LookupTestCheckLookup (L"Boot0000", &mLookupTestPlatformGuid);
+  UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+
+  //
+  // An update in progress leaves the old instance IN_DELETED_TRANSITION
+  // ahead of the new one, which the lookup must report too.
+  //
+  LookupTestAppendVariable (L"BootNext", &gEfiGlobalVariableGuid, VAR_ADDED & VAR_IN_DELETED_TRANSITION);
+  Status = LookupTestCheckLookup (L"BootNext", &gEfiGlobalVariableGuid);
+  UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  LookupTestAppendVariable (L"BootNext", &gEfiGlobalVariableGuid, VAR_ADDED);
+  Status = LookupTestCheckLookup (L"BootNext", &gEfiGlobalVariableGuid);
+  UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+
+  //
+  // Compact the store the way a reclaim does and drop the index.
+  //
+  Compacted = AllocatePool (LOOKUP_TEST_STORE_SIZE);
+  UT_ASSERT_NOT_NULL (Compacted);
+  SetMem (Compacted, LOOKUP_TEST_STORE_SIZE, 0xFF);
+  CopyMem (Compacted, mLookupTestStore, sizeof (VARIABLE_STORE_HEADER));
+  Offset = (UINTN) GetStartPointer (mLookupTestStore) - (UINTN) mLookupTestStore;
+  for ( Variable = GetStartPointer (mLookupTestStore)
+      ; IsValidVariableHeader (Variable, GetEndPointer (mLookupTestStore))
+      ; Variable = GetNextVariablePtr (Variable, TRUE)
+      ) {
+    if (Variable->State == VAR_ADDED) {
+      Size = (UINTN) GetNextVariablePtr (Variable, TRUE) - (UINTN) Variable;
+      CopyMem (Compacted + Offset, Variable, Size);
+      Offset += Size;
+    }
+  }
+  CopyMem (mLookupTestStore, Compacted, LOOKUP_TEST_STORE_SIZE);
+  mLookupTestLastOffset = Offset;
+  FreePool (Compacted);
+  InvalidateVariableStoreIndex (mLookupTestStore);
+
+  for (Index = 0; Index < mLookupTestVariableCount; Index++) {
+    Status = LookupTestCheckLookup (mLookupTestVariables[Index].Name, mLookupTestVariables[Index].Guid);
+    if (Status != UNIT_TEST_PASSED) {
+      return Status;
+    }
+  }
+  Status = LookupTestCheckLookup (L"BootNext", &gEfiGlobalVariableGuid);
+  UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Look a variable up with FindVariableEx () and check that it found the live
+  instance of the variable, with the expected name and GUID.
+**/
+STATIC
+UNIT_TEST_STATUS
+LookupTestCheckFound (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid
+  )
+{
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  EFI_STATUS              Status;
+
+  ZeroMem (&PtrTrack, sizeof (PtrTrack));
+  PtrTrack.StartPtr = GetStartPointer (mLookupTestStore);
+  PtrTrack.EndPtr   = GetEndPointer (mLookupTestStore);
+
+  Status = FindVariableEx (VariableName, VendorGuid, FALSE, &PtrTrack, TRUE);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_NOT_NULL (PtrTrack.CurrPtr);
+  UT_ASSERT_EQUAL (PtrTrack.CurrPtr->State, VAR_ADDED);
+  UT_ASSERT_TRUE (CompareGuid (GetVendorGuidPtr (PtrTrack.CurrPtr, TRUE), VendorGuid));
+  UT_ASSERT_EQUAL (NameSizeOfVariable (PtrTrack.CurrPtr, TRUE), StrSize (VariableName));
+  UT_ASSERT_MEM_EQUAL (GetVariableNamePtr (PtrTrack.CurrPtr, TRUE), VariableName, StrSize (VariableName));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that FindVariableEx () doesn't find a variable.
+**/
+STATIC
+UNIT_TEST_STATUS
+LookupTestCheckNotFound (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid
+  )
+{
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  EFI_STATUS              Status;
+
+  ZeroMem (&PtrTrack, sizeof (PtrTrack));
+  PtrTrack.StartPtr = GetStartPointer (mLookupTestStore);
+  PtrTrack.EndPtr   = GetEndPointer (mLookupTestStore);
+
+  Status = FindVariableEx (VariableName, VendorGuid, FALSE, &PtrTrack, TRUE);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check random lookups of existing variables, lookups of missing names and
+  lookups of existing names under another GUID.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LookupsFindLiveVariables (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS      Status;
+  LOOKUP_TEST_VARIABLE  *Entry;
+  UINTN                 Index;
+  UINT32                Random;
+  CHAR16                MissingName[32];
+
+  Random = 1;
+  for (Index = 0; Index < LOOKUP_TEST_LOOKUP_COUNT; Index++) {
+    Random = Random * 1103515245 + 12345;
+    Entry  = &mLookupTestVariables[(Random >> 8) % mLookupTestVariableCount];
+    Status = LookupTestCheckFound (Entry->Name, Entry->Guid);
+    UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  }
+
+  for (Index = 0; Index < 0x100; Index++) {
+    UnicodeSPrint (MissingName, sizeof (MissingName), L"Boot%04x", 0x8000 + Index);
+    Status = LookupTestCheckNotFound (MissingName, &gEfiGlobalVariableGuid);
+    UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+    UnicodeSPrint (MissingName, sizeof (MissingName), L"Boot%04x", Index);
+    Status = LookupTestCheckNotFound (MissingName, &mLookupTestPlatformGuid);
+    UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that lookups follow variables which are updated or deleted after the
+  store was indexed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LookupsFollowUpdates (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS        Status;
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  VARIABLE_HEADER         *OldVariable;
+  EFI_STATUS              FindStatus;
+  CHAR16                  Name[32];
+  UINTN                   Index;
+
+  //
+  // Index the whole store.
+  //
+  for (Index = 0; Index < mLookupTestVariableCount; Index++) {
+    Status = LookupTestCheckFound (mLookupTestVariables[Index].Name, mLookupTestVariables[Index].Guid);
+    UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  }
+
+  for (Index = 0; Index < LOOKUP_TEST_BOOT_OPTIONS; Index += 3) {
+    UnicodeSPrint (Name, sizeof (Name), L"Boot%04x", Index);
+    ZeroMem (&PtrTrack, sizeof (PtrTrack));
+    PtrTrack.StartPtr = GetStartPointer (mLookupTestStore);
+    PtrTrack.EndPtr   = GetEndPointer (mLookupTestStore);
+    FindStatus = FindVariableEx (Name, &gEfiGlobalVariableGuid, FALSE, &PtrTrack, TRUE);
+    UT_ASSERT_NOT_EFI_ERROR (FindStatus);
+    OldVariable = PtrTrack.CurrPtr;
+
+    if ((Index % 2) == 0) {
+      //
+      // Update: append the new instance and delete the old one, as
+      // UpdateVariable () does.
+      //
+      LookupTestAppendVariable (Name, &gEfiGlobalVariableGuid, VAR_ADDED);
+      OldVariable->State &= VAR_DELETED;
+      Status = LookupTestCheckFound (Name, &gEfiGlobalVariableGuid);
+      UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+
+      ZeroMem (&PtrTrack, sizeof (PtrTrack));
+      PtrTrack.StartPtr = GetStartPointer (mLookupTestStore);
+      PtrTrack.EndPtr   = GetEndPointer (mLookupTestStore);
+      FindStatus = FindVariableEx (Name, &gEfiGlobalVariableGuid, FALSE, &PtrTrack, TRUE);
+      UT_ASSERT_NOT_EFI_ERROR (FindStatus);
+      UT_ASSERT_TRUE ((UINTN) PtrTrack.CurrPtr > (UINTN) OldVariable);
+    } else {
+      OldVariable->State &= VAR_DELETED;
+      Status = LookupTestCheckNotFound (Name, &gEfiGlobalVariableGuid);
+      UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+    }
+  }
+
+  //
+  // New variables appended after the store was indexed are found as well.
+  //
+  for (Index = 0; Index < 16; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"Boot%04x", 0x8000 + Index);
+    LookupTestAppendVariable (Name, &gEfiGlobalVariableGuid, VAR_ADDED);
+    Status = LookupTestCheckFound (Name, &gEfiGlobalVariableGuid);
+    UT_ASSERT_EQUAL (Status, UNIT_TEST_PASSED);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  variable lookups and run them.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      LookupTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (
+             &LookupTests,
+             Framework,
+             "Variable Lookup Tests",
+             "MdeModulePkg.Variable.Lookup",
+             NULL,
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for LookupTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (LookupTests, "Indexed lookups match the store walk", "Consistency", IndexedLookupsMatchStoreWalk, LookupTestSetup, LookupTestTeardown, NULL);
+  AddTestCase (LookupTests, "Lookups find the live variables", "Lookups", LookupsFindLiveVariables, LookupTestSetup, LookupTestTeardown, NULL);
+  AddTestCase (LookupTests, "Lookups follow updates and deletes", "Updates", LookupsFollowUpdates, LookupTestSetup, LookupTestTeardown, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
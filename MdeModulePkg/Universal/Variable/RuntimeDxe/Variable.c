@@ -28,6 +28,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "VariableNonVolatile.h"
 #include "VariableParsing.h"
 #include "VariableRuntimeCache.h"
+#include "VariableIndex.h"
 
 VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
 
@@ -337,8 +338,8 @@ RecordVarErrorFlag (
       *VarErrFlag = TempFlag;
       Status =  SynchronizeRuntimeVariableCache (
                   &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
-                  0,
-                  mNvVariableCache->Size
+                  (UINTN) VarErrFlag - (UINTN) mNvVariableCache,
+                  sizeof (TempFlag)
                   );
       ASSERT_EFI_ERROR (Status);
     }
@@ -774,6 +775,14 @@ Reclaim (
   }
 
 Done:
+  //
+  // The variables were moved, so the store index has to be rebuilt.
+  //
+  InvalidateVariableStoreIndex (VariableStoreHeader);
+  if (!IsVolatile) {
+    InvalidateVariableStoreIndex (mNvVariableCache);
+  }
+
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     Status =  SynchronizeRuntimeVariableCache (
                 &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache,
@@ -1644,6 +1653,8 @@ UpdateVariable (
   BOOLEAN                             IsCommonUserVariable;
   AUTHENTICATED_VARIABLE_HEADER       *AuthVariable;
   BOOLEAN                             AuthFormat;
+  UINTN                               NonVolatileLastVariableOffset;
+  UINTN                               VolatileLastVariableOffset;
 
   if (mVariableModuleGlobal->FvbInstance == NULL && !mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     //
@@ -1666,6 +1677,8 @@ UpdateVariable (
   }
 
   AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
+  NonVolatileLastVariableOffset = mVariableModuleGlobal->NonVolatileLastVariableOffset;
+  VolatileLastVariableOffset    = mVariableModuleGlobal->VolatileLastVariableOffset;
 
   //
   // Check if CacheVariable points to the variable in variable HOB.
@@ -2300,18 +2313,24 @@ Done:
   if (!EFI_ERROR (Status)) {
     if ((Variable->CurrPtr != NULL && !Variable->Volatile) || (Attributes & EFI_VARIABLE_NON_VOLATILE) != 0) {
       VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache);
+      Status =  SynchronizeRuntimeVariableCacheWithUpdate (
+                  VolatileCacheInstance,
+                  mNvVariableCache,
+                  CacheVariable,
+                  NonVolatileLastVariableOffset,
+                  mVariableModuleGlobal->NonVolatileLastVariableOffset
+                  );
     } else {
       VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache);
-    }
-
-    if (VolatileCacheInstance->Store != NULL) {
-      Status =  SynchronizeRuntimeVariableCache (
+      Status =  SynchronizeRuntimeVariableCacheWithUpdate (
                   VolatileCacheInstance,
-                  0,
-                  VolatileCacheInstance->Store->Size
+                  (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.VolatileVariableBase,
+                  CacheVariable,
+                  VolatileLastVariableOffset,
+                  mVariableModuleGlobal->VolatileLastVariableOffset
                   );
-      ASSERT_EFI_ERROR (Status);
     }
+    ASSERT_EFI_ERROR (Status);
   }
 
   return Status;
@@ -3262,6 +3281,7 @@ FlushHobVariableToFlash (
       if (mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.HobFlushComplete != NULL) {
         *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.HobFlushComplete) = TRUE;
       }
+      InvalidateVariableStoreIndex (VariableStoreHeader);
       if (!AtRuntime ()) {
         FreePool ((VOID *) VariableStoreHeader);
       }
@@ -64,16 +64,37 @@ typedef enum {
   VariableStoreTypeMax
 } VARIABLE_STORE_TYPE;
 
+//
+// The number of disjoint ranges of a runtime cache that can be pending an
+// update. Further ranges are merged into a single span.
+//
+#define VARIABLE_RUNTIME_CACHE_MAX_PENDING_UPDATES  8
+
+typedef struct {
+  UINT32                  Offset;
+  UINT32                  Length;
+} VARIABLE_RUNTIME_CACHE_UPDATE;
+
 typedef struct {
-  UINT32                  PendingUpdateOffset;
-  UINT32                  PendingUpdateLength;
-  VARIABLE_STORE_HEADER   *Store;
+  UINT32                         PendingUpdateCount;
+  VARIABLE_RUNTIME_CACHE_UPDATE  PendingUpdates[VARIABLE_RUNTIME_CACHE_MAX_PENDING_UPDATES];
+  VARIABLE_STORE_HEADER          *Store;
 } VARIABLE_RUNTIME_CACHE;
 
 typedef struct {
-  BOOLEAN                 *ReadLock;
+  //
+  // Odd while the runtime caches are being updated, and incremented again
+  // once they are consistent, so readers can detect that an update overlapped
+  // their read and retry it instead of locking out the writer.
+  //
+  UINT32                  *SequenceCount;
   BOOLEAN                 *PendingUpdate;
   BOOLEAN                 *HobFlushComplete;
+  //
+  // Incremented whenever a runtime cache is rewritten from its store header
+  // on, so readers can drop what they derived from the old variable layout.
+  //
+  UINT32                  *RebuildCount;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeVolatileCache;
@@ -124,6 +145,12 @@ typedef struct {
   CHAR8           *PlatformLang;
   CHAR8           Lang[ISO_639_2_ENTRY_SIZE + 1];
   EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL *FvbInstance;
+  ///
+  /// Number of reclaims of the non-volatile variable store, and the bytes
+  /// they wrote to it.
+  ///
+  UINTN           ReclaimCount;
+  UINT64          ReclaimWriteSize;
 } VARIABLE_MODULE_GLOBAL;
 
 /**
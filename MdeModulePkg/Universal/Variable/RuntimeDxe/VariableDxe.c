@@ -10,6 +10,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "Variable.h"
+#include "VariableIndex.h"
 
 EFI_HANDLE                          mHandle                    = NULL;
 EFI_EVENT                           mVirtualAddressChangeEvent = NULL;
@@ -261,6 +262,14 @@ VariableClassAddressChangeEvent (
       EfiConvertPointer (0x0, (VOID **) mVarCheckAddressPointer[Index]);
     }
   }
+
+  for (Index = 0; Index < VARIABLE_INDEX_MAX_STORES; Index++) {
+    if (mVariableStoreIndex[Index].StartPtr != NULL) {
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index].StartPtr);
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index].Buckets);
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index].Entries);
+    }
+  }
 }
 
 
@@ -0,0 +1,429 @@
+/** @file
+  Functions in this module maintain the hash index of the variable stores that
+  FindVariableEx () uses to avoid walking a whole variable store per lookup.
+
+  Caution: This module requires additional review when modified.
+  This driver will have external input - variable data. They may be input in SMM mode.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableParsing.h"
+#include "VariableIndex.h"
+
+VARIABLE_STORE_INDEX  mVariableStoreIndex[VARIABLE_INDEX_MAX_STORES];
+
+/**
+  Compute the index hash of a vendor GUID and variable name.
+
+  This is the 32-bit FNV-1a hash of the GUID followed by the name, including
+  its null terminator.
+
+  @param[in] VendorGuid     Vendor GUID of the variable.
+  @param[in] VariableName   Name of the variable.
+  @param[in] NameSize       Size in bytes of the name.
+
+  @return The hash value.
+
+**/
+STATIC
+UINT32
+GetVariableIndexHash (
+  IN EFI_GUID                    *VendorGuid,
+  IN VOID                        *VariableName,
+  IN UINTN                       NameSize
+  )
+{
+  UINT32  Hash;
+  UINT8   *Byte;
+  UINTN   Index;
+
+  Hash = 0x811C9DC5;
+  Byte = (UINT8 *) VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Byte[Index]) * 0x01000193;
+  }
+  Byte = (UINT8 *) VariableName;
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Byte[Index]) * 0x01000193;
+  }
+  return Hash;
+}
+
+/**
+  Release or reset one variable store index.
+
+  At boot time the index memory is freed and the slot becomes available again.
+  At runtime memory cannot be freed, so the index is only emptied and will be
+  rebuilt by the next lookup.
+
+  @param[in, out] StoreIndex   The variable store index.
+
+**/
+STATIC
+VOID
+ResetVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX    *StoreIndex
+  )
+{
+  if (StoreIndex->StartPtr == NULL) {
+    return;
+  }
+
+  if (!AtRuntime ()) {
+    FreePool (StoreIndex->Buckets);
+    FreePool (StoreIndex->Entries);
+    ZeroMem (StoreIndex, sizeof (VARIABLE_STORE_INDEX));
+    return;
+  }
+
+  SetMem32 (StoreIndex->Buckets, StoreIndex->BucketCount * sizeof (UINT32), VARIABLE_INDEX_END_OF_CHAIN);
+  StoreIndex->IndexedOffset = 0;
+  StoreIndex->EntryCount    = 0;
+  StoreIndex->Overflow      = FALSE;
+}
+
+/**
+  Create the index of a variable store in a free slot.
+
+  The index is sized for the largest number of variables that fit in the
+  store, so appending variables never needs more memory.
+
+  @param[in] StartPtr      The first variable header of the store.
+  @param[in] StoreSize     The size in bytes from StartPtr to the end of the store.
+  @param[in] AuthFormat    TRUE indicates authenticated variables are used.
+                           FALSE indicates authenticated variables are not used.
+
+  @return The empty index, or NULL if no slot or memory is available.
+
+**/
+STATIC
+VARIABLE_STORE_INDEX *
+CreateVariableStoreIndex (
+  IN VARIABLE_HEADER             *StartPtr,
+  IN UINT32                      StoreSize,
+  IN BOOLEAN                     AuthFormat
+  )
+{
+  VARIABLE_STORE_INDEX  *StoreIndex;
+  UINTN                 Index;
+  UINT32                MaxEntries;
+  UINT32                BucketCount;
+
+  StoreIndex = NULL;
+  for (Index = 0; Index < VARIABLE_INDEX_MAX_STORES; Index++) {
+    if (mVariableStoreIndex[Index].StartPtr == NULL) {
+      StoreIndex = &mVariableStoreIndex[Index];
+      break;
+    }
+  }
+  if (StoreIndex == NULL) {
+    return NULL;
+  }
+
+  MaxEntries  = StoreSize / (UINT32) HEADER_ALIGN (GetVariableHeaderSize (AuthFormat) + sizeof (CHAR16)) + 1;
+  BucketCount = MAX (GetPowerOfTwo32 (MaxEntries), VARIABLE_INDEX_MIN_BUCKETS);
+
+  StoreIndex->Buckets = AllocateRuntimePool (BucketCount * sizeof (UINT32));
+  StoreIndex->Entries = AllocateRuntimePool (MaxEntries * sizeof (VARIABLE_INDEX_ENTRY));
+  if (StoreIndex->Buckets == NULL || StoreIndex->Entries == NULL) {
+    if (StoreIndex->Buckets != NULL) {
+      FreePool (StoreIndex->Buckets);
+    }
+    if (StoreIndex->Entries != NULL) {
+      FreePool (StoreIndex->Entries);
+    }
+    ZeroMem (StoreIndex, sizeof (VARIABLE_STORE_INDEX));
+    return NULL;
+  }
+
+  SetMem32 (StoreIndex->Buckets, BucketCount * sizeof (UINT32), VARIABLE_INDEX_END_OF_CHAIN);
+  StoreIndex->StartPtr      = StartPtr;
+  StoreIndex->StoreSize     = StoreSize;
+  StoreIndex->IndexedOffset = 0;
+  StoreIndex->EntryCount    = 0;
+  StoreIndex->MaxEntries    = MaxEntries;
+  StoreIndex->BucketCount   = BucketCount;
+  StoreIndex->Overflow      = FALSE;
+  return StoreIndex;
+}
+
+/**
+  Add the variable headers appended to a store since its last lookup to its index.
+
+  @param[in, out] StoreIndex   The variable store index.
+  @param[in]      EndPtr       The end of the variable store.
+  @param[in]      AuthFormat   TRUE indicates authenticated variables are used.
+                               FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+UpdateVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX    *StoreIndex,
+  IN     VARIABLE_HEADER         *EndPtr,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_INDEX_ENTRY  *Entry;
+  UINT8                 *Name;
+  UINTN                 NameSize;
+  UINT32                Bucket;
+
+  Variable = (VARIABLE_HEADER *) ((UINTN) StoreIndex->StartPtr + StoreIndex->IndexedOffset);
+  while (IsValidVariableHeader (Variable, EndPtr)) {
+    Name     = (UINT8 *) GetVariableNamePtr (Variable, AuthFormat);
+    NameSize = NameSizeOfVariable (Variable, AuthFormat);
+    if ((StoreIndex->EntryCount == StoreIndex->MaxEntries) ||
+        ((UINTN) Name > (UINTN) EndPtr) ||
+        (NameSize > (UINTN) EndPtr - (UINTN) Name)) {
+      //
+      // The store does not look like what the index was sized for; leave the
+      // lookups to the store walk until the store is rewritten.
+      //
+      StoreIndex->Overflow = TRUE;
+      return;
+    }
+
+    Entry         = &StoreIndex->Entries[StoreIndex->EntryCount];
+    Entry->Hash   = GetVariableIndexHash (GetVendorGuidPtr (Variable, AuthFormat), Name, NameSize);
+    Entry->Offset = (UINT32) ((UINTN) Variable - (UINTN) StoreIndex->StartPtr);
+    Bucket        = Entry->Hash & (StoreIndex->BucketCount - 1);
+    Entry->Next   = StoreIndex->Buckets[Bucket];
+    StoreIndex->Buckets[Bucket] = StoreIndex->EntryCount;
+    StoreIndex->EntryCount++;
+
+    Variable = GetNextVariablePtr (Variable, AuthFormat);
+  }
+
+  StoreIndex->IndexedOffset = (UINT32) ((UINTN) Variable - (UINTN) StoreIndex->StartPtr);
+}
+
+/**
+  Get the up to date index of a variable store, creating it on first use.
+
+  @param[in] StartPtr      The first variable header of the store.
+  @param[in] EndPtr        The end of the variable store.
+  @param[in] AuthFormat    TRUE indicates authenticated variables are used.
+                           FALSE indicates authenticated variables are not used.
+
+  @return The index, or NULL if the store cannot be indexed.
+
+**/
+STATIC
+VARIABLE_STORE_INDEX *
+GetVariableStoreIndex (
+  IN VARIABLE_HEADER             *StartPtr,
+  IN VARIABLE_HEADER             *EndPtr,
+  IN BOOLEAN                     AuthFormat
+  )
+{
+  VARIABLE_STORE_INDEX  *StoreIndex;
+  UINTN                 Index;
+  UINTN                 StoreSize;
+
+  if ((UINTN) EndPtr <= (UINTN) StartPtr) {
+    return NULL;
+  }
+  StoreSize = (UINTN) EndPtr - (UINTN) StartPtr;
+  if (StoreSize > MAX_UINT32) {
+    return NULL;
+  }
+
+  StoreIndex = NULL;
+  for (Index = 0; Index < VARIABLE_INDEX_MAX_STORES; Index++) {
+    if (mVariableStoreIndex[Index].StartPtr == StartPtr) {
+      StoreIndex = &mVariableStoreIndex[Index];
+      break;
+    }
+  }
+
+  if ((StoreIndex != NULL) && (StoreIndex->StoreSize != StoreSize)) {
+    //
+    // A different store took over the memory of an indexed one.
+    //
+    ResetVariableStoreIndex (StoreIndex);
+    if (StoreIndex->StartPtr != NULL) {
+      return NULL;
+    }
+    StoreIndex = NULL;
+  }
+
+  if (StoreIndex == NULL) {
+    //
+    // Memory cannot be allocated at runtime, so stores first searched at
+    // runtime keep being walked.
+    //
+    if (AtRuntime ()) {
+      return NULL;
+    }
+    StoreIndex = CreateVariableStoreIndex (StartPtr, (UINT32) StoreSize, AuthFormat);
+    if (StoreIndex == NULL) {
+      return NULL;
+    }
+  }
+
+  if (!StoreIndex->Overflow) {
+    UpdateVariableStoreIndex (StoreIndex, EndPtr, AuthFormat);
+  }
+  if (StoreIndex->Overflow) {
+    return NULL;
+  }
+  return StoreIndex;
+}
+
+/**
+  Check whether an indexed variable header is a live instance of the variable.
+
+  @param[in] Variable        The variable header.
+  @param[in] VariableName    Name of the variable to be found.
+  @param[in] VendorGuid      Vendor GUID to be found.
+  @param[in] IgnoreRtCheck   Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                             check at runtime when searching variable.
+  @param[in] AuthFormat      TRUE indicates authenticated variables are used.
+                             FALSE indicates authenticated variables are not used.
+
+  @retval TRUE               The header is an ADDED or IN_DELETED_TRANSITION instance of the variable.
+  @retval FALSE              The header is not.
+
+**/
+STATIC
+BOOLEAN
+IsIndexedVariableMatch (
+  IN VARIABLE_HEADER             *Variable,
+  IN CHAR16                      *VariableName,
+  IN EFI_GUID                    *VendorGuid,
+  IN BOOLEAN                     IgnoreRtCheck,
+  IN BOOLEAN                     AuthFormat
+  )
+{
+  if (Variable->State != VAR_ADDED && Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+    return FALSE;
+  }
+  if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+    return FALSE;
+  }
+  if (!CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat))) {
+    return FALSE;
+  }
+  ASSERT (NameSizeOfVariable (Variable, AuthFormat) != 0);
+  return (BOOLEAN) (CompareMem (
+                      VariableName,
+                      GetVariableNamePtr (Variable, AuthFormat),
+                      NameSizeOfVariable (Variable, AuthFormat)
+                      ) == 0);
+}
+
+/**
+  Find the variable in the specified variable store through the store index.
+
+  The result is the same as the one of walking the store in FindVariableEx ().
+
+  @param[in]       VariableName        Name of the variable to be found, not an empty string.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully.
+  @retval          EFI_NOT_FOUND       Variable not found.
+  @retval          EFI_UNSUPPORTED     The store has no usable index; the caller must walk the store.
+
+**/
+EFI_STATUS
+FindVariableInIndex (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_STORE_INDEX  *StoreIndex;
+  VARIABLE_INDEX_ENTRY  *Entry;
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_HEADER       *AddedVariable;
+  VARIABLE_HEADER       *InDeletedVariable;
+  UINT32                Hash;
+  UINT32                EntryIndex;
+  UINT32                FirstEntry;
+
+  StoreIndex = GetVariableStoreIndex (PtrTrack->StartPtr, PtrTrack->EndPtr, AuthFormat);
+  if (StoreIndex == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Hash       = GetVariableIndexHash (VendorGuid, VariableName, StrSize (VariableName));
+  FirstEntry = StoreIndex->Buckets[Hash & (StoreIndex->BucketCount - 1)];
+
+  //
+  // The store walk stops at the first ADDED instance of the variable, and
+  // reports the last IN_DELETED_TRANSITION instance before it.
+  //
+  AddedVariable = NULL;
+  for (EntryIndex = FirstEntry; EntryIndex != VARIABLE_INDEX_END_OF_CHAIN; EntryIndex = Entry->Next) {
+    Entry    = &StoreIndex->Entries[EntryIndex];
+    Variable = (VARIABLE_HEADER *) ((UINTN) PtrTrack->StartPtr + Entry->Offset);
+    if ((Entry->Hash == Hash) &&
+        (Variable->State == VAR_ADDED) &&
+        ((AddedVariable == NULL) || (Variable < AddedVariable)) &&
+        IsIndexedVariableMatch (Variable, VariableName, VendorGuid, IgnoreRtCheck, AuthFormat)) {
+      AddedVariable = Variable;
+    }
+  }
+
+  InDeletedVariable = NULL;
+  for (EntryIndex = FirstEntry; EntryIndex != VARIABLE_INDEX_END_OF_CHAIN; EntryIndex = Entry->Next) {
+    Entry    = &StoreIndex->Entries[EntryIndex];
+    Variable = (VARIABLE_HEADER *) ((UINTN) PtrTrack->StartPtr + Entry->Offset);
+    if ((Entry->Hash == Hash) &&
+        (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) &&
+        ((AddedVariable == NULL) || (Variable < AddedVariable)) &&
+        ((InDeletedVariable == NULL) || (Variable > InDeletedVariable)) &&
+        IsIndexedVariableMatch (Variable, VariableName, VendorGuid, IgnoreRtCheck, AuthFormat)) {
+      InDeletedVariable = Variable;
+    }
+  }
+
+  if (AddedVariable != NULL) {
+    PtrTrack->CurrPtr                = AddedVariable;
+    PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+    return EFI_SUCCESS;
+  }
+
+  PtrTrack->CurrPtr                = InDeletedVariable;
+  PtrTrack->InDeletedTransitionPtr = NULL;
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
+/**
+  Drop the index of a variable store whose variable headers were moved.
+
+  The index is rebuilt by the next lookup in the store. This must be called
+  whenever the store is rewritten other than by appending variables or
+  changing their state, e.g. after a reclaim, and before the store is freed.
+
+  @param[in] VariableStore   The variable store, or NULL to drop the index of all stores.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  IN VARIABLE_STORE_HEADER       *VariableStore OPTIONAL
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < VARIABLE_INDEX_MAX_STORES; Index++) {
+    if ((VariableStore == NULL) ||
+        (mVariableStoreIndex[Index].StartPtr == GetStartPointer (VariableStore))) {
+      ResetVariableStoreIndex (&mVariableStoreIndex[Index]);
+    }
+  }
+}
@@ -0,0 +1,104 @@
+/** @file
+  The variable store index routines shared by the DXE_RUNTIME variable module,
+  the DXE_SMM variable module and the runtime cache of the SMM runtime DXE
+  variable module.
+
+  Each index maps a hash of the vendor GUID and variable name to the offsets of
+  the variable headers carrying them, so a lookup visits the few headers that
+  may match instead of walking the whole variable store. Variable stores are
+  append-only between two reclaims, so an index is extended lazily with the
+  headers appended since the last lookup, and is dropped whenever its variable
+  store is rewritten.
+
+Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _VARIABLE_INDEX_H_
+#define _VARIABLE_INDEX_H_
+
+#include "Variable.h"
+
+//
+// The variable stores that can be indexed at the same time: volatile, HOB and
+// non-volatile, plus one spare for a store that is being replaced.
+//
+#define VARIABLE_INDEX_MAX_STORES      (VariableStoreTypeMax + 1)
+
+#define VARIABLE_INDEX_MIN_BUCKETS     16
+#define VARIABLE_INDEX_END_OF_CHAIN    MAX_UINT32
+
+typedef struct {
+  UINT32                  Hash;
+  UINT32                  Offset;
+  UINT32                  Next;
+} VARIABLE_INDEX_ENTRY;
+
+typedef struct {
+  //
+  // The first variable header of the indexed store, NULL if the slot is free.
+  //
+  VARIABLE_HEADER         *StartPtr;
+  UINT32                  StoreSize;
+  //
+  // Offset from StartPtr of the first variable header not indexed yet.
+  //
+  UINT32                  IndexedOffset;
+  UINT32                  EntryCount;
+  UINT32                  MaxEntries;
+  UINT32                  BucketCount;
+  BOOLEAN                 Overflow;
+  UINT32                  *Buckets;
+  VARIABLE_INDEX_ENTRY    *Entries;
+} VARIABLE_STORE_INDEX;
+
+///
+/// The runtime DXE variable modules convert the pointers in this table on
+/// virtual address change.
+///
+extern VARIABLE_STORE_INDEX   mVariableStoreIndex[VARIABLE_INDEX_MAX_STORES];
+
+/**
+  Find the variable in the specified variable store through the store index.
+
+  The result is the same as the one of walking the store in FindVariableEx ().
+
+  @param[in]       VariableName        Name of the variable to be found, not an empty string.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully.
+  @retval          EFI_NOT_FOUND       Variable not found.
+  @retval          EFI_UNSUPPORTED     The store has no usable index; the caller must walk the store.
+
+**/
+EFI_STATUS
+FindVariableInIndex (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  );
+
+/**
+  Drop the index of a variable store whose variable headers were moved.
+
+  The index is rebuilt by the next lookup in the store. This must be called
+  whenever the store is rewritten other than by appending variables or
+  changing their state, e.g. after a reclaim, and before the store is freed.
+
+  @param[in] VariableStore   The variable store, or NULL to drop the index of all stores.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  IN VARIABLE_STORE_HEADER       *VariableStore OPTIONAL
+  );
+
+#endif
@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "VariableParsing.h"
+#include "VariableIndex.h"
 
 /**
 
@@ -37,6 +38,50 @@ IsValidVariableHeader (
   return TRUE;
 }
 
+/**
+
+  This code checks if the name and data of a variable lie within its variable store.
+
+  The sizes in a variable header being written can be torn when the store is read
+  without blocking its writer, so they must be checked before the name is read or
+  the next variable is located.
+
+  @param[in] Variable           Pointer to a valid Variable Header.
+  @param[in] VariableStoreEnd   Pointer to the Variable Store End.
+  @param[in] AuthFormat         TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @retval TRUE              The variable lies within the variable store.
+  @retval FALSE             The variable runs past the end of the variable store.
+
+**/
+BOOLEAN
+IsVariableInStore (
+  IN  VARIABLE_HEADER       *Variable,
+  IN  VARIABLE_HEADER       *VariableStoreEnd,
+  IN  BOOLEAN               AuthFormat
+  )
+{
+  UINTN  Size;
+  UINTN  NameSize;
+  UINTN  DataSize;
+
+  Size = (UINTN) VariableStoreEnd - (UINTN) Variable;
+  if (Size < GetVariableHeaderSize (AuthFormat)) {
+    return FALSE;
+  }
+  Size -= GetVariableHeaderSize (AuthFormat);
+
+  NameSize = NameSizeOfVariable (Variable, AuthFormat);
+  if ((NameSize > Size) || (GET_PAD_SIZE (NameSize) > Size - NameSize)) {
+    return FALSE;
+  }
+  Size -= NameSize + GET_PAD_SIZE (NameSize);
+
+  DataSize = DataSizeOfVariable (Variable, AuthFormat);
+  return (BOOLEAN) (DataSize <= Size);
+}
+
 /**
 
   This code gets the current status of Variable Store.
@@ -462,16 +507,28 @@ FindVariableEx (
 {
   VARIABLE_HEADER                *InDeletedVariable;
   VOID                           *Point;
+  EFI_STATUS                     Status;
 
   PtrTrack->InDeletedTransitionPtr = NULL;
 
+  //
+  // Look a named variable up in the store index, if the store has one.
+  //
+  if (VariableName[0] != 0) {
+    Status = FindVariableInIndex (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+  }
+
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
   InDeletedVariable  = NULL;
 
   for ( PtrTrack->CurrPtr = PtrTrack->StartPtr
-      ; IsValidVariableHeader (PtrTrack->CurrPtr, PtrTrack->EndPtr)
+      ; IsValidVariableHeader (PtrTrack->CurrPtr, PtrTrack->EndPtr) &&
+        IsVariableInStore (PtrTrack->CurrPtr, PtrTrack->EndPtr, AuthFormat)
       ; PtrTrack->CurrPtr = GetNextVariablePtr (PtrTrack->CurrPtr, AuthFormat)
       ) {
     if (PtrTrack->CurrPtr->State == VAR_ADDED ||
@@ -597,7 +654,8 @@ VariableServiceGetNextVariableInternal (
     //
     // Switch to the next variable store if needed
     //
-    while (!IsValidVariableHeader (Variable.CurrPtr, Variable.EndPtr)) {
+    while (!IsValidVariableHeader (Variable.CurrPtr, Variable.EndPtr) ||
+           !IsVariableInStore (Variable.CurrPtr, Variable.EndPtr, AuthFormat)) {
       //
       // Find current storage index
       //
@@ -30,6 +30,30 @@ IsValidVariableHeader (
   IN  VARIABLE_HEADER       *VariableStoreEnd
   );
 
+/**
+
+  This code checks if the name and data of a variable lie within its variable store.
+
+  The sizes in a variable header being written can be torn when the store is read
+  without blocking its writer, so they must be checked before the name is read or
+  the next variable is located.
+
+  @param[in] Variable           Pointer to a valid Variable Header.
+  @param[in] VariableStoreEnd   Pointer to the Variable Store End.
+  @param[in] AuthFormat         TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @retval TRUE              The variable lies within the variable store.
+  @retval FALSE             The variable runs past the end of the variable store.
+
+**/
+BOOLEAN
+IsVariableInStore (
+  IN  VARIABLE_HEADER       *Variable,
+  IN  VARIABLE_HEADER       *VariableStoreEnd,
+  IN  BOOLEAN               AuthFormat
+  );
+
 /**
 
   This code gets the current status of Variable Store.
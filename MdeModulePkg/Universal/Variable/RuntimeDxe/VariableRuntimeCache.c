@@ -18,9 +18,111 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 extern VARIABLE_MODULE_GLOBAL   *mVariableModuleGlobal;
 extern VARIABLE_STORE_HEADER    *mNvVariableCache;
 
+/**
+  Adds a range to the pending updates of a runtime cache.
+
+  Overlapping and adjacent ranges are merged. If the range is disjoint from all pending ranges and there is no
+  room left to track it, all pending ranges are merged into a single span.
+
+  @param[in, out] VariableRuntimeCache Variable runtime cache structure for the runtime cache being updated.
+  @param[in]      Offset               Offset in bytes of the range.
+  @param[in]      Length               Length in bytes of the range.
+
+**/
+VOID
+AddPendingRuntimeCacheUpdate (
+  IN OUT VARIABLE_RUNTIME_CACHE       *VariableRuntimeCache,
+  IN     UINT32                       Offset,
+  IN     UINT32                       Length
+  )
+{
+  VARIABLE_RUNTIME_CACHE_UPDATE       *Update;
+  UINT32                              Index;
+  UINT32                              Start;
+  UINT32                              End;
+
+  if (Length == 0) {
+    return;
+  }
+
+  for (Index = 0; Index < VariableRuntimeCache->PendingUpdateCount; Index++) {
+    Update = &VariableRuntimeCache->PendingUpdates[Index];
+    if (Offset <= Update->Offset + Update->Length && Update->Offset <= Offset + Length) {
+      Start          = MIN (Update->Offset, Offset);
+      End            = MAX (Update->Offset + Update->Length, Offset + Length);
+      Update->Offset = Start;
+      Update->Length = End - Start;
+      return;
+    }
+  }
+
+  if (VariableRuntimeCache->PendingUpdateCount == VARIABLE_RUNTIME_CACHE_MAX_PENDING_UPDATES) {
+    Start = Offset;
+    End   = Offset + Length;
+    for (Index = 0; Index < VariableRuntimeCache->PendingUpdateCount; Index++) {
+      Update = &VariableRuntimeCache->PendingUpdates[Index];
+      Start  = MIN (Start, Update->Offset);
+      End    = MAX (End, Update->Offset + Update->Length);
+    }
+    VariableRuntimeCache->PendingUpdates[0].Offset = Start;
+    VariableRuntimeCache->PendingUpdates[0].Length = End - Start;
+    VariableRuntimeCache->PendingUpdateCount       = 1;
+    return;
+  }
+
+  Update         = &VariableRuntimeCache->PendingUpdates[VariableRuntimeCache->PendingUpdateCount++];
+  Update->Offset = Offset;
+  Update->Length = Length;
+}
+
+/**
+  Copies the pending updates of a runtime cache from the variable store it caches.
+
+  @param[in, out] VariableRuntimeCache Variable runtime cache structure for the runtime cache being updated.
+  @param[in]      VariableStore        The variable store cached by the runtime cache.
+
+  @retval TRUE                         The store header was copied, so the runtime cache was rewritten.
+  @retval FALSE                        Only variables were appended or changed.
+
+**/
+BOOLEAN
+CopyPendingRuntimeCacheUpdates (
+  IN OUT VARIABLE_RUNTIME_CACHE       *VariableRuntimeCache,
+  IN     VARIABLE_STORE_HEADER        *VariableStore
+  )
+{
+  VARIABLE_RUNTIME_CACHE_UPDATE       *Update;
+  UINT32                              Index;
+  BOOLEAN                             Rebuild;
+
+  Rebuild = FALSE;
+  for (Index = 0; Index < VariableRuntimeCache->PendingUpdateCount; Index++) {
+    Update = &VariableRuntimeCache->PendingUpdates[Index];
+    CopyMem (
+      (UINT8 *) VariableRuntimeCache->Store + Update->Offset,
+      (UINT8 *) VariableStore + Update->Offset,
+      Update->Length
+      );
+    //
+    // Appending a variable or changing its state never touches the store
+    // header, so an update starting at offset 0 means the store was rewritten,
+    // either at initialization or by a reclaim.
+    //
+    if (Update->Offset == 0) {
+      Rebuild = TRUE;
+    }
+  }
+  VariableRuntimeCache->PendingUpdateCount = 0;
+
+  return Rebuild;
+}
+
 /**
   Copies any pending updates to runtime variable caches.
 
+  The runtime caches are updated in place between two increments of the sequence count, so readers that overlap
+  the update observe a changed sequence count and retry their read.
+
   @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
   @retval EFI_SUCCESS             The volatile store was updated successfully.
 
@@ -31,61 +133,48 @@ FlushPendingRuntimeVariableCacheUpdates (
   )
 {
   VARIABLE_RUNTIME_CACHE_CONTEXT    *VariableRuntimeCacheContext;
+  volatile UINT32                   *SequenceCount;
+  BOOLEAN                           Rebuild;
 
   VariableRuntimeCacheContext = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
 
   if (VariableRuntimeCacheContext->VariableRuntimeNvCache.Store == NULL ||
       VariableRuntimeCacheContext->VariableRuntimeVolatileCache.Store == NULL ||
-      VariableRuntimeCacheContext->PendingUpdate == NULL) {
+      VariableRuntimeCacheContext->PendingUpdate == NULL ||
+      VariableRuntimeCacheContext->SequenceCount == NULL) {
     return EFI_UNSUPPORTED;
   }
 
   if (*(VariableRuntimeCacheContext->PendingUpdate)) {
+    SequenceCount = VariableRuntimeCacheContext->SequenceCount;
+    *SequenceCount = *SequenceCount + 1;
+    MemoryFence ();
+
+    Rebuild = FALSE;
     if (VariableRuntimeCacheContext->VariableRuntimeHobCache.Store != NULL &&
         mVariableModuleGlobal->VariableGlobal.HobVariableBase > 0) {
-      CopyMem (
-        (VOID *) (
-          ((UINT8 *) (UINTN) VariableRuntimeCacheContext->VariableRuntimeHobCache.Store) +
-          VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset
-          ),
-        (VOID *) (
-          ((UINT8 *) (UINTN) mVariableModuleGlobal->VariableGlobal.HobVariableBase) +
-          VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset
-          ),
-        VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateLength
-        );
-      VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateLength = 0;
-      VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
+      Rebuild |= CopyPendingRuntimeCacheUpdates (
+                   &VariableRuntimeCacheContext->VariableRuntimeHobCache,
+                   (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.HobVariableBase
+                   );
     }
+    VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateCount = 0;
 
-    CopyMem (
-      (VOID *) (
-        ((UINT8 *) (UINTN) VariableRuntimeCacheContext->VariableRuntimeNvCache.Store) +
-        VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset
-        ),
-      (VOID *) (
-        ((UINT8 *) (UINTN) mNvVariableCache) +
-        VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset
-        ),
-      VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateLength
-      );
-    VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateLength = 0;
-    VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset = 0;
-
-    CopyMem (
-      (VOID *) (
-        ((UINT8 *) (UINTN) VariableRuntimeCacheContext->VariableRuntimeVolatileCache.Store) +
-        VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset
-      ),
-      (VOID *) (
-        ((UINT8 *) (UINTN) mVariableModuleGlobal->VariableGlobal.VolatileVariableBase) +
-        VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset
-        ),
-      VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength
-      );
-    VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = 0;
-    VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
+    Rebuild |= CopyPendingRuntimeCacheUpdates (
+                 &VariableRuntimeCacheContext->VariableRuntimeNvCache,
+                 mNvVariableCache
+                 );
+    Rebuild |= CopyPendingRuntimeCacheUpdates (
+                 &VariableRuntimeCacheContext->VariableRuntimeVolatileCache,
+                 (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.VolatileVariableBase
+                 );
+    if (Rebuild && VariableRuntimeCacheContext->RebuildCount != NULL) {
+      (*(VariableRuntimeCacheContext->RebuildCount))++;
+    }
     *(VariableRuntimeCacheContext->PendingUpdate) = FALSE;
+
+    MemoryFence ();
+    *SequenceCount = *SequenceCount + 1;
   }
 
   return EFI_SUCCESS;
@@ -94,17 +183,15 @@ FlushPendingRuntimeVariableCacheUpdates (
 /**
   Synchronizes the runtime variable caches with all pending updates outside runtime.
 
-  Ensures all conditions are met to maintain coherency for runtime cache updates. This function will attempt
-  to write the given update (and any other pending updates) if the ReadLock is available. Otherwise, the
-  update is added as a pending update for the given variable store and it will be flushed to the runtime cache
-  at the next opportunity the ReadLock is available.
+  The given update is added to the pending updates of the runtime cache, and all pending updates are written to the
+  runtime caches. Readers of the runtime caches never block the update; they detect it through the sequence count
+  and retry their read.
 
   @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being synchronized.
   @param[in] Offset               Offset in bytes to apply the update.
   @param[in] Length               Length of data in bytes of the update.
 
-  @retval EFI_SUCCESS             The update was added as a pending update successfully. If the variable runtime
-                                  cache ReadLock was available, the runtime cache was updated successfully.
+  @retval EFI_SUCCESS             The runtime cache was updated successfully.
   @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
 
 **/
@@ -124,30 +211,77 @@ SynchronizeRuntimeVariableCache (
   }
 
   if (mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate == NULL ||
-      mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.ReadLock == NULL) {
+      mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.SequenceCount == NULL) {
     return EFI_UNSUPPORTED;
   }
 
-  if (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) &&
-      VariableRuntimeCache->PendingUpdateLength > 0) {
-    VariableRuntimeCache->PendingUpdateLength =
-      (UINT32) (
-        MAX (
-          (UINTN) (VariableRuntimeCache->PendingUpdateOffset + VariableRuntimeCache->PendingUpdateLength),
-          Offset + Length
-        ) - MIN ((UINTN) VariableRuntimeCache->PendingUpdateOffset, Offset)
-      );
-    VariableRuntimeCache->PendingUpdateOffset =
-      (UINT32) MIN ((UINTN) VariableRuntimeCache->PendingUpdateOffset, Offset);
-  } else {
-    VariableRuntimeCache->PendingUpdateLength = (UINT32) Length;
-    VariableRuntimeCache->PendingUpdateOffset = (UINT32) Offset;
+  if (Offset > VariableRuntimeCache->Store->Size || Length > VariableRuntimeCache->Store->Size - Offset) {
+    return EFI_INVALID_PARAMETER;
   }
-  *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) = TRUE;
 
-  if (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.ReadLock) == FALSE) {
-    return FlushPendingRuntimeVariableCacheUpdates ();
+  AddPendingRuntimeCacheUpdate (VariableRuntimeCache, (UINT32) Offset, (UINT32) Length);
+  if (VariableRuntimeCache->PendingUpdateCount > 0) {
+    *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) = TRUE;
   }
 
-  return EFI_SUCCESS;
+  return FlushPendingRuntimeVariableCacheUpdates ();
+}
+
+/**
+  Synchronizes a runtime variable cache with the update of a single variable.
+
+  Only the state of the variable headers the update deleted and the variables it appended are copied to the
+  runtime cache. If the update reclaimed the variable store, Reclaim () already synchronized the whole store.
+
+  @param[in] VariableRuntimeCache        Variable runtime cache structure for the runtime cache being synchronized.
+  @param[in] VariableStore               The variable store cached by the runtime cache.
+  @param[in] UpdatedVariable             The variable headers whose state the update changed.
+  @param[in] PreviousLastVariableOffset  The offset of the end of the variables before the update.
+  @param[in] LastVariableOffset          The offset of the end of the variables after the update.
+
+  @retval EFI_SUCCESS             The runtime cache was updated successfully.
+  @retval EFI_INVALID_PARAMETER   VariableRuntimeCache or UpdatedVariable is NULL.
+  @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
+
+**/
+EFI_STATUS
+SynchronizeRuntimeVariableCacheWithUpdate (
+  IN  VARIABLE_RUNTIME_CACHE          *VariableRuntimeCache,
+  IN  VARIABLE_STORE_HEADER           *VariableStore,
+  IN  VARIABLE_POINTER_TRACK          *UpdatedVariable,
+  IN  UINTN                           PreviousLastVariableOffset,
+  IN  UINTN                           LastVariableOffset
+  )
+{
+  VARIABLE_HEADER                     *Headers[2];
+  UINTN                               Index;
+  UINTN                               Offset;
+
+  if (VariableRuntimeCache == NULL || UpdatedVariable == NULL) {
+    return EFI_INVALID_PARAMETER;
+  } else if (VariableRuntimeCache->Store == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Headers[0] = UpdatedVariable->CurrPtr;
+  Headers[1] = UpdatedVariable->InDeletedTransitionPtr;
+  for (Index = 0; Index < ARRAY_SIZE (Headers); Index++) {
+    if (Headers[Index] == NULL ||
+        (UINTN) Headers[Index] < (UINTN) GetStartPointer (VariableStore) ||
+        (UINTN) Headers[Index] >= (UINTN) VariableStore + LastVariableOffset) {
+      continue;
+    }
+    Offset = (UINTN) &Headers[Index]->State - (UINTN) VariableStore;
+    AddPendingRuntimeCacheUpdate (VariableRuntimeCache, (UINT32) Offset, sizeof (Headers[Index]->State));
+  }
+
+  if (LastVariableOffset > PreviousLastVariableOffset) {
+    return SynchronizeRuntimeVariableCache (
+             VariableRuntimeCache,
+             PreviousLastVariableOffset,
+             LastVariableOffset - PreviousLastVariableOffset
+             );
+  }
+
+  return SynchronizeRuntimeVariableCache (VariableRuntimeCache, 0, 0);
 }
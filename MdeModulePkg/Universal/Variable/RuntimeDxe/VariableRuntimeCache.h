@@ -27,17 +27,15 @@ FlushPendingRuntimeVariableCacheUpdates (
 /**
   Synchronizes the runtime variable caches with all pending updates outside runtime.
 
-  Ensures all conditions are met to maintain coherency for runtime cache updates. This function will attempt
-  to write the given update (and any other pending updates) if the ReadLock is available. Otherwise, the
-  update is added as a pending update for the given variable store and it will be flushed to the runtime cache
-  at the next opportunity the ReadLock is available.
+  The given update is added to the pending updates of the runtime cache, and all pending updates are written to the
+  runtime caches. Readers of the runtime caches never block the update; they detect it through the sequence count
+  and retry their read.
 
   @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being synchronized.
   @param[in] Offset               Offset in bytes to apply the update.
   @param[in] Length               Length of data in bytes of the update.
 
-  @retval EFI_SUCCESS             The update was added as a pending update successfully. If the variable runtime
-                                  cache ReadLock was available, the runtime cache was updated successfully.
+  @retval EFI_SUCCESS             The runtime cache was updated successfully.
   @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
 
 **/
@@ -48,4 +46,30 @@ SynchronizeRuntimeVariableCache (
   IN  UINTN                           Length
   );
 
+/**
+  Synchronizes a runtime variable cache with the update of a single variable.
+
+  Only the state of the variable headers the update deleted and the variables it appended are copied to the
+  runtime cache. If the update reclaimed the variable store, Reclaim () already synchronized the whole store.
+
+  @param[in] VariableRuntimeCache        Variable runtime cache structure for the runtime cache being synchronized.
+  @param[in] VariableStore               The variable store cached by the runtime cache.
+  @param[in] UpdatedVariable             The variable headers whose state the update changed.
+  @param[in] PreviousLastVariableOffset  The offset of the end of the variables before the update.
+  @param[in] LastVariableOffset          The offset of the end of the variables after the update.
+
+  @retval EFI_SUCCESS             The runtime cache was updated successfully.
+  @retval EFI_INVALID_PARAMETER   VariableRuntimeCache or UpdatedVariable is NULL.
+  @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
+
+**/
+EFI_STATUS
+SynchronizeRuntimeVariableCacheWithUpdate (
+  IN  VARIABLE_RUNTIME_CACHE          *VariableRuntimeCache,
+  IN  VARIABLE_STORE_HEADER           *VariableStore,
+  IN  VARIABLE_POINTER_TRACK          *UpdatedVariable,
+  IN  UINTN                           PreviousLastVariableOffset,
+  IN  UINTN                           LastVariableOffset
+  );
+
 #endif
@@ -424,6 +424,97 @@ SmmVariableGetStatistics (
   return EFI_SUCCESS;
 }
 
+/**
+  Get or set the variables of a batch that was copied to the SMM variable
+  buffer payload.
+
+  Caution: This function may receive untrusted input.
+  The batch is external input, so each entry is validated before it is used,
+  and the walk stops at the first invalid entry.
+
+  @param[in] SetVariable          TRUE to set the variables, FALSE to get them.
+  @param[in] PayloadSize          The size of the batch.
+
+  @retval EFI_SUCCESS             All the entries were handled, the status of each entry
+                                  tells whether it was got or set.
+  @retval EFI_ACCESS_DENIED       An entry is invalid. The entries before it were handled.
+
+**/
+EFI_STATUS
+SmmVariableAccessVariableBatch (
+  IN BOOLEAN                                              SetVariable,
+  IN UINTN                                                PayloadSize
+  )
+{
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH          *Batch;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY    *Entry;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE                *SmmVariableHeader;
+  UINTN                                                   EntryCount;
+  UINTN                                                   Index;
+  UINTN                                                   Offset;
+  UINTN                                                   EntrySize;
+
+  Batch      = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH *) mVariableBufferPayload;
+  EntryCount = Batch->EntryCount;
+  Offset     = sizeof (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH);
+
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (PayloadSize - Offset < SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE) {
+      return EFI_ACCESS_DENIED;
+    }
+    Entry             = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY *) (mVariableBufferPayload + Offset);
+    SmmVariableHeader = &Entry->Variable;
+
+    //
+    // Both sizes are bounded by the payload size, so the entry size can not
+    // overflow.
+    //
+    if ((SmmVariableHeader->NameSize > PayloadSize - Offset - SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE) ||
+        (SmmVariableHeader->DataSize > PayloadSize - Offset - SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE - SmmVariableHeader->NameSize)) {
+      DEBUG ((DEBUG_ERROR, "VariableBatch: Data size exceed communication buffer size limit!\n"));
+      return EFI_ACCESS_DENIED;
+    }
+    EntrySize = SMM_VARIABLE_BATCH_ENTRY_SIZE (SmmVariableHeader->NameSize, SmmVariableHeader->DataSize);
+    if (EntrySize > PayloadSize - Offset) {
+      return EFI_ACCESS_DENIED;
+    }
+
+    //
+    // The VariableSpeculationBarrier() call here is to ensure the previous
+    // range/content checks for the CommBuffer have been completed before the
+    // subsequent consumption of the CommBuffer content.
+    //
+    VariableSpeculationBarrier ();
+    if (SmmVariableHeader->NameSize < sizeof (CHAR16) || SmmVariableHeader->Name[SmmVariableHeader->NameSize/sizeof (CHAR16) - 1] != L'\0') {
+      //
+      // Make sure VariableName is A Null-terminated string.
+      //
+      return EFI_ACCESS_DENIED;
+    }
+
+    if (SetVariable) {
+      Entry->Status = VariableServiceSetVariable (
+                        SmmVariableHeader->Name,
+                        &SmmVariableHeader->Guid,
+                        SmmVariableHeader->Attributes,
+                        SmmVariableHeader->DataSize,
+                        (UINT8 *)SmmVariableHeader->Name + SmmVariableHeader->NameSize
+                        );
+    } else {
+      Entry->Status = VariableServiceGetVariable (
+                        SmmVariableHeader->Name,
+                        &SmmVariableHeader->Guid,
+                        &SmmVariableHeader->Attributes,
+                        &SmmVariableHeader->DataSize,
+                        (UINT8 *)SmmVariableHeader->Name + SmmVariableHeader->NameSize
+                        );
+    }
+
+    Offset += EntrySize;
+  }
+
+  return EFI_SUCCESS;
+}
 
 /**
   Communication service SMI Handler entry.
@@ -797,7 +888,11 @@ SmmVariableHandler (
       CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
       break;
     case SMM_VARIABLE_FUNCTION_INIT_RUNTIME_VARIABLE_CACHE_CONTEXT:
-      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT)) {
+      //
+      // RebuildCount was appended to the context, a caller that doesn't know
+      // it may send a shorter context without it.
+      //
+      if (CommBufferPayloadSize < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT, RebuildCount)) {
         DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: SMM communication buffer size invalid!\n"));
         Status = EFI_ACCESS_DENIED;
         goto EXIT;
@@ -813,6 +908,9 @@ SmmVariableHandler (
       //
       CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
       RuntimeVariableCacheContext = (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT *) mVariableBufferPayload;
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT)) {
+        RuntimeVariableCacheContext->RebuildCount = NULL;
+      }
 
       //
       // Verify required runtime cache buffers are provided.
@@ -820,7 +918,7 @@ SmmVariableHandler (
       if (RuntimeVariableCacheContext->RuntimeVolatileCache == NULL ||
           RuntimeVariableCacheContext->RuntimeNvCache == NULL ||
           RuntimeVariableCacheContext->PendingUpdate == NULL ||
-          RuntimeVariableCacheContext->ReadLock == NULL ||
+          RuntimeVariableCacheContext->SequenceCount == NULL ||
           RuntimeVariableCacheContext->HobFlushComplete == NULL) {
         DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Required runtime cache buffer is NULL!\n"));
         Status = EFI_ACCESS_DENIED;
@@ -872,9 +970,9 @@ SmmVariableHandler (
         goto EXIT;
       }
       if (!VariableSmmIsBufferOutsideSmmValid (
-            (UINTN) RuntimeVariableCacheContext->ReadLock,
-            sizeof (*(RuntimeVariableCacheContext->ReadLock)))) {
-        DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Runtime cache read lock buffer in SMRAM or overflow!\n"));
+            (UINTN) RuntimeVariableCacheContext->SequenceCount,
+            sizeof (*(RuntimeVariableCacheContext->SequenceCount)))) {
+        DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Runtime cache sequence count buffer in SMRAM or overflow!\n"));
         Status = EFI_ACCESS_DENIED;
         goto EXIT;
       }
@@ -885,36 +983,48 @@ SmmVariableHandler (
         Status = EFI_ACCESS_DENIED;
         goto EXIT;
       }
+      if (RuntimeVariableCacheContext->RebuildCount != NULL &&
+          !VariableSmmIsBufferOutsideSmmValid (
+            (UINTN) RuntimeVariableCacheContext->RebuildCount,
+            sizeof (*(RuntimeVariableCacheContext->RebuildCount)))) {
+        DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Runtime cache rebuild count buffer in SMRAM or overflow!\n"));
+        Status = EFI_ACCESS_DENIED;
+        goto EXIT;
+      }
 
       VariableCacheContext = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
       VariableCacheContext->VariableRuntimeHobCache.Store      = RuntimeVariableCacheContext->RuntimeHobCache;
       VariableCacheContext->VariableRuntimeVolatileCache.Store = RuntimeVariableCacheContext->RuntimeVolatileCache;
       VariableCacheContext->VariableRuntimeNvCache.Store       = RuntimeVariableCacheContext->RuntimeNvCache;
       VariableCacheContext->PendingUpdate                      = RuntimeVariableCacheContext->PendingUpdate;
-      VariableCacheContext->ReadLock                           = RuntimeVariableCacheContext->ReadLock;
+      VariableCacheContext->SequenceCount                      = RuntimeVariableCacheContext->SequenceCount;
       VariableCacheContext->HobFlushComplete                   = RuntimeVariableCacheContext->HobFlushComplete;
+      VariableCacheContext->RebuildCount                       = RuntimeVariableCacheContext->RebuildCount;
 
       // Set up the intial pending request since the RT cache needs to be in sync with SMM cache
-      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateLength = 0;
+      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateCount = 0;
       if (mVariableModuleGlobal->VariableGlobal.HobVariableBase > 0 &&
           VariableCacheContext->VariableRuntimeHobCache.Store != NULL) {
         VariableCache = (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.HobVariableBase;
-        VariableCacheContext->VariableRuntimeHobCache.PendingUpdateLength = (UINT32) ((UINTN) GetEndPointer (VariableCache) - (UINTN) VariableCache);
+        VariableCacheContext->VariableRuntimeHobCache.PendingUpdates[0].Offset = 0;
+        VariableCacheContext->VariableRuntimeHobCache.PendingUpdates[0].Length = (UINT32) ((UINTN) GetEndPointer (VariableCache) - (UINTN) VariableCache);
+        VariableCacheContext->VariableRuntimeHobCache.PendingUpdateCount       = 1;
         CopyGuid (&(VariableCacheContext->VariableRuntimeHobCache.Store->Signature), &(VariableCache->Signature));
       }
       VariableCache = (VARIABLE_STORE_HEADER  *) (UINTN) mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
-      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset   = 0;
-      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength   = (UINT32) ((UINTN) GetEndPointer (VariableCache) - (UINTN) VariableCache);
+      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdates[0].Offset = 0;
+      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdates[0].Length = (UINT32) ((UINTN) GetEndPointer (VariableCache) - (UINTN) VariableCache);
+      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateCount       = 1;
       CopyGuid (&(VariableCacheContext->VariableRuntimeVolatileCache.Store->Signature), &(VariableCache->Signature));
 
       VariableCache = (VARIABLE_STORE_HEADER  *) (UINTN) mNvVariableCache;
-      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateLength = (UINT32) ((UINTN) GetEndPointer (VariableCache) - (UINTN) VariableCache);
+      VariableCacheContext->VariableRuntimeNvCache.PendingUpdates[0].Offset = 0;
+      VariableCacheContext->VariableRuntimeNvCache.PendingUpdates[0].Length = (UINT32) ((UINTN) GetEndPointer (VariableCache) - (UINTN) VariableCache);
+      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateCount       = 1;
       CopyGuid (&(VariableCacheContext->VariableRuntimeNvCache.Store->Signature), &(VariableCache->Signature));
 
       *(VariableCacheContext->PendingUpdate) = TRUE;
-      *(VariableCacheContext->ReadLock) = FALSE;
+      *(VariableCacheContext->SequenceCount) = 0;
       *(VariableCacheContext->HobFlushComplete) = FALSE;
 
       Status = EFI_SUCCESS;
@@ -945,6 +1055,23 @@ SmmVariableHandler (
       Status = EFI_SUCCESS;
       break;
 
+    case SMM_VARIABLE_FUNCTION_GET_VARIABLE_BATCH:
+    case SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH:
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH)) {
+        DEBUG ((DEBUG_ERROR, "VariableBatch: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+      //
+      // Copy the input communicate buffer payload to pre-allocated SMM variable buffer payload.
+      //
+      CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
+      Status = SmmVariableAccessVariableBatch (
+                 (BOOLEAN) (SmmVariableFunctionHeader->Function == SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH),
+                 CommBufferPayloadSize
+                 );
+      CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
+      break;
+
     default:
       Status = EFI_UNSUPPORTED;
   }
@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SmmVariable.h>
 #include <Protocol/VariableLock.h>
 #include <Protocol/VarCheck.h>
+#include <Protocol/VariableBatch.h>
 
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -41,6 +42,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "PrivilegePolymorphic.h"
 #include "VariableParsing.h"
+#include "VariableIndex.h"
+
+//
+// The number of times a read of the runtime caches is retried when SMM updates
+// them during the read, before the read is done in SMM instead.
+//
+#define VARIABLE_RUNTIME_CACHE_READ_RETRIES  8
 
 EFI_HANDLE                       mHandle                    = NULL;
 EFI_SMM_VARIABLE_PROTOCOL       *mSmmVariable               = NULL;
@@ -52,18 +60,23 @@ VARIABLE_INFO_ENTRY             *mVariableInfo              = NULL;
 VARIABLE_STORE_HEADER           *mVariableRuntimeHobCacheBuffer           = NULL;
 VARIABLE_STORE_HEADER           *mVariableRuntimeNvCacheBuffer            = NULL;
 VARIABLE_STORE_HEADER           *mVariableRuntimeVolatileCacheBuffer      = NULL;
+CHAR16                          *mVariableRuntimeCacheNameBuffer          = NULL;
 UINTN                            mVariableBufferSize;
 UINTN                            mVariableRuntimeHobCacheBufferSize;
 UINTN                            mVariableRuntimeNvCacheBufferSize;
 UINTN                            mVariableRuntimeVolatileCacheBufferSize;
+UINTN                            mVariableRuntimeCacheNameBufferSize;
 UINTN                            mVariableBufferPayloadSize;
 BOOLEAN                          mVariableRuntimeCachePendingUpdate;
-BOOLEAN                          mVariableRuntimeCacheReadLock;
+UINT32                           mVariableRuntimeCacheSequenceCount;
 BOOLEAN                          mVariableAuthFormat;
 BOOLEAN                          mHobFlushComplete;
+UINT32                           mVariableRuntimeCacheRebuildCount;
+UINT32                           mVariableStoreIndexRebuildCount;
 EFI_LOCK                         mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL     mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL         mVarCheck;
+EDKII_VARIABLE_BATCH_PROTOCOL    mVariableBatch;
 
 /**
   Some Secure Boot Policy Variable may update following other variable changes(SecureBoot follows PK change, etc).
@@ -528,7 +541,8 @@ SyncRuntimeCache (
   Check whether a SMI must be triggered to retrieve pending cache updates.
 
   If the variable HOB was finished being flushed since the last check for a runtime cache update, this function
-  will prevent the HOB cache from being used for future runtime cache hits.
+  will prevent the HOB cache from being used for future runtime cache hits. If SMM rewrote a runtime cache since
+  the last check, the variable store indexes are dropped.
 
 **/
 VOID
@@ -541,10 +555,16 @@ CheckForRuntimeCacheSync (
   }
   ASSERT (!mVariableRuntimeCachePendingUpdate);
 
+  if (mVariableStoreIndexRebuildCount != mVariableRuntimeCacheRebuildCount) {
+    InvalidateVariableStoreIndex (NULL);
+    mVariableStoreIndexRebuildCount = mVariableRuntimeCacheRebuildCount;
+  }
+
   //
   // The HOB variable data may have finished being flushed in the runtime cache sync update
   //
   if (mHobFlushComplete && mVariableRuntimeHobCacheBuffer != NULL) {
+    InvalidateVariableStoreIndex (mVariableRuntimeHobCacheBuffer);
     if (!EfiAtRuntime ()) {
       FreePages (mVariableRuntimeHobCacheBuffer, EFI_SIZE_TO_PAGES (mVariableRuntimeHobCacheBufferSize));
     }
@@ -552,9 +572,58 @@ CheckForRuntimeCacheSync (
   }
 }
 
+/**
+  Begins a read of the runtime caches.
+
+  @return The sequence count of the runtime caches the read must be validated against.
+
+**/
+UINT32
+BeginRuntimeCacheRead (
+  VOID
+  )
+{
+  UINT32  SequenceCount;
+
+  SequenceCount = *(volatile UINT32 *) &mVariableRuntimeCacheSequenceCount;
+  MemoryFence ();
+  return SequenceCount;
+}
+
+/**
+  Ends a read of the runtime caches.
+
+  @param[in] SequenceCount  The sequence count returned by BeginRuntimeCacheRead ().
+
+  @retval TRUE              No update of the runtime caches overlapped the read.
+  @retval FALSE             The runtime caches were updated during the read, which must be retried.
+
+**/
+BOOLEAN
+EndRuntimeCacheRead (
+  IN UINT32  SequenceCount
+  )
+{
+  MemoryFence ();
+  if ((SequenceCount & BIT0) == 0 &&
+      *(volatile UINT32 *) &mVariableRuntimeCacheSequenceCount == SequenceCount) {
+    return TRUE;
+  }
+
+  //
+  // The store indexes may have been extended with variable headers that were
+  // being written.
+  //
+  InvalidateVariableStoreIndex (NULL);
+  return FALSE;
+}
+
 /**
   Finds the given variable in a runtime cache variable store.
 
+  The runtime caches are read without blocking SMM from updating them. If an update overlaps the read, the read is
+  retried, and the variable must be read from SMM if the runtime caches kept being updated.
+
   Caution: This function may receive untrusted input.
   The data size is external input, so this function will validate it carefully to avoid buffer overflow.
 
@@ -568,6 +637,7 @@ CheckForRuntimeCacheSync (
   @retval EFI_SUCCESS                Found the specified variable.
   @retval EFI_INVALID_PARAMETER      Invalid parameter.
   @retval EFI_NOT_FOUND              The specified variable could not be found.
+  @retval EFI_NOT_READY              The runtime caches were updated during every read attempt.
 
 **/
 EFI_STATUS
@@ -581,30 +651,29 @@ FindVariableInRuntimeCache (
 {
   EFI_STATUS              Status;
   UINTN                   TempDataSize;
+  UINT8                   *TempData;
+  UINT32                  TempAttributes;
+  UINT32                  SequenceCount;
+  UINTN                   Retry;
   VARIABLE_POINTER_TRACK  RtPtrTrack;
   VARIABLE_STORE_TYPE     StoreType;
   VARIABLE_STORE_HEADER   *VariableStoreList[VariableStoreTypeMax];
 
-  Status = EFI_NOT_FOUND;
-
   if (VariableName == NULL || VendorGuid == NULL || DataSize == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  ZeroMem (&RtPtrTrack, sizeof (RtPtrTrack));
-
-  //
-  // The UEFI specification restricts Runtime Services callers from invoking the same or certain other Runtime Service
-  // functions prior to completion and return from a previous Runtime Service call. These restrictions prevent
-  // a GetVariable () or GetNextVariable () call from being issued until a prior call has returned. The runtime
-  // cache read lock should always be free when entering this function.
-  //
-  ASSERT (!mVariableRuntimeCacheReadLock);
+  for (Retry = 0; Retry < VARIABLE_RUNTIME_CACHE_READ_RETRIES; Retry++) {
+    SequenceCount = BeginRuntimeCacheRead ();
+    if ((SequenceCount & BIT0) != 0) {
+      CpuPause ();
+      continue;
+    }
+    CheckForRuntimeCacheSync ();
 
-  mVariableRuntimeCacheReadLock = TRUE;
-  CheckForRuntimeCacheSync ();
+    Status = EFI_NOT_FOUND;
+    ZeroMem (&RtPtrTrack, sizeof (RtPtrTrack));
 
-  if (!mVariableRuntimeCachePendingUpdate) {
     //
     // 0: Volatile, 1: HOB, 2: Non-Volatile.
     // The index and attributes mapping must be kept in this order as FindVariable
@@ -629,43 +698,48 @@ FindVariableInRuntimeCache (
       }
     }
 
+    TempDataSize   = 0;
+    TempAttributes = 0;
     if (!EFI_ERROR (Status)) {
       //
       // Get data size
       //
-      TempDataSize = DataSizeOfVariable (RtPtrTrack.CurrPtr, mVariableAuthFormat);
-      ASSERT (TempDataSize != 0);
-
-      if (*DataSize >= TempDataSize) {
+      TempDataSize   = DataSizeOfVariable (RtPtrTrack.CurrPtr, mVariableAuthFormat);
+      TempData       = GetVariableDataPtr (RtPtrTrack.CurrPtr, mVariableAuthFormat);
+      TempAttributes = RtPtrTrack.CurrPtr->Attributes;
+
+      if (TempDataSize > (UINTN) RtPtrTrack.EndPtr - (UINTN) TempData) {
+        //
+        // Only a variable being written can run past its store.
+        //
+        Status = EFI_NOT_FOUND;
+      } else if (*DataSize >= TempDataSize) {
         if (Data == NULL) {
           Status = EFI_INVALID_PARAMETER;
-          goto Done;
+        } else {
+          CopyMem (Data, TempData, TempDataSize);
         }
-
-        CopyMem (Data, GetVariableDataPtr (RtPtrTrack.CurrPtr, mVariableAuthFormat), TempDataSize);
-        *DataSize = TempDataSize;
-
-        UpdateVariableInfo (VariableName, VendorGuid, RtPtrTrack.Volatile, TRUE, FALSE, FALSE, TRUE, &mVariableInfo);
-
-        Status = EFI_SUCCESS;
-        goto Done;
       } else {
-        *DataSize = TempDataSize;
         Status = EFI_BUFFER_TOO_SMALL;
-        goto Done;
       }
     }
-  }
 
-Done:
-  if (Status == EFI_SUCCESS || Status == EFI_BUFFER_TOO_SMALL) {
-    if (Attributes != NULL && RtPtrTrack.CurrPtr != NULL) {
-      *Attributes = RtPtrTrack.CurrPtr->Attributes;
+    if (EndRuntimeCacheRead (SequenceCount)) {
+      if (Status == EFI_SUCCESS || Status == EFI_BUFFER_TOO_SMALL) {
+        ASSERT (TempDataSize != 0);
+        *DataSize = TempDataSize;
+        if (Attributes != NULL) {
+          *Attributes = TempAttributes;
+        }
+      }
+      if (Status == EFI_SUCCESS) {
+        UpdateVariableInfo (VariableName, VendorGuid, RtPtrTrack.Volatile, TRUE, FALSE, FALSE, TRUE, &mVariableInfo);
+      }
+      return Status;
     }
   }
-  mVariableRuntimeCacheReadLock = FALSE;
 
-  return Status;
+  return EFI_NOT_READY;
 }
 
 /**
@@ -818,6 +892,9 @@ RuntimeServiceGetVariable (
   AcquireLockOnlyAtBootTime (&mVariableServicesLock);
   if (FeaturePcdGet (PcdEnableVariableRuntimeCache)) {
     Status = FindVariableInRuntimeCache (VariableName, VendorGuid, Attributes, DataSize, Data);
+    if (Status == EFI_NOT_READY) {
+      Status = FindVariableInSmm (VariableName, VendorGuid, Attributes, DataSize, Data);
+    }
   } else {
     Status = FindVariableInSmm (VariableName, VendorGuid, Attributes, DataSize, Data);
   }
@@ -829,6 +906,9 @@ RuntimeServiceGetVariable (
 /**
   Finds the next available variable in a runtime cache variable store.
 
+  The runtime caches are read without blocking SMM from updating them. If an update overlaps the read, the read is
+  retried, and the next variable must be found in SMM if the runtime caches kept being updated.
+
   @param[in, out] VariableNameSize   Size of the variable name.
   @param[in, out] VariableName       Pointer to variable name.
   @param[in, out] VendorGuid         Variable Vendor Guid.
@@ -837,6 +917,8 @@ RuntimeServiceGetVariable (
   @retval EFI_SUCCESS                Find the specified variable.
   @retval EFI_NOT_FOUND              Not found.
   @retval EFI_BUFFER_TO_SMALL        DataSize is too small for the result.
+  @retval EFI_NOT_READY              The runtime caches were updated during every read attempt.
+                                     VariableNameSize, VariableName and VendorGuid are unchanged.
 
 **/
 EFI_STATUS
@@ -848,23 +930,38 @@ GetNextVariableNameInRuntimeCache (
 {
   EFI_STATUS              Status;
   UINTN                   VarNameSize;
+  CHAR16                  *VarName;
+  UINTN                   InVariableNameSize;
+  UINTN                   InVariableNameLength;
+  EFI_GUID                InVendorGuid;
+  UINT32                  SequenceCount;
+  UINTN                   Retry;
   VARIABLE_HEADER         *VariablePtr;
+  VARIABLE_HEADER         *VariableStoreEnd;
+  VARIABLE_STORE_TYPE     StoreType;
   VARIABLE_STORE_HEADER   *VariableStoreHeader[VariableStoreTypeMax];
 
-  Status = EFI_NOT_FOUND;
-
   //
-  // The UEFI specification restricts Runtime Services callers from invoking the same or certain other Runtime Service
-  // functions prior to completion and return from a previous Runtime Service call. These restrictions prevent
-  // a GetVariable () or GetNextVariable () call from being issued until a prior call has returned. The runtime
-  // cache read lock should always be free when entering this function.
+  // The name found is returned in the buffer of the name searched for, so the
+  // latter is saved to retry the search if the name copied out was being
+  // rewritten.
   //
-  ASSERT (!mVariableRuntimeCacheReadLock);
+  InVariableNameSize   = *VariableNameSize;
+  InVariableNameLength = StrSize (VariableName);
+  if (InVariableNameLength > mVariableRuntimeCacheNameBufferSize) {
+    return EFI_NOT_READY;
+  }
+  CopyMem (mVariableRuntimeCacheNameBuffer, VariableName, InVariableNameLength);
+  CopyGuid (&InVendorGuid, VendorGuid);
 
-  CheckForRuntimeCacheSync ();
+  for (Retry = 0; Retry < VARIABLE_RUNTIME_CACHE_READ_RETRIES; Retry++) {
+    SequenceCount = BeginRuntimeCacheRead ();
+    if ((SequenceCount & BIT0) != 0) {
+      CpuPause ();
+      continue;
+    }
+    CheckForRuntimeCacheSync ();
 
-  mVariableRuntimeCacheReadLock = TRUE;
-  if (!mVariableRuntimeCachePendingUpdate) {
     //
     // 0: Volatile, 1: HOB, 2: Non-Volatile.
     // The index and attributes mapping must be kept in this order as FindVariable
@@ -882,22 +979,49 @@ GetNextVariableNameInRuntimeCache (
                 mVariableAuthFormat
                 );
     if (!EFI_ERROR (Status)) {
+      VariableStoreEnd = NULL;
+      for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+        if ((VariableStoreHeader[StoreType] != NULL) &&
+            ((UINTN) VariablePtr >= (UINTN) GetStartPointer (VariableStoreHeader[StoreType])) &&
+            ((UINTN) VariablePtr < (UINTN) GetEndPointer (VariableStoreHeader[StoreType]))) {
+          VariableStoreEnd = GetEndPointer (VariableStoreHeader[StoreType]);
+          break;
+        }
+      }
+
       VarNameSize = NameSizeOfVariable (VariablePtr, mVariableAuthFormat);
-      ASSERT (VarNameSize != 0);
-      if (VarNameSize <= *VariableNameSize) {
-        CopyMem (VariableName, GetVariableNamePtr (VariablePtr, mVariableAuthFormat), VarNameSize);
-        CopyMem (VendorGuid, GetVendorGuidPtr (VariablePtr, mVariableAuthFormat), sizeof (EFI_GUID));
-        Status = EFI_SUCCESS;
+      VarName     = GetVariableNamePtr (VariablePtr, mVariableAuthFormat);
+      if ((VariableStoreEnd == NULL) ||
+          (VarNameSize == 0) ||
+          ((UINTN) VarName > (UINTN) VariableStoreEnd) ||
+          (VarNameSize > (UINTN) VariableStoreEnd - (UINTN) VarName)) {
+        //
+        // Only a variable being written can run past its store.
+        //
+        Status = EFI_NOT_FOUND;
       } else {
-        Status = EFI_BUFFER_TOO_SMALL;
+        if (VarNameSize <= *VariableNameSize) {
+          CopyMem (VariableName, VarName, VarNameSize);
+          CopyMem (VendorGuid, GetVendorGuidPtr (VariablePtr, mVariableAuthFormat), sizeof (EFI_GUID));
+          Status = EFI_SUCCESS;
+        } else {
+          Status = EFI_BUFFER_TOO_SMALL;
+        }
+
+        *VariableNameSize = VarNameSize;
       }
+    }
 
-      *VariableNameSize = VarNameSize;
+    if (EndRuntimeCacheRead (SequenceCount)) {
+      return Status;
     }
+
+    *VariableNameSize = InVariableNameSize;
+    CopyMem (VariableName, mVariableRuntimeCacheNameBuffer, InVariableNameLength);
+    CopyGuid (VendorGuid, &InVendorGuid);
   }
-  mVariableRuntimeCacheReadLock = FALSE;
 
-  return Status;
+  return EFI_NOT_READY;
 }
 
 /**
@@ -1043,6 +1167,9 @@ RuntimeServiceGetNextVariableName (
   AcquireLockOnlyAtBootTime (&mVariableServicesLock);
   if (FeaturePcdGet (PcdEnableVariableRuntimeCache)) {
     Status = GetNextVariableNameInRuntimeCache (VariableNameSize, VariableName, VendorGuid);
+    if (Status == EFI_NOT_READY) {
+      Status = GetNextVariableNameInSmm (VariableNameSize, VariableName, VendorGuid);
+    }
   } else {
     Status = GetNextVariableNameInSmm (VariableNameSize, VariableName, VendorGuid);
   }
@@ -1147,6 +1274,271 @@ Done:
   return Status;
 }
 
+/**
+  Check an entry of a batched GetVariable or SetVariable request, and get the
+  size of the data to send for it to SMM.
+
+  @param[in]  SetVariable            TRUE if the entry is set, FALSE if it is got.
+  @param[in]  Entry                  The entry.
+  @param[out] DataSize               The size of the data to send for the entry.
+
+  @retval EFI_SUCCESS                The entry can be sent to SMM.
+  @retval Others                     The status of the entry, it is not sent to SMM.
+
+**/
+EFI_STATUS
+GetVariableBatchEntryDataSize (
+  IN  BOOLEAN                               SetVariable,
+  IN  EDKII_VARIABLE_BATCH_ENTRY            *Entry,
+  OUT UINTN                                 *DataSize
+  )
+{
+  UINTN                                     VariableNameSize;
+  UINTN                                     MaxEntrySize;
+  UINTN                                     MaxDataSize;
+
+  if (Entry->VariableName == NULL || Entry->VendorGuid == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Entry->VariableName[0] == 0) {
+    return SetVariable ? EFI_INVALID_PARAMETER : EFI_NOT_FOUND;
+  }
+  if (SetVariable && Entry->DataSize != 0 && Entry->Data == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // If VariableName exceeds SMM payload limit. Return failure. The entry
+  // size is kept aligned, so that any valid entry fits in a batch of its own.
+  //
+  MaxEntrySize     = (mVariableBufferPayloadSize - sizeof (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH)) & ~(sizeof (UINTN) - 1);
+  VariableNameSize = StrSize (Entry->VariableName);
+  if ((VariableNameSize > MaxEntrySize) ||
+      (SMM_VARIABLE_BATCH_ENTRY_SIZE (VariableNameSize, 0) > MaxEntrySize)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  MaxDataSize = MaxEntrySize - SMM_VARIABLE_BATCH_ENTRY_SIZE (VariableNameSize, 0);
+
+  if (Entry->DataSize <= MaxDataSize) {
+    *DataSize = Entry->DataSize;
+  } else if (SetVariable) {
+    return EFI_INVALID_PARAMETER;
+  } else {
+    //
+    // If output data buffer exceed SMM payload limit. Trim output buffer to SMM payload size
+    //
+    *DataSize = MaxDataSize;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get or set the variables of a batch through as few SMM communications as
+  the payload size allows.
+
+  @param[in]      SetVariable        TRUE to set the variables, FALSE to get them.
+  @param[in]      EntryCount         The number of entries.
+  @param[in, out] Entries            The entries.
+
+**/
+VOID
+AccessVariableBatchInSmm (
+  IN     BOOLEAN                            SetVariable,
+  IN     UINTN                              EntryCount,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY         *Entries
+  )
+{
+  EFI_STATUS                                Status;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH        *Batch;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY  *SmmEntry;
+  EDKII_VARIABLE_BATCH_ENTRY                *Entry;
+  UINTN                                     First;
+  UINTN                                     Index;
+  UINTN                                     PayloadSize;
+  UINTN                                     EntrySize;
+  UINTN                                     DataSize;
+  UINTN                                     VariableNameSize;
+
+  Batch = NULL;
+  Index = 0;
+  while (Index < EntryCount) {
+    //
+    // Pack the entries that fit into one payload.
+    //
+    Status = InitCommunicateBuffer ((VOID **) &Batch, mVariableBufferPayloadSize, SetVariable ? SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH : SMM_VARIABLE_FUNCTION_GET_VARIABLE_BATCH);
+    ASSERT_EFI_ERROR (Status);
+    ASSERT (Batch != NULL);
+    Batch->EntryCount = 0;
+    PayloadSize       = sizeof (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH);
+
+    for (First = Index; Index < EntryCount; Index++) {
+      Entry  = &Entries[Index];
+      Status = GetVariableBatchEntryDataSize (SetVariable, Entry, &DataSize);
+      if (EFI_ERROR (Status)) {
+        Entry->Status = Status;
+        continue;
+      }
+      VariableNameSize = StrSize (Entry->VariableName);
+      EntrySize        = SMM_VARIABLE_BATCH_ENTRY_SIZE (VariableNameSize, DataSize);
+      if (EntrySize > mVariableBufferPayloadSize - PayloadSize) {
+        ASSERT (Batch->EntryCount != 0);
+        break;
+      }
+
+      SmmEntry = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY *) ((UINT8 *) Batch + PayloadSize);
+      SmmEntry->Status              = EFI_NOT_READY;
+      CopyGuid (&SmmEntry->Variable.Guid, Entry->VendorGuid);
+      SmmEntry->Variable.DataSize   = DataSize;
+      SmmEntry->Variable.NameSize   = VariableNameSize;
+      SmmEntry->Variable.Attributes = SetVariable ? Entry->Attributes : 0;
+      CopyMem (SmmEntry->Variable.Name, Entry->VariableName, VariableNameSize);
+      if (SetVariable) {
+        CopyMem ((UINT8 *) SmmEntry->Variable.Name + VariableNameSize, Entry->Data, DataSize);
+      }
+
+      Batch->EntryCount++;
+      PayloadSize += EntrySize;
+    }
+
+    //
+    // Send data to SMM.
+    //
+    Status = EFI_SUCCESS;
+    if (Batch->EntryCount != 0) {
+      InitCommunicateBuffer (NULL, PayloadSize, SetVariable ? SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH : SMM_VARIABLE_FUNCTION_GET_VARIABLE_BATCH);
+      Status = SendCommunicateBuffer (PayloadSize);
+    }
+
+    //
+    // Get the results from SMM, walking the entries the same way they were packed.
+    //
+    PayloadSize = sizeof (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH);
+    for (; First < Index; First++) {
+      Entry = &Entries[First];
+      if (EFI_ERROR (GetVariableBatchEntryDataSize (SetVariable, Entry, &DataSize))) {
+        continue;
+      }
+      VariableNameSize = StrSize (Entry->VariableName);
+      SmmEntry         = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_BATCH_ENTRY *) ((UINT8 *) Batch + PayloadSize);
+      PayloadSize     += SMM_VARIABLE_BATCH_ENTRY_SIZE (VariableNameSize, DataSize);
+
+      Entry->Status = EFI_ERROR (Status) ? Status : SmmEntry->Status;
+      if (SetVariable || EFI_ERROR (Status)) {
+        continue;
+      }
+
+      if (Entry->Status == EFI_SUCCESS || Entry->Status == EFI_BUFFER_TOO_SMALL) {
+        //
+        // SMM CommBuffer DataSize can be a trimed value
+        // Only update DataSize when needed
+        //
+        Entry->DataSize = SmmEntry->Variable.DataSize;
+      }
+      Entry->Attributes = SmmEntry->Variable.Attributes;
+      if (Entry->Status == EFI_SUCCESS) {
+        if (Entry->Data != NULL) {
+          CopyMem (Entry->Data, (UINT8 *) SmmEntry->Variable.Name + VariableNameSize, SmmEntry->Variable.DataSize);
+        } else {
+          Entry->Status = EFI_INVALID_PARAMETER;
+        }
+      }
+    }
+  }
+}
+
+/**
+  Read several variables with as few SMM communications as possible.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries.
+  @param[in, out] Entries       The variables to read.
+
+  @retval EFI_SUCCESS           The batch was processed, the Status of each
+                                entry tells whether the entry was read.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchGetVariables (
+  IN     EDKII_VARIABLE_BATCH_PROTOCOL      *This,
+  IN     UINTN                              EntryCount,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY         *Entries
+  )
+{
+  UINTN                                     Index;
+
+  if (Entries == NULL && EntryCount != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (FeaturePcdGet (PcdEnableVariableRuntimeCache)) {
+    //
+    // The runtime cache answers without SMM communication.
+    //
+    for (Index = 0; Index < EntryCount; Index++) {
+      Entries[Index].Status = RuntimeServiceGetVariable (
+                                Entries[Index].VariableName,
+                                Entries[Index].VendorGuid,
+                                &Entries[Index].Attributes,
+                                &Entries[Index].DataSize,
+                                Entries[Index].Data
+                                );
+    }
+    return EFI_SUCCESS;
+  }
+
+  AcquireLockOnlyAtBootTime (&mVariableServicesLock);
+  AccessVariableBatchInSmm (FALSE, EntryCount, Entries);
+  ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write several variables with as few SMM communications as possible.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries.
+  @param[in, out] Entries       The variables to write.
+
+  @retval EFI_SUCCESS           The batch was processed, the Status of each
+                                entry tells whether the entry was written.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN     EDKII_VARIABLE_BATCH_PROTOCOL      *This,
+  IN     UINTN                              EntryCount,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY         *Entries
+  )
+{
+  UINTN                                     Index;
+
+  if (Entries == NULL && EntryCount != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  AcquireLockOnlyAtBootTime (&mVariableServicesLock);
+  AccessVariableBatchInSmm (TRUE, EntryCount, Entries);
+  ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+
+  if (!EfiAtRuntime ()) {
+    for (Index = 0; Index < EntryCount; Index++) {
+      if (!EFI_ERROR (Entries[Index].Status)) {
+        SecureBootHook (
+          Entries[Index].VariableName,
+          Entries[Index].VendorGuid
+          );
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
 
 /**
   This code returns information about the EFI variables.
@@ -1308,11 +1700,21 @@ VariableAddressChangeEvent (
   IN VOID                                   *Context
   )
 {
+  UINTN          Index;
+
   EfiConvertPointer (0x0, (VOID **) &mVariableBuffer);
   EfiConvertPointer (0x0, (VOID **) &mSmmCommunication);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeVolatileCacheBuffer);
+  EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeCacheNameBuffer);
+  for (Index = 0; Index < VARIABLE_INDEX_MAX_STORES; Index++) {
+    if (mVariableStoreIndex[Index].StartPtr != NULL) {
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index].StartPtr);
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index].Buckets);
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index].Entries);
+    }
+  }
 }
 
 /**
@@ -1519,8 +1921,9 @@ SendRuntimeVariableCacheContextToSmm (
   SmmRuntimeVarCacheContext->RuntimeVolatileCache = mVariableRuntimeVolatileCacheBuffer;
   SmmRuntimeVarCacheContext->RuntimeNvCache = mVariableRuntimeNvCacheBuffer;
   SmmRuntimeVarCacheContext->PendingUpdate = &mVariableRuntimeCachePendingUpdate;
-  SmmRuntimeVarCacheContext->ReadLock = &mVariableRuntimeCacheReadLock;
+  SmmRuntimeVarCacheContext->SequenceCount = &mVariableRuntimeCacheSequenceCount;
   SmmRuntimeVarCacheContext->HobFlushComplete = &mHobFlushComplete;
+  SmmRuntimeVarCacheContext->RebuildCount = &mVariableRuntimeCacheRebuildCount;
 
   //
   // Send data to SMM.
@@ -1597,6 +2000,17 @@ SmmVariableReady (
         Status = InitVariableCache (&mVariableRuntimeNvCacheBuffer, &mVariableRuntimeNvCacheBufferSize);
         if (!EFI_ERROR (Status)) {
           Status = InitVariableCache (&mVariableRuntimeVolatileCacheBuffer, &mVariableRuntimeVolatileCacheBufferSize);
+          if (!EFI_ERROR (Status)) {
+            //
+            // A variable name longer than the SMM payload can neither be set nor
+            // be searched for in SMM, so the payload size bounds the names.
+            //
+            mVariableRuntimeCacheNameBufferSize = mVariableBufferPayloadSize;
+            mVariableRuntimeCacheNameBuffer     = AllocateRuntimePool (mVariableRuntimeCacheNameBufferSize);
+            if (mVariableRuntimeCacheNameBuffer == NULL) {
+              Status = EFI_OUT_OF_RESOURCES;
+            }
+          }
           if (!EFI_ERROR (Status)) {
             Status = SendRuntimeVariableCacheContextToSmm ();
             if (!EFI_ERROR (Status)) {
@@ -1652,6 +2066,16 @@ SmmVariableReady (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  mVariableBatch.GetVariables = VariableBatchGetVariables;
+  mVariableBatch.SetVariables = VariableBatchSetVariables;
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &mHandle,
+                  &gEdkiiVariableBatchProtocolGuid,
+                  &mVariableBatch,
+                  NULL
+                  );
+  ASSERT_EFI_ERROR (Status);
+
   gBS->CloseEvent (Event);
 }
 
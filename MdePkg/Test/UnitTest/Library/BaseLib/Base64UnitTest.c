@@ -13,6 +13,8 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UnitTestLib.h>
 
+#include "BaseLibUnitTests.h"
+
 #define UNIT_TEST_APP_NAME     "BaseLib Unit Test Application"
 #define UNIT_TEST_APP_VERSION  "1.0"
 
@@ -292,7 +294,7 @@ RfcDecodeTest(
 
 /**
   Initialze the unit test framework, suite, and unit tests for the
-  Base64 conversion APIs of BaseLib and run the unit tests.
+  Base64 conversion and CRC32 APIs of BaseLib and run the unit tests.
 
   @retval  EFI_SUCCESS           All test cases were dispatched.
   @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
@@ -367,6 +369,14 @@ UnitTestingEntry (
   AddTestCase (b64DecodeTests, "Incorrectly placed padding character", "Error4", RfcDecodeTest, NULL, CleanUpB64TestContext, &mBasicDecodeError4);
   AddTestCase (b64DecodeTests, "Too small of output buffer", "Error5", RfcDecodeTest, NULL, CleanUpB64TestContext, &mBasicDecodeError5);
 
+  //
+  // Populate the CRC32 Unit Test Suite.
+  //
+  Status = AddCrc32TestSuite (Fw);
+  if (EFI_ERROR (Status)) {
+    goto EXIT;
+  }
+
   //
   // Execute the tests.
   //
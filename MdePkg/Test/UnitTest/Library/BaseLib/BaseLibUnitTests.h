@@ -0,0 +1,29 @@
+/** @file
+  Unit test suites of BaseLib shared by the host and UEFI Shell test
+  applications.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _BASE_LIB_UNIT_TESTS_H_
+#define _BASE_LIB_UNIT_TESTS_H_
+
+#include <Library/UnitTestLib.h>
+
+/**
+  Populate the CRC32 Unit Test Suite.
+
+  @param[in]  Fw    The unit test framework handle.
+
+  @retval  EFI_SUCCESS           The test suite was created.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 create the test suite.
+**/
+EFI_STATUS
+AddCrc32TestSuite (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Fw
+  );
+
+#endif
@@ -0,0 +1,178 @@
+/** @file
+  Unit tests of the CalculateCrc32() API in BaseLib.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "BaseLibUnitTests.h"
+
+//
+// Large enough to cover every head alignment, the 8-byte loop and the tail.
+//
+#define CRC32_TEST_BUFFER_SIZE  (SIZE_64KB + 64)
+
+typedef struct {
+  CHAR8       *TestInput;
+  UINT32      ExpectedCrc;
+} CRC32_TEST_CONTEXT;
+
+//
+// Not allocated from the heap, so an assertion that returns early from a
+// test doesn't leak it, and not on the stack, which is small in UEFI.
+//
+UINT8  mCrc32TestBuffer[CRC32_TEST_BUFFER_SIZE];
+
+//
+// Well known CRC32 (ITU-T V.42) check values
+//
+CRC32_TEST_CONTEXT  mCrc32Test1 = {"",                                            0x00000000};
+CRC32_TEST_CONTEXT  mCrc32Test2 = {"a",                                           0xE8B7BE43};
+CRC32_TEST_CONTEXT  mCrc32Test3 = {"123456789",                                   0xCBF43926};
+CRC32_TEST_CONTEXT  mCrc32Test4 = {"The quick brown fox jumps over the lazy dog", 0x414FA339};
+
+/**
+  Reference CRC32 implementation that processes the buffer bit by bit.
+
+  @param[in]  Buffer       A pointer to the buffer.
+  @param[in]  Length       The number of bytes in the buffer.
+
+  @return The 32-bit CRC of the buffer.
+**/
+STATIC
+UINT32
+ReferenceCrc32 (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  UINT32  Crc;
+  UINTN   Index;
+  UINTN   Bit;
+
+  Crc = 0xffffffff;
+  for (Index = 0; Index < Length; Index++) {
+    Crc ^= Buffer[Index];
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (((Crc & 1) != 0) ? 0xEDB88320 : 0);
+    }
+  }
+
+  return Crc ^ 0xffffffff;
+}
+
+/**
+  Check CalculateCrc32() against a well known check value.
+
+  @param[in]  Context    The CRC32_TEST_CONTEXT of the test.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32KnownValueTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CRC32_TEST_CONTEXT  *Ctc;
+
+  Ctc = (CRC32_TEST_CONTEXT *)Context;
+
+  UT_ASSERT_EQUAL (
+    CalculateCrc32 (Ctc->TestInput, AsciiStrLen (Ctc->TestInput)),
+    Ctc->ExpectedCrc
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check CalculateCrc32() against the reference implementation for all
+  the buffer alignments and a range of lengths around the 8-byte blocks.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32AlignmentTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8   *Buffer;
+  UINTN   Index;
+  UINTN   Offset;
+  UINTN   Length;
+  UINT32  Seed;
+
+  Buffer = mCrc32TestBuffer;
+  Seed   = 0x12345678;
+  for (Index = 0; Index < CRC32_TEST_BUFFER_SIZE; Index++) {
+    Seed          = Seed * 1103515245 + 12345;
+    Buffer[Index] = (UINT8) (Seed >> 16);
+  }
+
+  for (Offset = 0; Offset < 8; Offset++) {
+    for (Length = 0; Length <= 64; Length++) {
+      UT_ASSERT_EQUAL (
+        CalculateCrc32 (Buffer + Offset, Length),
+        ReferenceCrc32 (Buffer + Offset, Length)
+        );
+    }
+
+    Length = CRC32_TEST_BUFFER_SIZE - 8 - Offset;
+    UT_ASSERT_EQUAL (
+      CalculateCrc32 (Buffer + Offset, Length),
+      ReferenceCrc32 (Buffer + Offset, Length)
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Populate the CRC32 Unit Test Suite.
+
+  @param[in]  Fw    The unit test framework handle.
+
+  @retval  EFI_SUCCESS           The test suite was created.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 create the test suite.
+**/
+EFI_STATUS
+AddCrc32TestSuite (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Fw
+  )
+{
+  EFI_STATUS              Status;
+  UNIT_TEST_SUITE_HANDLE  Crc32Tests;
+
+  Status = CreateUnitTestSuite (&Crc32Tests, Fw, "CRC32 calculation", "BaseLib.Crc32", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Crc32Tests\n"));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // --------------Suite-------Description-----------Class Name----Function-------------Pre---Post--Context------
+  AddTestCase (Crc32Tests, "Check Value - Empty",        "Test1", Crc32KnownValueTest, NULL, NULL, &mCrc32Test1);
+  AddTestCase (Crc32Tests, "Check Value - a",            "Test2", Crc32KnownValueTest, NULL, NULL, &mCrc32Test2);
+  AddTestCase (Crc32Tests, "Check Value - 123456789",    "Test3", Crc32KnownValueTest, NULL, NULL, &mCrc32Test3);
+  AddTestCase (Crc32Tests, "Check Value - quick fox",    "Test4", Crc32KnownValueTest, NULL, NULL, &mCrc32Test4);
+  AddTestCase (Crc32Tests, "Alignments and lengths",     "Test5", Crc32AlignmentTest,  NULL, NULL, NULL);
+
+  return EFI_SUCCESS;
+}
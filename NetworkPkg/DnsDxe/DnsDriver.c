@@ -346,6 +346,7 @@ DnsUnload (
   DNS4_SERVER_IP                  *ItemServerIp4;
   DNS6_CACHE                      *ItemCache6;
   DNS6_SERVER_IP                  *ItemServerIp6;
+  DNS_NEGATIVE_CACHE              *ItemNegativeCache;
 
   ItemCache4    = NULL;
   ItemServerIp4 = NULL;
@@ -400,6 +401,14 @@ DnsUnload (
       FreePool (ItemServerIp6);
     }
 
+    while (!IsListEmpty (&mDriverData->DnsNegativeCacheList)) {
+      Entry = NetListRemoveHead (&mDriverData->DnsNegativeCacheList);
+      ASSERT (Entry != NULL);
+      ItemNegativeCache = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+      FreePool (ItemNegativeCache->HostName);
+      FreePool (ItemNegativeCache);
+    }
+
     FreePool (mDriverData);
   }
 
@@ -490,6 +499,7 @@ DnsDriverEntryPoint (
   InitializeListHead (&mDriverData->Dns4ServerList);
   InitializeListHead (&mDriverData->Dns6CacheList);
   InitializeListHead (&mDriverData->Dns6ServerList);
+  InitializeListHead (&mDriverData->DnsNegativeCacheList);
 
   return Status;
 
@@ -39,6 +39,8 @@ struct _DNS_DRIVER_DATA {
 
   LIST_ENTRY                    Dns6CacheList;
   LIST_ENTRY                    Dns6ServerList;
+
+  LIST_ENTRY                    DnsNegativeCacheList;  /// Host names known not to exist.
 };
 
 struct _DNS_SERVICE {
@@ -771,6 +771,13 @@ UpdateDns4Cache (
   NewDnsCache = NULL;
   Item        = NULL;
 
+  //
+  // An address for the host name supersedes any cached name error.
+  //
+  if (!DeleteFlag) {
+    RemoveDnsNegativeCache (DnsCacheEntry.HostName);
+  }
+
   //
   // Search the database for the matching EFI_DNS_CACHE_ENTRY
   //
@@ -869,6 +876,13 @@ UpdateDns6Cache (
   NewDnsCache = NULL;
   Item        = NULL;
 
+  //
+  // An address for the host name supersedes any cached name error.
+  //
+  if (!DeleteFlag) {
+    RemoveDnsNegativeCache (DnsCacheEntry.HostName);
+  }
+
   //
   // Search the database for the matching EFI_DNS_CACHE_ENTRY
   //
@@ -937,6 +951,212 @@ UpdateDns6Cache (
   return EFI_SUCCESS;
 }
 
+/**
+  Record that a host name does not exist, in the negative cache shared by all
+  DNSv4 and DNSv6 instances.
+
+  @param  HostName           The host name that does not exist.
+  @param  Timeout            Time in seconds that the name error may be cached.
+
+  @retval EFI_SUCCESS        The negative cache is updated.
+  @retval Others             Failed to update the negative cache.
+
+**/
+EFI_STATUS
+UpdateDnsNegativeCache (
+  IN CHAR16                 *HostName,
+  IN UINT32                 Timeout
+  )
+{
+  DNS_NEGATIVE_CACHE    *NewDnsCache;
+  DNS_NEGATIVE_CACHE    *Item;
+  LIST_ENTRY            *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &mDriverData->DnsNegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (StrCmp (HostName, Item->HostName) == 0) {
+      Item->Timeout = Timeout;
+      return EFI_SUCCESS;
+    }
+  }
+
+  NewDnsCache = AllocateZeroPool (sizeof (DNS_NEGATIVE_CACHE));
+  if (NewDnsCache == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NewDnsCache->HostName = AllocateCopyPool (StrSize (HostName), HostName);
+  if (NewDnsCache->HostName == NULL) {
+    FreePool (NewDnsCache);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NewDnsCache->Timeout = Timeout;
+  InsertTailList (&mDriverData->DnsNegativeCacheList, &NewDnsCache->AllCacheLink);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether a host name is known not to exist.
+
+  @param  HostName           The host name to look up.
+
+  @retval TRUE               The host name is in the negative cache.
+  @retval FALSE              The host name is not in the negative cache.
+
+**/
+BOOLEAN
+IsDnsNegativelyCached (
+  IN CHAR16                 *HostName
+  )
+{
+  DNS_NEGATIVE_CACHE    *Item;
+  LIST_ENTRY            *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &mDriverData->DnsNegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (StrCmp (HostName, Item->HostName) == 0) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Forget that a host name does not exist, once it resolves to an address.
+
+  @param  HostName           The host name to remove from the negative cache.
+
+**/
+VOID
+RemoveDnsNegativeCache (
+  IN CHAR16                 *HostName
+  )
+{
+  DNS_NEGATIVE_CACHE    *Item;
+  LIST_ENTRY            *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &mDriverData->DnsNegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (StrCmp (HostName, Item->HostName) == 0) {
+      RemoveEntryList (&Item->AllCacheLink);
+      FreePool (Item->HostName);
+      FreePool (Item);
+      return;
+    }
+  }
+}
+
+/**
+  Get the length of an encoded domain name in a DNS message.
+
+  @param  Name               The encoded domain name.
+  @param  Length             The number of bytes available from Name.
+
+  @return The length of the encoded domain name in bytes, or 0 if the name is
+          malformed or truncated.
+
+**/
+UINTN
+DnsGetNameLength (
+  IN UINT8                  *Name,
+  IN UINTN                  Length
+  )
+{
+  UINTN                 Offset;
+  UINT8                 Label;
+
+  Offset = 0;
+  while (Offset < Length) {
+    Label = Name[Offset];
+    if (Label == 0) {
+      return Offset + 1;
+    }
+
+    if ((Label & 0xC0) == 0xC0) {
+      //
+      // A compression pointer ends the name.
+      //
+      return (Offset + 2 <= Length) ? Offset + 2 : 0;
+    }
+
+    if ((Label & 0xC0) != 0) {
+      return 0;
+    }
+
+    Offset += Label + 1;
+  }
+
+  return 0;
+}
+
+/**
+  Get the time that a name error may be cached, from the SOA record that the
+  server puts in the authority section of the response (RFC 2308, section 5).
+
+  @param  Authority          The first resource record of the authority section.
+  @param  Length             The number of bytes left in the response from Authority.
+  @param  Ttl                The smaller of the SOA record TTL and its MINIMUM field,
+                             capped at DNS_MAX_NEGATIVE_TTL.
+
+  @retval TRUE               Ttl is returned.
+  @retval FALSE              The authority section starts with no valid SOA record,
+                             so the name error must not be cached.
+
+**/
+BOOLEAN
+DnsGetNegativeTtl (
+  IN  UINT8                 *Authority,
+  IN  UINTN                 Length,
+  OUT UINT32                *Ttl
+  )
+{
+  DNS_ANSWER_SECTION    *Section;
+  UINT8                 *RData;
+  UINTN                 RDataLength;
+  UINTN                 NameLength;
+  UINT32                Minimum;
+
+  NameLength = DnsGetNameLength (Authority, Length);
+  if (NameLength == 0 || Length - NameLength < sizeof (DNS_ANSWER_SECTION)) {
+    return FALSE;
+  }
+
+  Section = (DNS_ANSWER_SECTION *) (Authority + NameLength);
+  if (NTOHS (Section->Type) != DNS_TYPE_SOA) {
+    return FALSE;
+  }
+
+  RDataLength = NTOHS (Section->DataLength);
+  if (Length - NameLength - sizeof (DNS_ANSWER_SECTION) < RDataLength) {
+    return FALSE;
+  }
+
+  //
+  // The SOA RDATA is MNAME, RNAME, then SERIAL, REFRESH, RETRY, EXPIRE and
+  // MINIMUM, each of 32 bits.
+  //
+  RData = (UINT8 *) Section + sizeof (DNS_ANSWER_SECTION);
+  NameLength = DnsGetNameLength (RData, RDataLength);
+  if (NameLength == 0) {
+    return FALSE;
+  }
+  RData       += NameLength;
+  RDataLength -= NameLength;
+
+  NameLength = DnsGetNameLength (RData, RDataLength);
+  if (NameLength == 0 || RDataLength - NameLength < 5 * sizeof (UINT32)) {
+    return FALSE;
+  }
+  RData += NameLength;
+
+  Minimum = NTOHL (ReadUnaligned32 ((UINT32 *) (RData + 4 * sizeof (UINT32))));
+  *Ttl    = MIN (MIN (NTOHL (Section->Ttl), Minimum), DNS_MAX_NEGATIVE_TTL);
+  return TRUE;
+}
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
@@ -1142,6 +1362,9 @@ ParseDnsResponse (
   UINT32                AnswerSectionNum;
   UINT32                CNameTtl;
 
+  CHAR16                *QueryHostName;
+  UINT32                NegativeTtl;
+
   EFI_IPv4_ADDRESS      *HostAddr4;
   EFI_IPv6_ADDRESS      *HostAddr6;
 
@@ -1278,6 +1501,24 @@ ParseDnsResponse (
     //
     if (DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) {
       Status = EFI_NOT_FOUND;
+
+      //
+      // Cache the name error, so the other instances fail at once instead of
+      // querying the servers again.
+      //
+      if (Instance->Service->IpVersion == IP_VERSION_4) {
+        QueryHostName = Dns4TokenEntry->GeneralLookUp ? NULL : Dns4TokenEntry->QueryHostName;
+      } else {
+        QueryHostName = Dns6TokenEntry->GeneralLookUp ? NULL : Dns6TokenEntry->QueryHostName;
+      }
+
+      if (QueryHostName != NULL &&
+          DnsHeader->Flags.Bits.QR == DNS_FLAGS_QR_RESPONSE &&
+          DnsHeader->AnswersNum == 0 && DnsHeader->AuthorityNum != 0 &&
+          DnsGetNegativeTtl ((UINT8 *) (QuerySection + 1), RemainingLength, &NegativeTtl) &&
+          NegativeTtl != 0) {
+        UpdateDnsNegativeCache (QueryHostName, NegativeTtl);
+      }
     } else {
       Status = EFI_DEVICE_ERROR;
     }
@@ -1517,7 +1758,12 @@ ParseDnsResponse (
           Dns4CacheEntry->Timeout = MAX (CNameTtl, AnswerSection->Ttl);
         }
 
-        UpdateDns4Cache (&mDriverData->Dns4CacheList, FALSE, TRUE, *Dns4CacheEntry);
+        //
+        // A zero TTL allows the answer to be used for this query only.
+        //
+        if (Dns4CacheEntry->Timeout != 0) {
+          UpdateDns4Cache (&mDriverData->Dns4CacheList, FALSE, TRUE, *Dns4CacheEntry);
+        }
 
         //
         // Free allocated CacheEntry pool.
@@ -1576,7 +1822,12 @@ ParseDnsResponse (
           Dns6CacheEntry->Timeout = MAX (CNameTtl, AnswerSection->Ttl);
         }
 
-        UpdateDns6Cache (&mDriverData->Dns6CacheList, FALSE, TRUE, *Dns6CacheEntry);
+        //
+        // A zero TTL allows the answer to be used for this query only.
+        //
+        if (Dns6CacheEntry->Timeout != 0) {
+          UpdateDns6Cache (&mDriverData->Dns6CacheList, FALSE, TRUE, *Dns6CacheEntry);
+        }
 
         //
         // Free allocated CacheEntry pool.
@@ -2192,51 +2443,52 @@ DnsOnTimerUpdate (
   LIST_ENTRY                 *Next;
   DNS4_CACHE                 *Item4;
   DNS6_CACHE                 *Item6;
+  DNS_NEGATIVE_CACHE         *ItemNegative;
 
   Item4 = NULL;
   Item6 = NULL;
 
   //
-  // Iterate through all the DNS4 cache list.
+  // Iterate through all the DNS4 cache list, and remove the expired entries.
   //
   NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->Dns4CacheList) {
     Item4 = NET_LIST_USER_STRUCT (Entry, DNS4_CACHE, AllCacheLink);
-    Item4->DnsCache.Timeout--;
-  }
-
-  Entry = mDriverData->Dns4CacheList.ForwardLink;
-  while (Entry != &mDriverData->Dns4CacheList) {
-    Item4 = NET_LIST_USER_STRUCT (Entry, DNS4_CACHE, AllCacheLink);
-    if (Item4->DnsCache.Timeout == 0) {
+    if (Item4->DnsCache.Timeout <= 1) {
       RemoveEntryList (&Item4->AllCacheLink);
       FreePool (Item4->DnsCache.HostName);
       FreePool (Item4->DnsCache.IpAddress);
       FreePool (Item4);
-      Entry = mDriverData->Dns4CacheList.ForwardLink;
     } else {
-      Entry = Entry->ForwardLink;
+      Item4->DnsCache.Timeout--;
     }
   }
 
   //
-  // Iterate through all the DNS6 cache list.
+  // Iterate through all the DNS6 cache list, and remove the expired entries.
   //
   NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->Dns6CacheList) {
     Item6 = NET_LIST_USER_STRUCT (Entry, DNS6_CACHE, AllCacheLink);
-    Item6->DnsCache.Timeout--;
-  }
-
-  Entry = mDriverData->Dns6CacheList.ForwardLink;
-  while (Entry != &mDriverData->Dns6CacheList) {
-    Item6 = NET_LIST_USER_STRUCT (Entry, DNS6_CACHE, AllCacheLink);
-    if (Item6->DnsCache.Timeout == 0) {
+    if (Item6->DnsCache.Timeout <= 1) {
       RemoveEntryList (&Item6->AllCacheLink);
       FreePool (Item6->DnsCache.HostName);
       FreePool (Item6->DnsCache.IpAddress);
       FreePool (Item6);
-      Entry = mDriverData->Dns6CacheList.ForwardLink;
     } else {
-      Entry = Entry->ForwardLink;
+      Item6->DnsCache.Timeout--;
+    }
+  }
+
+  //
+  // Iterate through the negative cache list, and remove the expired entries.
+  //
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->DnsNegativeCacheList) {
+    ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (ItemNegative->Timeout <= 1) {
+      RemoveEntryList (&ItemNegative->AllCacheLink);
+      FreePool (ItemNegative->HostName);
+      FreePool (ItemNegative);
+    } else {
+      ItemNegative->Timeout--;
     }
   }
 }
@@ -83,6 +83,12 @@ extern EFI_DNS6_PROTOCOL             mDns6Protocol;
 
 #define DNS_TIME_TO_GETMAP       5
 
+//
+// Upper bound on the time that a name error may be cached, in seconds
+// (RFC 2308, section 5).
+//
+#define DNS_MAX_NEGATIVE_TTL     10800
+
 #pragma pack(1)
 
 typedef union _DNS_FLAGS  DNS_FLAGS;
@@ -97,6 +103,12 @@ typedef struct {
   EFI_DNS6_CACHE_ENTRY   DnsCache;
 } DNS6_CACHE;
 
+typedef struct {
+  LIST_ENTRY             AllCacheLink;
+  CHAR16                 *HostName;
+  UINT32                 Timeout;
+} DNS_NEGATIVE_CACHE;
+
 typedef struct {
   LIST_ENTRY             AllServerLink;
   EFI_IPv4_ADDRESS       Dns4ServerIp;
@@ -516,6 +528,48 @@ UpdateDns6Cache (
   IN EFI_DNS6_CACHE_ENTRY   DnsCacheEntry
   );
 
+/**
+  Record that a host name does not exist, in the negative cache shared by all
+  DNSv4 and DNSv6 instances.
+
+  @param  HostName           The host name that does not exist.
+  @param  Timeout            Time in seconds that the name error may be cached.
+
+  @retval EFI_SUCCESS        The negative cache is updated.
+  @retval Others             Failed to update the negative cache.
+
+**/
+EFI_STATUS
+UpdateDnsNegativeCache (
+  IN CHAR16                 *HostName,
+  IN UINT32                 Timeout
+  );
+
+/**
+  Check whether a host name is known not to exist.
+
+  @param  HostName           The host name to look up.
+
+  @retval TRUE               The host name is in the negative cache.
+  @retval FALSE              The host name is not in the negative cache.
+
+**/
+BOOLEAN
+IsDnsNegativelyCached (
+  IN CHAR16                 *HostName
+  );
+
+/**
+  Forget that a host name does not exist, once it resolves to an address.
+
+  @param  HostName           The host name to remove from the negative cache.
+
+**/
+VOID
+RemoveDnsNegativeCache (
+  IN CHAR16                 *HostName
+  );
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
@@ -446,6 +446,21 @@ Dns4HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    if (IsDnsNegativelyCached (HostName)) {
+      //
+      // The host name was reported not to exist, and the report is still valid.
+      //
+      Token->Status = EFI_NOT_FOUND;
+
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      Status = EFI_SUCCESS;
+      goto ON_EXIT;
+    }
   }
 
   //
@@ -1288,6 +1303,21 @@ Dns6HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    if (IsDnsNegativelyCached (HostName)) {
+      //
+      // The host name was reported not to exist, and the report is still valid.
+      //
+      Token->Status = EFI_NOT_FOUND;
+
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      Status = EFI_SUCCESS;
+      goto ON_EXIT;
+    }
   }
 
   //
@@ -580,21 +580,24 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create a HttpIo instance configured for the file download.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       The callback function of the HttpIo, or NULL.
+  @param[out]   HttpIo         The HttpIo instance to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+HttpBootCreateHttpIoChild (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private,
+  IN     HTTP_IO_CALLBACK             Callback,  OPTIONAL
+     OUT HTTP_IO                      *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA          ConfigData;
-  EFI_STATUS                   Status;
   EFI_HANDLE                   ImageHandle;
 
   ASSERT (Private != NULL);
@@ -613,15 +616,34 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *) Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           Callback,
+           (VOID *) Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+  )
+{
+  EFI_STATUS                   Status;
+
+  Status = HttpBootCreateHttpIoChild (Private, HttpBootHttpIoCallback, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -630,6 +652,94 @@ HttpBootCreateHttpIo (
   return EFI_SUCCESS;
 }
 
+/**
+  Build the HTTP header for a request of the boot file. The header contains
+  the Host, Accept and User-Agent fields, and has room for ExtraCount more.
+
+  @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    ExtraCount     The number of header fields the caller will add.
+  @param[out]   HttpIoHeader   The created header, released by HttpBootFreeHeader().
+
+  @retval EFI_SUCCESS          The header was created.
+  @retval Others               Failed to create the header.
+
+**/
+EFI_STATUS
+HttpBootCreateRequestHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private,
+  IN     UINTN                        ExtraCount,
+     OUT HTTP_IO_HEADER               **HttpIoHeader
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_IO_HEADER             *Header;
+  CHAR8                      *HostName;
+
+  //
+  // 3 header is needed to download a boot file:
+  //       Host
+  //       Accept
+  //       User-Agent
+  //
+  Header = HttpBootCreateHeader (3 + ExtraCount);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Add HTTP header field 1: Host
+  //
+  HostName = NULL;
+  Status = HttpUrlGetHostName (
+             Private->BootFileUri,
+             Private->BootFileUriParser,
+             &HostName
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+  Status = HttpBootSetHeader (
+             Header,
+             HTTP_HEADER_HOST,
+             HostName
+             );
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Add HTTP header field 2: Accept
+  //
+  Status = HttpBootSetHeader (
+             Header,
+             HTTP_HEADER_ACCEPT,
+             "*/*"
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Add HTTP header field 3: User-Agent
+  //
+  Status = HttpBootSetHeader (
+             Header,
+             HTTP_HEADER_USER_AGENT,
+             HTTP_USER_AGENT_EFI_HTTP_BOOT
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpBootFreeHeader (Header);
+  return Status;
+}
+
 /**
   Release all the resource of a cache item.
 
@@ -814,7 +924,6 @@ HttpBootGetBootFileCallback (
   )
 {
   HTTP_BOOT_CALLBACK_DATA      *CallbackData;
-  HTTP_BOOT_ENTITY_DATA        *NewEntityData;
   EFI_STATUS                   Status;
   EFI_HTTP_BOOT_CALLBACK_PROTOCOL   *HttpBootCallback;
 
@@ -852,24 +961,408 @@ HttpBootGetBootFileCallback (
   }
 
   //
-  // The caller doesn't provide a buffer, save the block into cache list.
+  // The caller doesn't provide a buffer, compact the entity data in the stream
+  // block. The data was received at or after the end of the entity data saved
+  // so far, only the chunk headers between them are dropped.
   //
   if (CallbackData->Cache != NULL) {
-    NewEntityData = AllocatePool (sizeof (HTTP_BOOT_ENTITY_DATA));
-    if (NewEntityData == NULL) {
-      return EFI_OUT_OF_RESOURCES;
+    ASSERT ((UINT8 *) Data >= CallbackData->Block + CallbackData->BlockLength);
+    ASSERT ((UINT8 *) Data + Length <= CallbackData->Block + CallbackData->BlockSize);
+
+    CopyMem (CallbackData->Block + CallbackData->BlockLength, Data, Length);
+    CallbackData->BlockLength += Length;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Receive a message-body in identity transfer-coding directly into the buffer.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       ContentLength   The length of the message-body in bytes.
+  @param[out]      Buffer          The buffer to receive the message-body, at least
+                                   ContentLength bytes.
+
+  @retval EFI_SUCCESS              The message-body was received.
+  @retval Others                   Failed to receive the message-body, or aborted by
+                                   the HTTP Boot callback.
+
+**/
+EFI_STATUS
+HttpBootRecvEntityBody (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN     UINTN                    ContentLength,
+     OUT UINT8                    *Buffer
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_IO_RESPONSE_DATA      ResponseBody;
+  UINTN                      ReceivedSize;
+
+  ZeroMem (&ResponseBody, sizeof (HTTP_IO_RESPONSE_DATA));
+  ReceivedSize = 0;
+  while (ReceivedSize < ContentLength) {
+    ResponseBody.Body       = (CHAR8*) Buffer + ReceivedSize;
+    ResponseBody.BodyLength = ContentLength - ReceivedSize;
+    Status = HttpIoRecvResponse (
+               &Private->HttpIo,
+               FALSE,
+               &ResponseBody
+               );
+    if (EFI_ERROR (Status) || EFI_ERROR (ResponseBody.Status)) {
+      if (EFI_ERROR (ResponseBody.Status)) {
+        Status = ResponseBody.Status;
+      }
+      return Status;
     }
-    if (CallbackData->NewBlock) {
-      NewEntityData->Block = CallbackData->Block;
-      CallbackData->Block = NULL;
+    ReceivedSize += ResponseBody.BodyLength;
+    if (Private->HttpBootCallback != NULL) {
+      Status = Private->HttpBootCallback->Callback (
+                 Private->HttpBootCallback,
+                 HttpBootHttpEntityBody,
+                 TRUE,
+                 (UINT32)ResponseBody.BodyLength,
+                 ResponseBody.Body
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
     }
-    NewEntityData->DataLength = Length;
-    NewEntityData->DataStart  = (UINT8*) Data;
-    InsertTailList (&CallbackData->Cache->EntityDataList, &NewEntityData->Link);
   }
+
   return EFI_SUCCESS;
 }
 
+/**
+  Open a new connection for a byte range of the boot file, send the range
+  request and receive the response header.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  Range           The byte range to request.
+
+  @retval EFI_SUCCESS              The server accepted the range request, the
+                                   message-body can be received over Range->Io.
+  @retval EFI_UNSUPPORTED          The server did not return the requested range.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootStartRange (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN OUT HTTP_BOOT_RANGE          *Range
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_IO_HEADER             *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA      RequestData;
+  HTTP_IO_RESPONSE_DATA      ResponseData;
+  EFI_HTTP_HEADER            *Header;
+  CHAR8                      RangeStr[48];
+  UINTN                      UrlSize;
+  CHAR16                     *Url;
+
+  if (Range->Created) {
+    HttpIoDestroyIo (&Range->HttpIo);
+    Range->Created = FALSE;
+  }
+  Range->Io     = NULL;
+  Range->Queued = FALSE;
+
+  Status = HttpBootCreateHttpIoChild (Private, NULL, &Range->HttpIo);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  Range->Created = TRUE;
+  Range->Io      = &Range->HttpIo;
+
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+
+  Status = HttpBootCreateRequestHeader (Private, 1, &HttpIoHeader);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+  AsciiSPrint (RangeStr, sizeof (RangeStr), "bytes=%Lu-%Lu", (UINT64) Range->Offset, (UINT64) (Range->End - 1));
+  Status = HttpBootSetHeader (HttpIoHeader, HTTP_HEADER_RANGE, RangeStr);
+  if (EFI_ERROR (Status)) {
+    HttpBootFreeHeader (HttpIoHeader);
+    goto ON_EXIT;
+  }
+
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+  Status = HttpIoSendRequest (
+             Range->Io,
+             &RequestData,
+             HttpIoHeader->HeaderCount,
+             HttpIoHeader->Headers,
+             0,
+             NULL
+             );
+  HttpBootFreeHeader (HttpIoHeader);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+  Status = HttpIoRecvResponse (Range->Io, TRUE, &ResponseData);
+  if (EFI_ERROR (Status) || EFI_ERROR (ResponseData.Status)) {
+    if (!EFI_ERROR (Status)) {
+      Status = ResponseData.Status;
+    }
+    goto ON_FREE_HEADER;
+  }
+
+  //
+  // Only a "206 Partial Content" response carrying exactly the requested
+  // bytes can be received in place.
+  //
+  if (ResponseData.Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_FREE_HEADER;
+  }
+  Header = HttpFindHeader (ResponseData.HeaderCount, ResponseData.Headers, HTTP_HEADER_CONTENT_LENGTH);
+  if ((Header == NULL) || (AsciiStrDecimalToUintn (Header->FieldValue) != Range->End - Range->Offset)) {
+    Status = EFI_UNSUPPORTED;
+  }
+
+ON_FREE_HEADER:
+  if (ResponseData.Headers != NULL) {
+    HttpFreeHeaderFields (ResponseData.Headers, ResponseData.HeaderCount);
+  }
+
+ON_EXIT:
+  FreePool (Url);
+  return Status;
+}
+
+/**
+  Queue a response token to receive the rest of a byte range in place.
+
+  @param[in, out]  Range           The byte range to receive.
+  @param[in]       Buffer          The buffer the whole boot file is received into.
+
+  @retval EFI_SUCCESS              The response token is queued.
+  @retval Others                   Failed to queue the response token.
+
+**/
+EFI_STATUS
+HttpBootQueueRange (
+  IN OUT HTTP_BOOT_RANGE          *Range,
+  IN     UINT8                    *Buffer
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_IO                    *HttpIo;
+
+  HttpIo = Range->Io;
+  Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HTTP_BOOT_RESPONSE_TIMEOUT * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HttpIo->RspToken.Status                 = EFI_NOT_READY;
+  HttpIo->RspToken.Message->Data.Response = NULL;
+  HttpIo->RspToken.Message->HeaderCount   = 0;
+  HttpIo->RspToken.Message->Headers       = NULL;
+  HttpIo->RspToken.Message->BodyLength    = Range->End - Range->Offset;
+  HttpIo->RspToken.Message->Body          = Buffer + Range->Offset;
+  HttpIo->IsRxDone = FALSE;
+
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+    return Status;
+  }
+
+  Range->Queued = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Receive the message-body of the boot file left on the driver's connection
+  in byte ranges, each received over its own connection in parallel.
+
+  The first range is received from the driver's connection, the other ranges
+  are requested with a "Range" header. A range that fails or times out is
+  resumed from its first missing byte over a new connection. The driver's
+  connection is released when this function returns, since the rest of the
+  message-body is left on it.
+
+  If the other ranges can't be started, e.g. the server ignores the "Range"
+  header, the whole message-body is received over the driver's connection
+  instead, like HttpBootRecvEntityBody () does.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       ContentLength   The length of the message-body.
+  @param[out]      Buffer          The buffer to receive the message-body in.
+
+  @retval EFI_SUCCESS              The message-body was received.
+  @retval Others                   A range could not be received.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileInRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN     UINTN                    ContentLength,
+     OUT UINT8                    *Buffer
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_BOOT_RANGE            *Ranges;
+  HTTP_BOOT_RANGE            *Range;
+  HTTP_IO                    *HttpIo;
+  UINTN                      RangeCount;
+  UINTN                      RangeSize;
+  UINTN                      Index;
+  UINTN                      Length;
+  BOOLEAN                    Done;
+
+  RangeCount = MIN (PcdGet8 (PcdHttpBootRangeConnections), HTTP_BOOT_RANGE_MAX_CONNECTIONS);
+  RangeCount = MIN (RangeCount, ContentLength / HTTP_BOOT_RANGE_MIN_SIZE);
+  ASSERT (RangeCount > 1);
+
+  Ranges = AllocateZeroPool (RangeCount * sizeof (HTTP_BOOT_RANGE));
+  if (Ranges == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  RangeSize = ContentLength / RangeCount;
+  for (Index = 0; Index < RangeCount; Index++) {
+    Ranges[Index].Offset = Index * RangeSize;
+    Ranges[Index].End    = (Index == RangeCount - 1) ? ContentLength : (Index + 1) * RangeSize;
+  }
+  Ranges[0].Io = &Private->HttpIo;
+
+  Status = EFI_SUCCESS;
+  for (Index = 1; Index < RangeCount; Index++) {
+    Status = HttpBootStartRange (Private, &Ranges[Index]);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    //
+    // No byte of the message-body has been received yet, so it can still be
+    // received whole over the driver's connection.
+    //
+    DEBUG ((DEBUG_WARN, "HttpBootGetBootFileInRanges: range %d not started - %r, use one connection\n", Index, Status));
+    for (Index = 1; Index < RangeCount; Index++) {
+      if (Ranges[Index].Created) {
+        HttpIoDestroyIo (&Ranges[Index].HttpIo);
+      }
+    }
+    FreePool (Ranges);
+    return HttpBootRecvEntityBody (Private, ContentLength, Buffer);
+  }
+
+  while (TRUE) {
+    //
+    // Queue a response token on every connection with bytes to receive.
+    //
+    Done = TRUE;
+    for (Index = 0; Index < RangeCount; Index++) {
+      Range = &Ranges[Index];
+      if (Range->Offset == Range->End) {
+        continue;
+      }
+      Done = FALSE;
+      if (!Range->Queued) {
+        Status = HttpBootQueueRange (Range, Buffer);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+      }
+    }
+    if (Done) {
+      break;
+    }
+
+    for (Index = 0; Index < RangeCount; Index++) {
+      if (Ranges[Index].Queued) {
+        Ranges[Index].Io->Http->Poll (Ranges[Index].Io->Http);
+      }
+    }
+
+    for (Index = 0; Index < RangeCount; Index++) {
+      Range  = &Ranges[Index];
+      HttpIo = Range->Io;
+      if (!Range->Queued) {
+        continue;
+      }
+
+      if (HttpIo->IsRxDone) {
+        gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+        HttpIo->IsRxDone = FALSE;
+        Range->Queued    = FALSE;
+        Status           = HttpIo->RspToken.Status;
+        if (!EFI_ERROR (Status)) {
+          Length = HttpIo->RspToken.Message->BodyLength;
+          if (Private->HttpBootCallback != NULL) {
+            Status = Private->HttpBootCallback->Callback (
+                       Private->HttpBootCallback,
+                       HttpBootHttpEntityBody,
+                       TRUE,
+                       (UINT32) Length,
+                       Buffer + Range->Offset
+                       );
+            if (EFI_ERROR (Status)) {
+              goto ON_EXIT;
+            }
+          }
+          Range->Offset += Length;
+          continue;
+        }
+      } else if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+        HttpIo->Http->Cancel (HttpIo->Http, &HttpIo->RspToken);
+        Range->Queued = FALSE;
+        Status        = EFI_TIMEOUT;
+      } else {
+        continue;
+      }
+
+      //
+      // The range failed, resume it from its first missing byte.
+      //
+      DEBUG ((DEBUG_WARN, "HttpBootGetBootFileInRanges: range %d failed at offset %Lu - %r\n", Index, (UINT64) Range->Offset, Status));
+      if (Range->Retries++ >= HTTP_BOOT_RANGE_MAX_RETRIES) {
+        goto ON_EXIT;
+      }
+      Status = HttpBootStartRange (Private, Range);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    }
+  }
+
+ON_EXIT:
+  for (Index = 0; Index < RangeCount; Index++) {
+    Range = &Ranges[Index];
+    if (Range->Queued) {
+      Range->Io->Http->Cancel (Range->Io->Http, &Range->Io->RspToken);
+      gBS->SetTimer (Range->Io->TimeoutEvent, TimerCancel, 0);
+    }
+    if (Range->Created) {
+      HttpIoDestroyIo (&Range->HttpIo);
+    }
+  }
+  FreePool (Ranges);
+
+  //
+  // The driver's connection still carries the message-body beyond the first
+  // range, release it. HttpBootLoadFile() creates a new one on next use.
+  //
+  HttpIoDestroyIo (&Private->HttpIo);
+  Private->HttpCreated = FALSE;
+
+  return Status;
+}
+
 /**
   This function download the boot file by using UEFI HTTP protocol.
 
@@ -905,10 +1398,10 @@ HttpBootGetBootFile (
 {
   EFI_STATUS                 Status;
   EFI_HTTP_STATUS_CODE       StatusCode;
-  CHAR8                      *HostName;
   EFI_HTTP_REQUEST_DATA      *RequestData;
   HTTP_IO_RESPONSE_DATA      *ResponseData;
   HTTP_IO_RESPONSE_DATA      ResponseBody;
+  EFI_HTTP_HEADER            *Header;
   HTTP_IO                    *HttpIo;
   HTTP_IO_HEADER             *HttpIoHeader;
   VOID                       *Parser;
@@ -916,10 +1409,11 @@ HttpBootGetBootFile (
   UINTN                      ContentLength;
   HTTP_BOOT_CACHE_CONTENT    *Cache;
   UINT8                      *Block;
+  UINTN                      BlockSize;
   UINTN                      UrlSize;
   CHAR16                     *Url;
   BOOLEAN                    IdentityMode;
-  UINTN                      ReceivedSize;
+  HTTP_BOOT_ENTITY_DATA      *EntityData;
 
   ASSERT (Private != NULL);
   ASSERT (Private->HttpCreated);
@@ -949,6 +1443,42 @@ HttpBootGetBootFile (
     }
   }
 
+  //
+  // Then, check whether the message-body of the requested Uri was left on the
+  // connection by the previous call, and receive it directly into Buffer.
+  //
+  if (Private->BodyPending) {
+    Private->BodyPending = FALSE;
+
+    if (!HeaderOnly && (*BufferSize >= Private->PendingBodyLength)) {
+      FreePool (Url);
+      *ImageType = Private->PendingImageType;
+      if (Private->PendingAcceptRanges &&
+          (PcdGet8 (PcdHttpBootRangeConnections) > 1) &&
+          (Private->PendingBodyLength / HTTP_BOOT_RANGE_MIN_SIZE > 1)) {
+        Status = HttpBootGetBootFileInRanges (Private, Private->PendingBodyLength, Buffer);
+      } else {
+        Status = HttpBootRecvEntityBody (Private, Private->PendingBodyLength, Buffer);
+      }
+      if (!EFI_ERROR (Status)) {
+        *BufferSize = Private->PendingBodyLength;
+      }
+      return Status;
+    }
+
+    //
+    // The pending message-body is not wanted, reset the connection
+    // before sending a new request.
+    //
+    HttpIoDestroyIo (&Private->HttpIo);
+    Private->HttpCreated = FALSE;
+    Status = HttpBootCreateHttpIo (Private);
+    if (EFI_ERROR (Status)) {
+      FreePool (Url);
+      return Status;
+    }
+  }
+
   //
   // Not found in cache, try to download it through HTTP.
   //
@@ -972,61 +1502,11 @@ HttpBootGetBootFile (
   //
 
   //
-  // 2.1 Build HTTP header for the request, 3 header is needed to download a boot file:
-  //       Host
-  //       Accept
-  //       User-Agent
+  // 2.1 Build HTTP header for the request.
   //
-  HttpIoHeader = HttpBootCreateHeader (3);
-  if (HttpIoHeader == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ERROR_2;
-  }
-
-  //
-  // Add HTTP header field 1: Host
-  //
-  HostName = NULL;
-  Status = HttpUrlGetHostName (
-             Private->BootFileUri,
-             Private->BootFileUriParser,
-             &HostName
-             );
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-  Status = HttpBootSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_HOST,
-             HostName
-             );
-  FreePool (HostName);
+  Status = HttpBootCreateRequestHeader (Private, 0, &HttpIoHeader);
   if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  //
-  // Add HTTP header field 2: Accept
-  //
-  Status = HttpBootSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_ACCEPT,
-             "*/*"
-             );
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  //
-  // Add HTTP header field 3: User-Agent
-  //
-  Status = HttpBootSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_USER_AGENT,
-             HTTP_USER_AGENT_EFI_HTTP_BOOT
-             );
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
+    goto ERROR_2;
   }
 
   //
@@ -1115,9 +1595,10 @@ HttpBootGetBootFile (
   // 3.3 Init a message-body parser from the header information.
   //
   Parser = NULL;
-  Context.NewBlock   = FALSE;
-  Context.Block      = NULL;
-  Context.CopyedSize = 0;
+  Context.Block       = NULL;
+  Context.BlockSize   = 0;
+  Context.BlockLength = 0;
+  Context.CopyedSize  = 0;
   Context.Buffer     = Buffer;
   Context.BufferSize = *BufferSize;
   Context.Cache      = Cache;
@@ -1157,66 +1638,67 @@ HttpBootGetBootFile (
     //
     ZeroMem (&ResponseBody, sizeof (HTTP_IO_RESPONSE_DATA));
     if (IdentityMode) {
+      if (*BufferSize < ContentLength) {
+        //
+        // The caller's buffer is too small, leave the message-body on the
+        // connection. The caller is expected to come back with a buffer of
+        // ContentLength bytes, which the message-body is received into.
+        //
+        Private->BodyPending       = TRUE;
+        Private->PendingBodyLength = ContentLength;
+        Private->PendingImageType  = *ImageType;
+        Header = HttpFindHeader (ResponseData->HeaderCount, ResponseData->Headers, HTTP_HEADER_ACCEPT_RANGES);
+        Private->PendingAcceptRanges = (BOOLEAN) ((Header != NULL) && (AsciiStrStr (Header->FieldValue, "bytes") != NULL));
+        *BufferSize = ContentLength;
+        Status = EFI_BUFFER_TOO_SMALL;
+        goto ERROR_6;
+      }
+
       //
       // In identity transfer-coding there is no need to parse the message body,
       // just download the message body to the user provided buffer directly.
       //
-      ReceivedSize = 0;
-      while (ReceivedSize < ContentLength) {
-        ResponseBody.Body       = (CHAR8*) Buffer + ReceivedSize;
-        ResponseBody.BodyLength = *BufferSize - ReceivedSize;
-        Status = HttpIoRecvResponse (
-                   &Private->HttpIo,
-                   FALSE,
-                   &ResponseBody
-                   );
-        if (EFI_ERROR (Status) || EFI_ERROR (ResponseBody.Status)) {
-          if (EFI_ERROR (ResponseBody.Status)) {
-            Status = ResponseBody.Status;
-          }
-          goto ERROR_6;
-        }
-        ReceivedSize += ResponseBody.BodyLength;
-        if (Private->HttpBootCallback != NULL) {
-          Status = Private->HttpBootCallback->Callback (
-                     Private->HttpBootCallback,
-                     HttpBootHttpEntityBody,
-                     TRUE,
-                     (UINT32)ResponseBody.BodyLength,
-                     ResponseBody.Body
-                     );
-          if (EFI_ERROR (Status)) {
-            goto ERROR_6;
-          }
-        }
+      Status = HttpBootRecvEntityBody (Private, ContentLength, Buffer);
+      if (EFI_ERROR (Status)) {
+        goto ERROR_6;
       }
     } else {
       //
       // In "chunked" transfer-coding mode, so we need to parse the received
       // data to get the real entity content.
       //
-      Block = NULL;
       while (!HttpIsMessageComplete (Parser)) {
         //
-        // Allocate a buffer in Block to hold the message-body.
-        // If caller provides a buffer, this Block will be reused in every HttpIoRecvResponse().
-        // Otherwise a buffer, the buffer in Block will be cached and we should allocate a new before
-        // every HttpIoRecvResponse().
+        // If caller provides a buffer, a block is reused in every HttpIoRecvResponse()
+        // and the entity data is copied to the caller's buffer. Otherwise the message-body
+        // is received into the stream block of the cache, which grows as needed.
         //
-        if (Block == NULL || Context.BufferSize == 0) {
-          Block = AllocatePool (HTTP_BOOT_BLOCK_SIZE);
-          if (Block == NULL) {
-            Status = EFI_OUT_OF_RESOURCES;
-            goto ERROR_6;
+        if (Cache != NULL) {
+          if (Context.BlockSize - Context.BlockLength < HTTP_BOOT_BLOCK_SIZE) {
+            BlockSize = MAX (Context.BlockSize * 2, HTTP_BOOT_STREAM_INITIAL_SIZE);
+            Block = ReallocatePool (Context.BlockSize, BlockSize, Context.Block);
+            if (Block == NULL) {
+              Status = EFI_OUT_OF_RESOURCES;
+              goto ERROR_6;
+            }
+            Context.Block     = Block;
+            Context.BlockSize = BlockSize;
           }
-          Context.NewBlock = TRUE;
-          Context.Block = Block;
+          ResponseBody.Body       = (CHAR8*) Context.Block + Context.BlockLength;
+          ResponseBody.BodyLength = Context.BlockSize - Context.BlockLength;
         } else {
-          Context.NewBlock = FALSE;
+          if (Context.Block == NULL) {
+            Context.Block = AllocatePool (HTTP_BOOT_BLOCK_SIZE);
+            if (Context.Block == NULL) {
+              Status = EFI_OUT_OF_RESOURCES;
+              goto ERROR_6;
+            }
+            Context.BlockSize = HTTP_BOOT_BLOCK_SIZE;
+          }
+          ResponseBody.Body       = (CHAR8*) Context.Block;
+          ResponseBody.BodyLength = HTTP_BOOT_BLOCK_SIZE;
         }
 
-        ResponseBody.Body       = (CHAR8*) Block;
-        ResponseBody.BodyLength = HTTP_BOOT_BLOCK_SIZE;
         Status = HttpIoRecvResponse (
                    &Private->HttpIo,
                    FALSE,
@@ -1263,10 +1745,26 @@ HttpBootGetBootFile (
   // 4. Save the cache item to driver's cache list and return.
   //
   if (Cache != NULL) {
+    if (Context.Block != NULL) {
+      EntityData = AllocatePool (sizeof (HTTP_BOOT_ENTITY_DATA));
+      if (EntityData == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto ERROR_6;
+      }
+      EntityData->Block      = Context.Block;
+      EntityData->DataStart  = Context.Block;
+      EntityData->DataLength = Context.BlockLength;
+      InsertTailList (&Cache->EntityDataList, &EntityData->Link);
+      Context.Block = NULL;
+    }
     Cache->EntityLength = ContentLength;
     InsertTailList (&Private->CacheList, &Cache->Link);
   }
 
+  if (Context.Block != NULL) {
+    FreePool (Context.Block);
+  }
+
   if (Parser != NULL) {
     HttpFreeMsgParser (Parser);
   }
@@ -1280,10 +1778,21 @@ ERROR_6:
   if (Context.Block != NULL) {
     FreePool (Context.Block);
   }
-  HttpBootFreeCache (Cache);
+  if (Cache != NULL) {
+    //
+    // The request and response data are released below.
+    //
+    Cache->RequestData  = NULL;
+    Cache->ResponseData = NULL;
+    HttpBootFreeCache (Cache);
+    Cache = NULL;
+  }
 
 ERROR_5:
   if (ResponseData != NULL) {
+    if (ResponseData->Headers != NULL) {
+      HttpFreeHeaderFields (ResponseData->Headers, ResponseData->HeaderCount);
+    }
     FreePool (ResponseData);
   }
 ERROR_4:
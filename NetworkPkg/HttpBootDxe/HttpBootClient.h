@@ -13,6 +13,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_REQUEST_TIMEOUT            5000      // 5 seconds in uints of millisecond.
 #define HTTP_BOOT_RESPONSE_TIMEOUT           5000      // 5 seconds in uints of millisecond.
 #define HTTP_BOOT_BLOCK_SIZE                 1500
+#define HTTP_BOOT_STREAM_INITIAL_SIZE        SIZE_64KB
+
+//
+// A boot file is downloaded in byte ranges only if each range has at least
+// HTTP_BOOT_RANGE_MIN_SIZE bytes. A range that fails is resumed over a new
+// connection at most HTTP_BOOT_RANGE_MAX_RETRIES times.
+//
+#define HTTP_BOOT_RANGE_MAX_CONNECTIONS      8
+#define HTTP_BOOT_RANGE_MIN_SIZE             SIZE_1MB
+#define HTTP_BOOT_RANGE_MAX_RETRIES          3
 
 
 
@@ -40,17 +50,32 @@ typedef struct {
   LIST_ENTRY                 EntityDataList;  // Entity data (message-body)
 } HTTP_BOOT_CACHE_CONTENT;
 
+//
+// A byte range of the boot file, received over its own HTTP connection.
+//
+typedef struct {
+  HTTP_IO                    HttpIo;
+  HTTP_IO                    *Io;         // Points to HttpIo, or to the driver's HttpIo for the first range.
+  BOOLEAN                    Created;     // HttpIo has been created.
+  BOOLEAN                    Queued;      // A response token is queued on Io.
+  UINTN                      Offset;      // The next byte of the range to receive.
+  UINTN                      End;         // One past the last byte of the range.
+  UINTN                      Retries;
+} HTTP_BOOT_RANGE;
+
 //
 // Callback data for HTTP_BODY_PARSER_CALLBACK()
 //
 typedef struct {
   EFI_STATUS                 Status;
   //
-  // Cache info.
+  // Cache info. The entity data is streamed into Block, which is grown
+  // on demand and becomes the only entity data block of the cache item.
   //
   HTTP_BOOT_CACHE_CONTENT    *Cache;
-  BOOLEAN                    NewBlock;
   UINT8                      *Block;
+  UINTN                      BlockSize;
+  UINTN                      BlockLength;
 
   //
   // Caller provided buffer to load the file in.
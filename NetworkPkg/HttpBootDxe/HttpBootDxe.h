@@ -222,6 +222,16 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   //
   LIST_ENTRY                                CacheList;
 
+  //
+  // The message body of the boot file left unread on the HTTP connection
+  // when the caller's buffer was too small, to be received directly into
+  // the caller's buffer by the next download of the boot file.
+  //
+  BOOLEAN                                   BodyPending;
+  UINTN                                     PendingBodyLength;
+  HTTP_BOOT_IMAGE_TYPE                      PendingImageType;
+  BOOLEAN                                   PendingAcceptRanges;
+
   //
   // Cached DHCP offer
   //
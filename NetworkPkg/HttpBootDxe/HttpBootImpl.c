@@ -340,40 +340,6 @@ HttpBootLoadFile (
     }
   }
 
-  if (Private->BootFileSize == 0) {
-    //
-    // Discover the information about the bootfile if we haven't.
-    //
-
-    //
-    // Try to use HTTP HEAD method.
-    //
-    Status = HttpBootGetBootFile (
-               Private,
-               TRUE,
-               &Private->BootFileSize,
-               NULL,
-               &Private->ImageType
-               );
-    if (EFI_ERROR (Status) && Status != EFI_BUFFER_TOO_SMALL) {
-      //
-      // Failed to get file size by HEAD method, may be trunked encoding, try HTTP GET method.
-      //
-      ASSERT (Private->BootFileSize == 0);
-      Status = HttpBootGetBootFile (
-                 Private,
-                 FALSE,
-                 &Private->BootFileSize,
-                 NULL,
-                 &Private->ImageType
-                 );
-      if (EFI_ERROR (Status) && Status != EFI_BUFFER_TOO_SMALL) {
-        AsciiPrint ("\n  Error: Could not retrieve NBP file size from HTTP server.\n");
-        goto ON_EXIT;
-      }
-    }
-  }
-
   if (*BufferSize < Private->BootFileSize) {
     *BufferSize = Private->BootFileSize;
     *ImageType = Private->ImageType;
@@ -382,7 +348,10 @@ HttpBootLoadFile (
   }
 
   //
-  // Load the boot file into Buffer
+  // Load the boot file into Buffer. There is no separate request to discover
+  // the size of the boot file: if Buffer is too small, the GET request returns
+  // the size and leaves the message body on the connection (or streams it into
+  // the cache in chunked transfer-coding), to be received by the next call.
   //
   Status = HttpBootGetBootFile (
              Private,
@@ -391,6 +360,12 @@ HttpBootLoadFile (
              Buffer,
              ImageType
              );
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Private->BootFileSize = *BufferSize;
+    Private->ImageType    = *ImageType;
+  } else if (EFI_ERROR (Status) && (Buffer == NULL)) {
+    AsciiPrint ("\n  Error: Could not retrieve NBP file size from HTTP server.\n");
+  }
 
 ON_EXIT:
   HttpBootUninstallCallback (Private);
@@ -455,6 +430,7 @@ HttpBootStop (
   Private->BootFileUri = NULL;
   Private->BootFileUriParser = NULL;
   Private->BootFileSize = 0;
+  Private->BodyPending = FALSE;
   Private->SelectIndex = 0;
   Private->SelectProxyType = HttpOfferTypeMax;
 
@@ -443,10 +443,12 @@ EfiHttpRequest (
           (AsciiStrCmp (HttpInstance->RemoteHost, HostName) == 0) &&
           (!HttpInstance->UseHttps || (HttpInstance->UseHttps &&
                                        !TlsConfigure &&
-                                       HttpInstance->TlsSessionState == EfiTlsSessionDataTransferring))) {
+                                       (HttpInstance->TlsSessionState == EfiTlsSessionDataTransferring ||
+                                        HttpInstance->ConnectionClose)))) {
         //
         // Host Name and port number of the request URL are the same with previous call to Request().
-        // If Https protocol used, the corresponding SessionState is EfiTlsSessionDataTransferring.
+        // If Https protocol used, the corresponding SessionState is EfiTlsSessionDataTransferring,
+        // or the server closed the TLS session along with the connection.
         // Check whether previous TCP packet sent out.
         //
 
@@ -489,6 +491,21 @@ EfiHttpRequest (
           //
           Configure   = FALSE;
           ReConfigure = FALSE;
+
+          if (HttpInstance->ConnectionClose) {
+            //
+            // The server closed the connection after the previous response. Close
+            // our side too, so HttpInitSession() connects again to the resolved
+            // address, and resumes the TLS session for Https.
+            //
+            if (HttpInstance->UseHttps &&
+                HttpInstance->TlsSessionState == EfiTlsSessionDataTransferring) {
+              TlsCloseSession (HttpInstance);
+            }
+
+            HttpCloseConnection (HttpInstance);
+            HttpInstance->ConnectionClose = FALSE;
+          }
         }
       } else {
         //
@@ -499,6 +516,8 @@ EfiHttpRequest (
           HttpInstance->RemoteHost = NULL;
           HttpInstance->RemotePort = 0;
         }
+
+        HttpInstance->ConnectionClose = FALSE;
       }
     }
   }
@@ -983,6 +1002,7 @@ HttpResponseWorker (
   HTTP_TOKEN_WRAP               *ValueInItem;
   UINTN                         HdrLen;
   NET_FRAGMENT                  Fragment;
+  EFI_HTTP_HEADER               *Header;
 
   if (Wrap == NULL || Wrap->HttpInstance == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -1185,6 +1205,14 @@ HttpResponseWorker (
       FreePool (HttpHeaders);
       HttpHeaders = NULL;
 
+      //
+      // Check whether the server closes the connection after this response.
+      //
+      Header = HttpFindHeader (HttpMsg->HeaderCount, HttpMsg->Headers, HTTP_HEADER_CONNECTION);
+      if (Header != NULL && AsciiStriCmp (Header->FieldValue, HTTP_CONNECTION_CLOSE) == 0) {
+        HttpInstance->ConnectionClose = TRUE;
+      }
+
 
       //
       // Init message-body parser by header information.
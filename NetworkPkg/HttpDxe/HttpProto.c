@@ -855,6 +855,8 @@ HttpCleanProtocol (
     HttpInstance->RemoteHost = NULL;
   }
 
+  HttpInstance->ConnectionClose = FALSE;
+
   if (HttpInstance->MsgParser != NULL) {
     HttpFreeMsgParser (HttpInstance->MsgParser);
     HttpInstance->MsgParser = NULL;
@@ -1824,6 +1826,7 @@ HttpTcpReceiveHeader (
   CHAR8                         **HttpHeaders;
   CHAR8                         *Buffer;
   NET_FRAGMENT                  Fragment;
+  UINTN                         SearchOffset;
 
   ASSERT (HttpInstance != NULL);
 
@@ -1907,6 +1910,15 @@ HttpTcpReceiveHeader (
         }
       }
 
+      //
+      // The bytes received before were searched for the end of HTTP headers
+      // already, except the last ones that may start it.
+      //
+      SearchOffset = 0;
+      if (*SizeofHeaders >= AsciiStrLen (HTTP_END_OF_HDR_STR)) {
+        SearchOffset = *SizeofHeaders - AsciiStrLen (HTTP_END_OF_HDR_STR) + 1;
+      }
+
       //
       // Append the response string along with a Null-terminator.
       //
@@ -1934,7 +1946,7 @@ HttpTcpReceiveHeader (
       //
       // Check whether we received end of HTTP headers.
       //
-      *EndofHeader = AsciiStrStr (*HttpHeaders, HTTP_END_OF_HDR_STR);
+      *EndofHeader = AsciiStrStr (*HttpHeaders + SearchOffset, HTTP_END_OF_HDR_STR);
     };
 
     //
@@ -2007,6 +2019,15 @@ HttpTcpReceiveHeader (
         }
       }
 
+      //
+      // The bytes received before were searched for the end of HTTP headers
+      // already, except the last ones that may start it.
+      //
+      SearchOffset = 0;
+      if (*SizeofHeaders >= AsciiStrLen (HTTP_END_OF_HDR_STR)) {
+        SearchOffset = *SizeofHeaders - AsciiStrLen (HTTP_END_OF_HDR_STR) + 1;
+      }
+
       //
       // Append the response string along with a Null-terminator.
       //
@@ -2034,7 +2055,7 @@ HttpTcpReceiveHeader (
       //
       // Check whether we received end of HTTP headers.
       //
-      *EndofHeader = AsciiStrStr (*HttpHeaders, HTTP_END_OF_HDR_STR);
+      *EndofHeader = AsciiStrStr (*HttpHeaders + SearchOffset, HTTP_END_OF_HDR_STR);
     };
 
     //
@@ -285,103 +285,9 @@ HttpUtilitiesParse (
   OUT UINTN                        *FieldCount
   )
 {
-  EFI_STATUS                Status;
-  CHAR8                     *TempHttpMessage;
-  CHAR8                     *Token;
-  CHAR8                     *NextToken;
-  CHAR8                     *FieldName;
-  CHAR8                     *FieldValue;
-  UINTN                     Index;
-  UINTN                     HttpBufferSize;
-
-  Status          = EFI_SUCCESS;
-  TempHttpMessage = NULL;
-  Token           = NULL;
-  NextToken       = NULL;
-  FieldName       = NULL;
-  FieldValue      = NULL;
-  Index           = 0;
-
   if (This == NULL || HttpMessage == NULL || HeaderFields == NULL || FieldCount == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Append the http response string along with a Null-terminator.
-  //
-  HttpBufferSize = HttpMessageSize + 1;
-  TempHttpMessage = AllocatePool (HttpBufferSize);
-  if (TempHttpMessage == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  CopyMem (TempHttpMessage, HttpMessage, HttpMessageSize);
-  *(TempHttpMessage + HttpMessageSize) = '\0';
-
-  //
-  // Get header number
-  //
-  *FieldCount = 0;
-  Token = TempHttpMessage;
-  while (TRUE) {
-    FieldName     = NULL;
-    FieldValue    = NULL;
-    NextToken = HttpGetFieldNameAndValue (Token, &FieldName, &FieldValue);
-    Token     = NextToken;
-    if (FieldName == NULL || FieldValue == NULL) {
-      break;
-    }
-
-    (*FieldCount)++;
-  }
-
-  if (*FieldCount == 0) {
-    Status =  EFI_INVALID_PARAMETER;
-    goto ON_EXIT;
-  }
-
-  //
-  // Allocate buffer for header
-  //
-  *HeaderFields = AllocateZeroPool ((*FieldCount) * sizeof(EFI_HTTP_HEADER));
-  if (*HeaderFields == NULL) {
-    *FieldCount = 0;
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
-  }
-
-  CopyMem (TempHttpMessage, HttpMessage, HttpMessageSize);
-
-  //
-  // Set Field and Value to each header
-  //
-  Token = TempHttpMessage;
-  while (Index < *FieldCount) {
-    FieldName     = NULL;
-    FieldValue    = NULL;
-    NextToken = HttpGetFieldNameAndValue (Token, &FieldName, &FieldValue);
-    Token     = NextToken;
-    if (FieldName == NULL || FieldValue == NULL) {
-      break;
-    }
-
-    Status = HttpSetFieldNameAndValue (&(*HeaderFields)[Index], FieldName, FieldValue);
-    if (EFI_ERROR (Status)) {
-      *FieldCount = 0;
-      HttpFreeHeaderFields (*HeaderFields, Index);
-      goto ON_EXIT;
-    }
-
-    Index++;
-  }
-
-  //
-  // Free allocated buffer
-  //
-ON_EXIT:
-  if (TempHttpMessage != NULL) {
-    FreePool (TempHttpMessage);
-  }
-
-  return Status;
+  return HttpParseHeaderFields (HttpMessage, HttpMessageSize, HeaderFields, FieldCount);
 }
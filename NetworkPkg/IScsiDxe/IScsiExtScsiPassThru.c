@@ -20,6 +20,216 @@ EFI_EXT_SCSI_PASS_THRU_PROTOCOL gIScsiExtScsiPassThruProtocolTemplate = {
 };
 
 
+/**
+  Complete a nonblocking SCSI command: update its request packet, remove it
+  from the queue and free it.
+
+  @param[in]  Private  The iSCSI driver data.
+  @param[in]  Request  The nonblocking SCSI command.
+  @param[in]  Status   The status of the command if it was not sent, ignored
+                       otherwise.
+
+  @return The event to signal to notify the issuer of the command.
+
+**/
+EFI_EVENT
+IScsiCompleteAsyncIo (
+  IN ISCSI_DRIVER_DATA       *Private,
+  IN ISCSI_ASYNC_IO_REQUEST  *Request,
+  IN EFI_STATUS              Status
+  )
+{
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  EFI_EVENT                                   Event;
+  EFI_TPL                                     OldTpl;
+
+  if (Request->Tcb != NULL) {
+    ASSERT (Request->Tcb->StatusXferd);
+    Status = Request->Tcb->Status;
+    IScsiDelTcb (Request->Tcb);
+  }
+
+  //
+  // The nonblocking interface only reports the status through the packet.
+  //
+  Packet = Request->Packet;
+  if (Status == EFI_BAD_BUFFER_SIZE) {
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_DATA_OVERRUN_UNDERRUN;
+  } else if (Status == EFI_TIMEOUT) {
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND;
+  } else if (EFI_ERROR (Status)) {
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  RemoveEntryList (&Request->Link);
+  gBS->RestoreTPL (OldTpl);
+
+  Event = Request->Event;
+  FreePool (Request);
+
+  return Event;
+}
+
+
+/**
+  Send the nonblocking SCSI commands as the command window of the target opens,
+  and complete them as their responses arrive.
+
+  @param[in]  Event    The event signaled.
+  @param[in]  Context  The iSCSI driver data.
+
+**/
+VOID
+EFIAPI
+IScsiOnAsyncIoTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  ISCSI_DRIVER_DATA       *Private;
+  ISCSI_SESSION           *Session;
+  ISCSI_ASYNC_IO_REQUEST  *Request;
+  LIST_ENTRY              *Entry;
+  LIST_ENTRY              *NextEntry;
+  EFI_STATUS              Status;
+  EFI_STATUS              SendStatus;
+  BOOLEAN                 WindowOpen;
+  EFI_EVENT               Completed[ISCSI_ASYNC_IO_BATCH];
+  UINTN                   CompletedCount;
+  UINTN                   Index;
+  EFI_TPL                 OldTpl;
+
+  Private = (ISCSI_DRIVER_DATA *) Context;
+
+  if (Private->IoInProgress) {
+    //
+    // A blocking command owns the connection. It processes the PDUs of the
+    // nonblocking commands while waiting for its own.
+    //
+    return;
+  }
+
+  Private->IoInProgress = TRUE;
+  Session               = Private->Session;
+
+  //
+  // Process the PDUs that have arrived first, as they may open the command window.
+  //
+  if (Session != NULL) {
+    Status = IScsiPollSession (Session);
+  } else {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  WindowOpen = TRUE;
+  NET_LIST_FOR_EACH (Entry, &Private->AsyncIoQueue) {
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Request = NET_LIST_USER_STRUCT (Entry, ISCSI_ASYNC_IO_REQUEST, Link);
+    if (Request->Tcb == NULL) {
+      //
+      // Send the commands in the order they were issued, as long as the target
+      // accepts new ones.
+      //
+      if (WindowOpen) {
+        SendStatus = IScsiStartScsiCommand (Session, Request->Lun, Request->Packet, &Request->Tcb);
+        if (SendStatus == EFI_NOT_READY) {
+          WindowOpen = FALSE;
+        } else if (EFI_ERROR (SendStatus)) {
+          Status = SendStatus;
+        }
+      }
+    } else if (!Request->Tcb->StatusXferd && (Request->Timeout != 0)) {
+      if (Request->Timeout > ISCSI_ASYNC_IO_PERIOD) {
+        Request->Timeout -= ISCSI_ASYNC_IO_PERIOD;
+      } else {
+        //
+        // The target can only be made to drop the task by reinstating the
+        // session.
+        //
+        Request->Tcb->StatusXferd = TRUE;
+        Request->Tcb->Status      = EFI_TIMEOUT;
+        Status                    = EFI_TIMEOUT;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status) && (Session != NULL)) {
+    //
+    // Reinstate the session as the blocking interface does. The commands sent
+    // on the failed session are completed with an error, the others are sent
+    // on the new session.
+    //
+    Status = IScsiSessionReinstatement (Session);
+  }
+
+  //
+  // Complete the commands the target is done with, or all of them if the
+  // session can not be used any more.
+  //
+  CompletedCount = 0;
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->AsyncIoQueue) {
+    if (CompletedCount == ISCSI_ASYNC_IO_BATCH) {
+      break;
+    }
+
+    Request = NET_LIST_USER_STRUCT (Entry, ISCSI_ASYNC_IO_REQUEST, Link);
+    if (((Request->Tcb != NULL) && Request->Tcb->StatusXferd) ||
+        ((Request->Tcb == NULL) && EFI_ERROR (Status))) {
+      Completed[CompletedCount++] = IScsiCompleteAsyncIo (Private, Request, EFI_DEVICE_ERROR);
+    }
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (IsListEmpty (&Private->AsyncIoQueue)) {
+    gBS->SetTimer (Private->AsyncIoTimer, TimerCancel, 0);
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  Private->IoInProgress = FALSE;
+
+  //
+  // The issuers may issue new commands from their notification functions.
+  //
+  for (Index = 0; Index < CompletedCount; Index++) {
+    gBS->SignalEvent (Completed[Index]);
+  }
+}
+
+
+/**
+  Complete all the nonblocking SCSI commands with an error, and stop the timer
+  that drives them.
+
+  @param[in]  Private  The iSCSI driver data.
+
+**/
+VOID
+IScsiFlushAsyncIo (
+  IN ISCSI_DRIVER_DATA  *Private
+  )
+{
+  ISCSI_ASYNC_IO_REQUEST  *Request;
+  EFI_EVENT               Event;
+
+  gBS->SetTimer (Private->AsyncIoTimer, TimerCancel, 0);
+
+  while (!IsListEmpty (&Private->AsyncIoQueue)) {
+    Request = NET_LIST_HEAD (&Private->AsyncIoQueue, ISCSI_ASYNC_IO_REQUEST, Link);
+    if ((Request->Tcb != NULL) && !Request->Tcb->StatusXferd) {
+      Request->Tcb->StatusXferd = TRUE;
+      Request->Tcb->Status      = EFI_DEVICE_ERROR;
+    }
+
+    Event = IScsiCompleteAsyncIo (Private, Request, EFI_DEVICE_ERROR);
+    gBS->SignalEvent (Event);
+  }
+}
+
+
 /**
   Sends a SCSI Request Packet to a SCSI device that is attached to the SCSI channel.
   This function supports both blocking I/O and nonblocking I/O. The blocking I/O
@@ -80,8 +290,11 @@ IScsiExtScsiPassThruFunction (
   IN EFI_EVENT                                                Event     OPTIONAL
   )
 {
-  EFI_STATUS         Status;
-  ISCSI_DRIVER_DATA  *Private;
+  EFI_STATUS              Status;
+  ISCSI_DRIVER_DATA       *Private;
+  ISCSI_ASYNC_IO_REQUEST  *Request;
+  EFI_TPL                 OldTpl;
+  BOOLEAN                 Idle;
 
   if (Target[0] != 0) {
     return EFI_INVALID_PARAMETER;
@@ -91,19 +304,62 @@ IScsiExtScsiPassThruFunction (
     return EFI_INVALID_PARAMETER;
   }
 
+  Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (This);
+
+  if (Event != NULL) {
+    //
+    // Queue the command. It is sent by IScsiOnAsyncIoTimer () at TPL_CALLBACK,
+    // since this function may be called at a higher TPL from the notification
+    // function of another command.
+    //
+    Request = AllocateZeroPool (sizeof (ISCSI_ASYNC_IO_REQUEST));
+    if (Request == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Request->Lun    = Lun;
+    Request->Packet = Packet;
+    Request->Event  = Event;
+    if (Packet->Timeout != 0) {
+      Request->Timeout = MultU64x32 (Packet->Timeout, 4);
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Idle   = IsListEmpty (&Private->AsyncIoQueue);
+    InsertTailList (&Private->AsyncIoQueue, &Request->Link);
+    if (Idle) {
+      gBS->SetTimer (Private->AsyncIoTimer, TimerPeriodic, ISCSI_ASYNC_IO_PERIOD);
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    return EFI_SUCCESS;
+  }
+
+  if (Private->IoInProgress) {
+    //
+    // The nonblocking commands are being processed and this function is called
+    // from the notification function of one of them.
+    //
+    return EFI_NOT_READY;
+  }
+
+  Private->IoInProgress = TRUE;
+
   Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet);
   if ((Status != EFI_SUCCESS) && (Status != EFI_NOT_READY)) {
     //
     // Try to reinstate the session and re-execute the Scsi command.
     //
-    Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (This);
     if (EFI_ERROR (IScsiSessionReinstatement (Private->Session))) {
+      Private->IoInProgress = FALSE;
       return EFI_DEVICE_ERROR;
     }
 
     Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet);
   }
 
+  Private->IoInProgress = FALSE;
+
   return Status;
 }
 
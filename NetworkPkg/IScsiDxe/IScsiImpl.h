@@ -78,6 +78,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 /// 3 seconds
 ///
 #define ISCSI_WAIT_IPSEC_TIMEOUT  30000000U
+///
+/// 3 seconds, to receive the rest of a PDU once its header has arrived
+///
+#define ISCSI_RECEIVE_PDU_TIMEOUT 30000000U
+///
+/// 1 millisecond, the period of the timer that drives the nonblocking SCSI commands
+///
+#define ISCSI_ASYNC_IO_PERIOD     10000U
+///
+/// The most nonblocking SCSI commands completed in one period
+///
+#define ISCSI_ASYNC_IO_BATCH      32
 
 struct _ISCSI_SESSION {
   UINT32                      Signature;
@@ -163,8 +175,38 @@ struct _ISCSI_CONNECTION {
   UINT32            MaxRecvDataSegmentLength;
   ISCSI_DIGEST_TYPE HeaderDigest;
   ISCSI_DIGEST_TYPE DataDigest;
+
+  //
+  // The receive request for the basic header segment of the next PDU, kept
+  // pending with the TCP driver by IScsiPollPdu(). BhsLen is the number of
+  // header bytes received by the request and not consumed yet.
+  //
+  TCP_IO_IO_TOKEN       BhsRxToken;
+  EFI_TCP4_RECEIVE_DATA BhsRxData;
+  ISCSI_BASIC_HEADER    Bhs;
+  UINT32                BhsLen;
+  BOOLEAN               BhsRxPending;
+  BOOLEAN               BhsRxDone;
 };
 
+///
+/// A SCSI command issued through the nonblocking EXT SCSI PASS THRU interface.
+///
+typedef struct {
+  LIST_ENTRY                                  Link;
+  UINT64                                      Lun;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  EFI_EVENT                                   Event;
+  ///
+  /// The time left to complete the command in 100ns units, 0 for no timeout.
+  ///
+  UINT64                                      Timeout;
+  ///
+  /// NULL until the command is sent to the target.
+  ///
+  ISCSI_TCB                                   *Tcb;
+} ISCSI_ASYNC_IO_REQUEST;
+
 #define ISCSI_DRIVER_DATA_SIGNATURE SIGNATURE_32 ('I', 'S', 'D', 'A')
 
 #define ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU(PassThru) \
@@ -197,6 +239,15 @@ struct _ISCSI_DRIVER_DATA {
   EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
   EFI_HANDLE                      ChildHandle;
   ISCSI_SESSION                   *Session;
+
+  //
+  // The nonblocking SCSI commands in the order they were issued, and the timer
+  // that sends them and drives them to completion. IoInProgress is TRUE while a
+  // SCSI command is sent or PDUs are received on the session.
+  //
+  LIST_ENTRY                      AsyncIoQueue;
+  EFI_EVENT                       AsyncIoTimer;
+  BOOLEAN                         IoInProgress;
 };
 
 #endif
@@ -1742,6 +1742,23 @@ IScsiCreateDriverData (
     return NULL;
   }
 
+  //
+  // Create the timer that drives the nonblocking SCSI commands.
+  //
+  InitializeListHead (&Private->AsyncIoQueue);
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  IScsiOnAsyncIoTimer,
+                  Private,
+                  &Private->AsyncIoTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Private->ExitBootServiceEvent);
+    FreePool (Private);
+    return NULL;
+  }
+
   Private->ExtScsiPassThruHandle = NULL;
   CopyMem(&Private->IScsiExtScsiPassThru, &gIScsiExtScsiPassThruProtocolTemplate, sizeof(EFI_EXT_SCSI_PASS_THRU_PROTOCOL));
 
@@ -1749,7 +1766,9 @@ IScsiCreateDriverData (
   // 0 is designated to the TargetId, so use another value for the AdapterId.
   //
   Private->ExtScsiPassThruMode.AdapterId  = 2;
-  Private->ExtScsiPassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL | EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL;
+  Private->ExtScsiPassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL |
+                                            EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL |
+                                            EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
   Private->ExtScsiPassThruMode.IoAlign    = 4;
   Private->IScsiExtScsiPassThru.Mode      = &Private->ExtScsiPassThruMode;
 
@@ -1804,6 +1823,9 @@ EXIT:
     gBS->CloseEvent (Private->ExitBootServiceEvent);
   }
 
+  IScsiFlushAsyncIo (Private);
+  gBS->CloseEvent (Private->AsyncIoTimer);
+
   mCallbackInfo->Current = NULL;
 
   FreePool (Private);
@@ -2492,6 +2514,8 @@ IScsiOnExitBootService (
   gBS->CloseEvent (Private->ExitBootServiceEvent);
   Private->ExitBootServiceEvent = NULL;
 
+  gBS->SetTimer (Private->AsyncIoTimer, TimerCancel, 0);
+
   if (Private->Session != NULL) {
     IScsiSessionAbort (Private->Session);
   }
@@ -420,6 +420,33 @@ IScsiGetTcpConnDevicePath (
   IN ISCSI_SESSION      *Session
   );
 
+/**
+  Send the nonblocking SCSI commands as the command window of the target opens,
+  and complete them as their responses arrive.
+
+  @param[in]  Event    The event signaled.
+  @param[in]  Context  The iSCSI driver data.
+
+**/
+VOID
+EFIAPI
+IScsiOnAsyncIoTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+/**
+  Complete all the nonblocking SCSI commands with an error, and stop the timer
+  that drives them.
+
+  @param[in]  Private  The iSCSI driver data.
+
+**/
+VOID
+IScsiFlushAsyncIo (
+  IN ISCSI_DRIVER_DATA  *Private
+  );
+
 /**
   Abort the session when the transition from BS to RT is initiated.
 
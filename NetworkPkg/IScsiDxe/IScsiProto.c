@@ -187,6 +187,25 @@ IScsiConnReset (
 }
 
 
+/**
+  Notify function of the receive request for the basic header segment of the
+  next PDU.
+
+  @param[in]  Event   The event signaled.
+  @param[in]  Context The iSCSI connection.
+
+**/
+VOID
+EFIAPI
+IScsiOnBhsRxDone (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  ((ISCSI_CONNECTION *) Context)->BhsRxDone = TRUE;
+}
+
+
 /**
   Create a TCP connection for the iSCSI session.
 
@@ -240,6 +259,21 @@ IScsiCreateConnection (
     return NULL;
   }
 
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  IScsiOnBhsRxDone,
+                  Conn,
+                  &Conn->BhsRxToken.Tcp4Token.CompletionToken.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Conn->TimeoutEvent);
+    FreePool (Conn);
+    return NULL;
+  }
+
+  Conn->BhsRxToken.Tcp4Token.Packet.RxData = &Conn->BhsRxData;
+
   NetbufQueInit (&Conn->RspQue);
 
   //
@@ -261,6 +295,7 @@ IScsiCreateConnection (
 
     if (EFI_ERROR(Status)) {
       DEBUG ((EFI_D_ERROR, "The configuration of Target address or DNS server address is invalid!\n"));
+      gBS->CloseEvent (Conn->BhsRxToken.Tcp4Token.CompletionToken.Event);
       FreePool (Conn);
       return NULL;
     }
@@ -298,6 +333,7 @@ IScsiCreateConnection (
              );
   if (EFI_ERROR (Status)) {
     gBS->CloseEvent (Conn->TimeoutEvent);
+    gBS->CloseEvent (Conn->BhsRxToken.Tcp4Token.CompletionToken.Event);
     FreePool (Conn);
     Conn = NULL;
   }
@@ -321,6 +357,7 @@ IScsiDestroyConnection (
 
   NetbufQueFlush (&Conn->RspQue);
   gBS->CloseEvent (Conn->TimeoutEvent);
+  gBS->CloseEvent (Conn->BhsRxToken.Tcp4Token.CompletionToken.Event);
   FreePool (Conn);
 }
 
@@ -1300,6 +1337,8 @@ IScsiReceivePdu (
   UINT32          FragmentCount;
   NET_BUF         *DataSeg;
   UINT32          PadAndCRC32[2];
+  NET_BUF         *BhsRest;
+  ISCSI_TCB       *Tcb;
 
   NbufList = AllocatePool (sizeof (LIST_ENTRY));
   if (NbufList == NULL) {
@@ -1326,9 +1365,31 @@ IScsiReceivePdu (
   InsertTailList (NbufList, &PduHdr->List);
 
   //
-  // First step, receive the BHS of the PDU.
+  // First step, receive the BHS of the PDU. Its first bytes may have been
+  // received already by IScsiPollPdu ().
   //
-  Status = TcpIoReceive (&Conn->TcpIo, PduHdr, FALSE, TimeoutEvent);
+  if (Conn->BhsLen != 0) {
+    ASSERT (!HeaderDigest && (Conn->BhsLen <= Len));
+
+    CopyMem (Header, &Conn->Bhs, Conn->BhsLen);
+    Fragment[0].Len   = Len - Conn->BhsLen;
+    Fragment[0].Bulk  = Header + Conn->BhsLen;
+    Conn->BhsLen      = 0;
+
+    Status = EFI_SUCCESS;
+    if (Fragment[0].Len != 0) {
+      BhsRest = NetbufFromExt (&Fragment[0], 1, 0, 0, IScsiNbufExtFree, NULL);
+      if (BhsRest == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto ON_EXIT;
+      }
+
+      Status = TcpIoReceive (&Conn->TcpIo, BhsRest, FALSE, TimeoutEvent);
+      NetbufFree (BhsRest);
+    }
+  } else {
+    Status = TcpIoReceive (&Conn->TcpIo, PduHdr, FALSE, TimeoutEvent);
+  }
 
   if (EFI_ERROR (Status)) {
     goto ON_EXIT;
@@ -1360,8 +1421,16 @@ IScsiReceivePdu (
   case ISCSI_OPCODE_SCSI_DATA_IN:
     //
     // To reduce memory copy overhead, try to use the buffer described by Context
-    // if the PDU is an iSCSI SCSI data.
+    // if the PDU is an iSCSI SCSI data. Without Context, the data is received in
+    // the buffer of the task the PDU belongs to.
     //
+    if (Context == NULL) {
+      Tcb = IScsiFindTcb (Conn->Session, NTOHL (((ISCSI_BASIC_HEADER *) Header)->InitiatorTaskTag));
+      if (Tcb != NULL) {
+        Context = &Tcb->InBufferContext;
+      }
+    }
+
     InDataOffset = ISCSI_GET_BUFFER_OFFSET (Header);
     if ((Context == NULL) || ((InDataOffset + Len) > Context->InDataLen)) {
       Status = EFI_PROTOCOL_ERROR;
@@ -1466,6 +1535,87 @@ ON_EXIT:
 }
 
 
+/**
+  Receive the next iSCSI pdu of the full feature phase if its header has started
+  arriving, without waiting for it otherwise.
+
+  A receive request for the basic header segment is kept pending with the TCP
+  driver between calls, so once this function is called on a connection, all
+  the pdus of the connection must be received through it.
+
+  @param[in]  Conn         The iSCSI connection to receive data from.
+  @param[out] Pdu          The received iSCSI pdu.
+  @param[in]  TimeoutEvent The timeout event for the rest of the pdu once its
+                           header has started arriving, it's optional.
+
+  @retval EFI_SUCCESS          An iSCSI pdu is received.
+  @retval EFI_NOT_READY        No pdu has arrived yet.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiPollPdu (
+  IN ISCSI_CONNECTION                      *Conn,
+  OUT NET_BUF                              **Pdu,
+  IN EFI_EVENT                             TimeoutEvent OPTIONAL
+  )
+{
+  TCP_IO      *TcpIo;
+  EFI_STATUS  Status;
+
+  TcpIo = &Conn->TcpIo;
+
+  if (!Conn->BhsRxPending) {
+    Conn->BhsRxData.DataLength                      = sizeof (ISCSI_BASIC_HEADER);
+    Conn->BhsRxData.FragmentCount                   = 1;
+    Conn->BhsRxData.FragmentTable[0].FragmentLength = sizeof (ISCSI_BASIC_HEADER);
+    Conn->BhsRxData.FragmentTable[0].FragmentBuffer = &Conn->Bhs;
+
+    if (TcpIo->TcpVersion == TCP_VERSION_4) {
+      Status = TcpIo->Tcp.Tcp4->Receive (TcpIo->Tcp.Tcp4, &Conn->BhsRxToken.Tcp4Token);
+    } else {
+      Status = TcpIo->Tcp.Tcp6->Receive (TcpIo->Tcp.Tcp6, &Conn->BhsRxToken.Tcp6Token);
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Conn->BhsRxPending = TRUE;
+  }
+
+  if (!Conn->BhsRxDone) {
+    if (TcpIo->TcpVersion == TCP_VERSION_4) {
+      TcpIo->Tcp.Tcp4->Poll (TcpIo->Tcp.Tcp4);
+    } else {
+      TcpIo->Tcp.Tcp6->Poll (TcpIo->Tcp.Tcp6);
+    }
+
+    if (!Conn->BhsRxDone) {
+      return EFI_NOT_READY;
+    }
+  }
+
+  Conn->BhsRxPending = FALSE;
+  Conn->BhsRxDone    = FALSE;
+
+  Status = Conn->BhsRxToken.Tcp4Token.CompletionToken.Status;
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The TCP driver may return the header in several pieces. Receive the rest of
+  // it together with the data segment.
+  //
+  Conn->BhsLen = Conn->BhsRxData.DataLength;
+
+  return IScsiReceivePdu (Conn, Pdu, NULL, FALSE, FALSE, TimeoutEvent);
+}
+
+
 /**
   Check and get the result of the parameter negotiation.
 
@@ -2090,6 +2240,39 @@ IScsiDelTcb (
 }
 
 
+/**
+  Find the outstanding task with the specified initiator task tag.
+
+  @param[in]  Session           The iSCSI session.
+  @param[in]  InitiatorTaskTag  The initiator task tag, in host byte order.
+
+  @return The task control block, or NULL if no task with this tag is outstanding.
+
+**/
+ISCSI_TCB *
+IScsiFindTcb (
+  IN ISCSI_SESSION  *Session,
+  IN UINT32         InitiatorTaskTag
+  )
+{
+  LIST_ENTRY  *Entry;
+  ISCSI_TCB   *Tcb;
+
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    //
+    // A completed task may stay in the list until its issuer collects it, and
+    // its tag may be reused after the session is reinstated.
+    //
+    if (!Tcb->StatusXferd && (Tcb->InitiatorTaskTag == InitiatorTaskTag)) {
+      return Tcb;
+    }
+  }
+
+  return NULL;
+}
+
+
 /**
   Create a data segment, pad it, and calculate the CRC if needed.
 
@@ -2813,7 +2996,7 @@ IScsiOnScsiRspRcvd (
   Process the received NOP In PDU.
 
   @param[in]  Pdu            The NOP In PDU received.
-  @param[in]  Tcb            The task control block.
+  @param[in]  Conn           The iSCSI connection the PDU is received from.
 
   @retval EFI_SUCCESS        The NOP In PDU is processed and the related sequence
                              numbers are updated.
@@ -2822,8 +3005,8 @@ IScsiOnScsiRspRcvd (
 **/
 EFI_STATUS
 IScsiOnNopInRcvd (
-  IN NET_BUF    *Pdu,
-  IN ISCSI_TCB  *Tcb
+  IN NET_BUF           *Pdu,
+  IN ISCSI_CONNECTION  *Conn
   )
 {
   ISCSI_NOP_IN  *NopInHdr;
@@ -2839,71 +3022,59 @@ IScsiOnNopInRcvd (
   NopInHdr->MaxCmdSN  = NTOHL (NopInHdr->MaxCmdSN);
 
   if (NopInHdr->InitiatorTaskTag == ISCSI_RESERVED_TAG) {
-    if (NopInHdr->StatSN != Tcb->Conn->ExpStatSN) {
+    if (NopInHdr->StatSN != Conn->ExpStatSN) {
       return EFI_PROTOCOL_ERROR;
     }
   } else {
-    Status = IScsiCheckSN (&Tcb->Conn->ExpStatSN, NopInHdr->StatSN);
+    Status = IScsiCheckSN (&Conn->ExpStatSN, NopInHdr->StatSN);
     if (EFI_ERROR (Status)) {
       return Status;
     }
   }
 
-  IScsiUpdateCmdSN (Tcb->Conn->Session, NopInHdr->MaxCmdSN, NopInHdr->ExpCmdSN);
+  IScsiUpdateCmdSN (Conn->Session, NopInHdr->MaxCmdSN, NopInHdr->ExpCmdSN);
 
   return EFI_SUCCESS;
 }
 
 
 /**
-  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+  Send a SCSI command, and the unsolicited data following it, without waiting
+  for the target to complete it. The target completes the command through the
+  PDUs processed by IScsiDispatchPdu().
 
-  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
-  @param[in]       Target    The target ID.
+  @param[in]       Session   The iSCSI session.
   @param[in]       Lun       The LUN.
   @param[in, out]  Packet    The request packet containing IO request, SCSI command
                              buffer and buffers to read/write.
+  @param[out]      Tcb       The task control block of the command, to be deleted
+                             by the caller once StatusXferd is TRUE.
 
-  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
-                               the Packet.
+  @retval EFI_SUCCESS          The SCSI command is sent.
   @retval EFI_DEVICE_ERROR     Session state was not as required.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
-  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
-  @retval EFI_NOT_READY        The target can not accept new commands.
+  @retval EFI_NOT_READY        The command window of the target is closed.
   @retval Others               Other errors as indicated.
 
 **/
 EFI_STATUS
-IScsiExecuteScsiCommand (
-  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
-  IN UINT8                                           *Target,
+IScsiStartScsiCommand (
+  IN ISCSI_SESSION                                   *Session,
   IN UINT64                                          Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  OUT ISCSI_TCB                                      **Tcb
   )
 {
   EFI_STATUS              Status;
-  ISCSI_DRIVER_DATA       *Private;
-  ISCSI_SESSION           *Session;
-  EFI_EVENT               TimeoutEvent;
   ISCSI_CONNECTION        *Conn;
-  ISCSI_TCB               *Tcb;
+  ISCSI_TCB               *NewTcb;
   NET_BUF                 *Pdu;
   ISCSI_XFER_CONTEXT      *XferContext;
   UINT8                   *Data;
-  ISCSI_IN_BUFFER_CONTEXT InBufferContext;
-  UINT64                  Timeout;
   UINT8                   *PduHdr;
 
-  Private       = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
-  Session       = Private->Session;
-  Status        = EFI_SUCCESS;
-  Tcb           = NULL;
-  TimeoutEvent  = NULL;
-  Timeout       = 0;
-
   if (Session->State != SESSION_STATE_LOGGED_IN) {
-    Status = EFI_DEVICE_ERROR;
-    goto ON_EXIT;
+    return EFI_DEVICE_ERROR;
   }
 
   Conn = NET_LIST_USER_STRUCT_S (
@@ -2913,29 +3084,35 @@ IScsiExecuteScsiCommand (
            ISCSI_CONNECTION_SIGNATURE
            );
 
-  if (Packet->Timeout != 0) {
-    Timeout = MultU64x32 (Packet->Timeout, 4);
-  }
-
-  Status = IScsiNewTcb (Conn, &Tcb);
+  //
+  // IScsiNewTcb () fails if CmdSN is beyond the MaxCmdSN granted by the target,
+  // which bounds the number of outstanding commands.
+  //
+  Status = IScsiNewTcb (Conn, &NewTcb);
   if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+    return Status;
   }
+
+  NewTcb->Lun                       = Lun;
+  NewTcb->Packet                    = Packet;
+  NewTcb->InBufferContext.InData    = (UINT8 *) Packet->InDataBuffer;
+  NewTcb->InBufferContext.InDataLen = Packet->InTransferLength;
+
   //
   // Encapsulate the SCSI request packet into an iSCSI SCSI Command PDU.
   //
-  Pdu = IScsiNewScsiCmdPdu (Packet, Lun, Tcb);
+  Pdu = IScsiNewScsiCmdPdu (Packet, Lun, NewTcb);
   if (Pdu == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
+    goto ON_ERROR;
   }
 
-  XferContext         = &Tcb->XferContext;
+  XferContext         = &NewTcb->XferContext;
   PduHdr              = NetbufGetByte (Pdu, 0, NULL);
   if (PduHdr == NULL) {
     Status = EFI_PROTOCOL_ERROR;
     NetbufFree (Pdu);
-    goto ON_EXIT;
+    goto ON_ERROR;
   }
   XferContext->Offset = ISCSI_GET_DATASEG_LEN (PduHdr);
 
@@ -2947,7 +3124,7 @@ IScsiExecuteScsiCommand (
   NetbufFree (Pdu);
 
   if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+    goto ON_ERROR;
   }
 
   if (!Session->InitialR2T &&
@@ -2965,14 +3142,223 @@ IScsiExecuteScsiCommand (
                                    );
 
     Data    = (UINT8 *) Packet->OutDataBuffer + XferContext->Offset;
-    Status  = IScsiSendDataOutPduSequence (Data, Lun, Tcb);
+    Status  = IScsiSendDataOutPduSequence (Data, Lun, NewTcb);
     if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
+      goto ON_ERROR;
     }
   }
 
-  InBufferContext.InData    = (UINT8 *) Packet->InDataBuffer;
-  InBufferContext.InDataLen = Packet->InTransferLength;
+  *Tcb = NewTcb;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+
+  IScsiDelTcb (NewTcb);
+  return Status;
+}
+
+
+/**
+  Process an iSCSI PDU received in the full feature phase, on behalf of the
+  task it belongs to.
+
+  @param[in]  Conn               The iSCSI connection the PDU is received from.
+  @param[in]  Pdu                The PDU received.
+
+  @retval EFI_SUCCESS            The PDU is processed. If it completed a task, the
+                                 status of the task is in its Status field.
+  @retval EFI_PROTOCOL_ERROR     Some kind of iSCSI protocol error occurred.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiDispatchPdu (
+  IN ISCSI_CONNECTION  *Conn,
+  IN NET_BUF           *Pdu
+  )
+{
+  ISCSI_BASIC_HEADER  *PduHdr;
+  ISCSI_TCB           *Tcb;
+  EFI_STATUS          Status;
+
+  PduHdr = (ISCSI_BASIC_HEADER *) NetbufGetByte (Pdu, 0, NULL);
+  if (PduHdr == NULL) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Tcb = NULL;
+
+  switch (ISCSI_GET_OPCODE (PduHdr)) {
+  case ISCSI_OPCODE_SCSI_DATA_IN:
+  case ISCSI_OPCODE_R2T:
+  case ISCSI_OPCODE_SCSI_RSP:
+    Tcb = IScsiFindTcb (Conn->Session, NTOHL (PduHdr->InitiatorTaskTag));
+    if (Tcb == NULL) {
+      return EFI_PROTOCOL_ERROR;
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  switch (ISCSI_GET_OPCODE (PduHdr)) {
+  case ISCSI_OPCODE_SCSI_DATA_IN:
+    Status = IScsiOnDataInRcvd (Pdu, Tcb, Tcb->Packet);
+    break;
+
+  case ISCSI_OPCODE_R2T:
+    Status = IScsiOnR2TRcvd (Pdu, Tcb, Tcb->Lun, Tcb->Packet);
+    break;
+
+  case ISCSI_OPCODE_SCSI_RSP:
+    Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Tcb->Packet);
+    break;
+
+  case ISCSI_OPCODE_NOP_IN:
+    Status = IScsiOnNopInRcvd (Pdu, Conn);
+    break;
+
+  case ISCSI_OPCODE_VENDOR_T0:
+  case ISCSI_OPCODE_VENDOR_T1:
+  case ISCSI_OPCODE_VENDOR_T2:
+    //
+    // These messages are vendor specific. Skip them.
+    //
+    Status = EFI_SUCCESS;
+    break;
+
+  default:
+    Status = EFI_PROTOCOL_ERROR;
+    break;
+  }
+
+  if ((Tcb != NULL) && Tcb->StatusXferd) {
+    //
+    // The task is completed. A residual overflow only fails this task, while
+    // the other errors leave the connection out of sync.
+    //
+    Tcb->Status = Status;
+    if (Status == EFI_BAD_BUFFER_SIZE) {
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  return Status;
+}
+
+
+/**
+  Receive and process the PDUs that have arrived on the session, without
+  waiting for more.
+
+  @param[in]  Session            The iSCSI session.
+
+  @retval EFI_SUCCESS            All the PDUs that have arrived are processed.
+  @retval EFI_DEVICE_ERROR       Session state was not as required.
+  @retval Others                 The connection failed, the session must be
+                                 reinstated.
+
+**/
+EFI_STATUS
+IScsiPollSession (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS              Status;
+  ISCSI_CONNECTION        *Conn;
+  NET_BUF                 *Pdu;
+
+  if (Session->State != SESSION_STATE_LOGGED_IN) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Conn = NET_LIST_USER_STRUCT_S (
+           Session->Conns.ForwardLink,
+           ISCSI_CONNECTION,
+           Link,
+           ISCSI_CONNECTION_SIGNATURE
+           );
+
+  do {
+    Status = gBS->SetTimer (Conn->TimeoutEvent, TimerRelative, ISCSI_RECEIVE_PDU_TIMEOUT);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Status = IScsiPollPdu (Conn, &Pdu, Conn->TimeoutEvent);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Status = IScsiDispatchPdu (Conn, Pdu);
+    NetbufFree (Pdu);
+  } while (!EFI_ERROR (Status));
+
+  gBS->SetTimer (Conn->TimeoutEvent, TimerCancel, 0);
+
+  if (Status == EFI_NOT_READY) {
+    Status = EFI_SUCCESS;
+  }
+
+  return Status;
+}
+
+
+/**
+  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+
+  The PDUs of the other outstanding commands, issued through the nonblocking
+  interface, are processed as they arrive while waiting for this command.
+
+  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
+  @param[in]       Target    The target ID.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+
+  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
+                               the Packet.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
+  @retval EFI_NOT_READY        The target can not accept new commands.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiExecuteScsiCommand (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
+  IN UINT8                                           *Target,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+  )
+{
+  EFI_STATUS              Status;
+  ISCSI_DRIVER_DATA       *Private;
+  ISCSI_SESSION           *Session;
+  EFI_EVENT               TimeoutEvent;
+  ISCSI_CONNECTION        *Conn;
+  ISCSI_TCB               *Tcb;
+  NET_BUF                 *Pdu;
+  UINT64                  Timeout;
+
+  Private       = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
+  Session       = Private->Session;
+  Tcb           = NULL;
+  TimeoutEvent  = NULL;
+  Timeout       = 0;
+
+  Status = IScsiStartScsiCommand (Session, Lun, Packet, &Tcb);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Conn = Tcb->Conn;
+
+  if (Packet->Timeout != 0) {
+    Timeout = MultU64x32 (Packet->Timeout, 4);
+  }
 
   while (!Tcb->StatusXferd) {
     //
@@ -2990,63 +3376,37 @@ IScsiExecuteScsiCommand (
     //
     // Try to receive PDU from target.
     //
-    Status = IScsiReceivePdu (Conn, &Pdu, &InBufferContext, FALSE, FALSE, TimeoutEvent);
-    if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
+    do {
+      Status = IScsiPollPdu (Conn, &Pdu, TimeoutEvent);
+    } while ((Status == EFI_NOT_READY) &&
+             ((TimeoutEvent == NULL) || EFI_ERROR (gBS->CheckEvent (TimeoutEvent))));
+
+    if (Status == EFI_NOT_READY) {
+      Status = EFI_TIMEOUT;
     }
 
-    PduHdr = NetbufGetByte (Pdu, 0, NULL);
-    if (PduHdr == NULL) {
-      Status = EFI_PROTOCOL_ERROR;
-      NetbufFree (Pdu);
+    if (EFI_ERROR (Status)) {
       goto ON_EXIT;
     }
-    switch (ISCSI_GET_OPCODE (PduHdr)) {
-    case ISCSI_OPCODE_SCSI_DATA_IN:
-      Status = IScsiOnDataInRcvd (Pdu, Tcb, Packet);
-      break;
 
-    case ISCSI_OPCODE_R2T:
-      Status = IScsiOnR2TRcvd (Pdu, Tcb, Lun, Packet);
-      break;
-
-    case ISCSI_OPCODE_SCSI_RSP:
-      Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Packet);
-      break;
-
-    case ISCSI_OPCODE_NOP_IN:
-      Status = IScsiOnNopInRcvd (Pdu, Tcb);
-      break;
-
-    case ISCSI_OPCODE_VENDOR_T0:
-    case ISCSI_OPCODE_VENDOR_T1:
-    case ISCSI_OPCODE_VENDOR_T2:
-      //
-      // These messages are vendor specific. Skip them.
-      //
-      break;
-
-    default:
-      Status = EFI_PROTOCOL_ERROR;
-      break;
-    }
+    Status = IScsiDispatchPdu (Conn, Pdu);
 
     NetbufFree (Pdu);
 
     if (EFI_ERROR (Status)) {
-      break;
+      goto ON_EXIT;
     }
   }
 
+  Status = Tcb->Status;
+
 ON_EXIT:
 
   if (TimeoutEvent != NULL) {
     gBS->SetTimer (TimeoutEvent, TimerCancel, 0);
   }
 
-  if (Tcb != NULL) {
-    IScsiDelTcb (Tcb);
-  }
+  IScsiDelTcb (Tcb);
 
   return Status;
 }
@@ -3141,11 +3501,24 @@ IScsiSessionAbort (
 {
   ISCSI_CONNECTION  *Conn;
   EFI_GUID          *ProtocolGuid;
+  LIST_ENTRY        *Entry;
+  ISCSI_TCB         *Tcb;
 
   if (Session->State != SESSION_STATE_LOGGED_IN) {
     return ;
   }
 
+  //
+  // The outstanding tasks will never complete. Their issuers delete them.
+  //
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if (!Tcb->StatusXferd) {
+      Tcb->StatusXferd = TRUE;
+      Tcb->Status      = EFI_DEVICE_ERROR;
+    }
+  }
+
   ASSERT (!IsListEmpty (&Session->Conns));
 
   while (!IsListEmpty (&Session->Conns)) {
@@ -611,6 +611,19 @@ typedef struct _ISCSI_TCB {
   ISCSI_XFER_CONTEXT  XferContext;
 
   ISCSI_CONNECTION    *Conn;
+
+  //
+  // The SCSI command carried by this task. The PDUs of the task are routed
+  // here by their initiator task tag, since several tasks may be outstanding
+  // on the connection.
+  //
+  UINT64                                      Lun;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  ISCSI_IN_BUFFER_CONTEXT                     InBufferContext;
+  //
+  // The status of the task, valid once StatusXferd is TRUE.
+  //
+  EFI_STATUS                                  Status;
 } ISCSI_TCB;
 
 typedef struct _ISCSI_KEY_VALUE_PAIR {
@@ -865,6 +878,33 @@ IScsiReceivePdu (
   IN EFI_EVENT                             TimeoutEvent OPTIONAL
   );
 
+/**
+  Receive the next iSCSI pdu of the full feature phase if its header has started
+  arriving, without waiting for it otherwise.
+
+  A receive request for the basic header segment is kept pending with the TCP
+  driver between calls, so once this function is called on a connection, all
+  the pdus of the connection must be received through it.
+
+  @param[in]  Conn         The iSCSI connection to receive data from.
+  @param[out] Pdu          The received iSCSI pdu.
+  @param[in]  TimeoutEvent The timeout event for the rest of the pdu once its
+                           header has started arriving, it's optional.
+
+  @retval EFI_SUCCESS          An iSCSI pdu is received.
+  @retval EFI_NOT_READY        No pdu has arrived yet.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiPollPdu (
+  IN ISCSI_CONNECTION                      *Conn,
+  OUT NET_BUF                              **Pdu,
+  IN EFI_EVENT                             TimeoutEvent OPTIONAL
+  );
+
 /**
   Check and get the result of the parameter negotiation.
 
@@ -969,6 +1009,95 @@ IScsiNormalizeName (
   IN     UINTN      Len
   );
 
+/**
+  Find the outstanding task with the specified initiator task tag.
+
+  @param[in]  Session           The iSCSI session.
+  @param[in]  InitiatorTaskTag  The initiator task tag, in host byte order.
+
+  @return The task control block, or NULL if no task with this tag is outstanding.
+
+**/
+ISCSI_TCB *
+IScsiFindTcb (
+  IN ISCSI_SESSION  *Session,
+  IN UINT32         InitiatorTaskTag
+  );
+
+/**
+  Delete the tcb from the connection and destroy it.
+
+  @param[in]  Tcb The tcb to delete.
+
+**/
+VOID
+IScsiDelTcb (
+  IN ISCSI_TCB  *Tcb
+  );
+
+/**
+  Send a SCSI command, and the unsolicited data following it, without waiting
+  for the target to complete it. The target completes the command through the
+  PDUs processed by IScsiDispatchPdu().
+
+  @param[in]       Session   The iSCSI session.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+  @param[out]      Tcb       The task control block of the command, to be deleted
+                             by the caller once StatusXferd is TRUE.
+
+  @retval EFI_SUCCESS          The SCSI command is sent.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_NOT_READY        The command window of the target is closed.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiStartScsiCommand (
+  IN ISCSI_SESSION                                   *Session,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  OUT ISCSI_TCB                                      **Tcb
+  );
+
+/**
+  Process an iSCSI PDU received in the full feature phase, on behalf of the
+  task it belongs to.
+
+  @param[in]  Conn               The iSCSI connection the PDU is received from.
+  @param[in]  Pdu                The PDU received.
+
+  @retval EFI_SUCCESS            The PDU is processed. If it completed a task, the
+                                 status of the task is in its Status field.
+  @retval EFI_PROTOCOL_ERROR     Some kind of iSCSI protocol error occurred.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiDispatchPdu (
+  IN ISCSI_CONNECTION  *Conn,
+  IN NET_BUF           *Pdu
+  );
+
+/**
+  Receive and process the PDUs that have arrived on the session, without
+  waiting for more.
+
+  @param[in]  Session            The iSCSI session.
+
+  @retval EFI_SUCCESS            All the PDUs that have arrived are processed.
+  @retval EFI_DEVICE_ERROR       Session state was not as required.
+  @retval Others                 The connection failed, the session must be
+                                 reinstated.
+
+**/
+EFI_STATUS
+IScsiPollSession (
+  IN ISCSI_SESSION  *Session
+  );
+
 /**
   Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
 
@@ -398,6 +398,34 @@ HttpGetFieldNameAndValue (
      OUT CHAR8   **FieldValue
   );
 
+/**
+  Parse the raw HTTP header string into an array of key/value header pairs.
+
+  The end of the header is located once, and each header field is visited
+  once, so the parsing time grows linearly with the size of the header.
+
+  @param[in]  HttpMessage        Contains raw unformatted HTTP header string.
+  @param[in]  HttpMessageSize    Size of HTTP header.
+  @param[out] HeaderFields       Array of key/value header pairs. It is the
+                                 caller's responsibility to free it with
+                                 HttpFreeHeaderFields().
+  @param[out] FieldCount         Number of headers in HeaderFields.
+
+  @retval EFI_SUCCESS            The header fields were parsed.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or HttpMessage contains
+                                 no header field.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate resources.
+
+**/
+EFI_STATUS
+EFIAPI
+HttpParseHeaderFields (
+  IN     CHAR8             *HttpMessage,
+  IN     UINTN             HttpMessageSize,
+     OUT EFI_HTTP_HEADER   **HeaderFields,
+     OUT UINTN             *FieldCount
+  );
+
 /**
   Free existing HeaderFields.
 
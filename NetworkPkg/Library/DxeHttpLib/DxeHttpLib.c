@@ -1525,9 +1525,11 @@ HttpSetFieldNameAndValue (
 }
 
 /**
-  Get one key/value header pair from the raw string.
+  Get one key/value header pair from the raw string, whose end of header has
+  been located already.
 
   @param[in]  String             Pointer to the raw string.
+  @param[in]  EndofHeader        Pointer to the "\r\n\r\n" ending the raw string.
   @param[out] FieldName          Points directly to field name within 'HttpHeader'.
   @param[out] FieldValue         Points directly to field value within 'HttpHeader'.
 
@@ -1536,9 +1538,9 @@ HttpSetFieldNameAndValue (
 
 **/
 CHAR8 *
-EFIAPI
-HttpGetFieldNameAndValue (
+HttpGetFieldNameAndValueBefore (
   IN     CHAR8   *String,
+  IN     CHAR8   *EndofHeader,
      OUT CHAR8   **FieldName,
      OUT CHAR8   **FieldValue
   )
@@ -1546,25 +1548,17 @@ HttpGetFieldNameAndValue (
   CHAR8  *FieldNameStr;
   CHAR8  *FieldValueStr;
   CHAR8  *StrPtr;
-  CHAR8  *EndofHeader;
-
-  if (String == NULL || FieldName == NULL || FieldValue == NULL) {
-    return NULL;
-  }
 
   *FieldName    = NULL;
   *FieldValue   = NULL;
   FieldNameStr  = NULL;
   FieldValueStr = NULL;
   StrPtr        = NULL;
-  EndofHeader   = NULL;
-
 
-  //
-  // Check whether the raw HTTP header string is valid or not.
-  //
-  EndofHeader = AsciiStrStr (String, "\r\n\r\n");
-  if (EndofHeader == NULL) {
+  if (String >= EndofHeader + 2) {
+    //
+    // Only the empty line ending the header is left.
+    //
     return NULL;
   }
 
@@ -1585,7 +1579,7 @@ HttpGetFieldNameAndValue (
   //
   FieldNameStr = String;
   FieldValueStr = AsciiStrGetNextToken (FieldNameStr, ':');
-  if (FieldValueStr == NULL) {
+  if (FieldValueStr == NULL || FieldValueStr > EndofHeader) {
     return NULL;
   }
 
@@ -1674,6 +1668,169 @@ HttpGetFieldNameAndValue (
   return StrPtr;
 }
 
+/**
+  Get one key/value header pair from the raw string.
+
+  @param[in]  String             Pointer to the raw string.
+  @param[out] FieldName          Points directly to field name within 'HttpHeader'.
+  @param[out] FieldValue         Points directly to field value within 'HttpHeader'.
+
+  @return     Pointer to the next raw string.
+  @return     NULL if no key/value header pair from this raw string.
+
+**/
+CHAR8 *
+EFIAPI
+HttpGetFieldNameAndValue (
+  IN     CHAR8   *String,
+     OUT CHAR8   **FieldName,
+     OUT CHAR8   **FieldValue
+  )
+{
+  CHAR8  *EndofHeader;
+
+  if (String == NULL || FieldName == NULL || FieldValue == NULL) {
+    return NULL;
+  }
+
+  *FieldName  = NULL;
+  *FieldValue = NULL;
+
+  //
+  // Check whether the raw HTTP header string is valid or not.
+  //
+  EndofHeader = AsciiStrStr (String, "\r\n\r\n");
+  if (EndofHeader == NULL) {
+    return NULL;
+  }
+
+  return HttpGetFieldNameAndValueBefore (String, EndofHeader, FieldName, FieldValue);
+}
+
+/**
+  Parse the raw HTTP header string into an array of key/value header pairs.
+
+  The end of the header is located once, and each header field is visited
+  once, so the parsing time grows linearly with the size of the header.
+
+  @param[in]  HttpMessage        Contains raw unformatted HTTP header string.
+  @param[in]  HttpMessageSize    Size of HTTP header.
+  @param[out] HeaderFields       Array of key/value header pairs. It is the
+                                 caller's responsibility to free it with
+                                 HttpFreeHeaderFields().
+  @param[out] FieldCount         Number of headers in HeaderFields.
+
+  @retval EFI_SUCCESS            The header fields were parsed.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or HttpMessage contains
+                                 no header field.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate resources.
+
+**/
+EFI_STATUS
+EFIAPI
+HttpParseHeaderFields (
+  IN     CHAR8             *HttpMessage,
+  IN     UINTN             HttpMessageSize,
+     OUT EFI_HTTP_HEADER   **HeaderFields,
+     OUT UINTN             *FieldCount
+  )
+{
+  EFI_STATUS       Status;
+  CHAR8            *TempHttpMessage;
+  CHAR8            *EndofHeader;
+  CHAR8            *Token;
+  CHAR8            *FieldName;
+  CHAR8            *FieldValue;
+  EFI_HTTP_HEADER  *Fields;
+  UINTN            MaxFieldCount;
+  UINTN            Index;
+
+  if (HttpMessage == NULL || HeaderFields == NULL || FieldCount == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *HeaderFields = NULL;
+  *FieldCount   = 0;
+
+  //
+  // Append the http header string along with a Null-terminator.
+  //
+  TempHttpMessage = AllocatePool (HttpMessageSize + 1);
+  if (TempHttpMessage == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (TempHttpMessage, HttpMessage, HttpMessageSize);
+  TempHttpMessage[HttpMessageSize] = '\0';
+
+  //
+  // Locate the end of the header, and bound the number of header fields by
+  // the number of lines before it in the same pass.
+  //
+  EndofHeader   = NULL;
+  MaxFieldCount = 0;
+  for (Index = 0; Index + 3 < HttpMessageSize; Index++) {
+    if (TempHttpMessage[Index] == '\0') {
+      break;
+    }
+    if (TempHttpMessage[Index] == '\r' && TempHttpMessage[Index + 1] == '\n') {
+      if (TempHttpMessage[Index + 2] == '\r' && TempHttpMessage[Index + 3] == '\n') {
+        EndofHeader = TempHttpMessage + Index;
+        break;
+      }
+      MaxFieldCount++;
+    }
+  }
+
+  if (EndofHeader == NULL) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  //
+  // The last line before the end of header has no CRLF counted yet.
+  //
+  MaxFieldCount++;
+  Fields = AllocateZeroPool (MaxFieldCount * sizeof (EFI_HTTP_HEADER));
+  if (Fields == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  Status = EFI_SUCCESS;
+  Token  = TempHttpMessage;
+  Index  = 0;
+  while (Index < MaxFieldCount) {
+    Token = HttpGetFieldNameAndValueBefore (Token, EndofHeader, &FieldName, &FieldValue);
+    if (FieldName == NULL || FieldValue == NULL) {
+      break;
+    }
+
+    Status = HttpSetFieldNameAndValue (&Fields[Index], FieldName, FieldValue);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Index++;
+  }
+
+  if (!EFI_ERROR (Status) && Index == 0) {
+    Status = EFI_INVALID_PARAMETER;
+  }
+
+  if (EFI_ERROR (Status)) {
+    HttpFreeHeaderFields (Fields, Index);
+    goto ON_EXIT;
+  }
+
+  *HeaderFields = Fields;
+  *FieldCount   = Index;
+
+ON_EXIT:
+  FreePool (TempHttpMessage);
+  return Status;
+}
+
 /**
   Free existing HeaderFields.
 
@@ -184,19 +184,27 @@ MnpFreeNbuf (
   NET_PUT_REF (Nbuf);
 
   if (Nbuf->RefCnt == 1) {
-    //
-    // Trim all buffer contained in the Nbuf, then append it to the NbufQue.
-    //
-    NetbufTrim (Nbuf, Nbuf->TotalSize, NET_BUF_TAIL);
-
-    if (NetbufAllocSpace (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_HEAD) != NULL) {
+    if (Nbuf->Vector->Free == MnpReleaseLentFrame) {
       //
-      // There is space reserved for vlan tag in the head, reclaim it
+      // The Nbuf is built on a receive buffer lent by Snp, free it to give
+      // the buffer back.
       //
-      NetbufTrim (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_TAIL);
-    }
+      NetbufFree (Nbuf);
+    } else {
+      //
+      // Trim all buffer contained in the Nbuf, then append it to the NbufQue.
+      //
+      NetbufTrim (Nbuf, Nbuf->TotalSize, NET_BUF_TAIL);
 
-    NetbufQueAppend (&MnpDeviceData->FreeNbufQue, Nbuf);
+      if (NetbufAllocSpace (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_HEAD) != NULL) {
+        //
+        // There is space reserved for vlan tag in the head, reclaim it
+        //
+        NetbufTrim (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_TAIL);
+      }
+
+      NetbufQueAppend (&MnpDeviceData->FreeNbufQue, Nbuf);
+    }
   }
 
   gBS->RestoreTPL (OldTpl);
@@ -427,6 +435,7 @@ MnpInitializeDeviceData (
   EFI_STATUS                  Status;
   EFI_SIMPLE_NETWORK_PROTOCOL *Snp;
   EFI_SIMPLE_NETWORK_MODE     *SnpMode;
+  UINTN                       Index;
 
   MnpDeviceData->Signature        = MNP_DEVICE_DATA_SIGNATURE;
   MnpDeviceData->ImageHandle      = ImageHandle;
@@ -458,6 +467,28 @@ MnpInitializeDeviceData (
   SnpMode            = Snp->Mode;
   MnpDeviceData->Snp = Snp;
 
+  //
+  // Receive into the buffers of the SNP driver if it lends them, which saves
+  // copying each packet.
+  //
+  Status = gBS->OpenProtocol (
+                  ControllerHandle,
+                  &gEdkiiSimpleNetworkRxLendProtocolGuid,
+                  (VOID **) &MnpDeviceData->RxLend,
+                  ImageHandle,
+                  ControllerHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDeviceData->RxLend = NULL;
+  }
+
+  InitializeListHead (&MnpDeviceData->FreeLentFrameList);
+  for (Index = 0; Index < MNP_RX_LEND_MAX; Index++) {
+    MnpDeviceData->LentFrame[Index].MnpDeviceData = MnpDeviceData;
+    InsertTailList (&MnpDeviceData->FreeLentFrameList, &MnpDeviceData->LentFrame[Index].Link);
+  }
+
   //
   // Initialize the lists.
   //
@@ -660,6 +691,12 @@ MnpDestroyDeviceData (
   //
   MnpFreeNbuf (MnpDeviceData, MnpDeviceData->RxNbufCache);
 
+  //
+  // All the buffers lent by Snp must have been given back, see
+  // MnpDriverBindingStop ().
+  //
+  ASSERT (MnpDeviceData->LentFrameCount == 0);
+
   //
   // Flush the FreeNbufQue.
   //
@@ -1280,6 +1317,8 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->PollInterval     = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->IdlePollCount    = 0;
   }
 
   //
@@ -353,6 +353,20 @@ MnpDriverBindingStop (
   }
 
   if (NumberOfChildren == 0) {
+    //
+    // The receive buffers lent by Snp are given back when the receivers
+    // recycle their packets, which needs the device data. Don't stop until
+    // all of them have been given back.
+    //
+    if (MnpDeviceData->LentFrameCount != 0) {
+      DEBUG ((
+        EFI_D_ERROR,
+        "MnpDriverBindingStop: %d received packets are not recycled.\n",
+        MnpDeviceData->LentFrameCount
+        ));
+      return EFI_DEVICE_ERROR;
+    }
+
     //
     // Destroy all MNP service data
     //
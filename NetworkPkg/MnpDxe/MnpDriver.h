@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Protocol/ManagedNetwork.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkRxLend.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
 
@@ -32,12 +33,28 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define MNP_DEVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'D')
 
+//
+// Maximum number of receive buffers lent by the SNP driver that MNP holds at
+// the same time.
+//
+#define MNP_RX_LEND_MAX  64
+
 //
 // Global Variables
 //
 extern  EFI_DRIVER_BINDING_PROTOCOL gMnpDriverBinding;
 
+//
+// A receive buffer lent by the SNP driver, referenced by the NET_BUF built on
+// it until the NET_BUF is freed.
+//
 typedef struct {
+  LIST_ENTRY                    Link;
+  struct _MNP_DEVICE_DATA       *MnpDeviceData;
+  VOID                          *Context;
+} MNP_LENT_FRAME;
+
+typedef struct _MNP_DEVICE_DATA {
   UINT32                        Signature;
 
   EFI_HANDLE                    ControllerHandle;
@@ -69,6 +86,12 @@ typedef struct {
 
   EFI_EVENT                     PollTimer;
   BOOLEAN                       EnableSystemPoll;
+  //
+  // The current period of the poll timer, shortened while packets are
+  // received, and the number of polls in a row that received nothing.
+  //
+  UINT64                        PollInterval;
+  UINT32                        IdlePollCount;
 
   EFI_EVENT                     TimeoutCheckTimer;
   EFI_EVENT                     MediaDetectTimer;
@@ -85,6 +108,15 @@ typedef struct {
   UINT32                        BufferLength;
   UINT32                        PaddingSize;
   NET_BUF                       *RxNbufCache;
+
+  //
+  // The RX lend protocol installed with Snp, NULL if the SNP driver does
+  // not lend its receive buffers.
+  //
+  EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL *RxLend;
+  MNP_LENT_FRAME                LentFrame[MNP_RX_LEND_MAX];
+  LIST_ENTRY                    FreeLentFrameList;
+  UINT32                        LentFrameCount;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
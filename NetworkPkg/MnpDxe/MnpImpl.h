@@ -14,6 +14,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE            4
 
 #define MNP_SYS_POLL_INTERVAL         (10 * TICKS_PER_MS)   // 10 milliseconds
+#define MNP_SYS_POLL_FAST_INTERVAL    (1 * TICKS_PER_MS)    // 1 millisecond
+#define MNP_SYS_POLL_IDLE_COUNT       50    // Fast polls without packet before slowing down.
+#define MNP_RX_BATCH_MAX              64    // Maximum packets received per poll.
 #define MNP_TIMEOUT_CHECK_INTERVAL    (50 * TICKS_PER_MS)   // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL     (500 * TICKS_PER_MS)  // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME           (500 * TICKS_PER_MS)  // 500 milliseconds
@@ -430,6 +433,52 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA   *MnpDeviceData
   );
 
+/**
+  Receive and deliver all the packets pending in Snp, up to MNP_RX_BATCH_MAX.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                No packet is received, as returned by MnpReceivePacket().
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA   *MnpDeviceData
+  );
+
+/**
+  Try to receive a packet in a buffer lent by Snp and deliver it.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+  @retval EFI_SUCCESS           A packet is received.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_OUT_OF_RESOURCES  No buffer can be lent now, the packet must be
+                                received through Snp->Receive().
+  @retval EFI_UNSUPPORTED       Snp doesn't lend its buffers in the current
+                                configuration.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceiveLentPacket (
+  IN OUT MNP_DEVICE_DATA   *MnpDeviceData
+  );
+
+/**
+  Give the receive buffer behind a NET_BUF built by MnpReceiveLentPacket ()
+  back to the SNP driver. This is the free function of the NET_BUF.
+
+  @param[in]  Arg                  Pointer to the MNP_LENT_FRAME of the buffer.
+
+**/
+VOID
+EFIAPI
+MnpReleaseLentFrame (
+  IN VOID                  *Arg
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
@@ -831,6 +831,158 @@ MnpEnqueuePacket (
 }
 
 
+/**
+  Give the receive buffer behind a NET_BUF built by MnpReceiveLentPacket ()
+  back to the SNP driver. This is the free function of the NET_BUF.
+
+  @param[in]  Arg                  Pointer to the MNP_LENT_FRAME of the buffer.
+
+**/
+VOID
+EFIAPI
+MnpReleaseLentFrame (
+  IN VOID                  *Arg
+  )
+{
+  MNP_LENT_FRAME   *LentFrame;
+  MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_TPL          OldTpl;
+
+  LentFrame     = (MNP_LENT_FRAME *) Arg;
+  MnpDeviceData = LentFrame->MnpDeviceData;
+
+  MnpDeviceData->RxLend->Release (MnpDeviceData->RxLend, LentFrame->Context);
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ASSERT (MnpDeviceData->LentFrameCount > 0);
+  MnpDeviceData->LentFrameCount--;
+  InsertTailList (&MnpDeviceData->FreeLentFrameList, &LentFrame->Link);
+  gBS->RestoreTPL (OldTpl);
+}
+
+
+/**
+  Try to receive a packet in a buffer lent by Snp and deliver it.
+
+  The NET_BUF delivered to the instances is built on the lent buffer, so the
+  packet is not copied. The buffer is given back to Snp when the last receiver
+  recycles the packet. A packet whose protocol header is not 4-byte aligned
+  is copied into a NET_BUF of the pool instead.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+  @retval EFI_SUCCESS           A packet is received.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_OUT_OF_RESOURCES  No buffer can be lent now, the packet must be
+                                received through Snp->Receive().
+  @retval EFI_UNSUPPORTED       Snp doesn't lend its buffers in the current
+                                configuration.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceiveLentPacket (
+  IN OUT MNP_DEVICE_DATA   *MnpDeviceData
+  )
+{
+  EFI_STATUS                            Status;
+  EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL *RxLend;
+  MNP_LENT_FRAME                        *LentFrame;
+  NET_FRAGMENT                          Fragment;
+  NET_BUF                               *Nbuf;
+  UINT8                                 *Frame;
+  UINTN                                 FrameLength;
+  VOID                                  *Context;
+  UINT32                                HeaderSize;
+  MNP_SERVICE_DATA                      *MnpServiceData;
+  UINT16                                VlanId;
+  BOOLEAN                               Received;
+  EFI_TPL                               OldTpl;
+
+  RxLend = MnpDeviceData->RxLend;
+  if (IsListEmpty (&MnpDeviceData->FreeLentFrameList)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = RxLend->Receive (RxLend, (VOID **) &Frame, &FrameLength, &Context);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Sanity check.
+  //
+  HeaderSize = MnpDeviceData->Snp->Mode->MediaHeaderSize;
+  if ((FrameLength < HeaderSize) || (FrameLength > MnpDeviceData->BufferLength)) {
+    DEBUG ((EFI_D_WARN, "MnpReceiveLentPacket: Size error, HL:TL = %d:%d.\n", HeaderSize, FrameLength));
+    RxLend->Release (RxLend, Context);
+    return EFI_DEVICE_ERROR;
+  }
+
+  if ((((UINTN) Frame + HeaderSize) & 0x3) == 0) {
+    OldTpl    = gBS->RaiseTPL (TPL_NOTIFY);
+    LentFrame = NET_LIST_HEAD (&MnpDeviceData->FreeLentFrameList, MNP_LENT_FRAME, Link);
+    RemoveEntryList (&LentFrame->Link);
+    MnpDeviceData->LentFrameCount++;
+    gBS->RestoreTPL (OldTpl);
+
+    LentFrame->Context = Context;
+    Fragment.Bulk      = Frame;
+    Fragment.Len       = (UINT32) FrameLength;
+
+    Nbuf = NetbufFromExt (&Fragment, 1, 0, 0, MnpReleaseLentFrame, LentFrame);
+    if (Nbuf == NULL) {
+      MnpReleaseLentFrame (LentFrame);
+      return EFI_DEVICE_ERROR;
+    }
+
+    //
+    // Hold a reference as MnpAllocNbuf () does, the receivers take theirs.
+    //
+    NET_GET_REF (Nbuf);
+  } else {
+    Nbuf = MnpAllocNbuf (MnpDeviceData);
+    if (Nbuf == NULL) {
+      RxLend->Release (RxLend, Context);
+      return EFI_DEVICE_ERROR;
+    }
+
+    CopyMem (NetbufAllocSpace (Nbuf, (UINT32) FrameLength, NET_BUF_TAIL), Frame, FrameLength);
+    RxLend->Release (RxLend, Context);
+  }
+
+  VlanId = 0;
+  if (MnpDeviceData->NumberOfVlan != 0) {
+    //
+    // VLAN is configured, remove the VLAN tag if any
+    //
+    MnpRemoveVlanTag (MnpDeviceData, Nbuf, &VlanId);
+  }
+
+  //
+  // Enqueue the packet to the matched instances, RefCnt > 2 indicates there
+  // is at least one receiver of this packet.
+  //
+  Received       = FALSE;
+  MnpServiceData = MnpFindServiceData (MnpDeviceData, VlanId);
+  if (MnpServiceData != NULL) {
+    MnpEnqueuePacket (MnpServiceData, Nbuf);
+    Received = (BOOLEAN) (Nbuf->RefCnt > 2);
+  }
+
+  MnpFreeNbuf (MnpDeviceData, Nbuf);
+
+  if (Received) {
+    //
+    // Deliver the queued packets.
+    //
+    MnpDeliverPacket (MnpServiceData);
+  }
+
+  return EFI_SUCCESS;
+}
+
+
 /**
   Try to receive a packet and deliver it.
 
@@ -868,6 +1020,16 @@ MnpReceivePacket (
     return EFI_NOT_STARTED;
   }
 
+  if (MnpDeviceData->RxLend != NULL) {
+    //
+    // Use Snp->Receive () only if Snp can't lend a buffer now.
+    //
+    Status = MnpReceiveLentPacket (MnpDeviceData);
+    if ((Status != EFI_OUT_OF_RESOURCES) && (Status != EFI_UNSUPPORTED)) {
+      return Status;
+    }
+  }
+
   if (MnpDeviceData->RxNbufCache == NULL) {
     //
     // Try to get a new buffer as there may be buffers recycled.
@@ -1001,6 +1163,40 @@ EXIT:
 }
 
 
+/**
+  Receive and deliver all the packets pending in Snp, up to MNP_RX_BATCH_MAX.
+
+  The DPCs queued for each packet are dispatched before the next packet is
+  received, so the receivers can queue new rx tokens in between.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                No packet is received, as returned by MnpReceivePacket().
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA   *MnpDeviceData
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Count;
+
+  Status = EFI_NOT_READY;
+  for (Count = 0; Count < MNP_RX_BATCH_MAX; Count++) {
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    DispatchDpc ();
+  }
+
+  return (Count > 0) ? EFI_SUCCESS : Status;
+}
+
+
 /**
   Remove the received packets if timeout occurs.
 
@@ -1117,6 +1313,8 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_STATUS       Status;
+  UINT64           PollInterval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *) Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
@@ -1124,10 +1322,33 @@ MnpSystemPoll (
   //
   // Try to receive packets from Snp.
   //
-  MnpReceivePacket (MnpDeviceData);
+  Status = MnpReceivePackets (MnpDeviceData);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
   //
   DispatchDpc ();
+
+  if (!MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
+
+  //
+  // Poll faster while packets are being received, so the latency of the upper
+  // layers isn't bound by the poll interval during a transfer, and fall back
+  // to the normal interval once the link has been idle for a while.
+  //
+  PollInterval = MnpDeviceData->PollInterval;
+  if (!EFI_ERROR (Status)) {
+    MnpDeviceData->IdlePollCount = 0;
+    PollInterval = MNP_SYS_POLL_FAST_INTERVAL;
+  } else if (++MnpDeviceData->IdlePollCount >= MNP_SYS_POLL_IDLE_COUNT) {
+    PollInterval = MNP_SYS_POLL_INTERVAL;
+  }
+
+  if (PollInterval != MnpDeviceData->PollInterval) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, PollInterval))) {
+      MnpDeviceData->PollInterval = PollInterval;
+    }
+  }
 }
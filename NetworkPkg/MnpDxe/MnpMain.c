@@ -775,7 +775,7 @@ MnpPoll (
   //
   // Try to receive packets.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePackets (Instance->MnpServiceData->MnpDeviceData);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -0,0 +1,618 @@
+/** @file
+  Host based unit tests of the MTFTP4 download of out-of-order data blocks.
+
+  The tests feed data packets to the read request handler of the Mtftp4Dxe
+  sources over mocked network buffers and UDP I/O, with a window larger than
+  one block, and check that every block is saved at its offset in the file.
+  The packets include blocks ahead of a lost one, blocks resent after a window
+  restart, and blocks on both sides of the 16-bit block number roll-over.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../Mtftp4Impl.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "Mtftp4Dxe Read Request Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+//
+// Each data block holds its continuous block counter, so a block saved at
+// the wrong offset of the file is found.
+//
+#define MTFTP4_TEST_BLKSIZE       sizeof (UINT64)
+#define MTFTP4_TEST_WINDOWSIZE    16
+#define MTFTP4_TEST_LAST_SIZE     4
+
+//
+// One full round of the block number, then most of the next one.
+//
+#define MTFTP4_TEST_WRAP_BLOCKS   (0x10000 + 0xfffd)
+#define MTFTP4_TEST_SMALL_BLOCKS  40
+
+typedef struct {
+  MTFTP4_PROTOCOL           Instance;
+  EFI_MTFTP4_TOKEN          Token;
+  UINT64                    *Buffer;
+  UINT64                    BlockCount;
+  UINT16                    LastAck;
+  UINTN                     AckCount;
+} MTFTP4_TEST_CONTEXT;
+
+STATIC MTFTP4_TEST_CONTEXT  mMtftp4Test;
+STATIC EFI_BOOT_SERVICES    mBootServices;
+
+EFI_BOOT_SERVICES           *gBS = &mBootServices;
+EFI_IPv4_ADDRESS            mZeroIp4Addr;
+
+/**
+  Function to process the received data packets, from Mtftp4Rrq.c.
+
+  @param  Instance              The downloading MTFTP session
+  @param  Packet                The packet received
+  @param  Len                   The length of the packet
+  @param  Multicast             Whether this packet is multicast or unicast
+  @param  Completed             Return whether the download has completed
+
+  @retval EFI_SUCCESS           The data packet is successfully processed
+  @retval EFI_ABORTED           The download is aborted by the user
+  @retval EFI_BUFFER_TOO_SMALL  The user provided buffer is too small
+
+**/
+EFI_STATUS
+Mtftp4RrqHandleData (
+  IN     MTFTP4_PROTOCOL       *Instance,
+  IN     EFI_MTFTP4_PACKET     *Packet,
+  IN     UINT32                Len,
+  IN     BOOLEAN               Multicast,
+     OUT BOOLEAN               *Completed
+  );
+
+/**
+  Mock of NetListInsertAfter.
+**/
+VOID
+EFIAPI
+NetListInsertAfter (
+  IN OUT LIST_ENTRY         *PrevEntry,
+  IN OUT LIST_ENTRY         *NewEntry
+  )
+{
+  NewEntry->BackLink                = PrevEntry;
+  NewEntry->ForwardLink             = PrevEntry->ForwardLink;
+  PrevEntry->ForwardLink->BackLink  = NewEntry;
+  PrevEntry->ForwardLink            = NewEntry;
+}
+
+/**
+  Mock of NetbufAlloc, the data of the buffer follows its NET_BUF.
+**/
+NET_BUF *
+EFIAPI
+NetbufAlloc (
+  IN UINT32                 Len
+  )
+{
+  NET_BUF                   *Nbuf;
+
+  Nbuf = AllocateZeroPool (sizeof (NET_BUF) + Len);
+  if (Nbuf == NULL) {
+    return NULL;
+  }
+
+  Nbuf->RefCnt                = 1;
+  Nbuf->BlockOpNum            = 1;
+  Nbuf->BlockOp[0].BlockHead  = (UINT8 *) (Nbuf + 1);
+  Nbuf->BlockOp[0].BlockTail  = Nbuf->BlockOp[0].BlockHead + Len;
+  Nbuf->BlockOp[0].Head       = Nbuf->BlockOp[0].BlockHead;
+  Nbuf->BlockOp[0].Tail       = Nbuf->BlockOp[0].BlockHead;
+  return Nbuf;
+}
+
+/**
+  Mock of NetbufAllocSpace, space is only allocated at the tail.
+**/
+UINT8 *
+EFIAPI
+NetbufAllocSpace (
+  IN OUT NET_BUF            *Nbuf,
+  IN UINT32                 Len,
+  IN BOOLEAN                FromHead
+  )
+{
+  UINT8                     *Space;
+
+  if (FromHead || (Len > (UINTN) (Nbuf->BlockOp[0].BlockTail - Nbuf->BlockOp[0].Tail))) {
+    return NULL;
+  }
+
+  Space                  = Nbuf->BlockOp[0].Tail;
+  Nbuf->BlockOp[0].Tail += Len;
+  Nbuf->BlockOp[0].Size += Len;
+  Nbuf->TotalSize       += Len;
+  return Space;
+}
+
+/**
+  Mock of NetbufFree.
+**/
+VOID
+EFIAPI
+NetbufFree (
+  IN NET_BUF                *Nbuf
+  )
+{
+  if (--Nbuf->RefCnt == 0) {
+    FreePool (Nbuf);
+  }
+}
+
+/**
+  Mock of NetbufGetByte.
+**/
+UINT8 *
+EFIAPI
+NetbufGetByte (
+  IN  NET_BUF               *Nbuf,
+  IN  UINT32                Offset,
+  OUT UINT32                *Index  OPTIONAL
+  )
+{
+  if (Offset >= Nbuf->TotalSize) {
+    return NULL;
+  }
+
+  if (Index != NULL) {
+    *Index = 0;
+  }
+
+  return Nbuf->BlockOp[0].Head + Offset;
+}
+
+/**
+  Mock of NetbufCopy.
+**/
+UINT32
+EFIAPI
+NetbufCopy (
+  IN NET_BUF                *Nbuf,
+  IN UINT32                 Offset,
+  IN UINT32                 Len,
+  IN UINT8                  *Dest
+  )
+{
+  if (Offset >= Nbuf->TotalSize) {
+    return 0;
+  }
+
+  Len = MIN (Len, Nbuf->TotalSize - Offset);
+  CopyMem (Dest, Nbuf->BlockOp[0].Head + Offset, Len);
+  return Len;
+}
+
+/**
+  Mock of UdpIoSendDatagram, which records the block number of the ACKs sent
+  and completes the transmission at once.
+**/
+EFI_STATUS
+EFIAPI
+UdpIoSendDatagram (
+  IN  UDP_IO                *UdpIo,
+  IN  NET_BUF               *Packet,
+  IN  UDP_END_POINT         *EndPoint OPTIONAL,
+  IN  EFI_IP_ADDRESS        *Gateway  OPTIONAL,
+  IN  UDP_IO_CALLBACK       CallBack,
+  IN  VOID                  *Context
+  )
+{
+  EFI_MTFTP4_PACKET         *Ack;
+
+  Ack = (EFI_MTFTP4_PACKET *) NetbufGetByte (Packet, 0, NULL);
+  if ((Ack != NULL) && (NTOHS (Ack->Ack.OpCode) == EFI_MTFTP4_OPCODE_ACK)) {
+    mMtftp4Test.LastAck = NTOHS (Ack->Ack.Block[0]);
+    mMtftp4Test.AckCount++;
+  }
+
+  CallBack (Packet, EndPoint, EFI_SUCCESS, Context);
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of UdpIoRecvDatagram, the tests deliver the packets themselves.
+**/
+EFI_STATUS
+EFIAPI
+UdpIoRecvDatagram (
+  IN  UDP_IO                *UdpIo,
+  IN  UDP_IO_CALLBACK       CallBack,
+  IN  VOID                  *Context,
+  IN  UINT32                HeadLen
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of UdpIoCreateIo, the tests don't open multicast ports.
+**/
+UDP_IO *
+EFIAPI
+UdpIoCreateIo (
+  IN  EFI_HANDLE            Controller,
+  IN  EFI_HANDLE            ImageHandle,
+  IN  UDP_IO_CONFIG         Configure,
+  IN  UINT8                 UdpVersion,
+  IN  VOID                  *Context
+  )
+{
+  return NULL;
+}
+
+/**
+  Mock of UdpIoFreeIo.
+**/
+EFI_STATUS
+EFIAPI
+UdpIoFreeIo (
+  IN  UDP_IO                *UdpIo
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of Mtftp4CleanOperation from Mtftp4Impl.c, the tests clean up the
+  session in Mtftp4TestTeardown().
+**/
+VOID
+Mtftp4CleanOperation (
+  IN OUT MTFTP4_PROTOCOL        *Instance,
+  IN     EFI_STATUS             Result
+  )
+{
+}
+
+/**
+  Start a download of a file of a number of blocks, as the read request
+  handler does once the server acknowledged a window size.
+
+  @param  BlockCount            The number of blocks of the file.
+
+  @retval UNIT_TEST_PASSED      The download has been started.
+**/
+STATIC
+UNIT_TEST_STATUS
+Mtftp4TestStart (
+  IN UINT64                 BlockCount
+  )
+{
+  MTFTP4_PROTOCOL           *Instance;
+  EFI_STATUS                Status;
+
+  ZeroMem (&mMtftp4Test, sizeof (mMtftp4Test));
+  mMtftp4Test.BlockCount = BlockCount;
+  mMtftp4Test.Buffer     = AllocateZeroPool ((UINTN) BlockCount * MTFTP4_TEST_BLKSIZE);
+  UT_ASSERT_NOT_NULL (mMtftp4Test.Buffer);
+
+  mMtftp4Test.Token.Buffer     = mMtftp4Test.Buffer;
+  mMtftp4Test.Token.BufferSize = BlockCount * MTFTP4_TEST_BLKSIZE;
+
+  Instance             = &mMtftp4Test.Instance;
+  Instance->Token      = &mMtftp4Test.Token;
+  Instance->Master     = TRUE;
+  Instance->BlkSize    = MTFTP4_TEST_BLKSIZE;
+  Instance->WindowSize = MTFTP4_TEST_WINDOWSIZE;
+  Instance->Timeout    = 1;
+  InitializeListHead (&Instance->Blocks);
+
+  Status = Mtftp4InitBlockRange (&Instance->Blocks, 1, 0xffff);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the download session of the last test.
+
+  @param  Context               Unused.
+**/
+STATIC
+VOID
+EFIAPI
+Mtftp4TestTeardown (
+  IN UNIT_TEST_CONTEXT      Context
+  )
+{
+  MTFTP4_PROTOCOL           *Instance;
+  MTFTP4_BLOCK_RANGE        *Range;
+
+  Instance = &mMtftp4Test.Instance;
+  while ((Instance->Blocks.ForwardLink != NULL) && !IsListEmpty (&Instance->Blocks)) {
+    Range = NET_LIST_HEAD (&Instance->Blocks, MTFTP4_BLOCK_RANGE, Link);
+    RemoveEntryList (&Range->Link);
+    FreePool (Range);
+  }
+
+  if (Instance->LastPacket != NULL) {
+    NetbufFree (Instance->LastPacket);
+  }
+
+  if (mMtftp4Test.Buffer != NULL) {
+    FreePool (mMtftp4Test.Buffer);
+  }
+
+  ZeroMem (&mMtftp4Test, sizeof (mMtftp4Test));
+}
+
+/**
+  Deliver the data packet of a block of the file to the read request handler.
+
+  @param  Counter               The continuous block counter of the block, the
+                                block number is its value after roll-over.
+  @param  Data                  The data of the block, which is Counter unless
+                                a stale block of another round is sent.
+  @param  Completed             Return whether the download has completed.
+
+  @return The status returned by the read request handler.
+**/
+STATIC
+EFI_STATUS
+Mtftp4TestReceive (
+  IN  UINT64                Counter,
+  IN  UINT64                Data,
+  OUT BOOLEAN               *Completed
+  )
+{
+  UINT8                     Buffer[MTFTP4_DATA_HEAD_LEN + MTFTP4_TEST_BLKSIZE];
+  EFI_MTFTP4_PACKET         *Packet;
+  UINT32                    Len;
+
+  Packet              = (EFI_MTFTP4_PACKET *) Buffer;
+  Packet->Data.OpCode = HTONS (EFI_MTFTP4_OPCODE_DATA);
+  Packet->Data.Block  = HTONS ((UINT16) Counter);
+  CopyMem (Packet->Data.Data, &Data, MTFTP4_TEST_BLKSIZE);
+
+  Len = sizeof (Buffer);
+  if (Counter == mMtftp4Test.BlockCount) {
+    Len = MTFTP4_DATA_HEAD_LEN + MTFTP4_TEST_LAST_SIZE;
+  }
+
+  return Mtftp4RrqHandleData (&mMtftp4Test.Instance, Packet, Len, FALSE, Completed);
+}
+
+/**
+  Deliver the blocks of the file in a range in order.
+
+  @param  First                 The continuous block counter of the first block.
+  @param  Last                  The continuous block counter of the last block.
+  @param  Completed             Return whether the download has completed.
+
+  @retval EFI_SUCCESS           All the blocks have been processed.
+  @retval Others                The read request handler failed on a block.
+**/
+STATIC
+EFI_STATUS
+Mtftp4TestReceiveRange (
+  IN  UINT64                First,
+  IN  UINT64                Last,
+  OUT BOOLEAN               *Completed
+  )
+{
+  EFI_STATUS                Status;
+  UINT64                    Counter;
+
+  for (Counter = First; Counter <= Last; Counter++) {
+    Status = Mtftp4TestReceive (Counter, Counter, Completed);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check that the download completed with every block saved at its offset.
+
+  @retval UNIT_TEST_PASSED      The file has been downloaded intact.
+**/
+STATIC
+UNIT_TEST_STATUS
+Mtftp4TestCheckFile (
+  VOID
+  )
+{
+  UINT64                    Counter;
+  UINT64                    Last;
+
+  UT_ASSERT_EQUAL (
+    mMtftp4Test.Token.BufferSize,
+    (mMtftp4Test.BlockCount - 1) * MTFTP4_TEST_BLKSIZE + MTFTP4_TEST_LAST_SIZE
+    );
+  UT_ASSERT_TRUE (IsListEmpty (&mMtftp4Test.Instance.Blocks));
+  UT_ASSERT_EQUAL (mMtftp4Test.LastAck, (UINT16) mMtftp4Test.BlockCount);
+
+  for (Counter = 1; Counter < mMtftp4Test.BlockCount; Counter++) {
+    UT_ASSERT_EQUAL (mMtftp4Test.Buffer[Counter - 1], Counter);
+  }
+
+  Last = 0;
+  CopyMem (&Last, &mMtftp4Test.Buffer[Counter - 1], MTFTP4_TEST_LAST_SIZE);
+  UT_ASSERT_EQUAL (Last, mMtftp4Test.BlockCount & MAX_UINT32);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Download a file whose window is restarted after a lost block. The blocks
+  after the lost one are saved once, and resent ones aren't saved again.
+
+  @param  Context               Unused.
+
+  @retval UNIT_TEST_PASSED      The file has been downloaded intact.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DownloadWithLostBlock (
+  IN UNIT_TEST_CONTEXT      Context
+  )
+{
+  EFI_STATUS                Status;
+  BOOLEAN                   Completed;
+
+  UT_ASSERT_EQUAL (Mtftp4TestStart (MTFTP4_TEST_SMALL_BLOCKS), UNIT_TEST_PASSED);
+
+  //
+  // Block 5 of the first window is lost, the blocks after it are saved,
+  // and the ACK of the window is left to the timeout.
+  //
+  Status = Mtftp4TestReceiveRange (1, 4, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = Mtftp4TestReceiveRange (6, MTFTP4_TEST_WINDOWSIZE, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (Completed);
+  UT_ASSERT_EQUAL (mMtftp4Test.AckCount, 0);
+
+  //
+  // The server restarts the window from block 5, the blocks after it were
+  // saved already, and the window is acked up to its last block.
+  //
+  mMtftp4Test.Instance.AckedBlock = mMtftp4Test.Instance.TotalBlock;
+  Status = Mtftp4TestReceive (5, 5, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = Mtftp4TestReceiveRange (6, MTFTP4_TEST_WINDOWSIZE, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = Mtftp4TestReceiveRange (MTFTP4_TEST_WINDOWSIZE + 1, MTFTP4_TEST_WINDOWSIZE + 4, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mMtftp4Test.AckCount, 1);
+  UT_ASSERT_EQUAL (mMtftp4Test.LastAck, MTFTP4_TEST_WINDOWSIZE + 4);
+
+  Status = Mtftp4TestReceiveRange (MTFTP4_TEST_WINDOWSIZE + 5, MTFTP4_TEST_SMALL_BLOCKS, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (Completed);
+
+  return Mtftp4TestCheckFile ();
+}
+
+/**
+  Download a file across the roll-over of the block number, with the last
+  block of a round received ahead of the one before it, and a block of the
+  previous round resent after the roll-over.
+
+  @param  Context               Unused.
+
+  @retval UNIT_TEST_PASSED      The file has been downloaded intact.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DownloadAcrossBlockNumberWrap (
+  IN UNIT_TEST_CONTEXT      Context
+  )
+{
+  EFI_STATUS                Status;
+  BOOLEAN                   Completed;
+  UINTN                     AckCount;
+
+  UT_ASSERT_EQUAL (Mtftp4TestStart (MTFTP4_TEST_WRAP_BLOCKS), UNIT_TEST_PASSED);
+
+  Status = Mtftp4TestReceiveRange (1, 0xfffd, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  //
+  // Block 0xffff arrives ahead of block 0xfffe. It must not end the file.
+  //
+  Status = Mtftp4TestReceive (0xffff, 0xffff, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (Completed);
+  Status = Mtftp4TestReceive (0xfffe, 0xfffe, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (Completed);
+  UT_ASSERT_EQUAL (Mtftp4GetNextBlockNum (&mMtftp4Test.Instance.Blocks), 0);
+
+  Status = Mtftp4TestReceiveRange (0x10000, 0x10001, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  //
+  // Block 0xfffa of the previous round is resent. It must not be saved as
+  // block 0xfffa of this round, and it is acked at once.
+  //
+  AckCount = mMtftp4Test.AckCount;
+  Status   = Mtftp4TestReceive (0x1fffa, 0xfffa, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (Completed);
+  UT_ASSERT_EQUAL (mMtftp4Test.AckCount, AckCount + 1);
+  UT_ASSERT_EQUAL (mMtftp4Test.LastAck, 1);
+
+  Status = Mtftp4TestReceiveRange (0x10002, MTFTP4_TEST_WRAP_BLOCKS, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (Completed);
+
+  return Mtftp4TestCheckFile ();
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  read request data handling and run them.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RrqTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (
+             &RrqTests,
+             Framework,
+             "Read Request Data Tests",
+             "NetworkPkg.Mtftp4Dxe.Rrq",
+             NULL,
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RrqTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (RrqTests, "Download with a lost block", "LostBlock", DownloadWithLostBlock, NULL, Mtftp4TestTeardown, NULL);
+  AddTestCase (RrqTests, "Download across the block number roll-over", "BlockNumberWrap", DownloadAcrossBlockNumberWrap, NULL, Mtftp4TestTeardown, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
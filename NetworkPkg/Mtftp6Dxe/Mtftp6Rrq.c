@@ -224,6 +224,8 @@ Mtftp6RrqHandleData (
   EFI_STATUS                Status;
   UINT16                    BlockNum;
   INTN                      Expected;
+  BOOLEAN                   Ahead;
+  BOOLEAN                   Behind;
 
   *IsCompleted = FALSE;
   Status       = EFI_SUCCESS;
@@ -237,28 +239,46 @@ Mtftp6RrqHandleData (
   // the ACK for the block we received, then restart receiving the
   // expected one. If we are passive (Slave), save the block.
   //
+  // With a window larger than one, a block of the current window that arrives
+  // ahead of a lost one is saved and counted instead. One that arrives again
+  // after the server restarted the window has been saved already, and is only
+  // counted. The server is acked once per window, for the blocks received in
+  // order, and resends the window from the first hole. Blocks on the other
+  // side of a block number roll-over are never taken out of order, as the
+  // round of the block counter they belong to isn't known.
+  //
+  Behind = FALSE;
   if (Instance->IsMaster && (Expected != BlockNum)) {
-    //
-    // Free the received packet before send new packet in ReceiveNotify,
-    // since the udpio might need to be reconfigured.
-    //
-    NetbufFree (*UdpPacket);
-    *UdpPacket = NULL;
+    Ahead  = (BOOLEAN) ((Instance->WindowSize > 1) && (BlockNum > Expected) &&
+                        (BlockNum - Expected < Instance->WindowSize));
+    Behind = (BOOLEAN) ((Instance->WindowSize > 1) && (BlockNum < Expected) &&
+                        (Expected - BlockNum <= Instance->WindowSize));
+    if (!Ahead && !Behind) {
+      //
+      // Free the received packet before send new packet in ReceiveNotify,
+      // since the udpio might need to be reconfigured.
+      //
+      NetbufFree (*UdpPacket);
+      *UdpPacket = NULL;
 
-    //
-    // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
-    //
-    return Mtftp6RrqSendAck (Instance,  (UINT16) (Expected - 1));
+      //
+      // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
+      //
+      return Mtftp6RrqSendAck (Instance,  (UINT16) (Expected - 1));
+    }
   }
 
-  Status = Mtftp6RrqSaveBlock (Instance, Packet, Len, UdpPacket);
+  if (!Behind) {
+    Status = Mtftp6RrqSaveBlock (Instance, Packet, Len, UdpPacket);
 
-  if (EFI_ERROR (Status)) {
-    return Status;
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
   }
 
   //
-  // Record the total received and saved block number.
+  // Record the total received block number, the window is acked
+  // once this many blocks have been received since the last ACK.
   //
   Instance->TotalBlock ++;
 
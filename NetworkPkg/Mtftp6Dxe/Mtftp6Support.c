@@ -198,27 +198,30 @@ Mtftp6RemoveBlockNum (
     //    if End == Num, only need to decrease the End by one because
     //    we have (Start < Num) && (Num == End), so (Start <= End - 1).
     //    if (End > Num), the hold is split into two holes, with
-    //    [Start, Num - 1] and [Num + 1, End].
+    //    [Start, Num - 1] and [Num + 1, End]. If End == Num == Bound
+    //    and Num isn't the last block, the hole goes on in the next
+    //    round, so it is split into [Start, Num - 1] and [0, Bound].
     //
     if (Range->Start > Num) {
       return EFI_NOT_FOUND;
+    }
 
-    } else if (Range->Start == Num) {
-      Range->Start++;
+    //
+    // Note that: RFC 1350 does not mention block counter roll-over,
+    // but several TFTP hosts implement the roll-over be able to accept
+    // transfers of unlimited size. There is no consensus, however, whether
+    // the counter should wrap around to zero or to one. Many implementations
+    // wrap to zero, because this is the simplest to implement. Here we choose
+    // this solution.
+    //
+    *BlockCounter  = Num;
 
-      //
-      // Note that: RFC 1350 does not mention block counter roll-over,
-      // but several TFTP hosts implement the roll-over be able to accept
-      // transfers of unlimited size. There is no consensus, however, whether
-      // the counter should wrap around to zero or to one. Many implementations
-      // wrap to zero, because this is the simplest to implement. Here we choose
-      // this solution.
-      //
-      *BlockCounter  = Num;
+    if (Range->Round > 0) {
+      *BlockCounter += Range->Bound +  MultU64x32 (Range->Round - 1, (UINT32)(Range->Bound + 1)) + 1;
+    }
 
-      if (Range->Round > 0) {
-        *BlockCounter += Range->Bound +  MultU64x32 (Range->Round - 1, (UINT32)(Range->Bound + 1)) + 1;
-      }
+    if (Range->Start == Num) {
+      Range->Start++;
 
       if (Range->Start > Range->Bound) {
         Range->Start = 0;
@@ -233,15 +236,26 @@ Mtftp6RemoveBlockNum (
       return EFI_SUCCESS;
 
     } else {
-      if (Range->End == Num) {
+      if ((Range->End == Num) && ((Num < Range->Bound) || Completed)) {
         Range->End--;
       } else {
-        NewRange = Mtftp6AllocateRange ((UINT16) (Num + 1), (UINT16) Range->End);
+        if (Range->End == Num) {
+          NewRange = Mtftp6AllocateRange (0, (UINT16) Range->Bound);
+        } else {
+          NewRange = Mtftp6AllocateRange ((UINT16) (Num + 1), (UINT16) Range->End);
+        }
 
         if (NewRange == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
 
+        //
+        // The new hole is in the same round of the block counter,
+        // unless it starts over from zero.
+        //
+        NewRange->Round = (Range->End == Num) ? Range->Round + 1 : Range->Round;
+        NewRange->Bound = Range->Bound;
+
         Range->End = Num - 1;
         NetListInsertAfter (&Range->Link, &NewRange->Link);
       }
@@ -1185,6 +1199,8 @@ Mtftp6OnTimerTick (
   LIST_ENTRY                *Entry;
   LIST_ENTRY                *Next;
   EFI_MTFTP6_TOKEN          *Token;
+  EFI_MTFTP6_PACKET         *Ack;
+  INTN                      Expected;
   EFI_STATUS                Status;
 
   Service = (MTFTP6_SERVICE *) Context;
@@ -1231,6 +1247,18 @@ Mtftp6OnTimerTick (
     // otherwise exit the transfer.
     //
     if (Instance->CurRetry < Instance->MaxRetry) {
+      //
+      // If part of a window has been received since the last ACK, ack the blocks
+      // received in order instead, so the server resends from the first lost one.
+      //
+      if (Instance->TotalBlock != Instance->AckedBlock) {
+        Expected = Mtftp6GetNextBlockNum (&Instance->BlkList);
+        Ack      = (EFI_MTFTP6_PACKET *) NetbufGetByte (Instance->LastPacket, 0, NULL);
+        if ((Expected >= 0) && (Ack != NULL) && (NTOHS (Ack->OpCode) == EFI_MTFTP6_OPCODE_ACK)) {
+          Ack->Ack.Block[0]    = HTONS ((UINT16) (Expected - 1));
+          Instance->AckedBlock = Instance->TotalBlock;
+        }
+      }
       Mtftp6TransmitPacket (Instance, Instance->LastPacket);
     } else {
       Mtftp6OperationClean (Instance, EFI_TIMEOUT);
@@ -360,6 +360,20 @@ TcpRetransmit (
   IN TCP_SEQNO Seq
   );
 
+/**
+  Retransmit the holes in the SACK scoreboard during loss recovery.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @retval 0       The retransmission succeeded or nothing needed to be sent.
+  @retval -1      An error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB *Tcb
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -499,6 +513,17 @@ TcpInput (
   IN UINT8           Version
   );
 
+/**
+  Forget the SACK information received from the peer.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClearScoreboard (
+  IN OUT TCP_CB *Tcb
+  );
+
 //
 // Functions in TcpTimer.c
 //
@@ -42,8 +42,10 @@ TcpFastRecover (
   IN     TCP_SEG *Seg
   )
 {
-  UINT32  FlightSize;
-  UINT32  Acked;
+  UINT32      FlightSize;
+  UINT32      Acked;
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Node;
 
   //
   // Step 1: Three duplicate ACKs and not in fast recovery
@@ -65,7 +67,32 @@ TcpFastRecover (
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->FastRetxmits++;
+
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+      //
+      // RFC6675: the window is not inflated by the duplicate ACKs,
+      // the data allowed to send is computed from the pipe instead.
+      //
+      // The hole pointers left by a previous recovery are stale, start
+      // again from SND.UNA, and take the highest SACKed sequence from the
+      // scoreboard.
+      //
+      Tcb->CWnd        = Tcb->Ssthresh;
+      Tcb->SackHighSeq = Tcb->SndUna;
+
+      NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+        Node = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+        if (Node->Sacked && TCP_SEQ_GT (Node->End, Tcb->SackHighSeq)) {
+          Tcb->SackHighSeq = Node->End;
+        }
+      }
+
+      Tcb->SackRetxmitSeq = Tcb->SndUna + MIN (Tcb->SndMss, TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna));
+    } else {
+      Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    }
 
     DEBUG (
       (EFI_D_NET,
@@ -89,7 +116,9 @@ TcpFastRecover (
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+      Tcb->CWnd += Tcb->SndMss;
+    }
     DEBUG (
       (EFI_D_NET,
       "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -114,6 +143,12 @@ TcpFastRecover (
       Tcb->CWnd         = MIN (Tcb->Ssthresh, FlightSize + Tcb->SndMss);
 
       Tcb->CongestState = TCP_CONGEST_OPEN;
+
+      //
+      // Don't carry the hole pointers over to the next recovery.
+      //
+      Tcb->SackHighSeq    = Seg->Ack;
+      Tcb->SackRetxmitSeq = Seg->Ack;
       DEBUG (
         (EFI_D_NET,
         "TcpFastRecover: received a full ACK(%d) for TCB %p, exit fast recovery\n",
@@ -121,6 +156,25 @@ TcpFastRecover (
         Tcb)
         );
 
+    } else if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+               TCP_SEQ_GT (Tcb->SackHighSeq, Seg->Ack)) {
+
+      //
+      // Partial ACK with SACK information above it: the holes
+      // are retransmitted by TcpSackRetransmit once SndUna is
+      // updated, and the window is not deflated.
+      //
+      if (TCP_SEQ_LT (Tcb->SackRetxmitSeq, Seg->Ack)) {
+        Tcb->SackRetxmitSeq = Seg->Ack;
+      }
+
+      DEBUG (
+        (EFI_D_NET,
+        "TcpFastRecover: received a partial ACK(%d) with SACK for TCB %p\n",
+        Seg->Ack,
+        Tcb)
+        );
+
     } else {
 
       //
@@ -129,6 +183,12 @@ TcpFastRecover (
       // , then deflate the CWnd
       //
       TcpRetransmit (Tcb, Seg->Ack);
+
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+        Tcb->SackRetxmitSeq = Seg->Ack + MIN (Tcb->SndMss, TCP_SUB_SEQ (Tcb->SndNxt, Seg->Ack));
+        return;
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -205,6 +265,107 @@ TcpFastLossRecover (
   }
 }
 
+/**
+  Mark the segments in SndQue covered by the SACK blocks received from the
+  peer, as specified in RFC2018 and RFC6675.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg      Segment that carries the SACK option.
+  @param[in]       Option   Pointer to the options parsed from the segment.
+
+**/
+VOID
+TcpSackUpdateScoreboard (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEG    *Seg,
+  IN     TCP_OPTION *Option
+  )
+{
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Node;
+  TCP_SACK_BLOCK  *Block;
+  TCP_SEQNO       Highest;
+  UINT8           Index;
+
+  //
+  // Ignore the blocks already covered by the cumulative ACK (D-SACK)
+  // and the blocks beyond the data that has been sent.
+  //
+  Highest = Seg->Ack;
+
+  for (Index = 0; Index < Option->SackCount; Index++) {
+    Block = &Option->SackBlock[Index];
+
+    if (TCP_SEQ_GEQ (Block->Left, Block->Right) ||
+        TCP_SEQ_LT (Block->Left, Seg->Ack) ||
+        TCP_SEQ_GT (Block->Right, Tcb->SndNxt)
+        ) {
+
+      Block->Right = Block->Left;
+      continue;
+    }
+
+    if (TCP_SEQ_GT (Block->Right, Highest)) {
+      Highest = Block->Right;
+    }
+  }
+
+  if (Highest == Seg->Ack) {
+    return;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (TCP_SEQ_GEQ (Node->Seq, Highest)) {
+      break;
+    }
+
+    if (Node->Sacked || TCP_SEQ_LT (Node->Seq, Seg->Ack)) {
+      continue;
+    }
+
+    for (Index = 0; Index < Option->SackCount; Index++) {
+      Block = &Option->SackBlock[Index];
+
+      if (TCP_SEQ_LEQ (Block->Left, Node->Seq) && TCP_SEQ_LEQ (Node->End, Block->Right)) {
+
+        Node->Sacked      = TRUE;
+        Tcb->SackedBytes += TCP_SUB_SEQ (Node->End, Node->Seq);
+        break;
+      }
+    }
+  }
+
+  if (TCP_SEQ_GT (Highest, Tcb->SackHighSeq)) {
+    Tcb->SackHighSeq = Highest;
+  }
+}
+
+/**
+  Forget the SACK information received from the peer. It is called after
+  a retransmission timeout, when the peer may have discarded the data it
+  SACKed, RFC2018 section 8.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClearScoreboard (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List))->Sacked = FALSE;
+  }
+
+  Tcb->SackedBytes    = 0;
+  Tcb->SackHighSeq    = Tcb->SndUna;
+  Tcb->SackRetxmitSeq = Tcb->SndUna;
+}
+
 /**
   Compute the RTT as specified in RFC2988.
 
@@ -550,6 +711,7 @@ TcpDeliverData (
         }
       }
 
+      Tcb->BytesRcvd += Nbuf->TotalSize;
       SockDataRcvd (Tcb->Sk, Nbuf, Urgent);
     }
 
@@ -593,6 +755,18 @@ TcpQueueData (
   Seg   = TCPSEG_NETBUF (Nbuf);
   Head  = &Tcb->RcvQue;
 
+  //
+  // Remember the latest segment for the first SACK block,
+  // and acknowledge out-of-order data immediately, so the
+  // peer learns about the hole as soon as possible.
+  //
+  Tcb->SackRecentSeq = Seg->Seq;
+
+  if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+    Tcb->OutOfOrderSegs++;
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_ACK_NOW);
+  }
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -715,11 +889,19 @@ TcpAdjustSndQue (
     if (TCP_SEQ_LEQ (Seg->End, Ack)) {
       Cur = Cur->ForwardLink;
 
+      if (Seg->Sacked) {
+        Tcb->SackedBytes -= TCP_SUB_SEQ (Seg->End, Seg->Seq);
+      }
+
       RemoveEntryList (&Node->List);
       NetbufFree (Node);
       continue;
     }
 
+    if (Seg->Sacked) {
+      Tcb->SackedBytes -= TCP_SUB_SEQ (Ack, Seg->Seq);
+    }
+
     return TcpTrimSegment (Node, Ack, Seg->End);
   }
 
@@ -1262,6 +1444,16 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Update the SACK scoreboard before counting duplicate acks.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+      TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK))
+  {
+
+    TcpSackUpdateScoreboard (Tcb, Seg, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1279,8 +1471,12 @@ TcpInput (
 
   //
   // Congestion avoidance, fast recovery and fast retransmission.
+  // With SACK, the recovery is also entered once more than three
+  // segments above SND.UNA are SACKed, RFC6675 section 5.
   //
-  if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3)) ||
+  if (((Tcb->CongestState == TCP_CONGEST_OPEN) &&
+       (Tcb->DupAck < 3) &&
+       ((Seg->Ack != Tcb->SndUna) || (Tcb->SackedBytes < 3 * (UINT32) Tcb->SndMss))) ||
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
 
@@ -1327,6 +1523,16 @@ TcpInput (
     }
   }
 
+  //
+  // Retransmit the holes in the SACK scoreboard as the pipe allows.
+  //
+  if ((Tcb->CongestState == TCP_CONGEST_RECOVER) &&
+      TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK))
+  {
+
+    TcpSackRetransmit (Tcb);
+  }
+
   //
   // Update window info
   //
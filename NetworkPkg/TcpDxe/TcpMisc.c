@@ -83,6 +83,23 @@ TcpInitTcbLocal (
   Tcb->RetxmitSeqMax = 0;
 
   Tcb->ProbeTimerOn = FALSE;
+
+  //
+  // Nothing is SACKed or counted yet
+  //
+  Tcb->SackRecentSeq   = Tcb->Iss;
+  Tcb->SackHighSeq     = Tcb->Iss;
+  Tcb->SackRetxmitSeq  = Tcb->Iss;
+  Tcb->SackedBytes     = 0;
+
+  Tcb->BytesSent       = 0;
+  Tcb->BytesRcvd       = 0;
+  Tcb->RetxmitSegs     = 0;
+  Tcb->FastRetxmits    = 0;
+  Tcb->SackRetxmits    = 0;
+  Tcb->TimeoutRetxmits = 0;
+  Tcb->OutOfOrderSegs  = 0;
+  Tcb->StartTick       = mTcpTick;
 }
 
 /**
@@ -165,6 +182,14 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  //
+  // Use selective acknowledgment only if both ends permit it, RFC2018.
+  //
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SND_SACK);
+  }
 }
 
 /**
@@ -620,6 +645,7 @@ TcpSetState (
   switch (State) {
   case TCP_ESTABLISHED:
 
+    Tcb->StartTick = mTcpTick;
     SockConnEstablished (Tcb->Sk);
 
     if (Tcb->Parent != NULL) {
@@ -634,6 +660,22 @@ TcpSetState (
 
   case TCP_CLOSED:
 
+    DEBUG (
+      (EFI_D_NET,
+      "Tcb (%p) closed after %d ticks: sent %ld, received %ld bytes, "
+      "%d retransmitted segments (%d fast, %d SACK, %d timeout), %d out of order, SACK %s\n",
+      Tcb,
+      TCP_SUB_TIME (mTcpTick, Tcb->StartTick),
+      Tcb->BytesSent,
+      Tcb->BytesRcvd,
+      Tcb->RetxmitSegs,
+      Tcb->FastRetxmits,
+      Tcb->SackRetxmits,
+      Tcb->TimeoutRetxmits,
+      Tcb->OutOfOrderSegs,
+      TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ? L"on" : L"off")
+      );
+
     SockConnClosed (Tcb->Sk);
 
     break;
@@ -62,6 +62,86 @@ TcpPutUint32 (
   CopyMem (Buf, &Data, sizeof (UINT32));
 }
 
+/**
+  Collect the blocks of contiguous data queued out of order in RcvQue, to
+  be reported in the SACK option. The block containing the segment received
+  most recently is reported first, as required by RFC2018.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the blocks.
+  @param[in]   MaxCount  The number of entries in Block, at least 1.
+
+  @return                The number of blocks stored in Block.
+
+**/
+UINT8
+TcpSackCollectBlocks (
+  IN  TCP_CB         *Tcb,
+  OUT TCP_SACK_BLOCK *Block,
+  IN  UINT8          MaxCount
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Seg;
+  TCP_SEQNO   Left;
+  TCP_SEQNO   Right;
+  UINT8       Count;
+  BOOLEAN     Found;
+
+  ASSERT (MaxCount > 0);
+
+  //
+  // Block[0] is reserved for the block of the most recent segment.
+  //
+  Count = 1;
+  Found = FALSE;
+  Entry = Tcb->RcvQue.ForwardLink;
+
+  while (Entry != &Tcb->RcvQue) {
+    Seg   = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+    Left  = Seg->Seq;
+    Right = Seg->End;
+    Entry = Entry->ForwardLink;
+
+    //
+    // RcvQue is sorted by sequence number, merge the following
+    // segments that are adjacent to or overlap the block.
+    //
+    while (Entry != &Tcb->RcvQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+      if (TCP_SEQ_GT (Seg->Seq, Right)) {
+        break;
+      }
+
+      if (TCP_SEQ_GT (Seg->End, Right)) {
+        Right = Seg->End;
+      }
+
+      Entry = Entry->ForwardLink;
+    }
+
+    if (!Found && TCP_SEQ_GEQ (Tcb->SackRecentSeq, Left) && TCP_SEQ_LT (Tcb->SackRecentSeq, Right)) {
+
+      Block[0].Left  = Left;
+      Block[0].Right = Right;
+      Found          = TRUE;
+    } else if (Count < MaxCount) {
+
+      Block[Count].Left  = Left;
+      Block[Count].Right = Right;
+      Count++;
+    }
+  }
+
+  if (!Found) {
+    Count--;
+    CopyMem (&Block[0], &Block[1], Count * sizeof (TCP_SACK_BLOCK));
+  }
+
+  return Count;
+}
+
 /**
   Compute the window scale value according to the given buffer size.
 
@@ -159,6 +239,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build the SACK permitted option, only when SACK is not
+  // disabled, and either we are doing active open or we
+  // have received SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+        TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK))
+      ) {
+
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -186,11 +288,16 @@ TcpBuildOption (
   IN NET_BUF *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_SACK_MAX_BLOCKS];
+  UINT8           Count;
+  UINT8           Index;
+  UINT32          DataLen;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
-  Len = 0;
+  Len     = 0;
+  DataLen = Nbuf->TotalSize;
 
   //
   // Build the Timestamp option.
@@ -213,6 +320,41 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Report the data queued out of order in the SACK option. It is only
+  // carried by pure ACKs, so the data segments are still sized by SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      (DataLen == 0) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      ) {
+
+    Count = TcpSackCollectBlocks (
+              Tcb,
+              Block,
+              (UINT8) ((TCP_OPTION_MAX_LEN - Len - 4) / TCP_OPTION_SACK_BLOCK_LEN)
+              );
+
+    if (Count > 0) {
+      Data = NetbufAllocSpace (
+              Nbuf,
+              4 + Count * TCP_OPTION_SACK_BLOCK_LEN,
+              NET_BUF_HEAD
+              );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16) (Len + 4 + Count * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Count * TCP_OPTION_SACK_BLOCK_LEN));
+
+      for (Index = 0; Index < Count; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -238,10 +380,12 @@ TcpParseOption (
   UINT8 Cur;
   UINT8 Type;
   UINT8 Len;
+  UINT8 Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag  = 0;
+  Option->Flag      = 0;
+  Option->SackCount = 0;
 
   TotalLen      = (UINT8) ((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -313,6 +457,45 @@ TcpParseOption (
       Cur += TCP_OPTION_TS_LEN;
       break;
 
+    case TCP_OPTION_SACK_PERM:
+      Len = Head[Cur + 1];
+
+      if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+
+        return -1;
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+      Cur += TCP_OPTION_SACK_PERM_LEN;
+      break;
+
+    case TCP_OPTION_SACK:
+      Len = Head[Cur + 1];
+
+      if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+          ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+          (TotalLen - Cur < Len)
+          ) {
+
+        return -1;
+      }
+
+      Option->SackCount = (UINT8) MIN (
+                                    (Len - 2) / TCP_OPTION_SACK_BLOCK_LEN,
+                                    TCP_OPTION_SACK_MAX_BLOCKS
+                                    );
+
+      for (Index = 0; Index < Option->SackCount; Index++) {
+        Option->SackBlock[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        Option->SackBlock[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+      Cur = (UINT8) (Cur + Len);
+      break;
+
     case TCP_OPTION_NOP:
       Cur++;
       break;
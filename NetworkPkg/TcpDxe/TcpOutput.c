@@ -156,6 +156,47 @@ TcpGetMaxSndNxt (
   return TCPSEG_NETBUF (Nbuf)->End;
 }
 
+/**
+  Estimate the data outstanding in the network during SACK based
+  loss recovery, the "pipe" defined in RFC6675. The data not SACKed
+  is in the pipe unless it is below the highest SACKed sequence and
+  has not been retransmitted yet, that is, deemed lost.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The number of bytes estimated to be in the pipe.
+
+**/
+UINT32
+TcpSackPipe (
+  IN TCP_CB *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Seg;
+  UINT32      Pipe;
+
+  Pipe = 0;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SndNxt)) {
+      break;
+    }
+
+    if (Seg->Sacked) {
+      continue;
+    }
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SackHighSeq) || TCP_SEQ_LT (Seg->Seq, Tcb->SackRetxmitSeq)) {
+      Pipe += TCP_SUB_SEQ (Seg->End, Seg->Seq);
+    }
+  }
+
+  return Pipe;
+}
+
 /**
   Compute how much data to send.
 
@@ -177,6 +218,7 @@ TcpDataToSend (
   UINT32  Len;
   UINT32  Left;
   UINT32  Limit;
+  UINT32  Pipe;
 
   Sk = Tcb->Sk;
   ASSERT (Sk != NULL);
@@ -191,7 +233,23 @@ TcpDataToSend (
   Win   = 0;
   Limit = Tcb->SndWl2 + Tcb->SndWnd;
 
-  if (TCP_SEQ_GT (Limit, Tcb->SndUna + Tcb->CWnd)) {
+  if ((Tcb->CongestState == TCP_CONGEST_RECOVER) &&
+      TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)
+      ) {
+    //
+    // During SACK based loss recovery, new data can be sent as
+    // long as the pipe is smaller than the congestion window.
+    //
+    Pipe = TcpSackPipe (Tcb);
+
+    if (Pipe >= Tcb->CWnd) {
+
+      Limit = Tcb->SndNxt;
+    } else if (TCP_SEQ_GT (Limit, Tcb->SndNxt + Tcb->CWnd - Pipe)) {
+
+      Limit = Tcb->SndNxt + Tcb->CWnd - Pipe;
+    }
+  } else if (TCP_SEQ_GT (Limit, Tcb->SndUna + Tcb->CWnd)) {
 
     Limit = Tcb->SndUna + Tcb->CWnd;
   }
@@ -715,6 +773,8 @@ TcpRetransmit (
     Tcb->RetxmitSeqMax = Seq;
   }
 
+  Tcb->RetxmitSegs++;
+
   //
   // The retransmitted buffer may be on the SndQue,
   // trim TCP head because all the buffers on SndQue
@@ -735,6 +795,80 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the holes in the SACK scoreboard during loss recovery,
+  as specified in RFC6675. Holes are retransmitted in sequence order
+  from SackRetxmitSeq up to the highest SACKed sequence, as long as
+  the pipe leaves room for a full-sized segment in the congestion
+  window.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @retval 0       The retransmission succeeded or nothing needed to be sent.
+  @retval -1      An error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Seg;
+  TCP_SEQNO   Seq;
+  UINT32      Pipe;
+  UINT32      Len;
+
+  Pipe = TcpSackPipe (Tcb);
+  Seq  = Tcb->SackRetxmitSeq;
+
+  if (TCP_SEQ_LT (Seq, Tcb->SndUna)) {
+    Seq = Tcb->SndUna;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SackHighSeq)) {
+      break;
+    }
+
+    if (Seg->Sacked || TCP_SEQ_LEQ (Seg->End, Seq)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Seq, Seg->Seq)) {
+      Seq = Seg->Seq;
+    }
+
+    while (TCP_SEQ_LT (Seq, Seg->End)) {
+      if (Pipe + Tcb->SndMss > Tcb->CWnd) {
+        return 0;
+      }
+
+      if (TcpRetransmit (Tcb, Seq) != 0) {
+        return -1;
+      }
+
+      Len = MIN (TCP_SUB_SEQ (Seg->End, Seq), Tcb->SndMss);
+
+      Seq                 = Seq + Len;
+      Pipe               += Len;
+      Tcb->SackRetxmitSeq = Seq;
+      Tcb->SackRetxmits++;
+
+      DEBUG (
+        (EFI_D_NET,
+        "TcpSackRetransmit: retransmitted hole up to %d for TCB %p\n",
+        Seq,
+        Tcb)
+        );
+    }
+  }
+
+  return 0;
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
@@ -924,6 +1058,7 @@ TcpToSendData (
     }
 
     Sent += TCP_SUB_SEQ (End, Seq);
+    Tcb->BytesSent += Len;
 
     //
     // All the buffers in the SndQue are headless.
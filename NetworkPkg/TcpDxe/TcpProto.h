@@ -72,6 +72,8 @@
 #define TCP_CTRL_TIMER_ON        0x1000 ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON          0x2000 ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW         0x4000 ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK         0x8000 ///< Disable selective acknowledgment.
+#define TCP_CTRL_SND_SACK        0x10000 ///< SACK is negotiated with the remote.
 
 //
 // Timer related values
@@ -217,6 +219,7 @@ typedef struct _TCP_SEG {
   UINT8     Flag; ///< TCP header flags.
   UINT16    Urg;  ///< Valid if URG flag is set.
   UINT32    Wnd;  ///< TCP window size field.
+  BOOLEAN   Sacked; ///< The segment in SndQue is covered by a SACK block.
 } TCP_SEG;
 
 ///
@@ -315,6 +318,27 @@ struct _TCP_CONTROL_BLOCK {
   //
   TCP_SEQNO         RetxmitSeqMax;       ///< Max Seq number in previous retransmission.
 
+  //
+  // RFC2018 and RFC6675 variables.
+  // Selective acknowledgment and SACK based loss recovery.
+  //
+  TCP_SEQNO         SackRecentSeq;  ///< Seq of the segment that last entered RcvQue.
+  TCP_SEQNO         SackHighSeq;    ///< Highest sequence SACKed by the peer (HighData).
+  TCP_SEQNO         SackRetxmitSeq; ///< Next hole sequence to retransmit (HighRxt).
+  UINT32            SackedBytes;    ///< Bytes in SndQue SACKed by the peer.
+
+  //
+  // Per connection statistics, reported when the connection is closed.
+  //
+  UINT64            BytesSent;       ///< Data bytes sent, excluding retransmissions.
+  UINT64            BytesRcvd;       ///< Data bytes delivered to the socket.
+  UINT32            RetxmitSegs;     ///< Segments retransmitted for any reason.
+  UINT32            FastRetxmits;    ///< Fast retransmissions on recovery entry.
+  UINT32            SackRetxmits;    ///< Holes retransmitted from the SACK scoreboard.
+  UINT32            TimeoutRetxmits; ///< Retransmission timeouts.
+  UINT32            OutOfOrderSegs;  ///< Segments queued out of order.
+  UINT32            StartTick;       ///< mTcpTick when the connection was established.
+
   //
   // configuration parameters, for EFI_TCP4_PROTOCOL specification
   //
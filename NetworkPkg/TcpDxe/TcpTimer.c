@@ -220,6 +220,12 @@ TcpRexmitTimeout (
     return ;
   }
 
+  //
+  // The peer may have discarded the data it SACKed, RFC2018 section 8.
+  //
+  TcpSackClearScoreboard (Tcb);
+  Tcb->TimeoutRetxmits++;
+
   TcpBackoffRto (Tcb);
   TcpRetransmit (Tcb, Tcb->SndUna);
   TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
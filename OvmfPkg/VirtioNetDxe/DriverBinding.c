@@ -199,6 +199,10 @@ VirtioNetSnpPopulate (
   Dev->Snp.Receive        = &VirtioNetReceive;
   Dev->Snp.Mode           = &Dev->Snm;
 
+  Dev->RxLend.Revision = EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL_REVISION;
+  Dev->RxLend.Receive  = &VirtioNetRxLendReceive;
+  Dev->RxLend.Release  = &VirtioNetRxLendRelease;
+
   Dev->Snm.State                 = EfiSimpleNetworkStopped;
   Dev->Snm.HwAddressSize         = SIZE_OF_VNET (Mac);
   Dev->Snm.MediaHeaderSize       = SIZE_OF_VNET (Mac) + // dst MAC
@@ -490,12 +494,13 @@ VirtioNetDriverBindingStart (
   }
 
   //
-  // create a child handle with the Simple Network Protocol and the new
-  // device path installed on it
+  // create a child handle with the Simple Network Protocol, the RX lend
+  // protocol and the new device path installed on it
   //
   Status = gBS->InstallMultipleProtocolInterfaces (&Dev->MacHandle,
-                  &gEfiSimpleNetworkProtocolGuid, &Dev->Snp,
-                  &gEfiDevicePathProtocolGuid,    Dev->MacDevicePath,
+                  &gEfiSimpleNetworkProtocolGuid,          &Dev->Snp,
+                  &gEdkiiSimpleNetworkRxLendProtocolGuid,  &Dev->RxLend,
+                  &gEfiDevicePathProtocolGuid,             Dev->MacDevicePath,
                   NULL);
   if (EFI_ERROR (Status)) {
     goto FreeMacDevicePath;
@@ -516,8 +521,9 @@ VirtioNetDriverBindingStart (
 
 UninstallMultiple:
   gBS->UninstallMultipleProtocolInterfaces (Dev->MacHandle,
-         &gEfiDevicePathProtocolGuid,    Dev->MacDevicePath,
-         &gEfiSimpleNetworkProtocolGuid, &Dev->Snp,
+         &gEfiDevicePathProtocolGuid,             Dev->MacDevicePath,
+         &gEdkiiSimpleNetworkRxLendProtocolGuid,  &Dev->RxLend,
+         &gEfiSimpleNetworkProtocolGuid,          &Dev->Snp,
          NULL);
 
 FreeMacDevicePath:
@@ -605,9 +611,11 @@ VirtioNetDriverBindingStop (
     OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
     ASSERT (Dev->MacHandle == ChildHandleBuffer[0]);
-    if (Dev->Snm.State != EfiSimpleNetworkStopped) {
+    if (Dev->Snm.State != EfiSimpleNetworkStopped ||
+        Dev->RxStaleBuf != NULL) {
       //
-      // device in use, cannot stop driver instance
+      // device in use, or RX buffers still lent out, cannot stop driver
+      // instance
       //
       Status = EFI_DEVICE_ERROR;
     }
@@ -615,8 +623,9 @@ VirtioNetDriverBindingStop (
       gBS->CloseProtocol (DeviceHandle, &gVirtioDeviceProtocolGuid,
              This->DriverBindingHandle, Dev->MacHandle);
       gBS->UninstallMultipleProtocolInterfaces (Dev->MacHandle,
-             &gEfiDevicePathProtocolGuid,    Dev->MacDevicePath,
-             &gEfiSimpleNetworkProtocolGuid, &Dev->Snp,
+             &gEfiDevicePathProtocolGuid,             Dev->MacDevicePath,
+             &gEdkiiSimpleNetworkRxLendProtocolGuid,  &Dev->RxLend,
+             &gEfiSimpleNetworkProtocolGuid,          &Dev->Snp,
              NULL);
       FreePool (Dev->MacDevicePath);
       VirtioNetSnpEvacuate (Dev);
@@ -0,0 +1,238 @@
+/** @file
+
+  Implementation of the Simple Network Receive Lend Protocol, which hands the
+  RX buffers of the virtio-net device out to the consumer instead of copying
+  the received packets.
+
+  A lent buffer is taken out of the RX queue until the consumer releases it.
+  Released buffers are collected in Dev->RxReturned, and put back on the
+  available ring by the next SNP.Receive() or RxLend.Receive() call, because
+  the release may happen at TPL_NOTIFY, in the middle of either.
+
+  Copyright (c) 2020, TianoCore and contributors. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "VirtioNet.h"
+
+/**
+  Put the RX buffers released by the consumer back on the available ring of
+  the RX queue, and notify the device if there were any.
+
+  @param[in,out] Dev  The VNET_DEV driver instance, in the
+                      EfiSimpleNetworkInitialized state.
+
+  @retval EFI_SUCCESS  No buffer was released, or the released buffers were
+                       given back to the device.
+  @return              Status codes from VIRTIO_DEVICE_PROTOCOL.SetQueueNotify.
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetRepostReturnedRx (
+  IN OUT VNET_DEV *Dev
+  )
+{
+  EFI_TPL OldTpl;
+  UINT16  OldAvailIdx;
+  UINT16  AvailIdx;
+  UINT16  Index;
+
+  if (Dev->RxReturnedCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  //
+  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
+  //
+  OldAvailIdx = *Dev->RxRing.Avail.Idx;
+  AvailIdx    = OldAvailIdx;
+  for (Index = 0; Index < Dev->RxReturnedCount; ++Index) {
+    Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
+      Dev->RxReturned[Index];
+  }
+  ASSERT (Dev->RxLent >= Dev->RxReturnedCount);
+  Dev->RxLent         -= Dev->RxReturnedCount;
+  Dev->RxReturnedCount = 0;
+
+  MemoryFence ();
+  *Dev->RxRing.Avail.Idx = AvailIdx;
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (!VirtioNetNeedNotify (Dev, &Dev->RxRing, OldAvailIdx, AvailIdx)) {
+    return EFI_SUCCESS;
+  }
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+}
+
+
+/**
+  Receive a packet in a buffer lent by the network interface.
+
+  @param[in]  This         The protocol instance pointer.
+  @param[out] Frame        The received packet, starting with the media
+                           header.
+  @param[out] FrameLength  The length of the received packet in bytes.
+  @param[out] Context      The value to pass to VirtioNetRxLendRelease() to
+                           give the buffer back.
+
+  @retval EFI_SUCCESS           A packet is returned in Frame.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_NOT_READY         No packet has been received.
+  @retval EFI_OUT_OF_RESOURCES  Dev->RxMaxLent buffers are lent already; the
+                                packet is left for VirtioNetReceive().
+  @retval EFI_UNSUPPORTED       Buffers are not lent in this configuration.
+  @retval EFI_DEVICE_ERROR      The packet was too short and dropped, or the
+                                device could not be notified.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetRxLendReceive (
+  IN  EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL *This,
+  OUT VOID                                  **Frame,
+  OUT UINTN                                 *FrameLength,
+  OUT VOID                                  **Context
+  )
+{
+  VNET_DEV   *Dev;
+  EFI_TPL    OldTpl;
+  EFI_STATUS Status;
+  UINT16     RxCurUsed;
+  UINT16     DescIdx;
+  UINT32     RxLen;
+  UINT8      *RxPtr;
+
+  if (This == NULL || Frame == NULL || FrameLength == NULL ||
+      Context == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dev = VIRTIO_NET_FROM_RX_LEND (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  switch (Dev->Snm.State) {
+  case EfiSimpleNetworkStopped:
+    Status = EFI_NOT_STARTED;
+    goto Exit;
+  case EfiSimpleNetworkStarted:
+    Status = EFI_DEVICE_ERROR;
+    goto Exit;
+  default:
+    break;
+  }
+
+  if (Dev->RxMaxLent == 0) {
+    Status = EFI_UNSUPPORTED;
+    goto Exit;
+  }
+
+  Status = VirtioNetRepostReturnedRx (Dev);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  RxCurUsed = *Dev->RxRing.Used.Idx;
+  MemoryFence ();
+
+  if (Dev->RxLastUsed == RxCurUsed) {
+    Status = EFI_NOT_READY;
+    goto Exit;
+  }
+
+  if (Dev->RxLent >= Dev->RxMaxLent) {
+    //
+    // Keep enough buffers with the device; VirtioNetReceive() copies the
+    // packet out and recycles its buffer at once.
+    //
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  RxPtr = VirtioNetLocateRxFrame (Dev, &DescIdx, &RxLen);
+
+  ++Dev->RxLastUsed;
+  ++Dev->RxLent;
+  if (Dev->EventIdx) {
+    *Dev->RxRing.Avail.UsedEvent = (UINT16) (Dev->RxLastUsed - 1);
+  }
+
+  if (RxLen < Dev->Snm.MediaHeaderSize) {
+    //
+    // drop useless short packet
+    //
+    VirtioNetRxLendRelease (This, VNET_RX_LEND_CONTEXT (Dev->RxGeneration,
+                                    DescIdx));
+    VirtioNetRepostReturnedRx (Dev);
+    Status = EFI_DEVICE_ERROR;
+    goto Exit;
+  }
+
+  *Frame       = RxPtr;
+  *FrameLength = RxLen;
+  *Context     = VNET_RX_LEND_CONTEXT (Dev->RxGeneration, DescIdx);
+  Status = EFI_SUCCESS;
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+
+/**
+  Give a buffer returned by VirtioNetRxLendReceive() back to the device.
+
+  The buffer is put back on the available ring by the next receive call. If
+  the network interface was shut down since the buffer was lent, the RX area
+  that the buffer belongs to is freed with the last buffer released from it.
+
+  @param[in] This     The protocol instance pointer.
+  @param[in] Context  The Context returned by VirtioNetRxLendReceive() with
+                      the buffer.
+
+**/
+VOID
+EFIAPI
+VirtioNetRxLendRelease (
+  IN EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL *This,
+  IN VOID                                  *Context
+  )
+{
+  VNET_DEV *Dev;
+  EFI_TPL  OldTpl;
+
+  Dev = VIRTIO_NET_FROM_RX_LEND (This);
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (VNET_RX_LEND_GENERATION (Context) == Dev->RxGeneration) {
+    ASSERT (Dev->RxReturnedCount < Dev->RxLent);
+    Dev->RxReturned[Dev->RxReturnedCount++] = VNET_RX_LEND_DESC_IDX (Context);
+  } else {
+    //
+    // The buffer belongs to the RX area of an earlier initialization, which
+    // the device has stopped writing to.
+    //
+    ASSERT (Dev->RxStaleLent > 0);
+    if (--Dev->RxStaleLent == 0) {
+      Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxStaleBufMap);
+      Dev->VirtIo->FreeSharedPages (
+                     Dev->VirtIo,
+                     Dev->RxStaleBufNrPages,
+                     Dev->RxStaleBuf
+                     );
+      Dev->RxStaleBuf = NULL;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
@@ -132,6 +132,9 @@ VirtioNetGetStatus (
       ASSERT (Dev->TxCurPending <= Dev->TxMaxPending);
 
       UsedElemIdx = Dev->TxLastUsed++ % Dev->TxRing.QueueSize;
+      if (Dev->EventIdx) {
+        *Dev->TxRing.Avail.UsedEvent = (UINT16) (Dev->TxLastUsed - 1);
+      }
       DescIdx = Dev->TxRing.Used.UsedElem[UsedElemIdx].Id;
       ASSERT (DescIdx < (UINT32) (2 * Dev->TxMaxPending - 1));
 
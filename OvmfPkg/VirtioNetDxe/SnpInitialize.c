@@ -212,9 +212,10 @@ VirtioNetInitTx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  TxSharedReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  TxSharedReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0) &&
+                     !Dev->RxMergeable) ?
                     sizeof (Dev->TxSharedReq->V0_9_5) :
                     sizeof *Dev->TxSharedReq;
 
@@ -259,9 +260,11 @@ VirtioNetInitTx (
   ASSERT (Dev->TxLastUsed == 0);
 
   //
-  // want no interrupt when a transmit completes
+  // want no interrupt when a transmit completes; with
+  // VIRTIO_F_RING_EVENT_IDX, the used event index replaces the flag
   //
-  *Dev->TxRing.Avail.Flags = (UINT16) VRING_AVAIL_F_NO_INTERRUPT;
+  *Dev->TxRing.Avail.Flags     = (UINT16) VRING_AVAIL_F_NO_INTERRUPT;
+  *Dev->TxRing.Avail.UsedEvent = (UINT16) (Dev->TxLastUsed - 1);
 
   return EFI_SUCCESS;
 
@@ -293,7 +296,7 @@ FreeTxFreeStack:
     packet data into,
   - select polling over RX interrupt,
   - fully populate the RX queue with a static pattern of virtio descriptor
-    chains.
+    chains, or of single descriptors with VIRTIO_NET_F_MRG_RXBUF.
 
   @param[in,out] Dev       The VNET_DEV driver instance about to enter the
                            EfiSimpleNetworkInitialized state.
@@ -315,6 +318,8 @@ VirtioNetInitRx (
   EFI_STATUS            Status;
   UINTN                 VirtioNetReqSize;
   UINTN                 RxBufSize;
+  UINTN                 RxBufPad;
+  UINTN                 RxBufStride;
   UINT16                RxAlwaysPending;
   UINTN                 PktIdx;
   UINT16                DescIdx;
@@ -324,17 +329,20 @@ VirtioNetInitRx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  VirtioNetReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  VirtioNetReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0) &&
+                      !Dev->RxMergeable) ?
                      sizeof (VIRTIO_NET_REQ) :
                      sizeof (VIRTIO_1_0_NET_REQ);
+  Dev->RxHdrSize = VirtioNetReqSize;
 
   //
   // For each incoming packet we must supply two descriptors:
   // - the recipient for the virtio-net request header, plus
   // - the recipient for the network data (which consists of Ethernet header
   //   and Ethernet payload).
+  // With VIRTIO_NET_F_MRG_RXBUF, a single descriptor covers both.
   //
   RxBufSize = VirtioNetReqSize +
               (Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize);
@@ -343,7 +351,31 @@ VirtioNetInitRx (
   // Limit the number of pending RX packets if the queue is big. The division
   // by two is due to the above "two descriptors per packet" trait.
   //
-  RxAlwaysPending = (UINT16) MIN (Dev->RxRing.QueueSize / 2, VNET_MAX_PENDING);
+  RxAlwaysPending = (UINT16) MIN (
+                               Dev->RxRing.QueueSize /
+                               (Dev->RxMergeable ? 1 : 2),
+                               VNET_MAX_PENDING
+                               );
+
+  //
+  // Place each packet so that the protocol header following the Ethernet
+  // header is 4-byte aligned, the way the consumers of lent buffers expect
+  // it.
+  //
+  RxBufPad = ALIGN_VALUE (VirtioNetReqSize + Dev->Snm.MediaHeaderSize, 4) -
+             (VirtioNetReqSize + Dev->Snm.MediaHeaderSize);
+  RxBufStride = ALIGN_VALUE (RxBufPad + RxBufSize, 4);
+
+  //
+  // Lend at most half of the buffers, so that the device can keep receiving
+  // while the consumer holds on to the other half. The RX area of an earlier
+  // initialization that still has buffers out on loan is tracked separately;
+  // don't lend from this one until it is freed.
+  //
+  Dev->RxMaxLent       = (Dev->RxStaleBuf == NULL) ?
+                         (UINT16) (RxAlwaysPending / 2) : 0;
+  Dev->RxLent          = 0;
+  Dev->RxReturnedCount = 0;
 
   //
   // The RxBuf is shared between guest and hypervisor, use
@@ -351,7 +383,7 @@ VirtioNetInitRx (
   // BusMasterCommonBuffer so that it can be accessed by both guest and
   // hypervisor.
   //
-  NumBytes = RxAlwaysPending * RxBufSize;
+  NumBytes = RxAlwaysPending * RxBufStride;
   Dev->RxBufNrPages = EFI_SIZE_TO_PAGES (NumBytes);
   Status = Dev->VirtIo->AllocateSharedPages (
                           Dev->VirtIo,
@@ -384,21 +416,27 @@ VirtioNetInitRx (
   MemoryFence ();
   Dev->RxLastUsed = *Dev->RxRing.Used.Idx;
   ASSERT (Dev->RxLastUsed == 0);
+  Dev->RxDropBuffers = 0;
 
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device:
   // the host should not send interrupts, we'll poll in VirtioNetReceive()
-  // and VirtioNetIsPacketAvailable().
+  // and VirtioNetIsPacketAvailable(). With VIRTIO_F_RING_EVENT_IDX, the used
+  // event index replaces the flag.
   //
-  *Dev->RxRing.Avail.Flags = (UINT16) VRING_AVAIL_F_NO_INTERRUPT;
+  *Dev->RxRing.Avail.Flags     = (UINT16) VRING_AVAIL_F_NO_INTERRUPT;
+  *Dev->RxRing.Avail.UsedEvent = (UINT16) (Dev->RxLastUsed - 1);
 
   //
-  // now set up a separate, two-part descriptor chain for each RX packet, and
-  // link each chain into (from) the available ring as well
+  // now set up a separate, two-part descriptor chain (or a single descriptor)
+  // for each RX packet, and link each chain into (from) the available ring as
+  // well
   //
   DescIdx = 0;
-  RxBufDeviceAddress = Dev->RxBufDeviceBase;
   for (PktIdx = 0; PktIdx < RxAlwaysPending; ++PktIdx) {
+    RxBufDeviceAddress = Dev->RxBufDeviceBase + PktIdx * RxBufStride +
+                         RxBufPad;
+
     //
     // virtio-0.9.5, 2.4.1.2 Updating the Available Ring
     // invisible to the host until we update the Index Field
@@ -408,6 +446,13 @@ VirtioNetInitRx (
     //
     // virtio-0.9.5, 2.4.1.1 Placing Buffers into the Descriptor Table
     //
+    if (Dev->RxMergeable) {
+      Dev->RxRing.Desc[DescIdx].Addr    = RxBufDeviceAddress;
+      Dev->RxRing.Desc[DescIdx].Len     = (UINT32) RxBufSize;
+      Dev->RxRing.Desc[DescIdx++].Flags = VRING_DESC_F_WRITE;
+      continue;
+    }
+
     Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
     Dev->RxRing.Desc[DescIdx].Len   = (UINT32) VirtioNetReqSize;
     Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE | VRING_DESC_F_NEXT;
@@ -416,8 +461,7 @@ VirtioNetInitRx (
 
     Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
     Dev->RxRing.Desc[DescIdx].Len   = (UINT32) (RxBufSize - VirtioNetReqSize);
-    Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE;
-    RxBufDeviceAddress += Dev->RxRing.Desc[DescIdx++].Len;
+    Dev->RxRing.Desc[DescIdx++].Flags = VRING_DESC_F_WRITE;
   }
 
   //
@@ -556,8 +600,16 @@ VirtioNetInitialize (
   ASSERT (Dev->Snm.MediaPresentSupported ==
     !!(Features & VIRTIO_NET_F_STATUS));
 
+  //
+  // VIRTIO_NET_F_CSUM and VIRTIO_NET_F_GUEST_CSUM are left out: SNP has no
+  // way to pass per-packet checksum state to or from the network stack, which
+  // computes and verifies all checksums itself.
+  //
   Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_F_IOMMU_PLATFORM | VIRTIO_NET_F_MRG_RXBUF |
+              VIRTIO_F_RING_EVENT_IDX;
+  Dev->EventIdx    = (BOOLEAN) ((Features & VIRTIO_F_RING_EVENT_IDX) != 0);
+  Dev->RxMergeable = (BOOLEAN) ((Features & VIRTIO_NET_F_MRG_RXBUF) != 0);
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -626,6 +678,15 @@ VirtioNetInitialize (
     goto ReleaseTxAux;
   }
 
+  //
+  // With an IOMMU (e.g. SEV), the RX area is shared with the host, which
+  // could change a lent packet while the consumer parses it. Copy the packets
+  // into private memory in VirtioNetReceive() instead.
+  //
+  if ((Features & VIRTIO_F_IOMMU_PLATFORM) != 0) {
+    Dev->RxMaxLent = 0;
+  }
+
   Dev->Snm.State = EfiSimpleNetworkInitialized;
   gBS->RestoreTPL (OldTpl);
   return EFI_SUCCESS;
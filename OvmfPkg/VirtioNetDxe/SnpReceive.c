@@ -69,14 +69,12 @@ VirtioNetReceive (
   EFI_TPL    OldTpl;
   EFI_STATUS Status;
   UINT16     RxCurUsed;
-  UINT16     UsedElemIdx;
-  UINT32     DescIdx;
+  UINT16     DescIdx;
   UINT32     RxLen;
   UINTN      OrigBufferSize;
   UINT8      *RxPtr;
   UINT16     AvailIdx;
   EFI_STATUS NotifyStatus;
-  UINTN      RxBufOffset;
 
   if (This == NULL || BufferSize == NULL || Buffer == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -95,6 +93,14 @@ VirtioNetReceive (
     break;
   }
 
+  //
+  // give the buffers released through the RX lend protocol back first
+  //
+  Status = VirtioNetRepostReturnedRx (Dev);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
   //
@@ -107,19 +113,7 @@ VirtioNetReceive (
     goto Exit;
   }
 
-  UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
-  DescIdx = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
-  RxLen   = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
-
-  //
-  // the virtio-net request header must be complete; we skip it
-  //
-  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
-  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
-  //
-  // the host must not have filled in more data than requested
-  //
-  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+  RxPtr = VirtioNetLocateRxFrame (Dev, &DescIdx, &RxLen);
 
   OrigBufferSize = *BufferSize;
   *BufferSize = RxLen;
@@ -138,9 +132,6 @@ VirtioNetReceive (
     *HeaderSize = Dev->Snm.MediaHeaderSize;
   }
 
-  RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
-                        Dev->RxBufDeviceBase);
-  RxPtr = Dev->RxBuf + RxBufOffset;
   CopyMem (Buffer, RxPtr, RxLen);
 
   if (DestAddr != NULL) {
@@ -162,21 +153,29 @@ VirtioNetReceive (
 
 RecycleDesc:
   ++Dev->RxLastUsed;
+  if (Dev->EventIdx) {
+    //
+    // keep the used event index behind the consumed packets, so that the host
+    // never interrupts us
+    //
+    *Dev->RxRing.Avail.UsedEvent = (UINT16) (Dev->RxLastUsed - 1);
+  }
 
   //
   // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
   //
   AvailIdx = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16) DescIdx;
-
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
+  Dev->RxRing.Avail.Ring[AvailIdx % Dev->RxRing.QueueSize] = DescIdx;
 
   MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) { // earlier error takes precedence
-    Status = NotifyStatus;
+  *Dev->RxRing.Avail.Idx = (UINT16) (AvailIdx + 1);
+
+  if (VirtioNetNeedNotify (Dev, &Dev->RxRing, AvailIdx,
+        (UINT16) (AvailIdx + 1))) {
+    NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+    if (!EFI_ERROR (Status)) { // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
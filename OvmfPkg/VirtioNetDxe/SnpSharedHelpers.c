@@ -8,7 +8,9 @@
 
 **/
 
+#include <Library/BaseLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
 
 #include "VirtioNet.h"
 
@@ -43,6 +45,30 @@ VirtioNetShutdownRx (
   IN OUT VNET_DEV *Dev
   )
 {
+  EFI_TPL OldTpl;
+
+  //
+  // Buffers lent from the RX area and not released yet keep it alive. The
+  // device is reset already, so it no longer writes to the area; the last
+  // VirtioNetRxLendRelease() call frees it.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Dev->RxGeneration++;
+  if (Dev->RxLent > Dev->RxReturnedCount) {
+    ASSERT (Dev->RxStaleBuf == NULL);
+    Dev->RxStaleBuf        = Dev->RxBuf;
+    Dev->RxStaleBufNrPages = Dev->RxBufNrPages;
+    Dev->RxStaleBufMap     = Dev->RxBufMap;
+    Dev->RxStaleLent       = Dev->RxLent - Dev->RxReturnedCount;
+    Dev->RxLent            = 0;
+    Dev->RxReturnedCount   = 0;
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+  Dev->RxLent          = 0;
+  Dev->RxReturnedCount = 0;
+  gBS->RestoreTPL (OldTpl);
+
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxBufMap);
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
@@ -83,6 +109,139 @@ VirtioNetShutdownTx (
   FreePool (Dev->TxFreeStack);
 }
 
+/**
+  Locate the packet that the host reports first on the Used Ring of the RX
+  queue, at Dev->RxLastUsed. The caller is responsible for checking that the
+  Used Ring is not empty, and for advancing Dev->RxLastUsed.
+
+  The virtio-net request header and the packet data are laid out back to
+  back in the Receive Destination Area, whether they are described by one
+  descriptor (VIRTIO_NET_F_MRG_RXBUF) or by a two-part descriptor chain.
+
+  A packet that the host reports malformed, or merged from more than one
+  receive buffer, is reported with zero length, so that the caller drops it
+  and recycles its descriptor. The buffers that the host merged into such a
+  packet are reported the same way, one by one, as they are located.
+
+  @param[in]  Dev       The VNET_DEV driver instance in the
+                        EfiSimpleNetworkInitialized state.
+  @param[out] DescIdx   The head descriptor of the packet, to recycle to the
+                        Available Ring once the packet is consumed.
+  @param[out] FrameLen  The length of the packet data, including the media
+                        header; zero if the packet must be dropped.
+
+  @return  The packet data in the Receive Destination Area.
+*/
+UINT8 *
+EFIAPI
+VirtioNetLocateRxFrame (
+  IN  VNET_DEV *Dev,
+  OUT UINT16   *DescIdx,
+  OUT UINT32   *FrameLen
+  )
+{
+  UINT16 UsedElemIdx;
+  UINT32 RxLen;
+  UINT8  *RxPtr;
+  UINT16 NumBuffers;
+
+  UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
+  *DescIdx    = (UINT16) Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+  RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+  RxPtr       = Dev->RxBuf + (UINTN) (Dev->RxRing.Desc[*DescIdx].Addr -
+                                      Dev->RxBufDeviceBase);
+  *FrameLen   = 0;
+
+  //
+  // a continuation buffer of a merged packet that we dropped carries no
+  // virtio-net request header
+  //
+  if (Dev->RxDropBuffers > 0) {
+    --Dev->RxDropBuffers;
+    return RxPtr;
+  }
+
+  //
+  // the virtio-net request header must be complete; we skip it
+  //
+  if (RxLen < Dev->RxHdrSize) {
+    return RxPtr;
+  }
+  RxLen -= (UINT32) Dev->RxHdrSize;
+  //
+  // the host must not have filled in more data than requested
+  //
+  if (RxLen > Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize) {
+    return RxPtr;
+  }
+
+  //
+  // Without GSO, every packet should fit in one receive buffer. Should the
+  // host merge buffers nonetheless, drop the packet together with all of its
+  // continuation buffers.
+  //
+  if (Dev->RxMergeable) {
+    NumBuffers = ((VIRTIO_1_0_NET_REQ *) RxPtr)->NumBuffers;
+    if (NumBuffers != 1) {
+      if (NumBuffers > 1) {
+        Dev->RxDropBuffers = NumBuffers - 1;
+      }
+      return RxPtr;
+    }
+  }
+
+  *FrameLen = RxLen;
+  return RxPtr + Dev->RxHdrSize;
+}
+
+
+/**
+  Check whether the host needs to be notified of the descriptor chains that
+  the guest placed on the Available Ring of a queue.
+
+  With VIRTIO_F_RING_EVENT_IDX, the host publishes the available index at
+  which it wants to be notified; otherwise it sets VRING_USED_F_NO_NOTIFY
+  while it is processing the queue anyway. This lets back-to-back
+  submissions share a single notification.
+
+  @param[in] Dev          The VNET_DEV driver instance.
+  @param[in] Ring         The ring of the queue.
+  @param[in] OldAvailIdx  The available index before the submission.
+  @param[in] NewAvailIdx  The available index after the submission, already
+                          written to the ring.
+
+  @retval TRUE   The host must be notified.
+  @retval FALSE  The host will see the new descriptor chains without a
+                 notification.
+*/
+BOOLEAN
+EFIAPI
+VirtioNetNeedNotify (
+  IN VNET_DEV *Dev,
+  IN VRING    *Ring,
+  IN UINT16   OldAvailIdx,
+  IN UINT16   NewAvailIdx
+  )
+{
+  UINT16 AvailEvent;
+
+  //
+  // the new available index must be visible to the host before we look at
+  // its notification request
+  //
+  MemoryFence ();
+  if (Dev->EventIdx) {
+    //
+    // virtio-1.0, 2.4.7.2 Notification suppression: vring_need_event()
+    //
+    AvailEvent = *Ring->Used.AvailEvent;
+    return (BOOLEAN) ((UINT16) (NewAvailIdx - AvailEvent - 1) <
+                      (UINT16) (NewAvailIdx - OldAvailIdx));
+  }
+  return (BOOLEAN) ((*Ring->Used.Flags & VRING_USED_F_NO_NOTIFY) == 0);
+}
+
+
 /**
   Release TX and RX VRING resources.
 
@@ -164,13 +164,20 @@ VirtioNetTransmit (
   // without a barrier
   //
   AvailIdx = *Dev->TxRing.Avail.Idx;
-  Dev->TxRing.Avail.Ring[AvailIdx++ % Dev->TxRing.QueueSize] = DescIdx;
+  Dev->TxRing.Avail.Ring[AvailIdx % Dev->TxRing.QueueSize] = DescIdx;
 
   MemoryFence ();
-  *Dev->TxRing.Avail.Idx = AvailIdx;
+  *Dev->TxRing.Avail.Idx = (UINT16) (AvailIdx + 1);
 
-  MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  //
+  // While the host is still working through earlier packets, it picks this
+  // one up without being notified.
+  //
+  Status = EFI_SUCCESS;
+  if (VirtioNetNeedNotify (Dev, &Dev->TxRing, AvailIdx,
+        (UINT16) (AvailIdx + 1))) {
+    Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  }
 
 Exit:
   gBS->RestoreTPL (OldTpl);
@@ -20,6 +20,7 @@
 #include <Protocol/DevicePath.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkRxLend.h>
 #include <Library/OrderedCollectionLib.h>
 
 #define VNET_SIG SIGNATURE_32 ('V', 'N', 'E', 'T')
@@ -27,7 +28,16 @@
 //
 // maximum number of pending packets, separately for each direction
 //
-#define VNET_MAX_PENDING 64
+#define VNET_MAX_PENDING 128
+
+//
+// The Context of a lent RX buffer carries the RX generation it belongs to in
+// its high bits, and the head descriptor of the buffer in its low bits.
+//
+#define VNET_RX_LEND_CONTEXT(Generation, DescIdx) \
+        ((VOID *)(UINTN)(((UINT32)(Generation) << 16) | (DescIdx)))
+#define VNET_RX_LEND_GENERATION(Context)  ((UINT16)((UINTN)(Context) >> 16))
+#define VNET_RX_LEND_DESC_IDX(Context)    ((UINT16)(UINTN)(Context))
 
 //
 // State diagram:
@@ -76,15 +86,30 @@ typedef struct {
   EFI_EVENT                   ExitBoot;          // VirtioNetSnpPopulate
   EFI_DEVICE_PATH_PROTOCOL    *MacDevicePath;    // VirtioNetDriverBindingStart
   EFI_HANDLE                  MacHandle;         // VirtioNetDriverBindingStart
+  EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL RxLend;  // VirtioNetSnpPopulate
+  BOOLEAN                     EventIdx;          // VirtioNetInitialize
+  BOOLEAN                     RxMergeable;       // VirtioNetInitialize
 
   VRING                       RxRing;            // VirtioNetInitRing
   VOID                        *RxRingMap;        // VirtioRingMap and
                                                  // VirtioNetInitRing
   UINT8                       *RxBuf;            // VirtioNetInitRx
+  UINTN                       RxHdrSize;         // VirtioNetInitRx
   UINT16                      RxLastUsed;        // VirtioNetInitRx
+  UINT16                      RxDropBuffers;     // VirtioNetInitRx
   UINTN                       RxBufNrPages;      // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS        RxBufDeviceBase;   // VirtioNetInitRx
   VOID                        *RxBufMap;         // VirtioNetInitRx
+  UINT16                      RxMaxLent;         // VirtioNetInitRx
+  UINT16                      RxLent;            // VirtioNetInitRx
+  UINT16                      RxGeneration;      // VirtioNetShutdownRx
+  UINT16                      RxReturnedCount;   // VirtioNetInitRx
+  UINT16                      RxReturned[VNET_MAX_PENDING];
+                                                 // VirtioNetRxLendRelease
+  UINT8                       *RxStaleBuf;       // VirtioNetShutdownRx
+  UINTN                       RxStaleBufNrPages; // VirtioNetShutdownRx
+  VOID                        *RxStaleBufMap;    // VirtioNetShutdownRx
+  UINT16                      RxStaleLent;       // VirtioNetShutdownRx
 
   VRING                       TxRing;            // VirtioNetInitRing
   VOID                        *TxRingMap;        // VirtioRingMap and
@@ -112,6 +137,9 @@ typedef struct {
 #define VIRTIO_NET_FROM_SNP(SnpPointer) \
         CR (SnpPointer, VNET_DEV, Snp, VNET_SIG)
 
+#define VIRTIO_NET_FROM_RX_LEND(RxLendPointer) \
+        CR (RxLendPointer, VNET_DEV, RxLend, VNET_SIG)
+
 #define VIRTIO_CFG_WRITE(Dev, Field, Value)  ((Dev)->VirtIo->WriteDevice (  \
                                                 (Dev)->VirtIo,              \
                                                 OFFSET_OF_VNET (Field),     \
@@ -253,9 +281,34 @@ VirtioNetReceive (
   OUT UINT16                     *Protocol   OPTIONAL
   );
 
+//
+// member functions implementing the Simple Network Receive Lend Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioNetRxLendReceive (
+  IN  EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL *This,
+  OUT VOID                                  **Frame,
+  OUT UINTN                                 *FrameLength,
+  OUT VOID                                  **Context
+  );
+
+VOID
+EFIAPI
+VirtioNetRxLendRelease (
+  IN EDKII_SIMPLE_NETWORK_RX_LEND_PROTOCOL *This,
+  IN VOID                                  *Context
+  );
+
 //
 // utility functions shared by various SNP member functions
 //
+EFI_STATUS
+EFIAPI
+VirtioNetRepostReturnedRx (
+  IN OUT VNET_DEV *Dev
+  );
+
 VOID
 EFIAPI
 VirtioNetShutdownRx (
@@ -268,6 +321,23 @@ VirtioNetShutdownTx (
   IN OUT VNET_DEV *Dev
   );
 
+UINT8 *
+EFIAPI
+VirtioNetLocateRxFrame (
+  IN  VNET_DEV *Dev,
+  OUT UINT16   *DescIdx,
+  OUT UINT32   *FrameLen
+  );
+
+BOOLEAN
+EFIAPI
+VirtioNetNeedNotify (
+  IN VNET_DEV *Dev,
+  IN VRING    *Ring,
+  IN UINT16   OldAvailIdx,
+  IN UINT16   NewAvailIdx
+  );
+
 VOID
 EFIAPI
 VirtioNetUninitRing (